@@ -31,9 +31,17 @@
 #include "system-mutex.h"
 #include "boolean.h"
 #include "enum.h"
+#include "integer.h"
+#include "trace-source-accessor.h"
 
 
 #include <cmath>
+#include <iomanip>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 
 /**
@@ -51,6 +59,8 @@ NS_LOG_COMPONENT_DEFINE ("RealtimeSimulatorImpl");
 
 NS_OBJECT_ENSURE_REGISTERED (RealtimeSimulatorImpl);
 
+const uint32_t RealtimeSimulatorImpl::LATENESS_BUCKETS;
+
 TypeId
 RealtimeSimulatorImpl::GetTypeId (void)
 {
@@ -69,6 +79,17 @@ RealtimeSimulatorImpl::GetTypeId (void)
                    TimeValue (Seconds (0.1)),
                    MakeTimeAccessor (&RealtimeSimulatorImpl::m_hardLimit),
                    MakeTimeChecker ())
+    .AddAttribute ("CpuAffinity",
+                   "Processor to pin the thread calling Run () to while the simulation "
+                   "runs, or -1 to let the operating system choose (Linux only).",
+                   IntegerValue (-1),
+                   MakeIntegerAccessor (&RealtimeSimulatorImpl::m_cpuAffinity),
+                   MakeIntegerChecker<int32_t> (-1))
+    .AddTraceSource ("Lateness",
+                     "Real time elapsed between the scheduled time of an event "
+                     "and the start of its execution.",
+                     MakeTraceSourceAccessor (&RealtimeSimulatorImpl::m_latenessTrace),
+                     "ns3::Time::TracedCallback")
   ;
   return tid;
 }
@@ -90,6 +111,9 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
+  m_cpuAffinity = -1;
+  m_latenessHistogram.resize (LATENESS_BUCKETS);
+  ResetLatenessStatistics ();
 
   m_main = SystemThread::Self();
 
@@ -316,6 +340,8 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   // whatever event is at the head of this list if the list is in time order.
   //
   Scheduler::Event next;
+  uint64_t tsFinal;
+  uint64_t lateness;
 
   { 
     CriticalSection cs (m_mutex);
@@ -350,6 +376,14 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
 
+    //
+    // Record how late we are starting the event, so that the user can tell
+    // how well the simulation keeps up with real time.
+    //
+    tsFinal = m_synchronizer->GetCurrentRealtime ();
+    lateness = tsFinal > m_currentTs ? tsFinal - m_currentTs : 0;
+    RecordLateness (lateness);
+
     // 
     // We're about to run the event and we've done our best to synchronize this
     // event execution time to real time.  Now, if we're in SYNC_HARD_LIMIT mode
@@ -361,7 +395,6 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     //
     if (m_synchronizationMode == SYNC_HARD_LIMIT)
       {
-        uint64_t tsFinal = m_synchronizer->GetCurrentRealtime ();
         uint64_t tsJitter;
 
         if (tsFinal >= m_currentTs)
@@ -386,6 +419,8 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   // event list so we can execute it outside a critical section without fear of someone
   // changing things out from under us.
 
+  m_latenessTrace (TimeStep (lateness));
+
   EventImpl *event = next.impl;
   m_synchronizer->EventStart ();
   event->Invoke ();
@@ -430,6 +465,33 @@ RealtimeSimulatorImpl::Run (void)
 
   m_stop = false;
   m_running = true;
+
+#ifdef __linux__
+  cpu_set_t previousCpus;
+  bool pinned = false;
+  if (m_cpuAffinity >= 0)
+    {
+      cpu_set_t cpus;
+      CPU_ZERO (&cpus);
+      CPU_SET (m_cpuAffinity, &cpus);
+      pthread_getaffinity_np (pthread_self (), sizeof (previousCpus), &previousCpus);
+      if (pthread_setaffinity_np (pthread_self (), sizeof (cpus), &cpus) == 0)
+        {
+          pinned = true;
+        }
+      else
+        {
+          NS_LOG_WARN ("RealtimeSimulatorImpl::Run(): could not pin the simulator thread "
+                       "to processor " << m_cpuAffinity);
+        }
+    }
+#else
+  if (m_cpuAffinity >= 0)
+    {
+      NS_LOG_WARN ("RealtimeSimulatorImpl::Run(): CpuAffinity is not supported on this platform");
+    }
+#endif
+
   m_synchronizer->SetOrigin (m_currentTs);
 
   // Sleep until signalled
@@ -476,9 +538,121 @@ RealtimeSimulatorImpl::Run (void)
                    "RealtimeSimulatorImpl::Run(): Empty queue and unprocessed events");
   }
 
+#ifdef __linux__
+  if (pinned)
+    {
+      pthread_setaffinity_np (pthread_self (), sizeof (previousCpus), &previousCpus);
+    }
+#endif
+
   m_running = false;
 }
 
+void
+RealtimeSimulatorImpl::RecordLateness (uint64_t lateness)
+{
+  ++m_processedEvents;
+  m_totalLateness += lateness;
+  if (lateness > m_maxLateness)
+    {
+      m_maxLateness = lateness;
+    }
+  if (lateness > static_cast<uint64_t> (m_hardLimit.GetTimeStep ()))
+    {
+      ++m_lateEvents;
+    }
+
+  // Bucket i > 0 holds [2^(i-1), 2^i) us
+  uint64_t us = TimeStep (lateness).GetMicroSeconds ();
+  uint32_t bucket = 0;
+  while (us > 0 && bucket < LATENESS_BUCKETS - 1)
+    {
+      us >>= 1;
+      ++bucket;
+    }
+  ++m_latenessHistogram[bucket];
+}
+
+uint64_t
+RealtimeSimulatorImpl::GetProcessedEvents (void) const
+{
+  CriticalSection cs (m_mutex);
+  return m_processedEvents;
+}
+
+uint64_t
+RealtimeSimulatorImpl::GetLateEvents (void) const
+{
+  CriticalSection cs (m_mutex);
+  return m_lateEvents;
+}
+
+Time
+RealtimeSimulatorImpl::GetMaxLateness (void) const
+{
+  CriticalSection cs (m_mutex);
+  return TimeStep (m_maxLateness);
+}
+
+Time
+RealtimeSimulatorImpl::GetMeanLateness (void) const
+{
+  CriticalSection cs (m_mutex);
+  if (m_processedEvents == 0)
+    {
+      return Time (0);
+    }
+  return TimeStep (m_totalLateness / m_processedEvents);
+}
+
+std::vector<uint64_t>
+RealtimeSimulatorImpl::GetLatenessHistogram (void) const
+{
+  CriticalSection cs (m_mutex);
+  return m_latenessHistogram;
+}
+
+void
+RealtimeSimulatorImpl::PrintLatenessStatistics (std::ostream &os) const
+{
+  std::vector<uint64_t> histogram = GetLatenessHistogram ();
+  os << "events " << GetProcessedEvents ()
+     << " late " << GetLateEvents ()
+     << " mean " << GetMeanLateness ().As (Time::US)
+     << " max " << GetMaxLateness ().As (Time::US) << std::endl;
+  for (uint32_t i = 0; i < LATENESS_BUCKETS; ++i)
+    {
+      if (histogram[i] == 0)
+        {
+          continue;
+        }
+      if (i == 0)
+        {
+          os << "      < 1us";
+        }
+      else if (i == LATENESS_BUCKETS - 1)
+        {
+          os << " >= " << std::setw (6) << (1ULL << (i - 1)) << "us";
+        }
+      else
+        {
+          os << " < " << std::setw (7) << (1ULL << i) << "us";
+        }
+      os << " " << histogram[i] << std::endl;
+    }
+}
+
+void
+RealtimeSimulatorImpl::ResetLatenessStatistics (void)
+{
+  CriticalSection cs (m_mutex);
+  m_processedEvents = 0;
+  m_lateEvents = 0;
+  m_totalLateness = 0;
+  m_maxLateness = 0;
+  std::fill (m_latenessHistogram.begin (), m_latenessHistogram.end (), 0);
+}
+
 bool
 RealtimeSimulatorImpl::Running (void) const
 {
@@ -30,8 +30,11 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "traced-callback.h"
 
 #include <list>
+#include <vector>
+#include <ostream>
 
 /**
  * \file
@@ -52,6 +55,13 @@ namespace ns3 {
  * \ingroup realtime
  *
  * Realtime version of SimulatorImpl.
+ *
+ * The lateness of each event, that is the real time elapsed between its
+ * scheduled time and the moment it starts executing, is recorded in a
+ * histogram and reported by the Lateness trace source.  The simulator
+ * thread can be pinned to a processor with the CpuAffinity attribute;
+ * how the thread waits for the next event is configured on the
+ * WallClockSynchronizer.
  */
 class RealtimeSimulatorImpl : public SimulatorImpl
 {
@@ -154,6 +164,48 @@ public:
    */
   Time GetHardLimit (void) const;
 
+  /** Number of buckets of the lateness histogram. */
+  static const uint32_t LATENESS_BUCKETS = 24;
+
+  /**
+   * Get the number of events whose lateness was recorded.
+   * \returns The number of events processed by Run ().
+   */
+  uint64_t GetProcessedEvents (void) const;
+  /**
+   * Get the number of events that started later than the hard limit
+   * after their scheduled time, whatever the SynchronizationMode.
+   * \returns The number of events over the hard limit.
+   */
+  uint64_t GetLateEvents (void) const;
+  /**
+   * Get the largest lateness observed.
+   * \returns The maximum lateness.
+   */
+  Time GetMaxLateness (void) const;
+  /**
+   * Get the average lateness of the events.
+   * \returns The mean lateness.
+   */
+  Time GetMeanLateness (void) const;
+  /**
+   * Get the lateness histogram.
+   *
+   * Bucket 0 counts the events less than 1 us late, bucket i the events
+   * between 2^(i-1) and 2^i us late, and the last bucket all the later
+   * events.
+   *
+   * \returns The number of events in each of the LATENESS_BUCKETS buckets.
+   */
+  std::vector<uint64_t> GetLatenessHistogram (void) const;
+  /**
+   * Print the lateness statistics.
+   * \param [in,out] os The output stream.
+   */
+  void PrintLatenessStatistics (std::ostream &os) const;
+  /** Reset the lateness statistics. */
+  void ResetLatenessStatistics (void);
+
 private:
   /**
    * Is the simulator running?
@@ -172,6 +224,12 @@ private:
   uint64_t NextTs (void) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
+  /**
+   * Record the lateness of an event.  Should be called with critical
+   * section locked.
+   * \param [in] lateness The lateness, in time steps.
+   */
+  void RecordLateness (uint64_t lateness);
   /** Destructor implementation. */
   virtual void DoDispose (void);
 
@@ -216,6 +274,30 @@ private:
   /** The maximum allowable drift from real-time in SYNC_HARD_LIMIT mode. */
   Time m_hardLimit;
 
+  /** Processor to pin the simulator thread to, or -1. */
+  int32_t m_cpuAffinity;
+
+  /**
+   * \name Lateness statistics.
+   *
+   * These variables are protected by #m_mutex.
+   */
+  /**@{*/
+  /** Number of events recorded. */
+  uint64_t m_processedEvents;
+  /** Number of events later than #m_hardLimit. */
+  uint64_t m_lateEvents;
+  /** Sum of the lateness of the events, in time steps. */
+  uint64_t m_totalLateness;
+  /** Largest lateness, in time steps. */
+  uint64_t m_maxLateness;
+  /** Lateness histogram, see GetLatenessHistogram. */
+  std::vector<uint64_t> m_latenessHistogram;
+  /**@}*/
+
+  /** Trace source fired with the lateness of each event before it runs. */
+  TracedCallback<Time> m_latenessTrace;
+
   /** Main SystemThread. */
   SystemThread::ThreadId m_main;
 };
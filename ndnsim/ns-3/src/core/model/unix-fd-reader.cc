@@ -21,14 +21,25 @@
 
 #include <cerrno>
 #include <cstring>
+#include <map>
+#include <vector>
 #include <unistd.h>  // close()
 #include <fcntl.h>
+#include <poll.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #include "log.h"
 #include "fatal-error.h"
+#include "global-value.h"
 #include "simple-ref-count.h"
+#include "system-condition.h"
+#include "system-mutex.h"
 #include "system-thread.h"
 #include "simulator.h"
+#include "uinteger.h"
 
 #include "unix-fd-reader.h"
 
@@ -42,6 +53,297 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FdReader");
 
+/**
+ * \ingroup system
+ * The number of threads shared by all the FdReader objects, 0 to give
+ * each FdReader its own thread.
+ */
+static GlobalValue g_fdReaderThreads ("FdReaderThreads",
+                                      "The number of threads shared by all the FdReader "
+                                      "objects to wait for their file descriptors with epoll "
+                                      "(Linux only); 0 gives each FdReader its own thread",
+                                      UintegerValue (0),
+                                      MakeUintegerChecker<uint32_t> ());
+
+const uint32_t FdReader::MAX_READS_PER_WAKEUP;
+
+#ifdef __linux__
+
+/**
+ * \ingroup system
+ * \brief A pool of threads reading the file descriptors of many FdReader
+ * objects, which they wait for with epoll.
+ *
+ * Each file descriptor is registered with EPOLLONESHOT, so that a single
+ * thread reads it at a time, and rearmed once read.  The reactor exists
+ * while readers are registered.
+ */
+class FdReaderReactor : public SimpleRefCount<FdReaderReactor>
+{
+public:
+  /**
+   * \param threads number of threads
+   */
+  FdReaderReactor (uint32_t threads);
+  ~FdReaderReactor ();
+
+  /**
+   * \return the reactor, created if there is none
+   */
+  static Ptr<FdReaderReactor> Get (void);
+
+  /**
+   * Start reading the file descriptor of a reader.
+   * \param reader the reader
+   */
+  void Add (FdReader *reader);
+
+  /**
+   * Stop reading the file descriptor of a reader.  When this method
+   * returns, no thread uses the reader anymore.
+   * \param reader the reader
+   */
+  void Remove (FdReader *reader);
+
+private:
+  /** A registered reader */
+  struct Entry
+  {
+    FdReader *reader;    //!< the reader
+    bool busy;           //!< whether a thread is reading
+  };
+
+  /** The function run by the threads */
+  void Run (void);
+
+  /** The reactor, while readers are registered */
+  static Ptr<FdReaderReactor> g_reactor;
+  /** Protects g_reactor */
+  static SystemMutex g_reactorMutex;
+
+  int m_epfd;                      //!< the epoll file descriptor
+  int m_evpipe[2];                 //!< pipe used to stop the threads
+  std::vector<Ptr<SystemThread> > m_threads;   //!< the threads
+  std::map<uint64_t, Entry> m_entries;         //!< the registered readers, by id
+  std::map<FdReader *, uint64_t> m_ids;        //!< the ids of the registered readers
+  uint64_t m_nextId;               //!< id of the next registered reader
+  SystemMutex m_mutex;             //!< protects m_entries and m_ids
+  SystemCondition m_idle;          //!< set when a reader is no longer busy
+};
+
+Ptr<FdReaderReactor> FdReaderReactor::g_reactor;
+SystemMutex FdReaderReactor::g_reactorMutex;
+
+FdReaderReactor::FdReaderReactor (uint32_t threads)
+  : m_nextId (1)
+{
+  NS_LOG_FUNCTION (this << threads);
+
+  m_epfd = epoll_create1 (EPOLL_CLOEXEC);
+  if (m_epfd == -1)
+    {
+      NS_FATAL_ERROR ("epoll_create1() failed: " << std::strerror (errno));
+    }
+  if (pipe (m_evpipe) == -1)
+    {
+      NS_FATAL_ERROR ("pipe() failed: " << std::strerror (errno));
+    }
+  // The pipe stays readable once written, waking every thread up
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.u64 = 0;
+  if (epoll_ctl (m_epfd, EPOLL_CTL_ADD, m_evpipe[0], &ev) == -1)
+    {
+      NS_FATAL_ERROR ("epoll_ctl() failed: " << std::strerror (errno));
+    }
+
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&FdReaderReactor::Run, this));
+      thread->Start ();
+      m_threads.push_back (thread);
+    }
+}
+
+FdReaderReactor::~FdReaderReactor ()
+{
+  NS_LOG_FUNCTION (this);
+  char zero = 0;
+  if (write (m_evpipe[1], &zero, sizeof (zero)) != sizeof (zero))
+    {
+      NS_LOG_WARN ("incomplete write(): " << std::strerror (errno));
+    }
+  for (std::vector<Ptr<SystemThread> >::iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  close (m_evpipe[0]);
+  close (m_evpipe[1]);
+  close (m_epfd);
+}
+
+Ptr<FdReaderReactor>
+FdReaderReactor::Get (void)
+{
+  CriticalSection cs (g_reactorMutex);
+  if (g_reactor == 0)
+    {
+      UintegerValue threads;
+      g_fdReaderThreads.GetValue (threads);
+      g_reactor = Create<FdReaderReactor> (threads.Get ());
+    }
+  return g_reactor;
+}
+
+void
+FdReaderReactor::Add (FdReader *reader)
+{
+  NS_LOG_FUNCTION (this << reader);
+  uint64_t id;
+  {
+    CriticalSection cs (m_mutex);
+    id = m_nextId++;
+    Entry entry;
+    entry.reader = reader;
+    entry.busy = false;
+    m_entries[id] = entry;
+    m_ids[reader] = id;
+  }
+
+  struct epoll_event ev;
+  ev.events = EPOLLIN | EPOLLONESHOT;
+  ev.data.u64 = id;
+  if (epoll_ctl (m_epfd, EPOLL_CTL_ADD, reader->m_fd, &ev) == -1)
+    {
+      NS_FATAL_ERROR ("epoll_ctl() failed: " << std::strerror (errno));
+    }
+}
+
+void
+FdReaderReactor::Remove (FdReader *reader)
+{
+  NS_LOG_FUNCTION (this << reader);
+  uint64_t id;
+  {
+    CriticalSection cs (m_mutex);
+    std::map<FdReader *, uint64_t>::iterator i = m_ids.find (reader);
+    NS_ASSERT (i != m_ids.end ());
+    id = i->second;
+    m_ids.erase (i);
+    // The descriptor may already be closed, in which case the kernel
+    // removed it already
+    epoll_ctl (m_epfd, EPOLL_CTL_DEL, reader->m_fd, NULL);
+  }
+
+  bool empty;
+  for (;;)
+    {
+      {
+        CriticalSection cs (m_mutex);
+        if (!m_entries[id].busy)
+          {
+            m_entries.erase (id);
+            empty = m_entries.empty ();
+            break;
+          }
+        m_idle.SetCondition (false);
+      }
+      // The thread reading sets the condition once done.  The wait is
+      // bounded, since another Remove may have unset the condition since.
+      m_idle.TimedWait (1000000);
+    }
+
+  if (empty)
+    {
+      // Let the threads go with the last reader
+      CriticalSection cs (g_reactorMutex);
+      if (g_reactor == this)
+        {
+          g_reactor = 0;
+        }
+    }
+}
+
+// This runs in the threads of the pool
+void
+FdReaderReactor::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  struct epoll_event events[16];
+
+  for (;;)
+    {
+      int n = epoll_wait (m_epfd, events, 16, -1);
+      if (n == -1)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          NS_FATAL_ERROR ("epoll_wait() failed: " << std::strerror (errno));
+        }
+
+      for (int i = 0; i < n; ++i)
+        {
+          uint64_t id = events[i].data.u64;
+          if (id == 0)
+            {
+              // this thread is done
+              return;
+            }
+
+          std::map<uint64_t, Entry>::iterator it;
+          FdReader *reader;
+          {
+            CriticalSection cs (m_mutex);
+            it = m_entries.find (id);
+            if (it == m_entries.end () || m_ids.find (it->second.reader) == m_ids.end ())
+              {
+                // removed meanwhile
+                continue;
+              }
+            it->second.busy = true;
+            reader = it->second.reader;
+          }
+
+          bool more = reader->ReadAvailable ();
+
+          {
+            CriticalSection cs (m_mutex);
+            it->second.busy = false;
+            if (more && m_ids.find (reader) != m_ids.end ())
+              {
+                struct epoll_event ev;
+                ev.events = EPOLLIN | EPOLLONESHOT;
+                ev.data.u64 = id;
+                epoll_ctl (m_epfd, EPOLL_CTL_MOD, reader->m_fd, &ev);
+              }
+            m_idle.SetCondition (true);
+          }
+          m_idle.Broadcast ();
+        }
+    }
+}
+
+#else /* __linux__ */
+
+/**
+ * \ingroup system
+ * \brief Placeholder of the epoll reactor where epoll is not available.
+ */
+class FdReaderReactor : public SimpleRefCount<FdReaderReactor>
+{
+public:
+  /**
+   * \param reader the reader
+   */
+  void Remove (FdReader *reader)
+  {
+  }
+};
+
+#endif /* __linux__ */
+
 FdReader::FdReader ()
   : m_fd (-1), m_readCallback (0), m_readThread (0), m_stop (false),
     m_destroyEvent ()
@@ -57,12 +359,48 @@ FdReader::~FdReader ()
   Stop ();
 }
 
+bool
+FdReader::IsShared (void) const
+{
+  return m_reactor != 0;
+}
+
 void FdReader::Start (int fd, Callback<void, uint8_t *, ssize_t> readCallback)
+{
+  Start (fd, readCallback, MakeNullCallback<void> ());
+}
+
+void FdReader::Start (int fd, Callback<void, uint8_t *, ssize_t> readCallback,
+                      Callback<void> batchEndCallback)
 {
   NS_LOG_FUNCTION (this << fd << &readCallback);
   int tmp;
 
-  NS_ASSERT_MSG (m_readThread == 0, "read thread already exists");
+  NS_ASSERT_MSG (m_readThread == 0 && m_reactor == 0, "read thread already exists");
+
+  m_batchEndCallback = batchEndCallback;
+
+  UintegerValue threads;
+  g_fdReaderThreads.GetValue (threads);
+  if (threads.Get () > 0)
+    {
+#ifdef __linux__
+      m_fd = fd;
+      m_readCallback = readCallback;
+      if (!m_destroyEvent.IsRunning ())
+        {
+          this->Ref ();
+          m_destroyEvent =
+            Simulator::ScheduleDestroy (&FdReader::DestroyEvent, this);
+        }
+      NS_LOG_LOGIC ("Reading with the shared reactor");
+      m_reactor = FdReaderReactor::Get ();
+      m_reactor->Add (this);
+      return;
+#else
+      NS_LOG_WARN ("FdReaderThreads needs epoll, using a thread per reader");
+#endif
+    }
 
   // create a pipe for inter-thread event notification
   tmp = pipe (m_evpipe);
@@ -121,6 +459,12 @@ void FdReader::Stop (void)
   NS_LOG_FUNCTION (this);
   m_stop = true;
 
+  if (m_reactor != 0)
+    {
+      m_reactor->Remove (this);
+      m_reactor = 0;
+    }
+
   // signal the read thread
   if (m_evpipe[1] != -1)
     {
@@ -154,9 +498,50 @@ void FdReader::Stop (void)
   // reset everything else
   m_fd = -1;
   m_readCallback.Nullify ();
+  m_batchEndCallback.Nullify ();
   m_stop = false;
 }
 
+bool FdReader::ReadAvailable (void)
+{
+  NS_LOG_FUNCTION (this);
+  bool more = true;
+
+  for (uint32_t i = 0; i < MAX_READS_PER_WAKEUP; ++i)
+    {
+      struct FdReader::Data data = DoRead ();
+      // reading stops when m_len is zero
+      if (data.m_len == 0)
+        {
+          more = false;
+          break;
+        }
+      // the callback is only called when m_len is positive (data
+      // is ignored if m_len is negative)
+      if (data.m_len < 0)
+        {
+          break;
+        }
+      m_readCallback (data.m_buf, data.m_len);
+
+      // read on while data is already available
+      struct pollfd pfd;
+      pfd.fd = m_fd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      if (poll (&pfd, 1, 0) <= 0 || !(pfd.revents & POLLIN))
+        {
+          break;
+        }
+    }
+
+  if (!m_batchEndCallback.IsNull ())
+    {
+      m_batchEndCallback ();
+    }
+  return more;
+}
+
 // This runs in a separate thread
 void FdReader::Run (void)
 {
@@ -214,18 +599,10 @@ void FdReader::Run (void)
 
       if (FD_ISSET (m_fd, &readfds))
         {
-          struct FdReader::Data data = DoRead ();
-          // reading stops when m_len is zero
-          if (data.m_len == 0)
+          if (!ReadAvailable ())
             {
               break;
             }
-          // the callback is only called when m_len is positive (data
-          // is ignored if m_len is negative)
-          else if (data.m_len > 0)
-            {
-              m_readCallback (data.m_buf, data.m_len);
-            }
         }
     }
 }
@@ -35,6 +35,8 @@
 
 namespace ns3 {
 
+class FdReaderReactor;
+
 /**
  * \ingroup system
  * \brief A class that asynchronously reads from a file descriptor.
@@ -43,6 +45,15 @@ namespace ns3 {
  * given file descriptor and invokes a given callback when data is
  * received.  This class handles thread management automatically but
  * the \p DoRead() method must be implemented by a subclass.
+ *
+ * When the "FdReaderThreads" global value is not zero, the readers do
+ * not get a thread each: they share a pool of that many threads waiting
+ * on all their file descriptors with epoll (Linux only).  Either way,
+ * each time the file descriptor becomes readable, the data already
+ * available is read, up to MAX_READS_PER_WAKEUP reads, and the optional
+ * batch end callback is invoked once after these reads, so that the
+ * owner of the reader can inject a single simulator event for all of
+ * them.
  */
 class FdReader : public SimpleRefCount<FdReader>
 {
@@ -62,6 +73,30 @@ public:
    */
   void Start (int fd, Callback<void, uint8_t *, ssize_t> readCallback);
 
+  /**
+   * Start reading, and be notified at the end of each batch of reads.
+   *
+   * \param [in] fd A valid file descriptor open for reading.
+   *
+   * \param [in] readCallback A callback to invoke when new data is
+   * available.
+   *
+   * \param [in] batchEndCallback A callback to invoke after the reads
+   * done when the file descriptor became readable.
+   */
+  void Start (int fd, Callback<void, uint8_t *, ssize_t> readCallback,
+              Callback<void> batchEndCallback);
+
+  /**
+   * \return true if the file descriptor is read by the threads shared by
+   * all the readers (see the "FdReaderThreads" global value), in which
+   * case the read callbacks must not block.
+   */
+  bool IsShared (void) const;
+
+  /** Maximum number of reads done each time the file descriptor is readable. */
+  static const uint32_t MAX_READS_PER_WAKEUP = 64;
+
   /**
    * Stop the read thread and reset internal state.  This does not
    * close the file descriptor used for reading.
@@ -111,14 +146,29 @@ protected:
   int m_fd;
 
 private:
+  friend class FdReaderReactor;
 
   /** The asynchronous function which performs the read. */
   void Run (void);
+
+  /**
+   * Read the data available on the file descriptor and invoke the
+   * callbacks.
+   *
+   * \return false when reading stops.
+   */
+  bool ReadAvailable (void);
   /** Event handler scheduled for destroy time to halt the thread. */
   void DestroyEvent (void);
 
   /** The main thread callback function to invoke when we have data. */
   Callback<void, uint8_t *, ssize_t> m_readCallback;
+
+  /** The callback to invoke after each batch of reads. */
+  Callback<void> m_batchEndCallback;
+
+  /** The shared reactor reading the file descriptor, if any. */
+  Ptr<FdReaderReactor> m_reactor;
   
   /** The thread doing the read, created and launched by Start(). */
   Ptr<SystemThread> m_readThread;
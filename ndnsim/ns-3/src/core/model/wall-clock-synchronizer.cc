@@ -18,11 +18,14 @@
 
 
 #include <ctime>       // clock_t
+#include <cerrno>
+#include <algorithm>   // std::min
 #include <sys/time.h>  // gettimeofday
                        // clock_getres: glibc < 2.17, link with librt
 
 #include "log.h"
 #include "system-condition.h"
+#include "enum.h"
 
 #include "wall-clock-synchronizer.h"
 
@@ -44,11 +47,31 @@ WallClockSynchronizer::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::WallClockSynchronizer")
     .SetParent<Synchronizer> ()
     .SetGroupName ("Core")
+    .AddAttribute ("WaitMode",
+                   "How to wait until the next event is due.",
+                   EnumValue (WAIT_CONDITION),
+                   MakeEnumAccessor (&WallClockSynchronizer::m_waitMode),
+                   MakeEnumChecker (WAIT_CONDITION, "Condition",
+                                    WAIT_HYBRID, "Hybrid",
+                                    WAIT_BUSY_POLL, "BusyPoll"))
+    .AddAttribute ("SpinThreshold",
+                   "Time spent busy-waiting at the end of each wait, to make up "
+                   "for sleeps that return late (Condition and Hybrid modes).",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&WallClockSynchronizer::m_spinThreshold),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("SleepSlice",
+                   "Longest single sleep in Hybrid mode, which bounds the time "
+                   "taken to notice an event scheduled by another thread.",
+                   TimeValue (MicroSeconds (100)),
+                   MakeTimeAccessor (&WallClockSynchronizer::m_sleepSlice),
+                   MakeTimeChecker (NanoSeconds (1)))
   ;
   return tid;
 }
 
 WallClockSynchronizer::WallClockSynchronizer ()
+  : m_waitMode (WAIT_CONDITION)
 {
   NS_LOG_FUNCTION (this);
 //
@@ -192,6 +215,37 @@ WallClockSynchronizer::DoSynchronize (uint64_t nsCurrent, uint64_t nsDelay)
   uint64_t ns = DriftCorrect (nsCurrent, nsDelay);
   NS_LOG_INFO ("Synchronize ns = " << ns);
 //
+// In busy-poll mode there is nothing to split: spin until the event is due
+// or an external event shows up.
+//
+  if (m_waitMode == WAIT_BUSY_POLL)
+    {
+      return SpinWait (nsCurrent + nsDelay);
+    }
+//
+// Otherwise we sleep for all but the last SpinThreshold of the wait (and at
+// least three jiffies, see below), and spin for the rest.
+//
+  uint64_t nsSpin = m_spinThreshold.GetNanoSeconds ();
+  if (m_waitMode == WAIT_HYBRID)
+    {
+      if (ns > nsSpin)
+        {
+          // Absolute deadline: the time spent since nsCurrent was read
+          // does not add up to the sleep.
+          if (NanoSleepWait (nsCurrent + nsDelay - nsSpin) == false)
+            {
+              NS_LOG_INFO ("NanoSleepWait interrupted");
+              return false;
+            }
+        }
+      if (DoGetDrift (nsCurrent + nsDelay) >= 0)
+        {
+          return true;
+        }
+      return SpinWait (nsCurrent + nsDelay);
+    }
+//
 // Once we've decided on how long we need to delay, we need to split this
 // time into sleep waits and busy waits.  The reason for this is described
 // in the comments for the constructor where jiffies and jiffy resolution is
@@ -225,7 +279,7 @@ WallClockSynchronizer::DoSynchronize (uint64_t nsCurrent, uint64_t nsDelay)
 //
 // \todo Hardcoded tunable parameter below.
 //
-  if (numberJiffies > 3)
+  if (numberJiffies > 3 && (numberJiffies - 3) * m_jiffy > nsSpin)
     {
       NS_LOG_INFO ("SleepWait for " << numberJiffies * m_jiffy << " ns");
       NS_LOG_INFO ("SleepWait until " << nsCurrent + numberJiffies * m_jiffy 
@@ -236,7 +290,7 @@ WallClockSynchronizer::DoSynchronize (uint64_t nsCurrent, uint64_t nsDelay)
 // interrupted by a Signal.  In this case, we need to return and let the 
 // simulator re-evaluate what to do.
 //
-      if (SleepWait ((numberJiffies - 3) * m_jiffy) == false)
+      if (SleepWait ((numberJiffies - 3) * m_jiffy - nsSpin) == false)
         {
           NS_LOG_INFO ("SleepWait interrupted");
           return false;
@@ -339,6 +393,43 @@ WallClockSynchronizer::SleepWait (uint64_t ns)
   return m_condition.TimedWait (ns);
 }
 
+bool
+WallClockSynchronizer::NanoSleepWait (uint64_t ns)
+{
+  NS_LOG_FUNCTION (this << ns);
+  uint64_t nsSlice = m_sleepSlice.GetNanoSeconds ();
+  for (;;)
+    {
+      if (m_condition.GetCondition ())
+        {
+          return false;
+        }
+      uint64_t nsNow = GetNormalizedRealtime ();
+      if (nsNow >= ns)
+        {
+          return true;
+        }
+      uint64_t nsTarget = std::min (ns, nsNow + nsSlice);
+#if defined (CLOCK_MONOTONIC) && defined (TIMER_ABSTIME)
+      // GetRealtime reads CLOCK_MONOTONIC, so the deadline can be absolute
+      uint64_t nsAbsolute = nsTarget + m_realtimeOriginNano;
+      struct timespec ts;
+      ts.tv_sec = nsAbsolute / NS_PER_SEC;
+      ts.tv_nsec = nsAbsolute % NS_PER_SEC;
+      while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        {
+        }
+#else
+      struct timespec ts;
+      ts.tv_sec = (nsTarget - nsNow) / NS_PER_SEC;
+      ts.tv_nsec = (nsTarget - nsNow) % NS_PER_SEC;
+      nanosleep (&ts, NULL);
+#endif
+    }
+// Quiet compiler
+  return true;
+}
+
 uint64_t
 WallClockSynchronizer::DriftCorrect (uint64_t nsNow, uint64_t nsDelay)
 {
@@ -374,9 +465,20 @@ uint64_t
 WallClockSynchronizer::GetRealtime (void)
 {
   NS_LOG_FUNCTION (this);
+#if defined (CLOCK_MONOTONIC) && defined (TIMER_ABSTIME)
+//
+// The monotonic clock has a nanosecond resolution and does not jump when
+// the system time is set, and NanoSleepWait can sleep until a deadline
+// expressed on it.
+//
+  struct timespec tsNow;
+  clock_gettime (CLOCK_MONOTONIC, &tsNow);
+  return tsNow.tv_sec * NS_PER_SEC + tsNow.tv_nsec;
+#else
   struct timeval tvNow;
   gettimeofday (&tvNow, NULL);
   return TimevalToNs (&tvNow);
+#endif
 }
 
 uint64_t
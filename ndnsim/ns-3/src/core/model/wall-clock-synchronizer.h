@@ -21,6 +21,7 @@
 
 #include "system-condition.h"
 #include "synchronizer.h"
+#include "nstime.h"
 
 /**
  * @file
@@ -59,6 +60,21 @@ namespace ns3 {
  *
  * @todo Add more on jiffies, sleep, processes, etc.
  *
+ * How the synchronizer waits is selected with the WaitMode attribute:
+ *
+ * - @c Condition (the default) sleeps on a condition variable, which is
+ *   woken up immediately by Signal () but usually oversleeps by tens of
+ *   microseconds;
+ * - @c Hybrid sleeps with @c clock_nanosleep() until an absolute deadline,
+ *   in slices no longer than the SleepSlice attribute so that a Signal ()
+ *   is noticed within one slice;
+ * - @c BusyPoll never sleeps: it spins on the clock and the condition,
+ *   using a whole processor but reacting within a few hundred nanoseconds.
+ *
+ * In the first two modes the last SpinThreshold of each wait is spent
+ * spinning, so that a sleep that returns a bit late does not make the
+ * event late.
+ *
  * @internal
  * Nanosleep takes a <tt>struct timeval</tt> as an input so we have to
  * deal with conversion between Time and @c timeval here.
@@ -85,6 +101,13 @@ public:
   /** Conversion constant between ns and s. */
   static const uint64_t NS_PER_SEC = (uint64_t)1000000000;
 
+  /** How to wait until the next event is due. */
+  enum WaitMode {
+    WAIT_CONDITION,   /**< Sleep on a condition variable, then spin. */
+    WAIT_HYBRID,      /**< Sleep with clock_nanosleep in slices, then spin. */
+    WAIT_BUSY_POLL    /**< Always spin. */
+  };
+
 protected:
   /**
    * @brief Do a busy-wait until the normalized realtime equals the argument
@@ -123,6 +146,16 @@ protected:
    *          @c false if we retured because the condition was set.
    */
   bool SleepWait (uint64_t ns);
+  /**
+   * @brief Sleep until the normalized realtime equals the argument or the
+   * condition becomes @c true, using absolute @c clock_nanosleep()
+   * deadlines of at most one SleepSlice.
+   *
+   * @param [in] ns The target normalized real time we should wait for.
+   * @returns @c true if we reached the target time,
+   *          @c false if we retured because the condition was set.
+   */
+  bool NanoSleepWait (uint64_t ns);
 
   // Inherited from Synchronizer
   virtual void DoSetOrigin (uint64_t ns);
@@ -188,6 +221,12 @@ protected:
 
   /** Size of the system clock tick, as reported by @c clock_getres, in ns. */
   uint64_t m_jiffy;
+  /** How to wait for the next event. */
+  WaitMode m_waitMode;
+  /** Time spent spinning at the end of each wait. */
+  Time m_spinThreshold;
+  /** Longest single sleep in WAIT_HYBRID mode. */
+  Time m_sleepSlice;
   /** Time recorded by DoEventStart. */
   uint64_t m_nsEventStart;
 
@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/realtime-simulator-impl.h"
+#include "ns3/wall-clock-synchronizer.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/integer.h"
+#include "ns3/nstime.h"
+
+#include <numeric>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace ns3;
+
+/**
+ * Run evenly spaced events with one of the wait modes of the
+ * WallClockSynchronizer, and check that no event runs early and that the
+ * lateness statistics account for every event.
+ */
+class RealtimeWaitModeTestCase : public TestCase
+{
+public:
+  RealtimeWaitModeTestCase (std::string mode);
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Event (void);
+  void Lateness (Time lateness);
+
+  std::string m_mode;
+  uint32_t m_events;
+  uint32_t m_early;
+  uint32_t m_traced;
+};
+
+RealtimeWaitModeTestCase::RealtimeWaitModeTestCase (std::string mode)
+  : TestCase ("Check realtime synchronization in " + mode + " wait mode"),
+    m_mode (mode)
+{
+}
+
+void
+RealtimeWaitModeTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+  Config::SetDefault ("ns3::WallClockSynchronizer::WaitMode", StringValue (m_mode));
+  Config::SetDefault ("ns3::WallClockSynchronizer::SpinThreshold", TimeValue (MicroSeconds (50)));
+  m_events = 0;
+  m_early = 0;
+  m_traced = 0;
+}
+
+void
+RealtimeWaitModeTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::WallClockSynchronizer::WaitMode", StringValue ("Condition"));
+  Config::SetDefault ("ns3::WallClockSynchronizer::SpinThreshold", TimeValue (Seconds (0)));
+}
+
+void
+RealtimeWaitModeTestCase::Event (void)
+{
+  Ptr<RealtimeSimulatorImpl> impl = DynamicCast<RealtimeSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl->RealtimeNow () < Simulator::Now ())
+    {
+      ++m_early;
+    }
+  ++m_events;
+}
+
+void
+RealtimeWaitModeTestCase::Lateness (Time lateness)
+{
+  ++m_traced;
+}
+
+void
+RealtimeWaitModeTestCase::DoRun (void)
+{
+  Ptr<RealtimeSimulatorImpl> impl = DynamicCast<RealtimeSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "Realtime simulator not in use");
+  impl->TraceConnectWithoutContext ("Lateness", MakeCallback (&RealtimeWaitModeTestCase::Lateness, this));
+
+  for (uint32_t i = 1; i <= 20; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (2 * i), &RealtimeWaitModeTestCase::Event, this);
+    }
+  Simulator::Stop (MilliSeconds (50));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_events, 20, "Not all the events ran");
+  NS_TEST_EXPECT_MSG_EQ (m_early, 0, "Events ran before their time");
+  // The 20 events and the stop event
+  NS_TEST_EXPECT_MSG_EQ (impl->GetProcessedEvents (), 21, "Lateness not recorded for every event");
+  NS_TEST_EXPECT_MSG_EQ (m_traced, 21, "Lateness not traced for every event");
+  std::vector<uint64_t> histogram = impl->GetLatenessHistogram ();
+  NS_TEST_EXPECT_MSG_EQ (histogram.size (), RealtimeSimulatorImpl::LATENESS_BUCKETS, "Bad histogram size");
+  NS_TEST_EXPECT_MSG_EQ (std::accumulate (histogram.begin (), histogram.end (), (uint64_t)0), 21,
+                         "Histogram does not hold every event");
+  NS_TEST_EXPECT_MSG_EQ ((impl->GetMeanLateness () <= impl->GetMaxLateness ()), true, "Mean above maximum");
+
+  impl->ResetLatenessStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (impl->GetProcessedEvents (), 0, "Statistics not reset");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetMaxLateness (), Time (0), "Statistics not reset");
+
+  Simulator::Destroy ();
+}
+
+#ifdef __linux__
+/**
+ * Check that the CpuAffinity attribute pins the simulator thread while
+ * the simulation runs, and only then.
+ */
+class RealtimeCpuAffinityTestCase : public TestCase
+{
+public:
+  RealtimeCpuAffinityTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Event (void);
+
+  int m_cpu;        //!< the processor to pin the simulator thread to
+  cpu_set_t m_cpus; //!< the affinity of the simulator thread during the run
+};
+
+RealtimeCpuAffinityTestCase::RealtimeCpuAffinityTestCase ()
+  : TestCase ("Check the CpuAffinity attribute of the realtime simulator")
+{
+}
+
+void
+RealtimeCpuAffinityTestCase::DoSetup (void)
+{
+  // the first processor this process may run on, which is not always 0
+  // in containers or cpusets
+  cpu_set_t allowed;
+  sched_getaffinity (0, sizeof (allowed), &allowed);
+  m_cpu = 0;
+  while (m_cpu < CPU_SETSIZE - 1 && !CPU_ISSET (m_cpu, &allowed))
+    {
+      m_cpu++;
+    }
+
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+  Config::SetDefault ("ns3::RealtimeSimulatorImpl::CpuAffinity", IntegerValue (m_cpu));
+  CPU_ZERO (&m_cpus);
+}
+
+void
+RealtimeCpuAffinityTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::RealtimeSimulatorImpl::CpuAffinity", IntegerValue (-1));
+}
+
+void
+RealtimeCpuAffinityTestCase::Event (void)
+{
+  sched_getaffinity (0, sizeof (m_cpus), &m_cpus);
+}
+
+void
+RealtimeCpuAffinityTestCase::DoRun (void)
+{
+  cpu_set_t before;
+  sched_getaffinity (0, sizeof (before), &before);
+
+  Simulator::Schedule (MilliSeconds (1), &RealtimeCpuAffinityTestCase::Event, this);
+  Simulator::Stop (MilliSeconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (CPU_COUNT (&m_cpus), 1, "Simulator thread not pinned to one processor");
+  NS_TEST_EXPECT_MSG_EQ (CPU_ISSET (m_cpu, &m_cpus), true, "Simulator thread not pinned to processor " << m_cpu);
+
+  cpu_set_t after;
+  sched_getaffinity (0, sizeof (after), &after);
+  NS_TEST_EXPECT_MSG_EQ (CPU_EQUAL (&before, &after), true, "Affinity not restored after Run");
+}
+#endif /* __linux__ */
+
+class RealtimeSimulatorTestSuite : public TestSuite
+{
+public:
+  RealtimeSimulatorTestSuite ()
+    : TestSuite ("realtime-simulator")
+  {
+    AddTestCase (new RealtimeWaitModeTestCase ("Condition"), TestCase::QUICK);
+    AddTestCase (new RealtimeWaitModeTestCase ("Hybrid"), TestCase::QUICK);
+    AddTestCase (new RealtimeWaitModeTestCase ("BusyPoll"), TestCase::QUICK);
+#ifdef __linux__
+    AddTestCase (new RealtimeCpuAffinityTestCase (), TestCase::QUICK);
+#endif
+  }
+} g_realtimeSimulatorTestSuite;
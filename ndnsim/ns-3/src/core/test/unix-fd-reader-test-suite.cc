@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/unix-fd-reader.h"
+#include "ns3/system-mutex.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * Read the bytes written in a pipe, up to 16 at a time.
+ */
+class PipeReader : public FdReader
+{
+private:
+  FdReader::Data DoRead (void)
+  {
+    uint8_t *buf = (uint8_t *)std::malloc (16);
+    ssize_t len = read (m_fd, buf, 16);
+    if (len <= 0)
+      {
+        std::free (buf);
+        return FdReader::Data (0, 0);
+      }
+    return FdReader::Data (buf, len);
+  }
+};
+
+} // anonymous namespace
+
+/**
+ * Read many pipes at once, with a thread per reader or with the shared
+ * epoll reactor, and check that every byte is read and that the batch end
+ * callback follows the reads.
+ */
+class FdReaderPipesTestCase : public TestCase
+{
+public:
+  FdReaderPipesTestCase (uint32_t threads);
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Read (uint8_t *buf, ssize_t len);
+  void BatchEnd (void);
+
+  uint32_t m_threads;
+  SystemMutex m_mutex;
+  uint32_t m_bytes;
+  uint32_t m_reads;
+  uint32_t m_batchEnds;
+  uint32_t m_readsNotEnded;
+};
+
+/**
+ * \param threads the number of reactor threads
+ * \return the name of the test case
+ */
+static std::string
+PipesTestName (uint32_t threads)
+{
+  std::ostringstream oss;
+  oss << "Check FdReader with " << threads << " shared threads";
+  return oss.str ();
+}
+
+FdReaderPipesTestCase::FdReaderPipesTestCase (uint32_t threads)
+  : TestCase (threads == 0 ? "Check FdReader with a thread per reader" : PipesTestName (threads)),
+    m_threads (threads)
+{
+}
+
+void
+FdReaderPipesTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("FdReaderThreads", UintegerValue (m_threads));
+  m_bytes = 0;
+  m_reads = 0;
+  m_batchEnds = 0;
+  m_readsNotEnded = 0;
+}
+
+void
+FdReaderPipesTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("FdReaderThreads", UintegerValue (0));
+}
+
+void
+FdReaderPipesTestCase::Read (uint8_t *buf, ssize_t len)
+{
+  std::free (buf);
+  CriticalSection cs (m_mutex);
+  m_bytes += len;
+  ++m_reads;
+  ++m_readsNotEnded;
+}
+
+void
+FdReaderPipesTestCase::BatchEnd (void)
+{
+  CriticalSection cs (m_mutex);
+  ++m_batchEnds;
+  m_readsNotEnded = 0;
+}
+
+void
+FdReaderPipesTestCase::DoRun (void)
+{
+  const uint32_t nPipes = 20;
+  const uint32_t nWrites = 50;
+  std::vector<int> fds (2 * nPipes);
+  std::vector<Ptr<PipeReader> > readers;
+  for (uint32_t i = 0; i < nPipes; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (pipe (&fds[2 * i]), 0, "pipe() failed");
+      Ptr<PipeReader> reader = Create<PipeReader> ();
+      reader->Start (fds[2 * i], MakeCallback (&FdReaderPipesTestCase::Read, this),
+                     MakeCallback (&FdReaderPipesTestCase::BatchEnd, this));
+      readers.push_back (reader);
+    }
+
+  const uint8_t data[10] = { 0 };
+  for (uint32_t j = 0; j < nWrites; ++j)
+    {
+      for (uint32_t i = 0; i < nPipes; ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (write (fds[2 * i + 1], data, sizeof (data)), (ssize_t)sizeof (data), "write() failed");
+        }
+    }
+
+  uint32_t expected = nPipes * nWrites * sizeof (data);
+  for (uint32_t wait = 0; wait < 500; ++wait)
+    {
+      {
+        CriticalSection cs (m_mutex);
+        if (m_bytes == expected && m_readsNotEnded == 0)
+          {
+            break;
+          }
+      }
+      usleep (10000);
+    }
+
+  for (uint32_t i = 0; i < nPipes; ++i)
+    {
+      readers[i]->Stop ();
+      close (fds[2 * i]);
+      close (fds[2 * i + 1]);
+    }
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_bytes, expected, "Not every byte was read");
+  NS_TEST_EXPECT_MSG_EQ (m_readsNotEnded, 0, "Reads not followed by the batch end callback");
+  NS_TEST_EXPECT_MSG_GT (m_batchEnds, 0, "Batch end callback never invoked");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_batchEnds, m_reads, "More batch ends than reads");
+}
+
+class FdReaderTestSuite : public TestSuite
+{
+public:
+  FdReaderTestSuite ()
+    : TestSuite ("unix-fd-reader")
+  {
+    AddTestCase (new FdReaderPipesTestCase (0), TestCase::QUICK);
+    AddTestCase (new FdReaderPipesTestCase (1), TestCase::QUICK);
+    AddTestCase (new FdReaderPipesTestCase (3), TestCase::QUICK);
+  }
+} g_fdReaderTestSuite;
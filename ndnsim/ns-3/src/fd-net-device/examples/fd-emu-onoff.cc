@@ -74,6 +74,16 @@
 //       
 // client host: $ ./waf --run="fd-emu-onoff"
 //
+// Both sides accept --packetMmap=1 to exchange the frames through
+// PACKET_MMAP rings instead of one system call per frame.  The two
+// sides can also run on a single host, on the ends of a veth pair:
+//
+// $ sudo ip link add veth0 type veth peer name veth1
+// $ sudo ip link set veth0 up promisc on
+// $ sudo ip link set veth1 up promisc on
+// $ ./waf --run="fd-emu-onoff --serverMode=1 --deviceName=veth1"
+// $ ./waf --run="fd-emu-onoff --deviceName=veth0"
+//
 
 #include <iostream>
 #include <fstream>
@@ -98,6 +108,7 @@ main (int argc, char *argv[])
   uint32_t packetSize = 10000; // bytes
   std::string dataRate("1000Mb/s");
   bool serverMode = false;
+  bool packetMmap = false;
 
   std::string deviceName ("eth0");
   std::string client ("10.1.1.1");
@@ -115,6 +126,7 @@ main (int argc, char *argv[])
   cmd.AddValue ("mac-client", "Mac Address for Server Client : 00:00:00:00:00:01", macClient);
   cmd.AddValue ("mac-server", "Mac Address for Server Default : 00:00:00:00:00:02", macServer);
   cmd.AddValue ("data-rate", "Data rate defaults to 1000Mb/s", dataRate);
+  cmd.AddValue ("packetMmap", "Exchange the frames through PACKET_MMAP rings", packetMmap);
   cmd.Parse (argc, argv);
 
   Ipv4Address remoteIp;
@@ -146,6 +158,10 @@ main (int argc, char *argv[])
   NS_LOG_INFO ("Create Device");
   EmuFdNetDeviceHelper emu;
   emu.SetDeviceName (deviceName);
+  if (packetMmap)
+    {
+      emu.EnablePacketMmap ();
+    }
   NetDeviceContainer devices = emu.Install (node);
   Ptr<NetDevice> device = devices.Get (0);
   device->SetAttribute ("Address", localMac);
@@ -62,6 +62,19 @@ NS_LOG_COMPONENT_DEFINE ("EmuFdNetDeviceHelper");
 EmuFdNetDeviceHelper::EmuFdNetDeviceHelper ()
 {
   m_deviceName = "undefined";
+  m_packetMmap = false;
+  m_blockSize = 1 << 16;
+  m_blockCount = 32;
+  m_blockTimeout = 1;
+}
+
+void
+EmuFdNetDeviceHelper::EnablePacketMmap (uint32_t blockSize, uint32_t blockCount, uint32_t blockTimeout)
+{
+  m_packetMmap = true;
+  m_blockSize = blockSize;
+  m_blockCount = blockCount;
+  m_blockTimeout = blockTimeout;
 }
 
 void
@@ -186,7 +199,18 @@ EmuFdNetDeviceHelper::SetFileDescriptor (Ptr<FdNetDevice> device) const
     }
  
   close (mtufd);
-  device->SetMtu (ifr.ifr_mtu);
+  device->SetMtu (ifr2.ifr_mtu);
+
+  if (m_packetMmap)
+    {
+      // 22 bytes covers 14 bytes Ethernet header with possible 8 bytes LLC/SNAP
+      Ptr<FdNetDevicePacketRing> ring = Create<FdNetDevicePacketRing> ();
+      if (!ring->Setup (fd, m_blockSize, m_blockCount, ifr2.ifr_mtu + 22, m_blockTimeout))
+        {
+          NS_FATAL_ERROR ("EmuFdNetDeviceHelper::SetFileDescriptor (): Can't set up the PACKET_MMAP rings");
+        }
+      device->SetPacketRing (ring);
+    }
 }
 
 int
@@ -62,6 +62,19 @@ public:
    */
   void SetDeviceName (std::string deviceName);
 
+  /**
+   * Exchange the frames with the kernel through PACKET_MMAP (TPACKET_V3)
+   * rings shared with the raw socket, instead of one read () or write ()
+   * per frame.  Linux only.
+   *
+   * \param blockSize size of a ring block, a multiple of the page size
+   * \param blockCount number of blocks of the receive ring, and of the
+   *        transmit ring
+   * \param blockTimeout time in milliseconds after which a receive block
+   *        that is not full is handed over to the simulation
+   */
+  void EnablePacketMmap (uint32_t blockSize = 1 << 16, uint32_t blockCount = 32, uint32_t blockTimeout = 1);
+
 protected:
 
   /**
@@ -89,6 +102,11 @@ protected:
    * The unix/linux name of the underlying device (e.g., eth0)
    */
   std::string m_deviceName;
+
+  bool m_packetMmap;          //!< whether to use PACKET_MMAP rings
+  uint32_t m_blockSize;       //!< size of a ring block
+  uint32_t m_blockCount;      //!< number of blocks of each ring
+  uint32_t m_blockTimeout;    //!< receive block timeout, in milliseconds
 };
 
 } // namespace ns3
@@ -0,0 +1,340 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fd-net-device-packet-ring.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined (__linux__) && defined (HAVE_PACKET_H)
+#define NS3_PACKET_RING 1
+#include <linux/if_packet.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FdNetDevicePacketRing");
+
+FdNetDevicePacketRing::FdNetDevicePacketRing ()
+  : m_fd (-1),
+    m_map (0),
+    m_mapSize (0),
+    m_blockSize (0),
+    m_blockCount (0),
+    m_rxNext (0),
+    m_rxRelease (0),
+    m_rxTaken (0),
+    m_tx (0),
+    m_txFrameSize (0),
+    m_txFrameCount (0),
+    m_txFramesPerBlock (0),
+    m_txNext (0),
+    m_txPending (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FdNetDevicePacketRing::~FdNetDevicePacketRing ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef NS3_PACKET_RING
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapSize);
+    }
+#endif
+}
+
+#ifdef NS3_PACKET_RING
+
+bool
+FdNetDevicePacketRing::Setup (int fd, uint32_t blockSize, uint32_t blockCount, uint32_t maxFrameSize, uint32_t blockTimeout)
+{
+  NS_LOG_FUNCTION (this << fd << blockSize << blockCount << maxFrameSize << blockTimeout);
+  NS_ASSERT (m_map == 0);
+
+  int version = TPACKET_V3;
+  if (setsockopt (fd, SOL_PACKET, PACKET_VERSION, &version, sizeof (version)) == -1)
+    {
+      NS_LOG_WARN ("TPACKET_V3 not supported: " << strerror (errno));
+      return false;
+    }
+
+  // The blocks hold whole pages and at least one transmit slot
+  uint32_t pageSize = sysconf (_SC_PAGESIZE);
+  uint32_t frameSize = TPACKET_ALIGN (TPACKET_ALIGN (sizeof (struct tpacket3_hdr)) + maxFrameSize);
+  if (blockSize < frameSize)
+    {
+      blockSize = frameSize;
+    }
+  blockSize = (blockSize + pageSize - 1) / pageSize * pageSize;
+
+  struct tpacket_req3 req;
+  memset (&req, 0, sizeof (req));
+  req.tp_block_size = blockSize;
+  req.tp_block_nr = blockCount;
+  req.tp_frame_size = frameSize;
+  req.tp_frame_nr = blockSize / frameSize * blockCount;
+  req.tp_retire_blk_tov = blockTimeout;
+  if (setsockopt (fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof (req)) == -1)
+    {
+      NS_LOG_WARN ("Can't set up the receive ring: " << strerror (errno));
+      return false;
+    }
+
+  // The transmit ring does not use the receive block parameters
+  req.tp_retire_blk_tov = 0;
+  bool hasTx = (setsockopt (fd, SOL_PACKET, PACKET_TX_RING, &req, sizeof (req)) == 0);
+  if (!hasTx)
+    {
+      NS_LOG_WARN ("Can't set up the transmit ring, frames are sent with write (): " << strerror (errno));
+    }
+
+  size_t ringSize = (size_t)blockSize * blockCount;
+  m_mapSize = hasTx ? 2 * ringSize : ringSize;
+  void *map = mmap (0, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, fd, 0);
+  if (map == MAP_FAILED)
+    {
+      // MAP_LOCKED needs a large enough RLIMIT_MEMLOCK
+      map = mmap (0, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+  if (map == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Can't map the rings: " << strerror (errno));
+      m_mapSize = 0;
+      return false;
+    }
+
+  m_fd = fd;
+  m_map = (uint8_t *)map;
+  m_blockSize = blockSize;
+  m_blockCount = blockCount;
+  if (hasTx)
+    {
+      m_tx = m_map + ringSize;
+      m_txFrameSize = frameSize;
+      m_txFrameCount = req.tp_frame_nr;
+      m_txFramesPerBlock = blockSize / frameSize;
+    }
+  return true;
+}
+
+uint8_t *
+FdNetDevicePacketRing::NextBlock (void)
+{
+  uint8_t *block = m_map + (size_t)m_rxNext * m_blockSize;
+  struct tpacket_block_desc *desc = (struct tpacket_block_desc *)block;
+  {
+    CriticalSection cs (m_rxMutex);
+    if (m_rxTaken == m_blockCount)
+      {
+        return 0;
+      }
+  }
+  if ((__atomic_load_n (&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0)
+    {
+      return 0;
+    }
+  {
+    CriticalSection cs (m_rxMutex);
+    ++m_rxTaken;
+  }
+  m_rxNext = (m_rxNext + 1) % m_blockCount;
+  return block;
+}
+
+void
+FdNetDevicePacketRing::ReadBlock (uint8_t *block, Callback<void, const uint8_t *, ssize_t> frameCallback)
+{
+  struct tpacket_block_desc *desc = (struct tpacket_block_desc *)block;
+  uint32_t n = desc->hdr.bh1.num_pkts;
+  uint8_t *frame = block + desc->hdr.bh1.offset_to_first_pkt;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      struct tpacket3_hdr *hdr = (struct tpacket3_hdr *)frame;
+      frameCallback (frame + hdr->tp_mac, hdr->tp_snaplen);
+      frame += hdr->tp_next_offset;
+    }
+}
+
+void
+FdNetDevicePacketRing::ReleaseBlock (uint8_t *block)
+{
+  NS_ASSERT (block == m_map + (size_t)m_rxRelease * m_blockSize);
+  struct tpacket_block_desc *desc = (struct tpacket_block_desc *)block;
+  __atomic_store_n (&desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+  m_rxRelease = (m_rxRelease + 1) % m_blockCount;
+  {
+    CriticalSection cs (m_rxMutex);
+    NS_ASSERT (m_rxTaken > 0);
+    --m_rxTaken;
+  }
+  m_rxReleased.SetCondition (true);
+  m_rxReleased.Signal ();
+}
+
+uint8_t *
+FdNetDevicePacketRing::ReserveTxFrame (void)
+{
+  NS_ASSERT (m_tx != 0);
+  uint8_t *slot = GetTxSlot (m_txNext);
+  struct tpacket3_hdr *hdr = (struct tpacket3_hdr *)slot;
+  uint32_t status = __atomic_load_n (&hdr->tp_status, __ATOMIC_ACQUIRE);
+  if (status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING))
+    {
+      return 0;
+    }
+  if (status & TP_STATUS_WRONG_FORMAT)
+    {
+      NS_LOG_WARN ("Frame rejected by the kernel");
+    }
+  // Without PACKET_TX_HAS_OFF the kernel takes the frame right after the header
+  return slot + TPACKET_ALIGN (sizeof (struct tpacket3_hdr));
+}
+
+void
+FdNetDevicePacketRing::CommitTxFrame (uint32_t len)
+{
+  NS_ASSERT (len <= GetMaxTxFrameSize ());
+  struct tpacket3_hdr *hdr = (struct tpacket3_hdr *)GetTxSlot (m_txNext);
+  hdr->tp_len = len;
+  hdr->tp_snaplen = len;
+  hdr->tp_next_offset = 0;
+  __atomic_store_n (&hdr->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+  m_txNext = (m_txNext + 1) % m_txFrameCount;
+  ++m_txPending;
+}
+
+bool
+FdNetDevicePacketRing::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_txPending);
+  if (m_txPending == 0)
+    {
+      return true;
+    }
+  m_txPending = 0;
+  ssize_t rc = send (m_fd, NULL, 0, MSG_DONTWAIT);
+  if (rc == -1 && errno != EAGAIN && errno != ENOBUFS)
+    {
+      NS_LOG_WARN ("send () failed: " << strerror (errno));
+      return false;
+    }
+  return true;
+}
+
+uint32_t
+FdNetDevicePacketRing::GetMaxTxFrameSize (void) const
+{
+  return m_txFrameSize - TPACKET_ALIGN (sizeof (struct tpacket3_hdr));
+}
+
+uint8_t *
+FdNetDevicePacketRing::GetTxSlot (uint32_t index) const
+{
+  return m_tx + (size_t)(index / m_txFramesPerBlock) * m_blockSize
+         + (size_t)(index % m_txFramesPerBlock) * m_txFrameSize;
+}
+
+#else /* NS3_PACKET_RING */
+
+bool
+FdNetDevicePacketRing::Setup (int fd, uint32_t blockSize, uint32_t blockCount, uint32_t maxFrameSize, uint32_t blockTimeout)
+{
+  NS_LOG_WARN ("PACKET_MMAP rings are only supported on Linux");
+  return false;
+}
+
+uint8_t *
+FdNetDevicePacketRing::NextBlock (void)
+{
+  return 0;
+}
+
+void
+FdNetDevicePacketRing::ReadBlock (uint8_t *block, Callback<void, const uint8_t *, ssize_t> frameCallback)
+{
+}
+
+void
+FdNetDevicePacketRing::ReleaseBlock (uint8_t *block)
+{
+}
+
+uint8_t *
+FdNetDevicePacketRing::ReserveTxFrame (void)
+{
+  return 0;
+}
+
+void
+FdNetDevicePacketRing::CommitTxFrame (uint32_t len)
+{
+}
+
+bool
+FdNetDevicePacketRing::Flush (void)
+{
+  return false;
+}
+
+uint32_t
+FdNetDevicePacketRing::GetMaxTxFrameSize (void) const
+{
+  return 0;
+}
+
+uint8_t *
+FdNetDevicePacketRing::GetTxSlot (uint32_t index) const
+{
+  return 0;
+}
+
+#endif /* NS3_PACKET_RING */
+
+void
+FdNetDevicePacketRing::WaitRelease (uint64_t timeout)
+{
+  m_rxReleased.SetCondition (false);
+  {
+    CriticalSection cs (m_rxMutex);
+    if (m_rxTaken == 0)
+      {
+        return;
+      }
+  }
+  m_rxReleased.TimedWait (timeout);
+}
+
+bool
+FdNetDevicePacketRing::HasTxRing (void) const
+{
+  return m_tx != 0;
+}
+
+uint32_t
+FdNetDevicePacketRing::GetPendingTxFrames (void) const
+{
+  return m_txPending;
+}
+
+} // namespace ns3
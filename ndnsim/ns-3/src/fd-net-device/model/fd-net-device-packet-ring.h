@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FD_NET_DEVICE_PACKET_RING_H
+#define FD_NET_DEVICE_PACKET_RING_H
+
+#include "ns3/callback.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/system-condition.h"
+#include "ns3/system-mutex.h"
+
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup fd-net-device
+ * \brief The PACKET_MMAP (TPACKET_V3) rings of a Linux packet socket.
+ *
+ * The receive ring is made of blocks that the kernel fills with frames
+ * and hands over to user space when they are full, or when the block
+ * timeout expires.  The reader thread takes the blocks handed over with
+ * NextBlock, the simulator reads their frames straight from the shared
+ * memory with ReadBlock, then gives them back to the kernel with
+ * ReleaseBlock, in the order they were taken.
+ *
+ * The transmit ring is made of fixed size frame slots: a frame is
+ * written in place in the slot returned by ReserveTxFrame, queued by
+ * CommitTxFrame, and all the queued frames are sent by Flush with a
+ * single system call.  If the kernel does not support a TPACKET_V3
+ * transmit ring (before Linux 4.11), only the receive ring is used.
+ *
+ * The rings are only available on Linux; elsewhere Setup fails.
+ */
+class FdNetDevicePacketRing : public SimpleRefCount<FdNetDevicePacketRing>
+{
+public:
+  FdNetDevicePacketRing ();
+  ~FdNetDevicePacketRing ();
+
+  /**
+   * Set the rings up on a packet socket.
+   *
+   * \param fd the packet socket
+   * \param blockSize size of a ring block, rounded up to a multiple of the page size
+   * \param blockCount number of blocks of each ring
+   * \param maxFrameSize size of the largest frame to send
+   * \param blockTimeout time in milliseconds after which a receive block
+   *        that is not full is handed over
+   * \return true if at least the receive ring could be set up
+   */
+  bool Setup (int fd, uint32_t blockSize, uint32_t blockCount, uint32_t maxFrameSize, uint32_t blockTimeout);
+
+  /**
+   * \return the next receive block handed over by the kernel and not
+   * taken yet, or 0 if there is none.
+   *
+   * Called by the reader thread.
+   */
+  uint8_t * NextBlock (void);
+
+  /**
+   * \param block a block returned by NextBlock
+   * \param frameCallback called with each frame of the block
+   */
+  static void ReadBlock (uint8_t *block, Callback<void, const uint8_t *, ssize_t> frameCallback);
+
+  /**
+   * \param block the oldest block taken with NextBlock and not released yet
+   *
+   * Give a block back to the kernel.
+   */
+  void ReleaseBlock (uint8_t *block);
+
+  /**
+   * Wait until a block taken with NextBlock is released, or for at most
+   * timeout nanoseconds.  Return immediately if no block is taken.
+   * \param timeout the maximum wait
+   */
+  void WaitRelease (uint64_t timeout);
+
+  /**
+   * \return true if the transmit ring is set up
+   */
+  bool HasTxRing (void) const;
+
+  /**
+   * \return the largest frame a transmit slot can hold
+   */
+  uint32_t GetMaxTxFrameSize (void) const;
+
+  /**
+   * \return where to write the next frame to send, or 0 if the transmit
+   * ring is full
+   */
+  uint8_t * ReserveTxFrame (void);
+
+  /**
+   * \param len the length of the frame written in the slot returned by
+   * the last ReserveTxFrame
+   */
+  void CommitTxFrame (uint32_t len);
+
+  /**
+   * \return the number of frames committed and not flushed yet
+   */
+  uint32_t GetPendingTxFrames (void) const;
+
+  /**
+   * Ask the kernel to send the committed frames.
+   * \return false if the kernel reported an error
+   */
+  bool Flush (void);
+
+private:
+  /**
+   * \param index index of a transmit slot
+   * \return the slot; the slots do not straddle blocks
+   */
+  uint8_t * GetTxSlot (uint32_t index) const;
+
+  int m_fd;                  //!< the packet socket
+  uint8_t *m_map;            //!< the mapped rings, receive ring first
+  size_t m_mapSize;          //!< size of the mapping
+  uint32_t m_blockSize;      //!< size of a block
+  uint32_t m_blockCount;     //!< number of blocks of each ring
+  uint32_t m_rxNext;         //!< next receive block to take
+  uint32_t m_rxRelease;      //!< next receive block to release
+  uint32_t m_rxTaken;        //!< receive blocks taken and not released
+  SystemMutex m_rxMutex;     //!< protects m_rxTaken
+  SystemCondition m_rxReleased; //!< signaled when a block is released
+  uint8_t *m_tx;             //!< the transmit ring, 0 if not set up
+  uint32_t m_txFrameSize;    //!< size of a transmit slot
+  uint32_t m_txFrameCount;   //!< number of transmit slots
+  uint32_t m_txFramesPerBlock; //!< number of transmit slots in a block
+  uint32_t m_txNext;         //!< next transmit slot to reserve
+  uint32_t m_txPending;      //!< frames committed and not flushed
+};
+
+} // namespace ns3
+
+#endif /* FD_NET_DEVICE_PACKET_RING_H */
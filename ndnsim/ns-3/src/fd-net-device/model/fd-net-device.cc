@@ -36,7 +36,12 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <cstring>
 #include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
 #include <arpa/inet.h>
 #include <net/ethernet.h>
 
@@ -44,11 +49,90 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FdNetDevice");
 
+/**
+ * \ingroup fd-net-device
+ * \brief Check whether a file descriptor is a socket
+ * \param fd the file descriptor
+ * \return true if fd is a socket
+ */
+static bool
+IsSocket (int fd)
+{
+  int type;
+  socklen_t len = sizeof (type);
+  return getsockopt (fd, SOL_SOCKET, SO_TYPE, &type, &len) == 0;
+}
+
+FdNetDeviceBufferPool::FdNetDeviceBufferPool (uint32_t bufferSize, uint32_t maxFree)
+  : m_bufferSize (bufferSize),
+    m_maxFree (maxFree)
+{
+  m_free.reserve (maxFree);
+}
+
+FdNetDeviceBufferPool::~FdNetDeviceBufferPool ()
+{
+  for (std::vector<uint8_t *>::iterator i = m_free.begin (); i != m_free.end (); ++i)
+    {
+      free (*i);
+    }
+}
+
+uint8_t *
+FdNetDeviceBufferPool::Get (void)
+{
+  {
+    CriticalSection cs (m_mutex);
+    if (!m_free.empty ())
+      {
+        uint8_t *buf = m_free.back ();
+        m_free.pop_back ();
+        return buf;
+      }
+  }
+  uint8_t *buf = (uint8_t *)malloc (m_bufferSize);
+  NS_ABORT_MSG_IF (buf == 0, "malloc() failed");
+  return buf;
+}
+
+void
+FdNetDeviceBufferPool::Put (uint8_t *buf)
+{
+  {
+    CriticalSection cs (m_mutex);
+    if (m_free.size () < m_maxFree)
+      {
+        m_free.push_back (buf);
+        return;
+      }
+  }
+  free (buf);
+}
+
+uint32_t
+FdNetDeviceBufferPool::GetBufferSize (void) const
+{
+  return m_bufferSize;
+}
+
 FdNetDeviceFdReader::FdNetDeviceFdReader ()
-  : m_bufferSize (65536) // Defaults to maximum TCP window size
+  : m_bufferSize (65536), // Defaults to maximum TCP window size
+    m_batchSize (1),
+    m_isSocket (-1)
 {
 }
 
+FdNetDeviceFdReader::~FdNetDeviceFdReader ()
+{
+  for (std::vector<uint8_t *>::iterator i = m_buffers.begin (); i != m_buffers.end (); ++i)
+    {
+      if (*i != 0)
+        {
+          m_pool->Put (*i);
+        }
+    }
+}
+
 void
 FdNetDeviceFdReader::SetBufferSize (uint32_t bufferSize)
 {
@@ -56,10 +140,40 @@ FdNetDeviceFdReader::SetBufferSize (uint32_t bufferSize)
   m_bufferSize = bufferSize;
 }
 
+void
+FdNetDeviceFdReader::SetBatch (uint32_t batchSize, Ptr<FdNetDeviceBufferPool> pool,
+                               Callback<void, uint8_t **, ssize_t *, uint32_t> batchCallback)
+{
+  NS_LOG_FUNCTION (this << batchSize << pool);
+  NS_ASSERT (batchSize > 0);
+  m_batchSize = batchSize;
+  m_pool = pool;
+  m_batchCallback = batchCallback;
+  m_buffers.assign (batchSize, 0);
+  m_lengths.assign (batchSize, 0);
+}
+
+void
+FdNetDeviceFdReader::SetPacketRing (Ptr<FdNetDevicePacketRing> ring, Callback<void, uint8_t *> blockCallback)
+{
+  NS_LOG_FUNCTION (this << ring);
+  m_ring = ring;
+  m_blockCallback = blockCallback;
+}
+
 FdReader::Data FdNetDeviceFdReader::DoRead (void)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_ring != 0)
+    {
+      return DoReadRing ();
+    }
+  if (m_pool != 0)
+    {
+      return DoReadBatch ();
+    }
+
   uint8_t *buf = (uint8_t *)malloc (m_bufferSize);
   NS_ABORT_MSG_IF (buf == 0, "malloc() failed");
 
@@ -75,6 +189,118 @@ FdReader::Data FdNetDeviceFdReader::DoRead (void)
   return FdReader::Data (buf, len);
 }
 
+FdReader::Data FdNetDeviceFdReader::DoReadRing (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t blocks = 0;
+  uint8_t *block;
+  while ((block = m_ring->NextBlock ()) != 0)
+    {
+      m_blockCallback (block);
+      ++blocks;
+    }
+  if (blocks == 0)
+    {
+      // The socket stays readable while the blocks handed over are not
+      // released by the simulator: wait for it rather than spin
+      m_ring->WaitRelease (1000000);
+    }
+  NS_LOG_LOGIC ("Got " << blocks << " blocks on fd " << m_fd);
+  return FdReader::Data (0, -1);
+}
+
+FdReader::Data FdNetDeviceFdReader::DoReadBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_isSocket == -1)
+    {
+      m_isSocket = IsSocket (m_fd) ? 1 : 0;
+    }
+
+  uint32_t size = std::min (m_bufferSize, m_pool->GetBufferSize ());
+  for (uint32_t i = 0; i < m_batchSize; ++i)
+    {
+      if (m_buffers[i] == 0)
+        {
+          m_buffers[i] = m_pool->Get ();
+        }
+    }
+
+  uint32_t received = 0;
+#ifdef __linux__
+  if (m_isSocket == 1)
+    {
+      // One system call for all the frames already queued on the socket
+      std::vector<struct mmsghdr> msgs (m_batchSize);
+      std::vector<struct iovec> iovs (m_batchSize);
+      for (uint32_t i = 0; i < m_batchSize; ++i)
+        {
+          iovs[i].iov_base = m_buffers[i];
+          iovs[i].iov_len = size;
+          std::memset (&msgs[i], 0, sizeof (msgs[i]));
+          msgs[i].msg_hdr.msg_iov = &iovs[i];
+          msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+      int n = recvmmsg (m_fd, &msgs[0], m_batchSize, MSG_WAITFORONE, NULL);
+      if (n < 0 && (errno == EINTR || errno == EAGAIN))
+        {
+          // Nothing to process
+          return FdReader::Data (0, -1);
+        }
+      if (n <= 0)
+        {
+          NS_LOG_LOGIC ("recvmmsg on fd " << m_fd << " returned " << n);
+          return FdReader::Data (0, 0);
+        }
+      for (int i = 0; i < n; ++i)
+        {
+          m_lengths[i] = msgs[i].msg_len;
+        }
+      received = n;
+    }
+  else
+#endif
+    {
+      // Frames are read one at a time from tap devices, but all the
+      // frames already queued are read before handing them over
+      ssize_t len = read (m_fd, m_buffers[0], size);
+      if (len <= 0)
+        {
+          return FdReader::Data (0, 0);
+        }
+      m_lengths[0] = len;
+      received = 1;
+      while (received < m_batchSize)
+        {
+          struct pollfd pfd;
+          pfd.fd = m_fd;
+          pfd.events = POLLIN;
+          pfd.revents = 0;
+          if (poll (&pfd, 1, 0) <= 0 || !(pfd.revents & POLLIN))
+            {
+              break;
+            }
+          len = read (m_fd, m_buffers[received], size);
+          if (len <= 0)
+            {
+              break;
+            }
+          m_lengths[received++] = len;
+        }
+    }
+
+  NS_LOG_LOGIC ("Read " << received << " frames on fd " << m_fd);
+  m_batchCallback (&m_buffers[0], &m_lengths[0], received);
+  // The buffers now belong to the callback
+  for (uint32_t i = 0; i < received; ++i)
+    {
+      m_buffers[i] = 0;
+    }
+  return FdReader::Data (0, -1);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (FdNetDevice);
 
 TypeId
@@ -115,6 +341,13 @@ FdNetDevice::GetTypeId (void)
                    UintegerValue (1000),
                    MakeUintegerAccessor (&FdNetDevice::m_maxPendingReads),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BatchSize", "Maximum number of frames read or written "
+                   "with a single system call (recvmmsg/sendmmsg on sockets), "
+                   "using recycled buffers; the frames read together are "
+                   "processed by a single event.  1 disables batching.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FdNetDevice::m_batchSize),
+                   MakeUintegerChecker<uint32_t> (1, 1024))
     //
     // Trace sources at the "top" of the net device, where packets transition
     // to/from higher layers.  These points do not really correspond to the
@@ -174,6 +407,9 @@ FdNetDevice::FdNetDevice ()
     m_fdReader (0),
     m_isBroadcast (true),
     m_isMulticast (false),
+    m_batchSize (1),
+    m_forwardUpScheduled (false),
+    m_isSocket (false),
     m_startEvent (),
     m_stopEvent ()
 {
@@ -207,6 +443,7 @@ FdNetDevice::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   StopDevice ();
+  m_packetRing = 0;
   NetDevice::DoDispose ();
 }
 
@@ -262,7 +499,19 @@ FdNetDevice::StartDevice (void)
   m_fdReader = Create<FdNetDeviceFdReader> ();
   // 22 bytes covers 14 bytes Ethernet header with possible 8 bytes LLC/SNAP
   m_fdReader->SetBufferSize (m_mtu + 22);
-  m_fdReader->Start (m_fd, MakeCallback (&FdNetDevice::ReceiveCallback, this));
+  if (m_batchSize > 1)
+    {
+      // 4 more bytes for the PI header of transmitted frames
+      m_bufferPool = Create<FdNetDeviceBufferPool> (m_mtu + 26, m_maxPendingReads + 2 * m_batchSize);
+      m_isSocket = IsSocket (m_fd);
+      m_fdReader->SetBatch (m_batchSize, m_bufferPool, MakeCallback (&FdNetDevice::ReceiveBatchCallback, this));
+    }
+  if (m_packetRing != 0)
+    {
+      m_fdReader->SetPacketRing (m_packetRing, MakeCallback (&FdNetDevice::ReceiveBlockCallback, this));
+    }
+  m_fdReader->Start (m_fd, MakeCallback (&FdNetDevice::ReceiveCallback, this),
+                     MakeCallback (&FdNetDevice::ReadBatchEndCallback, this));
 
   NotifyLinkUp ();
 }
@@ -278,6 +527,18 @@ FdNetDevice::StopDevice (void)
       m_fdReader = 0;
     }
 
+  Simulator::Cancel (m_transmitFlushEvent);
+  if (m_fd != -1)
+    {
+      FlushTransmitBatch ();
+    }
+
+  {
+    // The blocks are given back to the kernel with the rings
+    CriticalSection cs (m_pendingReadMutex);
+    std::queue<uint8_t *> ().swap (m_pendingBlocks);
+  }
+
   if (m_fd != -1)
     {
       close (m_fd);
@@ -305,13 +566,77 @@ FdNetDevice::ReceiveCallback (uint8_t *buf, ssize_t len)
   }
 
   if (skip)
+    {
+      free (buf);
+      // A thread shared with other devices must not stall them
+      if (!m_fdReader->IsShared ())
+        {
+          struct timespec time = {
+            0, 100000000L
+          };                                        // 100 ms
+          nanosleep (&time, NULL);
+        }
+    }
+}
+
+void
+FdNetDevice::ReceiveBatchCallback (uint8_t **bufs, ssize_t *lens, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  bool skip = false;
+
+  {
+    CriticalSection cs (m_pendingReadMutex);
+    for (uint32_t i = 0; i < n; ++i)
+      {
+        if (m_pendingQueue.size () >= m_maxPendingReads)
+          {
+            NS_LOG_WARN ("Packet dropped");
+            m_bufferPool->Put (bufs[i]);
+            skip = true;
+          }
+        else
+          {
+            m_pendingQueue.push (std::make_pair (bufs[i], lens[i]));
+          }
+      }
+  }
+
+  if (skip && !m_fdReader->IsShared ())
     {
       struct timespec time = {
         0, 100000000L
       };                                        // 100 ms
       nanosleep (&time, NULL);
     }
-  else
+}
+
+void
+FdNetDevice::ReceiveBlockCallback (uint8_t *block)
+{
+  NS_LOG_FUNCTION (this << static_cast<void *> (block));
+  // The ring bounds the number of pending frames, no need to drop here
+  CriticalSection cs (m_pendingReadMutex);
+  m_pendingBlocks.push (block);
+}
+
+void
+FdNetDevice::ReadBatchEndCallback (void)
+{
+  NS_LOG_FUNCTION (this);
+  bool schedule = false;
+
+  {
+    // A single event forwards all the frames queued until it runs
+    CriticalSection cs (m_pendingReadMutex);
+    if ((!m_pendingQueue.empty () || !m_pendingBlocks.empty ()) && !m_forwardUpScheduled)
+      {
+        m_forwardUpScheduled = true;
+        schedule = true;
+      }
+  }
+
+  if (schedule)
     {
       Simulator::ScheduleWithContext (m_nodeId, Time (0), MakeEvent (&FdNetDevice::ForwardUp, this));
     }
@@ -320,21 +645,13 @@ FdNetDevice::ReceiveCallback (uint8_t *buf, ssize_t len)
 /**
  * \ingroup fd-net-device
  * \brief Synthesize PI header for the kernel
- * \param buf the buffer to add the header to
- * \param len the buffer length
- *
- * \todo Consider having a instance member m_packetBuffer and using memmove
- * instead of memcpy to add the PI header. It might be faster in this case
- * to use memmove and avoid the extra mallocs.
+ * \param frame the Ethernet frame
+ * \param len the frame length
+ * \param pi where to write the 4 bytes of the PI header
  */
 static void
-AddPIHeader (uint8_t *&buf, ssize_t &len)
+WritePIHeader (const uint8_t *frame, ssize_t len, uint8_t *pi)
 {
-  // Synthesize PI header for our friend the kernel
-  uint8_t *buf2 = (uint8_t*)malloc (len + 4);
-  memcpy (buf2 + 4, buf, len);
-  len += 4;
-
   // PI = 16 bits flags (0) + 16 bits proto
   // NOTE: be careful to interpret buffer data explicitly as
   //  little-endian to be insensible to native byte ordering.
@@ -342,75 +659,100 @@ AddPIHeader (uint8_t *&buf, ssize_t &len)
   uint16_t proto = 0x0008; // default to IPv4
   if (len > 14)
     {
-      if (buf[12] == 0x81 && buf[13] == 0x00 && len > 18)
+      if (frame[12] == 0x81 && frame[13] == 0x00 && len > 18)
         {
           // tagged ethernet packet
-          proto = buf[16] | (buf[17] << 8);
+          proto = frame[16] | (frame[17] << 8);
         }
       else
         {
           // untagged ethernet packet
-          proto = buf[12] | (buf[13] << 8);
+          proto = frame[12] | (frame[13] << 8);
         }
     }
-  buf2[0] = (uint8_t)flags;
-  buf2[1] = (uint8_t)(flags >> 8);
-  buf2[2] = (uint8_t)proto;
-  buf2[3] = (uint8_t)(proto >> 8);
-
-  // swap buffer
-  free (buf);
-  buf = buf2;
+  pi[0] = (uint8_t)flags;
+  pi[1] = (uint8_t)(flags >> 8);
+  pi[2] = (uint8_t)proto;
+  pi[3] = (uint8_t)(proto >> 8);
 }
 
 /**
  * \ingroup fd-net-device
- * \brief Removes PI header
+ * \brief Synthesize PI header for the kernel
  * \param buf the buffer to add the header to
  * \param len the buffer length
  */
 static void
-RemovePIHeader (uint8_t *&buf, ssize_t &len)
+AddPIHeader (uint8_t *&buf, ssize_t &len)
 {
-  // strip PI header if present, shrink buffer
-  if (len >= 4)
-    {
-      len -= 4;
-      memmove (buf, buf + 4, len);
-      buf = (uint8_t*)realloc (buf, len);
-    }
+  // Synthesize PI header for our friend the kernel
+  uint8_t *buf2 = (uint8_t*)malloc (len + 4);
+  memcpy (buf2 + 4, buf, len);
+  WritePIHeader (buf, len, buf2);
+  len += 4;
+
+  // swap buffer
+  free (buf);
+  buf = buf2;
 }
 
 void
 FdNetDevice::ForwardUp (void)
 {
+  NS_LOG_FUNCTION (this);
 
-  uint8_t *buf = 0; 
-  ssize_t len = 0;
-
+  std::queue< std::pair<uint8_t *, ssize_t> > frames;
+  std::queue<uint8_t *> blocks;
   {
     CriticalSection cs (m_pendingReadMutex);
-    std::pair<uint8_t *, ssize_t> next = m_pendingQueue.front ();
-    m_pendingQueue.pop ();
-
-    buf = next.first;
-    len = next.second;
+    frames.swap (m_pendingQueue);
+    blocks.swap (m_pendingBlocks);
+    m_forwardUpScheduled = false;
   }
 
+  while (!frames.empty ())
+    {
+      std::pair<uint8_t *, ssize_t> next = frames.front ();
+      frames.pop ();
+      ProcessFrame (next.first, next.second);
+      if (m_bufferPool != 0)
+        {
+          m_bufferPool->Put (next.first);
+        }
+      else
+        {
+          free (next.first);
+        }
+    }
+
+  if (!blocks.empty ())
+    {
+      Callback<void, const uint8_t *, ssize_t> processFrame = MakeCallback (&FdNetDevice::ProcessFrame, this);
+      while (!blocks.empty ())
+        {
+          FdNetDevicePacketRing::ReadBlock (blocks.front (), processFrame);
+          m_packetRing->ReleaseBlock (blocks.front ());
+          blocks.pop ();
+        }
+    }
+}
+
+void
+FdNetDevice::ProcessFrame (const uint8_t *buf, ssize_t len)
+{
   NS_LOG_FUNCTION (this << buf << len);
 
   // We need to remove the PI header and ignore it
-  if (m_encapMode == DIXPI)
+  if (m_encapMode == DIXPI && len >= 4)
     {
-      RemovePIHeader (buf, len);
+      buf += 4;
+      len -= 4;
     }
 
   //
-  // Create a packet out of the buffer we received and free that buffer.
+  // Create a packet out of the buffer we received.
   //
-  Ptr<Packet> packet = Create<Packet> (reinterpret_cast<const uint8_t *> (buf), len);
-  free (buf);
-  buf = 0;
+  Ptr<Packet> packet = Create<Packet> (buf, len);
 
   //
   // Trace sinks will expect complete packets, not packets without some of the
@@ -574,6 +916,67 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
   m_promiscSnifferTrace (packet);
   m_snifferTrace (packet);
 
+  if (m_packetRing != 0 && m_packetRing->HasTxRing ())
+    {
+      // Copy the frame in place in the transmit ring; the frames written
+      // in the same event, or until the batch is full, are sent together
+      uint8_t *slot = m_packetRing->ReserveTxFrame ();
+      if (slot == 0)
+        {
+          m_packetRing->Flush ();
+          slot = m_packetRing->ReserveTxFrame ();
+        }
+      if (slot == 0)
+        {
+          NS_LOG_WARN ("Transmit ring full, packet dropped");
+          m_macTxDropTrace (packet);
+          return false;
+        }
+      uint32_t len = packet->GetSize ();
+      NS_ASSERT (len <= m_packetRing->GetMaxTxFrameSize ());
+      packet->CopyData (slot, len);
+      m_packetRing->CommitTxFrame (len);
+      if (m_packetRing->GetPendingTxFrames () >= m_batchSize)
+        {
+          Simulator::Cancel (m_transmitFlushEvent);
+          FlushTransmitBatch ();
+        }
+      else if (!m_transmitFlushEvent.IsRunning ())
+        {
+          m_transmitFlushEvent = Simulator::ScheduleNow (&FdNetDevice::FlushTransmitBatch, this);
+        }
+      return true;
+    }
+
+  if (m_batchSize > 1)
+    {
+      // Queue the frame; the frames sent in the same event, or until the
+      // batch is full, are written together
+      TransmitFrame frame;
+      frame.buf = m_bufferPool->Get ();
+      frame.len = packet->GetSize ();
+      frame.packet = packet;
+      uint32_t offset = (m_encapMode == DIXPI) ? 4 : 0;
+      NS_ASSERT (frame.len + offset <= m_bufferPool->GetBufferSize ());
+      packet->CopyData (frame.buf + offset, frame.len);
+      if (m_encapMode == DIXPI)
+        {
+          WritePIHeader (frame.buf + offset, frame.len, frame.buf);
+          frame.len += offset;
+        }
+      m_transmitBatch.push_back (frame);
+      if (m_transmitBatch.size () >= m_batchSize)
+        {
+          Simulator::Cancel (m_transmitFlushEvent);
+          FlushTransmitBatch ();
+        }
+      else if (!m_transmitFlushEvent.IsRunning ())
+        {
+          m_transmitFlushEvent = Simulator::ScheduleNow (&FdNetDevice::FlushTransmitBatch, this);
+        }
+      return true;
+    }
+
   NS_LOG_LOGIC ("calling write");
 
 
@@ -599,6 +1002,79 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
   return true;
 }
 
+void
+FdNetDevice::FlushTransmitBatch (void)
+{
+  NS_LOG_FUNCTION (this << m_transmitBatch.size ());
+
+  if (m_packetRing != 0 && m_packetRing->HasTxRing ())
+    {
+      m_packetRing->Flush ();
+      return;
+    }
+
+  uint32_t n = m_transmitBatch.size ();
+  uint32_t sent = 0;
+#ifdef __linux__
+  if (m_isSocket)
+    {
+      std::vector<struct mmsghdr> msgs (n);
+      std::vector<struct iovec> iovs (n);
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          iovs[i].iov_base = m_transmitBatch[i].buf;
+          iovs[i].iov_len = m_transmitBatch[i].len;
+          std::memset (&msgs[i], 0, sizeof (msgs[i]));
+          msgs[i].msg_hdr.msg_iov = &iovs[i];
+          msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+      while (sent < n)
+        {
+          int r = sendmmsg (m_fd, &msgs[sent], n - sent, 0);
+          if (r > 0)
+            {
+              for (int i = 0; i < r; ++i)
+                {
+                  if (msgs[sent + i].msg_len != (unsigned int)m_transmitBatch[sent + i].len)
+                    {
+                      m_macTxDropTrace (m_transmitBatch[sent + i].packet);
+                    }
+                }
+              sent += r;
+            }
+          else if (r == 0 || errno != EINTR)
+            {
+              // Nothing was sent, or the first frame left failed: skip it,
+              // errno is only meaningful when sendmmsg returns -1
+              m_macTxDropTrace (m_transmitBatch[sent].packet);
+              ++sent;
+            }
+        }
+    }
+#endif
+  for (; sent < n; ++sent)
+    {
+      ssize_t written = write (m_fd, m_transmitBatch[sent].buf, m_transmitBatch[sent].len);
+      if (written != m_transmitBatch[sent].len)
+        {
+          m_macTxDropTrace (m_transmitBatch[sent].packet);
+        }
+    }
+
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m_bufferPool->Put (m_transmitBatch[i].buf);
+    }
+  m_transmitBatch.clear ();
+}
+
+void
+FdNetDevice::SetPacketRing (Ptr<FdNetDevicePacketRing> ring)
+{
+  NS_LOG_FUNCTION (this << ring);
+  m_packetRing = ring;
+}
+
 void
 FdNetDevice::SetFileDescriptor (int fd)
 {
@@ -35,9 +35,11 @@
 #include "ns3/traced-callback.h"
 #include "ns3/unix-fd-reader.h"
 #include "ns3/system-mutex.h"
+#include "fd-net-device-packet-ring.h"
 
 #include <utility>
 #include <queue>
+#include <vector>
 
 namespace ns3 {
 
@@ -48,24 +50,112 @@ namespace ns3 {
  * For a generic functional description, please refer to the ns-3 manual.
  */
 
+/**
+ * \ingroup fd-net-device
+ * \brief A thread safe pool of fixed size frame buffers.
+ *
+ * Buffers are allocated with malloc (), so that a buffer taken from the
+ * pool can also be released with free ().
+ */
+class FdNetDeviceBufferPool : public SimpleRefCount<FdNetDeviceBufferPool>
+{
+public:
+  /**
+   * \param bufferSize size of each buffer
+   * \param maxFree maximum number of free buffers kept for reuse
+   */
+  FdNetDeviceBufferPool (uint32_t bufferSize, uint32_t maxFree);
+  ~FdNetDeviceBufferPool ();
+
+  /**
+   * \return a buffer of GetBufferSize () bytes
+   */
+  uint8_t * Get (void);
+
+  /**
+   * \param buf a buffer obtained from Get, given back to the pool
+   */
+  void Put (uint8_t *buf);
+
+  /**
+   * \return the size of the buffers
+   */
+  uint32_t GetBufferSize (void) const;
+
+private:
+  uint32_t m_bufferSize;          //!< size of the buffers
+  uint32_t m_maxFree;             //!< maximum number of free buffers kept
+  std::vector<uint8_t *> m_free;  //!< free buffers
+  SystemMutex m_mutex;            //!< protects m_free
+};
+
 /**
  * \ingroup fd-net-device
  * \brief This class performs the actual data reading from the sockets.
+ *
+ * By default each frame is read with one read () call into a buffer
+ * allocated for it.  In batch mode (see SetBatch) up to a batch of
+ * frames is read at once, with recvmmsg () on sockets, into buffers of a
+ * FdNetDeviceBufferPool, and the whole batch is handed to a single
+ * callback.  In ring mode (see SetPacketRing) the frames are not read
+ * at all: the blocks of the receive ring handed over by the kernel are
+ * passed on to a callback.
  */
 class FdNetDeviceFdReader : public FdReader
 {
 public:
   FdNetDeviceFdReader ();
+  ~FdNetDeviceFdReader ();
 
   /**
    * Set size of the read buffer.
    */
   void SetBufferSize (uint32_t bufferSize);
 
+  /**
+   * \param batchSize maximum number of frames read at once
+   * \param pool the pool providing the read buffers
+   * \param batchCallback callback invoked with the buffers, the lengths
+   *        and the number of frames read; it takes ownership of the buffers
+   *
+   * Enable batch mode.
+   */
+  void SetBatch (uint32_t batchSize, Ptr<FdNetDeviceBufferPool> pool,
+                 Callback<void, uint8_t **, ssize_t *, uint32_t> batchCallback);
+
+  /**
+   * \param ring the PACKET_MMAP rings of the socket
+   * \param blockCallback callback invoked with each receive block handed
+   *        over by the kernel; the block must be released to the ring
+   *
+   * Enable ring mode.
+   */
+  void SetPacketRing (Ptr<FdNetDevicePacketRing> ring, Callback<void, uint8_t *> blockCallback);
+
 private:
   FdReader::Data DoRead (void);
 
+  /**
+   * Pass the receive blocks handed over by the kernel to the block callback.
+   * \return the data structure expected from DoRead
+   */
+  FdReader::Data DoReadRing (void);
+
+  /**
+   * Read a batch of frames and pass them to the batch callback.
+   * \return the data structure expected from DoRead
+   */
+  FdReader::Data DoReadBatch (void);
+
   uint32_t m_bufferSize; //!< size of the read buffer
+  uint32_t m_batchSize;  //!< maximum number of frames read at once, 1 if not batching
+  Ptr<FdNetDeviceBufferPool> m_pool; //!< pool of the batch read buffers
+  Callback<void, uint8_t **, ssize_t *, uint32_t> m_batchCallback; //!< batch receive callback
+  std::vector<uint8_t *> m_buffers; //!< buffers of the next batch
+  std::vector<ssize_t> m_lengths;   //!< lengths of the frames of the batch
+  int m_isSocket;        //!< 1 if the fd is a socket, 0 if not, -1 if unknown yet
+  Ptr<FdNetDevicePacketRing> m_ring; //!< the rings in ring mode
+  Callback<void, uint8_t *> m_blockCallback; //!< receive block callback
 };
 
 class Node;
@@ -136,6 +226,17 @@ public:
    */
   void SetFileDescriptor (int fd);
 
+  /**
+   * Exchange the frames through the PACKET_MMAP rings of the file
+   * descriptor, a packet socket, instead of reading and writing them.
+   * The received frames are copied once, from the ring to the packet,
+   * and all the frames of a receive block are processed by a single
+   * event.
+   *
+   * \param ring the rings, already set up on the file descriptor
+   */
+  void SetPacketRing (Ptr<FdNetDevicePacketRing> ring);
+
   /**
    * Set a start time for the device.
    *
@@ -215,10 +316,40 @@ private:
   void ReceiveCallback (uint8_t *buf, ssize_t len);
 
   /**
-   * Forward the frame to the appropriate callback for processing
+   * Callback to invoke when a batch of frames is received
+   */
+  void ReceiveBatchCallback (uint8_t **bufs, ssize_t *lens, uint32_t n);
+
+  /**
+   * Callback to invoke when a receive block of the ring is handed over
+   */
+  void ReceiveBlockCallback (uint8_t *block);
+
+  /**
+   * Callback to invoke after each batch of reads, to schedule the
+   * processing of the frames read
+   */
+  void ReadBatchEndCallback (void);
+
+  /**
+   * Forward the frames read and not processed yet to the appropriate
+   * callback for processing, and give the receive blocks of the ring
+   * back to the kernel
    */
   void ForwardUp (void);
 
+  /**
+   * Process a received frame
+   * \param buf the frame
+   * \param len the frame length, including the PI header if any
+   */
+  void ProcessFrame (const uint8_t *buf, ssize_t len);
+
+  /**
+   * Write the frames queued for transmission in batch mode
+   */
+  void FlushTransmitBatch (void);
+
   /**
    * Start Sending a Packet Down the Wire.
    * @param p packet to send
@@ -311,6 +442,59 @@ private:
    */
   SystemMutex m_pendingReadMutex;
 
+  /**
+   * Maximum number of frames read or written with a single system call,
+   * 1 to disable batching.
+   */
+  uint32_t m_batchSize;
+
+  /**
+   * Buffers used in batch mode.
+   */
+  Ptr<FdNetDeviceBufferPool> m_bufferPool;
+
+  /**
+   * Whether an event draining m_pendingQueue and m_pendingBlocks is
+   * scheduled (protected by m_pendingReadMutex).
+   */
+  bool m_forwardUpScheduled;
+
+  /**
+   * Whether the file descriptor is a socket, so that sendmmsg can be used.
+   */
+  bool m_isSocket;
+
+  /**
+   * A frame waiting to be written in batch mode.
+   */
+  struct TransmitFrame
+  {
+    uint8_t *buf;          //!< frame buffer, from m_bufferPool
+    ssize_t len;           //!< frame length
+    Ptr<Packet> packet;    //!< the packet, for the drop trace
+  };
+
+  /**
+   * Frames waiting to be written in batch mode.
+   */
+  std::vector<TransmitFrame> m_transmitBatch;
+
+  /**
+   * Event writing the frames of m_transmitBatch.
+   */
+  EventId m_transmitFlushEvent;
+
+  /**
+   * The PACKET_MMAP rings, if any.
+   */
+  Ptr<FdNetDevicePacketRing> m_packetRing;
+
+  /**
+   * Receive blocks handed over and not processed yet (protected by
+   * m_pendingReadMutex).
+   */
+  std::queue<uint8_t *> m_pendingBlocks;
+
   /**
    * Time to start spinning up the device
    */
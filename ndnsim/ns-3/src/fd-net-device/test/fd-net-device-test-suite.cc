@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/mac48-address.h"
+#include "ns3/fd-net-device.h"
+#include "ns3/fd-net-device-helper.h"
+
+#include <sstream>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+using namespace ns3;
+
+/**
+ * Connect an FdNetDevice to one end of a datagram socketpair, write
+ * Ethernet frames on the other end and send packets through the device
+ * in a single event, and check that every frame goes through, whole and
+ * in order, in both directions.  With a BatchSize above 1 the frames are
+ * read with recvmmsg and written with sendmmsg.
+ */
+class FdNetDeviceSocketPairTestCase : public TestCase
+{
+public:
+  /**
+   * \param batchSize the BatchSize attribute of the device
+   * \param readerThreads the FdReaderThreads global value
+   */
+  FdNetDeviceSocketPairTestCase (uint32_t batchSize, uint32_t readerThreads);
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * Write the frames to the device on the peer socket
+   * \param fd the peer socket
+   */
+  void WriteFrames (int fd);
+  /**
+   * Send the packets through the device
+   * \param device the device
+   */
+  void SendPackets (Ptr<FdNetDevice> device);
+  /**
+   * Protocol handler of the node
+   * \param device the receiving device
+   * \param packet the received packet
+   * \param protocol the protocol number
+   * \param from the source address
+   * \param to the destination address
+   * \param packetType the type of packet
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  /// Number of frames in each direction, more than a batch
+  static const uint32_t FRAMES = 20;
+  /// Payload size of the frames
+  static const uint32_t PAYLOAD_SIZE = 100;
+  /// An EtherType for local experiments
+  static const uint16_t PROTOCOL = 0x88b5;
+
+  uint32_t m_batchSize;                  //!< BatchSize attribute of the device
+  uint32_t m_readerThreads;              //!< FdReaderThreads global value
+  Mac48Address m_address;                //!< Address of the device
+  Mac48Address m_peerAddress;            //!< Address of the peer
+  std::vector<uint8_t> m_received;       //!< First payload byte of the packets received by the node
+  std::vector<uint32_t> m_receivedSizes; //!< Sizes of the packets received by the node
+};
+
+const uint32_t FdNetDeviceSocketPairTestCase::FRAMES;
+const uint32_t FdNetDeviceSocketPairTestCase::PAYLOAD_SIZE;
+const uint16_t FdNetDeviceSocketPairTestCase::PROTOCOL;
+
+static std::string
+Name (uint32_t batchSize, uint32_t readerThreads)
+{
+  std::ostringstream oss;
+  oss << "Frames through a socketpair, batch size " << batchSize
+      << ", " << readerThreads << " shared reader threads";
+  return oss.str ();
+}
+
+FdNetDeviceSocketPairTestCase::FdNetDeviceSocketPairTestCase (uint32_t batchSize, uint32_t readerThreads)
+  : TestCase (Name (batchSize, readerThreads)),
+    m_batchSize (batchSize),
+    m_readerThreads (readerThreads)
+{
+}
+
+void
+FdNetDeviceSocketPairTestCase::DoSetup (void)
+{
+  // The device reads in another thread
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+  Config::SetGlobal ("FdReaderThreads", UintegerValue (m_readerThreads));
+  m_received.clear ();
+  m_receivedSizes.clear ();
+}
+
+void
+FdNetDeviceSocketPairTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetGlobal ("FdReaderThreads", UintegerValue (0));
+}
+
+void
+FdNetDeviceSocketPairTestCase::WriteFrames (int fd)
+{
+  for (uint32_t i = 0; i < FRAMES; ++i)
+    {
+      std::vector<uint8_t> payload (PAYLOAD_SIZE, i);
+      Ptr<Packet> packet = Create<Packet> (&payload[0], PAYLOAD_SIZE);
+      EthernetHeader header (false);
+      header.SetSource (m_peerAddress);
+      header.SetDestination (m_address);
+      header.SetLengthType (PROTOCOL);
+      packet->AddHeader (header);
+
+      std::vector<uint8_t> frame (packet->GetSize ());
+      packet->CopyData (&frame[0], frame.size ());
+      ssize_t written = write (fd, &frame[0], frame.size ());
+      NS_TEST_EXPECT_MSG_EQ (written, (ssize_t)frame.size (), "Frame " << i << " not written: " << std::strerror (errno));
+    }
+}
+
+void
+FdNetDeviceSocketPairTestCase::SendPackets (Ptr<FdNetDevice> device)
+{
+  for (uint32_t i = 0; i < FRAMES; ++i)
+    {
+      std::vector<uint8_t> payload (PAYLOAD_SIZE, i);
+      Ptr<Packet> packet = Create<Packet> (&payload[0], PAYLOAD_SIZE);
+      NS_TEST_EXPECT_MSG_EQ (device->Send (packet, m_peerAddress, PROTOCOL), true, "Packet " << i << " not sent");
+    }
+}
+
+void
+FdNetDeviceSocketPairTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                        const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  uint8_t first = 0;
+  packet->CopyData (&first, 1);
+  m_received.push_back (first);
+  m_receivedSizes.push_back (packet->GetSize ());
+}
+
+void
+FdNetDeviceSocketPairTestCase::DoRun (void)
+{
+  int sv[2];
+  NS_TEST_ASSERT_MSG_EQ (socketpair (AF_UNIX, SOCK_DGRAM, 0, sv), 0, "socketpair failed: " << std::strerror (errno));
+
+  m_address = Mac48Address::Allocate ();
+  m_peerAddress = Mac48Address::Allocate ();
+
+  Ptr<Node> node = CreateObject<Node> ();
+  FdNetDeviceHelper helper;
+  helper.SetAttribute ("BatchSize", UintegerValue (m_batchSize));
+  Ptr<FdNetDevice> device = helper.Install (node).Get (0)->GetObject<FdNetDevice> ();
+  device->SetAddress (m_address);
+  // The device owns sv[0] from now on
+  device->SetFileDescriptor (sv[0]);
+  node->RegisterProtocolHandler (MakeCallback (&FdNetDeviceSocketPairTestCase::Receive, this),
+                                 PROTOCOL, device);
+
+  Simulator::Schedule (MilliSeconds (10), &FdNetDeviceSocketPairTestCase::WriteFrames, this, sv[1]);
+  Simulator::Schedule (MilliSeconds (10), &FdNetDeviceSocketPairTestCase::SendPackets, this, device);
+  Simulator::Stop (MilliSeconds (200));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received.size (), FRAMES, "Not every frame was received");
+  for (uint32_t i = 0; i < m_received.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)m_received[i], i, "Frame received out of order");
+      NS_TEST_EXPECT_MSG_EQ (m_receivedSizes[i], PAYLOAD_SIZE, "Frame " << i << " truncated");
+    }
+
+  uint32_t sent = 0;
+  uint8_t buf[2048];
+  ssize_t len;
+  while ((len = recv (sv[1], buf, sizeof (buf), MSG_DONTWAIT)) > 0)
+    {
+      Ptr<Packet> packet = Create<Packet> (buf, len);
+      EthernetHeader header (false);
+      packet->RemoveHeader (header);
+      NS_TEST_EXPECT_MSG_EQ (header.GetDestination (), m_peerAddress, "Bad destination of frame " << sent);
+      NS_TEST_EXPECT_MSG_EQ (header.GetSource (), m_address, "Bad source of frame " << sent);
+      NS_TEST_EXPECT_MSG_EQ (header.GetLengthType (), PROTOCOL, "Bad EtherType of frame " << sent);
+      NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), PAYLOAD_SIZE, "Frame " << sent << " truncated");
+      uint8_t first = 0;
+      packet->CopyData (&first, 1);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)first, sent, "Frame sent out of order");
+      ++sent;
+    }
+  NS_TEST_EXPECT_MSG_EQ (sent, FRAMES, "Not every packet was sent");
+  close (sv[1]);
+}
+
+
+class FdNetDeviceTestSuite : public TestSuite
+{
+public:
+  FdNetDeviceTestSuite ();
+};
+
+FdNetDeviceTestSuite::FdNetDeviceTestSuite ()
+  : TestSuite ("fd-net-device", UNIT)
+{
+  AddTestCase (new FdNetDeviceSocketPairTestCase (1, 0), TestCase::QUICK);
+  AddTestCase (new FdNetDeviceSocketPairTestCase (8, 0), TestCase::QUICK);
+  AddTestCase (new FdNetDeviceSocketPairTestCase (8, 1), TestCase::QUICK);
+}
+
+static FdNetDeviceTestSuite g_fdNetDeviceTestSuite;
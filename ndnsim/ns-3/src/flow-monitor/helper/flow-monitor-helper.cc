@@ -34,6 +34,7 @@
 namespace ns3 {
 
 FlowMonitorHelper::FlowMonitorHelper ()
+  : m_ipv4TagFree (false)
 {
   m_monitorFactory.SetTypeId ("ns3::FlowMonitor");
 }
@@ -55,6 +56,17 @@ FlowMonitorHelper::SetMonitorAttribute (std::string n1, const AttributeValue &v1
   m_monitorFactory.Set (n1, v1);
 }
 
+void
+FlowMonitorHelper::SetIpv4TagFree (bool tagFree)
+{
+  NS_ASSERT_MSG (!m_flowMonitor, "SetIpv4TagFree must be called before installing the monitor");
+  m_ipv4TagFree = tagFree;
+  if (m_flowClassifier4)
+    {
+      DynamicCast<Ipv4FlowClassifier> (m_flowClassifier4)->SetTagFree (tagFree);
+    }
+}
+
 
 Ptr<FlowMonitor>
 FlowMonitorHelper::GetMonitor ()
@@ -62,9 +74,9 @@ FlowMonitorHelper::GetMonitor ()
   if (!m_flowMonitor)
     {
       m_flowMonitor = m_monitorFactory.Create<FlowMonitor> ();
-      m_flowClassifier4 = Create<Ipv4FlowClassifier> ();
+      m_flowClassifier4 = GetClassifier ();
       m_flowMonitor->AddFlowClassifier (m_flowClassifier4);
-      m_flowClassifier6 = Create<Ipv6FlowClassifier> ();
+      m_flowClassifier6 = GetClassifier6 ();
       m_flowMonitor->AddFlowClassifier (m_flowClassifier6);
     }
   return m_flowMonitor;
@@ -76,7 +88,9 @@ FlowMonitorHelper::GetClassifier ()
 {
   if (!m_flowClassifier4)
     {
-      m_flowClassifier4 = Create<Ipv4FlowClassifier> ();
+      Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+      classifier->SetTagFree (m_ipv4TagFree);
+      m_flowClassifier4 = classifier;
     }
   return m_flowClassifier4;
 }
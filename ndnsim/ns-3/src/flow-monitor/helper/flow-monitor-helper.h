@@ -50,6 +50,22 @@ public:
    */
   void SetMonitorAttribute (std::string n1, const AttributeValue &v1);
 
+  /**
+   * \brief Enable or disable the tag-free mode of the IPv4 probes
+   *
+   * In tag-free mode the IPv4 probes do not add a byte tag to each
+   * monitored packet; packets are re-identified at each hop from their
+   * 5-tuple and IPv4 identification field instead.  The identification
+   * is only 16 bits wide: it is extended with a per-flow wrap-around
+   * count, so a flow must not have 65536 or more packets in flight at
+   * once.  Packets dropped by device queues are then reported as lost
+   * after MaxPerHopDelay rather than as queue drops.  Must be called
+   * before Install.
+   *
+   * \param tagFree true to enable the tag-free mode
+   */
+  void SetIpv4TagFree (bool tagFree);
+
   /**
    * \brief Enable flow monitoring on a set of nodes
    * \param nodes A NodeContainer holding the set of nodes to work with.
@@ -131,6 +147,7 @@ private:
   Ptr<FlowMonitor> m_flowMonitor;        //!< the FlowMonitor object
   Ptr<FlowClassifier> m_flowClassifier4; //!< the FlowClassifier object for IPv4
   Ptr<FlowClassifier> m_flowClassifier6; //!< the FlowClassifier object for IPv6
+  bool m_ipv4TagFree;                    //!< IPv4 probes run in tag-free mode
 };
 
 } // namespace ns3
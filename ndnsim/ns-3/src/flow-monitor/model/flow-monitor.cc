@@ -22,6 +22,7 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include <fstream>
 #include <sstream>
 
@@ -72,6 +73,11 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("PacketSamplingInterval", ("Monitor about one packet out of this many in each flow "
+                                              "(1 monitors every packet)."),
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FlowMonitor::m_samplingInterval),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -83,7 +89,8 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_enabled (false),
+    m_samplingInterval (1)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
@@ -102,17 +109,30 @@ FlowMonitor::DoDispose (void)
       m_flowProbes[i]->Dispose ();
       m_flowProbes[i] = 0;
     }
+  m_exportStream = 0;
   Object::DoDispose ();
 }
 
 inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow (FlowId flowId)
 {
-  FlowStatsContainerI iter;
-  iter = m_flowStats.find (flowId);
-  if (iter == m_flowStats.end ())
+  FlowStatsIndex::iterator iter;
+  iter = m_flowStatsIndex.find (flowId);
+  if (iter == m_flowStatsIndex.end ())
     {
       FlowMonitor::FlowStats &ref = m_flowStats[flowId];
+      FlowStatsIndexEntry &entry = m_flowStatsIndex[flowId];
+      entry.stats = &ref;
+      entry.dirty = false;
+      entry.exported.delaySum = Seconds (0);
+      entry.exported.jitterSum = Seconds (0);
+      entry.exported.txBytes = 0;
+      entry.exported.rxBytes = 0;
+      entry.exported.txPackets = 0;
+      entry.exported.rxPackets = 0;
+      entry.exported.lostPackets = 0;
+      entry.exported.timesForwarded = 0;
+      MarkDirty (entry, flowId);
       ref.delaySum = Seconds (0);
       ref.jitterSum = Seconds (0);
       ref.lastDelay = Seconds (0);
@@ -130,10 +150,28 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
     }
   else
     {
-      return iter->second;
+      MarkDirty (iter->second, flowId);
+      return *iter->second.stats;
     }
 }
 
+inline void
+FlowMonitor::MarkDirty (FlowStatsIndexEntry &entry, FlowId flowId)
+{
+  if (m_exportStream && !entry.dirty)
+    {
+      entry.dirty = true;
+      m_dirtyFlows.push_back (flowId);
+    }
+}
+
+inline void
+FlowMonitor::TouchExpiry (TrackedPacket &tracked, Time now)
+{
+  tracked.expiry->lastSeenTime = now;
+  m_expiryQueue.splice (m_expiryQueue.end (), m_expiryQueue, tracked.expiry);
+}
+
 
 void
 FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
@@ -143,7 +181,16 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
+  std::pair<TrackedPacketMap::iterator, bool> inserted = m_trackedPackets.insert (std::make_pair (key, TrackedPacket ()));
+  TrackedPacket &tracked = inserted.first->second;
+  if (inserted.second)
+    {
+      TrackedPacketExpiry expiry;
+      expiry.key = key;
+      tracked.expiry = m_expiryQueue.insert (m_expiryQueue.end (), expiry);
+    }
+  TouchExpiry (tracked, now);
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
@@ -181,6 +228,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
 
   tracked->second.timesForwarded++;
   tracked->second.lastSeenTime = Simulator::Now ();
+  TouchExpiry (tracked->second, tracked->second.lastSeenTime);
 
   Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
@@ -247,7 +295,9 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  // we don't need to track this packet anymore
+  m_expiryQueue.erase (tracked->second.expiry);
+  m_trackedPackets.erase (tracked);
 }
 
 void
@@ -279,6 +329,7 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
       // FIXME: this will not necessarily be true with broadcast/multicast
       NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
+      m_expiryQueue.erase (tracked->second.expiry);
       m_trackedPackets.erase (tracked);
     }
 }
@@ -295,23 +346,21 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
-  for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+  // The expiry queue holds the tracked packets sorted by the time
+  // they were last seen, so only its head can have expired.
+  while (!m_expiryQueue.empty () && now - m_expiryQueue.front ().lastSeenTime >= maxDelay)
     {
-      if (now - iter->second.lastSeenTime >= maxDelay)
-        {
-          // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
+      const TrackedPacketExpiry &expiry = m_expiryQueue.front ();
 
-          // we won't track it anymore
-          m_trackedPackets.erase (iter++);
-        }
-      else
-        {
-          iter++;
-        }
+      // packet is considered lost, add it to the loss statistics
+      FlowStatsIndex::iterator flow = m_flowStatsIndex.find (expiry.key.first);
+      NS_ASSERT (flow != m_flowStatsIndex.end ());
+      flow->second.stats->lostPackets++;
+      MarkDirty (flow->second, flow->first);
+
+      // we won't track it anymore
+      m_trackedPackets.erase (expiry.key);
+      m_expiryQueue.pop_front ();
     }
 }
 
@@ -328,6 +377,73 @@ FlowMonitor::PeriodicCheckForLostPackets ()
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+void
+FlowMonitor::EnablePeriodicExport (Ptr<OutputStreamWrapper> stream, Time interval)
+{
+  NS_LOG_FUNCTION (this << stream << interval);
+  NS_ASSERT_MSG (interval.IsStrictlyPositive (), "The export interval must be positive");
+  bool scheduled = m_exportStream != 0;
+  m_exportStream = stream;
+  m_exportInterval = interval;
+
+  // flows seen before the export was enabled are exported on the first period
+  m_dirtyFlows.clear ();
+  for (FlowStatsIndex::iterator iter = m_flowStatsIndex.begin (); iter != m_flowStatsIndex.end (); iter++)
+    {
+      iter->second.dirty = false;
+      MarkDirty (iter->second, iter->first);
+    }
+
+  *m_exportStream->GetStream () << "time,flowId,txPackets,txBytes,rxPackets,rxBytes,"
+                                 << "lostPackets,delaySum,jitterSum,timesForwarded" << std::endl;
+  if (!scheduled)
+    {
+      Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+    }
+}
+
+void
+FlowMonitor::PeriodicExport ()
+{
+  if (!m_exportStream)
+    {
+      return;
+    }
+  CheckForLostPackets ();
+
+  std::ostream *os = m_exportStream->GetStream ();
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  for (std::vector<FlowId>::const_iterator flowId = m_dirtyFlows.begin (); flowId != m_dirtyFlows.end (); flowId++)
+    {
+      FlowStatsIndexEntry &entry = m_flowStatsIndex[*flowId];
+      const FlowStats &stats = *entry.stats;
+      ExportedCounters &exported = entry.exported;
+      *os << now << ',' << *flowId
+          << ',' << stats.txPackets - exported.txPackets
+          << ',' << stats.txBytes - exported.txBytes
+          << ',' << stats.rxPackets - exported.rxPackets
+          << ',' << stats.rxBytes - exported.rxBytes
+          << ',' << stats.lostPackets - exported.lostPackets
+          << ',' << (stats.delaySum - exported.delaySum).GetNanoSeconds ()
+          << ',' << (stats.jitterSum - exported.jitterSum).GetNanoSeconds ()
+          << ',' << stats.timesForwarded - exported.timesForwarded
+          << '\n';
+      exported.delaySum = stats.delaySum;
+      exported.jitterSum = stats.jitterSum;
+      exported.txBytes = stats.txBytes;
+      exported.rxBytes = stats.rxBytes;
+      exported.txPackets = stats.txPackets;
+      exported.rxPackets = stats.rxPackets;
+      exported.lostPackets = stats.lostPackets;
+      exported.timesForwarded = stats.timesForwarded;
+      entry.dirty = false;
+    }
+  m_dirtyFlows.clear ();
+  os->flush ();
+
+  Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
 void
 FlowMonitor::NotifyConstructionCompleted ()
 {
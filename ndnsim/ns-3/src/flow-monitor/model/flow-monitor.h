@@ -23,6 +23,8 @@
 
 #include <vector>
 #include <map>
+#include <list>
+#include <unordered_map>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
@@ -31,6 +33,7 @@
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/output-stream-wrapper.h"
 
 namespace ns3 {
 
@@ -201,6 +204,35 @@ public:
   void ReportDrop (Ptr<FlowProbe> probe, FlowId flowId, FlowPacketId packetId,
                    uint32_t packetSize, uint32_t reasonCode);
 
+  /// FlowProbe implementations are supposed to call this method
+  /// before tagging or reporting a new packet, and at every hop where
+  /// the packet is identified again from its headers.  About one packet
+  /// out of every PacketSamplingInterval packets of a flow is monitored;
+  /// the others are ignored by the probes altogether, so the collected
+  /// statistics refer to the sampled packets only.  The decision is a
+  /// hash of the flow and packet ids, so it is the same at every hop and
+  /// it does not depend on how the classifier numbers the packets: the
+  /// IPv4 identification used in tag-free mode is shared by all the
+  /// flows between the same hosts.
+  /// \param flowId flow identification
+  /// \param packetId Packet ID
+  /// \returns true if the packet is to be monitored
+  bool IsPacketSampled (FlowId flowId, FlowPacketId packetId) const
+  {
+    if (m_samplingInterval <= 1)
+      {
+        return true;
+      }
+    // 64-bit finalizer of MurmurHash3
+    uint64_t h = (uint64_t (flowId) << 32) | packetId;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h % m_samplingInterval == 0;
+  }
+
   /// Check right now for packets that appear to be lost
   void CheckForLostPackets ();
 
@@ -250,6 +282,19 @@ public:
   /// \return the XML output as string
   std::string SerializeToXmlString (int indent, bool enableHistograms, bool enableProbes);
 
+  /// \brief Periodically export the per-flow statistics deltas
+  ///
+  /// Every \p interval, one CSV line is written for each flow whose
+  /// statistics changed since the previous export, holding the
+  /// increments of its counters over that interval:
+  /// time,flowId,txPackets,txBytes,rxPackets,rxBytes,lostPackets,delaySum,jitterSum,timesForwarded
+  /// (times in nanoseconds).  Lost packets are detected before each
+  /// export.  Unlike the XML serialization, the cost of an export only
+  /// depends on the number of flows active in the interval.
+  /// \param stream the output stream
+  /// \param interval the export period
+  void EnablePeriodicExport (Ptr<OutputStreamWrapper> stream, Time interval);
+
   /// Same as SerializeToXmlStream, but writes to a file instead
   /// \param fileName name or path of the output file that will be created
   /// \param enableHistograms if true, include also the histograms in the output
@@ -264,19 +309,72 @@ protected:
 
 private:
 
+
+  /// FlowId --> FlowStats
+  FlowStatsContainer m_flowStats;
+
+  /// Hash function for the (FlowId,PacketId) pair
+  struct TrackedPacketKeyHash
+  {
+    /// \param key the key to hash
+    /// \returns the hash of the key
+    size_t operator() (const std::pair<FlowId, FlowPacketId> &key) const
+    {
+      uint64_t h = (uint64_t (key.first) << 32) | key.second;
+      h *= 0x9e3779b97f4a7c15ULL;
+      return static_cast<size_t> (h ^ (h >> 32));
+    }
+  };
+
+  /// Flow counters as of the last periodic export
+  struct ExportedCounters
+  {
+    Time delaySum;           //!< see FlowStats::delaySum
+    Time jitterSum;          //!< see FlowStats::jitterSum
+    uint64_t txBytes;        //!< see FlowStats::txBytes
+    uint64_t rxBytes;        //!< see FlowStats::rxBytes
+    uint32_t txPackets;      //!< see FlowStats::txPackets
+    uint32_t rxPackets;      //!< see FlowStats::rxPackets
+    uint32_t lostPackets;    //!< see FlowStats::lostPackets
+    uint32_t timesForwarded; //!< see FlowStats::timesForwarded
+  };
+
+  /// Entry of the flow stats index
+  struct FlowStatsIndexEntry
+  {
+    FlowStats *stats;          //!< the flow stats, stored in m_flowStats
+    bool dirty;                //!< the stats changed since the last periodic export
+    ExportedCounters exported; //!< counters as of the last periodic export
+  };
+
+  /// FlowId --> FlowStats, hashed index into m_flowStats
+  typedef std::unordered_map<FlowId, FlowStatsIndexEntry> FlowStatsIndex;
+  FlowStatsIndex m_flowStatsIndex; //!< Index for fast lookup of the flow stats
+
+  /// A tracked packet was last reported at the given time.  Each tracked
+  /// packet has exactly one entry, moved to the tail whenever the packet
+  /// is reported again and erased when it is delivered or dropped, so
+  /// that lost packets are found by looking only at the head of the queue.
+  struct TrackedPacketExpiry
+  {
+    std::pair<FlowId, FlowPacketId> key; //!< the tracked packet
+    Time lastSeenTime; //!< time of the last report
+  };
+  /// Tracked packets ordered by the time they were last reported
+  typedef std::list<TrackedPacketExpiry> ExpiryQueue;
+  ExpiryQueue m_expiryQueue; //!< Tracked packets, least recently seen first
+
   /// Structure to represent a single tracked packet data
   struct TrackedPacket
   {
     Time firstSeenTime; //!< absolute time when the packet was first seen by a probe
     Time lastSeenTime; //!< absolute time when the packet was last seen by a probe
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+    ExpiryQueue::iterator expiry; //!< entry of the packet in m_expiryQueue
   };
 
-  /// FlowId --> FlowStats
-  FlowStatsContainer m_flowStats;
-
   /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  typedef std::unordered_map< std::pair<FlowId, FlowPacketId>, TrackedPacket, TrackedPacketKeyHash> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
@@ -292,14 +390,32 @@ private:
   double m_packetSizeBinWidth;  //!< packet size bin width (for histograms)
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
+  uint32_t m_samplingInterval; //!< Monitor about one packet out of this many per flow
+
+  Ptr<OutputStreamWrapper> m_exportStream; //!< Periodic export output
+  Time m_exportInterval;     //!< Periodic export interval
+  std::vector<FlowId> m_dirtyFlows; //!< Flows changed since the last periodic export
 
   /// Get the stats for a given flow
   /// \param flowId the Flow identification
   /// \returns the stats of the flow
   FlowStats& GetStatsForFlow (FlowId flowId);
 
+  /// Mark the stats of a flow as changed since the last periodic export
+  /// \param entry the flow stats index entry
+  /// \param flowId the Flow identification
+  void MarkDirty (FlowStatsIndexEntry &entry, FlowId flowId);
+
+  /// Move a tracked packet to the tail of the expiry queue
+  /// \param tracked the tracked packet
+  /// \param now the time the packet was seen
+  void TouchExpiry (TrackedPacket &tracked, Time now);
+
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// Periodic function to export the flow stats deltas
+  void PeriodicExport ();
 };
 
 
@@ -23,6 +23,7 @@
 #include "ipv4-flow-classifier.h"
 #include "ns3/udp-header.h"
 #include "ns3/tcp-header.h"
+#include "ns3/assert.h"
 
 namespace ns3 {
 
@@ -95,13 +96,42 @@ bool operator == (const Ipv4FlowClassifier::FiveTuple &t1,
 
 
 
+size_t
+Ipv4FlowClassifier::FiveTupleHash::operator() (const FiveTuple &t) const
+{
+  uint64_t h = t.sourceAddress.Get ();
+  h = (h << 32) | t.destinationAddress.Get ();
+  h ^= (uint64_t (t.protocol) << 40) ^ (uint64_t (t.sourcePort) << 16) ^ t.destinationPort;
+  // 64-bit mix (MurmurHash3 finalizer)
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return static_cast<size_t> (h);
+}
+
 Ipv4FlowClassifier::Ipv4FlowClassifier ()
+  : m_tagFree (false)
+{
+}
+
+void
+Ipv4FlowClassifier::SetTagFree (bool tagFree)
 {
+  NS_ASSERT_MSG (m_flowMap.empty (), "Tag-free mode must be set before any packet is classified");
+  m_tagFree = tagFree;
 }
 
 bool
-Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
-                              uint32_t *out_flowId, uint32_t *out_packetId)
+Ipv4FlowClassifier::IsTagFree (void) const
+{
+  return m_tagFree;
+}
+
+bool
+Ipv4FlowClassifier::MakeTuple (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
+                               FiveTuple &tuple)
 {
   if (ipHeader.GetFragmentOffset () > 0 )
     {
@@ -109,7 +139,6 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
       return false;
     }
 
-  FiveTuple tuple;
   tuple.sourceAddress = ipHeader.GetSource ();
   tuple.destinationAddress = ipHeader.GetDestination ();
   tuple.protocol = ipHeader.GetProtocol ();
@@ -146,25 +175,89 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
   tuple.sourcePort = srcPort;
   tuple.destinationPort = dstPort;
 
+  return true;
+}
+
+bool
+Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
+                              uint32_t *out_flowId, uint32_t *out_packetId)
+{
+  FiveTuple tuple;
+  if (!MakeTuple (ipHeader, ipPayload, tuple))
+    {
+      return false;
+    }
+
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
+  std::pair<std::unordered_map<FiveTuple, FlowId, FiveTupleHash>::iterator, bool> insert
     = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
   if (insert.second)
     {
-      FlowId newFlowId = GetNewFlowId ();
-      insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
+      insert.first->second = GetNewFlowId ();
+    }
+  *out_flowId = insert.first->second;
+
+  if (m_tagFree)
+    {
+      // the last packet id holds the number of times the identification
+      // of the flow wrapped around in its upper 16 bits
+      FlowPacketId &last = m_flowPktIdMap[*out_flowId];
+      uint16_t identification = ipHeader.GetIdentification ();
+      FlowPacketId epoch = last >> 16;
+      if (identification < (last & 0xffff))
+        {
+          epoch++;
+        }
+      last = (epoch << 16) | identification;
+      *out_packetId = last;
+      return true;
+    }
+
+  if (insert.second)
+    {
+      m_flowPktIdMap[*out_flowId] = 0;
+      *out_packetId = 0;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      *out_packetId = ++m_flowPktIdMap[*out_flowId];
     }
 
-  *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  return true;
+}
+
+bool
+Ipv4FlowClassifier::Lookup (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
+                            uint32_t *out_flowId, uint32_t *out_packetId) const
+{
+  NS_ASSERT_MSG (m_tagFree, "Lookup is only available in tag-free mode");
+
+  FiveTuple tuple;
+  if (!MakeTuple (ipHeader, ipPayload, tuple))
+    {
+      return false;
+    }
+
+  std::unordered_map<FiveTuple, FlowId, FiveTupleHash>::const_iterator iter = m_flowMap.find (tuple);
+  if (iter == m_flowMap.end ())
+    {
+      return false;
+    }
+
+  *out_flowId = iter->second;
 
+  std::unordered_map<FlowId, FlowPacketId>::const_iterator last = m_flowPktIdMap.find (iter->second);
+  NS_ASSERT (last != m_flowPktIdMap.end ());
+  uint16_t identification = ipHeader.GetIdentification ();
+  FlowPacketId epoch = last->second >> 16;
+  if (identification > (last->second & 0xffff) && epoch > 0)
+    {
+      // sent before the identification last wrapped around
+      epoch--;
+    }
+  *out_packetId = (epoch << 16) | identification;
   return true;
 }
 
@@ -172,7 +265,7 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
+  for (std::unordered_map<FiveTuple, FlowId, FiveTupleHash>::const_iterator
        iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
     {
       if (iter->second == flowId)
@@ -192,17 +285,25 @@ Ipv4FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
 
   INDENT (indent); os << "<Ipv4FlowClassifier>\n";
 
-  indent += 2;
-  for (std::map<FiveTuple, FlowId>::const_iterator
+  // the flow map is unordered: sort by flow id for a stable output
+  std::map<FlowId, FiveTuple> sortedFlows;
+  for (std::unordered_map<FiveTuple, FlowId, FiveTupleHash>::const_iterator
        iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+    {
+      sortedFlows[iter->second] = iter->first;
+    }
+
+  indent += 2;
+  for (std::map<FlowId, FiveTuple>::const_iterator
+       iter = sortedFlows.begin (); iter != sortedFlows.end (); iter++)
     {
       INDENT (indent);
-      os << "<Flow flowId=\"" << iter->second << "\""
-         << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-         << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-         << " protocol=\"" << int(iter->first.protocol) << "\""
-         << " sourcePort=\"" << iter->first.sourcePort << "\""
-         << " destinationPort=\"" << iter->first.destinationPort << "\""
+      os << "<Flow flowId=\"" << iter->first << "\""
+         << " sourceAddress=\"" << iter->second.sourceAddress << "\""
+         << " destinationAddress=\"" << iter->second.destinationAddress << "\""
+         << " protocol=\"" << int(iter->second.protocol) << "\""
+         << " sourcePort=\"" << iter->second.sourcePort << "\""
+         << " destinationPort=\"" << iter->second.destinationPort << "\""
          << " />\n";
     }
 
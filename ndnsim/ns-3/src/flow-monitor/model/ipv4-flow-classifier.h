@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <map>
+#include <unordered_map>
 
 #include "ns3/ipv4-header.h"
 #include "ns3/flow-classifier.h"
@@ -49,6 +50,14 @@ public:
     uint16_t destinationPort;       //!< Destination port
   };
 
+  /// Hash function for FiveTuple
+  struct FiveTupleHash
+  {
+    /// \param t the tuple to hash
+    /// \returns the hash of the tuple
+    size_t operator() (const FiveTuple &t) const;
+  };
+
   Ipv4FlowClassifier ();
 
   /// \brief try to classify the packet into flow-id and packet-id
@@ -64,6 +73,37 @@ public:
   bool Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
                  uint32_t *out_flowId, uint32_t *out_packetId);
 
+  /// \brief find the flow-id and packet-id of an already classified packet
+  ///
+  /// Unlike Classify, no new flow is created and no packet counter is
+  /// advanced, so this can be called at every hop.  It is only
+  /// meaningful in tag-free mode, where the packet identifier is
+  /// derived from the IPv4 identification field of the header.
+  ///
+  /// \return true if the packet belongs to a known flow
+  /// \param ipHeader packet's IP header
+  /// \param ipPayload packet's IP payload
+  /// \param out_flowId packet's FlowId
+  /// \param out_packetId packet's identifier
+  bool Lookup (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
+               uint32_t *out_flowId, uint32_t *out_packetId) const;
+
+  /// \brief Enable or disable the tag-free mode.
+  ///
+  /// In tag-free mode the packet identifier is taken from the IPv4
+  /// identification field instead of a per-flow counter, so that the
+  /// probes can re-identify a packet at each hop from its headers
+  /// alone, without adding an Ipv4FlowProbeTag to it.  The 16-bit
+  /// identification is extended with the number of times it wrapped
+  /// around in the flow, which keeps the identifiers unique as long as
+  /// fewer than 65536 packets of a flow are in flight at once.  Must be
+  /// set before the first packet is classified.
+  /// \param tagFree true to enable the tag-free mode
+  void SetTagFree (bool tagFree);
+
+  /// \returns true if the classifier is in tag-free mode
+  bool IsTagFree (void) const;
+
   /// Searches for the FiveTuple corresponding to the given flowId
   /// \param flowId the FlowId to search for
   /// \returns the FiveTuple corresponding to flowId
@@ -73,10 +113,20 @@ public:
 
 private:
 
+  /// \brief build the FiveTuple of a packet
+  /// \return true if the packet can be part of a flow
+  /// \param ipHeader packet's IP header
+  /// \param ipPayload packet's IP payload
+  /// \param tuple the resulting FiveTuple
+  static bool MakeTuple (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
+                         FiveTuple &tuple);
+
   /// Map to Flows Identifiers to FlowIds
-  std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+  std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+  /// Map to FlowIds to FlowPacketId (the last one assigned, in tag-free mode)
+  std::unordered_map<FlowId, FlowPacketId> m_flowPktIdMap;
+  /// Use the IPv4 identification as packet identifier
+  bool m_tagFree;
 
 };
 
@@ -221,6 +221,14 @@ Ipv4FlowProbe::Ipv4FlowProbe (Ptr<FlowMonitor> monitor,
       NS_FATAL_ERROR ("trace fail");
     }
 
+  if (m_classifier->IsTagFree ())
+    {
+      // queue drops only see the L2 frame, which carries no tag to
+      // identify it: such packets are accounted as lost after
+      // MaxPerHopDelay instead
+      return;
+    }
+
   // code copied from point-to-point-helper.cc
   std::ostringstream oss;
   oss << "/NodeList/" << node->GetId () << "/DeviceList/*/TxQueue/Drop";
@@ -252,6 +260,26 @@ Ipv4FlowProbe::DoDispose ()
   FlowProbe::DoDispose ();
 }
 
+bool
+Ipv4FlowProbe::IdentifyPacket (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
+                               FlowId *flowId, FlowPacketId *packetId)
+{
+  if (m_classifier->IsTagFree ())
+    {
+      return m_classifier->Lookup (ipHeader, ipPayload, flowId, packetId)
+             && m_flowMonitor->IsPacketSampled (*flowId, *packetId);
+    }
+
+  Ipv4FlowProbeTag fTag;
+  if (!ipPayload->FindFirstMatchingByteTag (fTag))
+    {
+      return false;
+    }
+  *flowId = fTag.GetFlowId ();
+  *packetId = fTag.GetPacketId ();
+  return true;
+}
+
 void
 Ipv4FlowProbe::SendOutgoingLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload, uint32_t interface)
 {
@@ -266,11 +294,22 @@ Ipv4FlowProbe::SendOutgoingLogger (const Ipv4Header &ipHeader, Ptr<const Packet>
 
   if (m_classifier->Classify (ipHeader, ipPayload, &flowId, &packetId))
     {
+      if (!m_flowMonitor->IsPacketSampled (flowId, packetId))
+        {
+          return;
+        }
+
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
       NS_LOG_DEBUG ("ReportFirstTx ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<"); "
                                      << ipHeader << *ipPayload);
       m_flowMonitor->ReportFirstTx (this, flowId, packetId, size);
 
+      if (m_classifier->IsTagFree ())
+        {
+          // the packet will be identified again from its headers
+          return;
+        }
+
       // tag the packet with the flow id and packet id, so that the packet can be identified even
       // when Ipv4Header is not accessible at some non-IPv4 protocol layer
       Ipv4FlowProbeTag fTag (flowId, packetId, size);
@@ -281,14 +320,11 @@ Ipv4FlowProbe::SendOutgoingLogger (const Ipv4Header &ipHeader, Ptr<const Packet>
 void
 Ipv4FlowProbe::ForwardLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload, uint32_t interface)
 {
-  Ipv4FlowProbeTag fTag;
-  bool found = ipPayload->FindFirstMatchingByteTag (fTag);
+  FlowId flowId;
+  FlowPacketId packetId;
 
-  if (found)
+  if (IdentifyPacket (ipHeader, ipPayload, &flowId, &packetId))
     {
-      FlowId flowId = fTag.GetFlowId ();
-      FlowPacketId packetId = fTag.GetPacketId ();
-
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
       NS_LOG_DEBUG ("ReportForwarding ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<");");
       m_flowMonitor->ReportForwarding (this, flowId, packetId, size);
@@ -298,14 +334,11 @@ Ipv4FlowProbe::ForwardLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
 void
 Ipv4FlowProbe::ForwardUpLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload, uint32_t interface)
 {
-  Ipv4FlowProbeTag fTag;
-  bool found = ipPayload->FindFirstMatchingByteTag (fTag);
+  FlowId flowId;
+  FlowPacketId packetId;
 
-  if (found)
+  if (IdentifyPacket (ipHeader, ipPayload, &flowId, &packetId))
     {
-      FlowId flowId = fTag.GetFlowId ();
-      FlowPacketId packetId = fTag.GetPacketId ();
-
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
       NS_LOG_DEBUG ("ReportLastRx ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<");");
       m_flowMonitor->ReportLastRx (this, flowId, packetId, size);
@@ -334,14 +367,11 @@ Ipv4FlowProbe::DropLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPaylo
     }
 #endif
 
-  Ipv4FlowProbeTag fTag;
-  bool found = ipPayload->FindFirstMatchingByteTag (fTag);
+  FlowId flowId;
+  FlowPacketId packetId;
 
-  if (found)
+  if (IdentifyPacket (ipHeader, ipPayload, &flowId, &packetId))
     {
-      FlowId flowId = fTag.GetFlowId ();
-      FlowPacketId packetId = fTag.GetPacketId ();
-
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
       NS_LOG_DEBUG ("Drop ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<", " << reason 
                             << ", destIp=" << ipHeader.GetDestination () << "); "
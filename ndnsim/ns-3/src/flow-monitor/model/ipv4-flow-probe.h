@@ -82,6 +82,16 @@ protected:
   virtual void DoDispose (void);
 
 private:
+  /// Find the flow and packet identifiers of a packet already seen by
+  /// the SendOutgoing trace, either from its Ipv4FlowProbeTag or, in
+  /// tag-free mode, from its headers
+  /// \param ipHeader IP header
+  /// \param ipPayload IP payload
+  /// \param flowId the packet's FlowId
+  /// \param packetId the packet's identifier
+  /// \returns true if the packet is monitored
+  bool IdentifyPacket (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
+                       FlowId *flowId, FlowPacketId *packetId);
   /// Log a packet being sent
   /// \param ipHeader IP header
   /// \param ipPayload IP payload
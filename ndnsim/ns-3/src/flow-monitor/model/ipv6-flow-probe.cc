@@ -259,6 +259,11 @@ Ipv6FlowProbe::SendOutgoingLogger (const Ipv6Header &ipHeader, Ptr<const Packet>
 
   if (m_classifier->Classify (ipHeader, ipPayload, &flowId, &packetId))
     {
+      if (!m_flowMonitor->IsPacketSampled (flowId, packetId))
+        {
+          return;
+        }
+
       uint32_t size = (ipPayload->GetSize () + ipHeader.GetSerializedSize ());
       NS_LOG_DEBUG ("ReportFirstTx ("<<this<<", "<<flowId<<", "<<packetId<<", "<<size<<"); "
                                      << ipHeader << *ipPayload);
@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+#include <sstream>
+
+using namespace ns3;
+
+/// A probe that lets the test report packet events directly
+class TestFlowProbe : public FlowProbe
+{
+public:
+  TestFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+class FlowMonitorPeriodicExportTestCase : public TestCase
+{
+public:
+  FlowMonitorPeriodicExportTestCase ();
+  virtual void DoRun (void);
+};
+
+FlowMonitorPeriodicExportTestCase::FlowMonitorPeriodicExportTestCase ()
+  : TestCase ("FlowMonitor lost packet detection and periodic export")
+{
+}
+
+void
+FlowMonitorPeriodicExportTestCase::DoRun (void)
+{
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (1)));
+  monitor->StartRightNow ();
+  Ptr<FlowProbe> probe = Create<TestFlowProbe> (monitor);
+
+  std::ostringstream oss;
+  monitor->EnablePeriodicExport (Create<OutputStreamWrapper> (&oss), Seconds (1));
+
+  // flow 1: packet 0 is received, packet 1 never is
+  monitor->ReportFirstTx (probe, 1, 0, 100);
+  monitor->ReportFirstTx (probe, 1, 1, 100);
+  // flow 2: packet 0 is forwarded once and then disappears
+  monitor->ReportFirstTx (probe, 2, 0, 50);
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportLastRx, monitor, probe, 1, 0, 100);
+  Simulator::Schedule (Seconds (0.5), &FlowMonitor::ReportForwarding, monitor, probe, 2, 0, 50);
+
+  Simulator::Stop (Seconds (2.5));
+  Simulator::Run ();
+
+  const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.find (1)->second.rxPackets, 1, "");
+  NS_TEST_EXPECT_MSG_EQ (stats.find (1)->second.lostPackets, 1, "");
+  NS_TEST_EXPECT_MSG_EQ (stats.find (2)->second.lostPackets, 1, "");
+
+  std::string expected =
+    "time,flowId,txPackets,txBytes,rxPackets,rxBytes,lostPackets,delaySum,jitterSum,timesForwarded\n"
+    "1000000000,1,2,200,1,100,1,100000000,0,0\n"
+    "1000000000,2,1,50,0,0,0,0,0,0\n"
+    "2000000000,2,0,0,0,0,1,0,0,0\n";
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), expected, "unexpected periodic export");
+
+  monitor->Dispose ();
+  Simulator::Destroy ();
+}
+
+/// Two UDP flows between the same hosts, through a router, with their
+/// packets interleaved, so that in tag-free mode the IPv4
+/// identifications of each flow are not consecutive.  Check that about
+/// one packet out of PacketSamplingInterval is sampled in each flow, and
+/// that the sampled packets are the same at every hop.
+class FlowMonitorPacketSamplingTestCase : public TestCase
+{
+public:
+  /// \param tagFree whether the IPv4 probes run in tag-free mode
+  FlowMonitorPacketSamplingTestCase (bool tagFree);
+  virtual void DoRun (void);
+
+private:
+  /// \param socket the socket to send a packet with
+  void SendPacket (Ptr<Socket> socket);
+
+  bool m_tagFree; //!< Whether the IPv4 probes run in tag-free mode
+};
+
+FlowMonitorPacketSamplingTestCase::FlowMonitorPacketSamplingTestCase (bool tagFree)
+  : TestCase (std::string ("FlowMonitor packet sampling, ") + (tagFree ? "tag-free" : "tagged") + " IPv4 probes"),
+    m_tagFree (tagFree)
+{
+}
+
+void
+FlowMonitorPacketSamplingTestCase::SendPacket (Ptr<Socket> socket)
+{
+  socket->Send (Create<Packet> (100));
+}
+
+void
+FlowMonitorPacketSamplingTestCase::DoRun (void)
+{
+  const uint32_t packetsPerFlow = 400;
+  const uint32_t interval = 4;
+
+  // source -- router -- sink
+  NodeContainer nodes;
+  nodes.Create (3);
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  NetDeviceContainer first = simple.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  NetDeviceContainer second = simple.Install (NodeContainer (nodes.Get (1), nodes.Get (2)));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (first);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer sinkInterfaces = address.Assign (second);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  FlowMonitorHelper flowmon;
+  flowmon.SetIpv4TagFree (m_tagFree);
+  flowmon.SetMonitorAttribute ("PacketSamplingInterval", UintegerValue (interval));
+  Ptr<FlowMonitor> monitor = flowmon.InstallAll ();
+
+  // port 8 only resolves the ARP entries along the path before the
+  // flows start, none of their packets is then held or dropped by ARP
+  std::vector<Ptr<Socket> > sources;
+  std::vector<Ptr<Socket> > sinks;
+  for (uint16_t port = 8; port <= 10; port++)
+    {
+      Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (2), UdpSocketFactory::GetTypeId ());
+      sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinks.push_back (sink);
+      Ptr<Socket> source = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+      source->Bind ();
+      source->Connect (InetSocketAddress (sinkInterfaces.GetAddress (1), port));
+      sources.push_back (source);
+    }
+  Simulator::Schedule (Seconds (0.5), &FlowMonitorPacketSamplingTestCase::SendPacket, this, sources[0]);
+  for (uint32_t i = 0; i < 2 * packetsPerFlow; i++)
+    {
+      Simulator::Schedule (Seconds (1) + MilliSeconds (i), &FlowMonitorPacketSamplingTestCase::SendPacket,
+                           this, sources[1 + i % 2]);
+    }
+
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+
+  monitor->CheckForLostPackets ();
+  Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowmon.GetClassifier ());
+  const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+  uint32_t flows = 0;
+  for (FlowMonitor::FlowStatsContainerCI i = stats.begin (); i != stats.end (); i++)
+    {
+      uint16_t port = classifier->FindFlow (i->first).destinationPort;
+      if (port == 8)
+        {
+          continue;
+        }
+      flows++;
+      // a binomial variable with mean 100 and standard deviation below 9
+      NS_TEST_EXPECT_MSG_GT (i->second.txPackets, packetsPerFlow / interval - 30,
+                             "too few packets sampled in the flow to port " << port);
+      NS_TEST_EXPECT_MSG_LT (i->second.txPackets, packetsPerFlow / interval + 30,
+                             "too many packets sampled in the flow to port " << port);
+      NS_TEST_EXPECT_MSG_EQ (i->second.rxPackets, i->second.txPackets,
+                             "the packets sampled at the source and at the sink differ, port " << port);
+      NS_TEST_EXPECT_MSG_EQ (i->second.timesForwarded, i->second.txPackets,
+                             "the packets sampled at the source and at the router differ, port " << port);
+      NS_TEST_EXPECT_MSG_EQ (i->second.lostPackets, 0, "sampled packets lost in the flow to port " << port);
+    }
+  NS_TEST_EXPECT_MSG_EQ (flows, 2, "expected a flow to each of ports 9 and 10");
+
+  for (uint32_t i = 0; i < sources.size (); i++)
+    {
+      sources[i]->Close ();
+      sinks[i]->Close ();
+    }
+  Simulator::Destroy ();
+}
+
+static class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ()
+    : TestSuite ("flow-monitor", UNIT)
+  {
+    AddTestCase (new FlowMonitorPeriodicExportTestCase (), TestCase::QUICK);
+    AddTestCase (new FlowMonitorPacketSamplingTestCase (false), TestCase::QUICK);
+    AddTestCase (new FlowMonitorPacketSamplingTestCase (true), TestCase::QUICK);
+  }
+} g_flowMonitorTestSuite;
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/packet.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+static Ptr<Packet>
+MakeUdpPayload (uint16_t sourcePort, uint16_t destinationPort)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  UdpHeader udp;
+  udp.SetSourcePort (sourcePort);
+  udp.SetDestinationPort (destinationPort);
+  p->AddHeader (udp);
+  return p;
+}
+
+static Ipv4Header
+MakeIpv4Header (const char *source, const char *destination, uint16_t identification)
+{
+  Ipv4Header ip;
+  ip.SetSource (Ipv4Address (source));
+  ip.SetDestination (Ipv4Address (destination));
+  ip.SetProtocol (17);
+  ip.SetIdentification (identification);
+  return ip;
+}
+
+class Ipv4FlowClassifierTestCase : public TestCase
+{
+public:
+  Ipv4FlowClassifierTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4FlowClassifierTestCase::Ipv4FlowClassifierTestCase ()
+  : TestCase ("Ipv4FlowClassifier assigns flow and packet ids")
+{
+}
+
+void
+Ipv4FlowClassifierTestCase::DoRun (void)
+{
+  Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+  FlowId flowA, flowB;
+  FlowPacketId packetId;
+
+  Ipv4Header ipA = MakeIpv4Header ("10.0.0.1", "10.0.0.2", 7);
+  Ipv4Header ipB = MakeIpv4Header ("10.0.0.2", "10.0.0.1", 7);
+
+  NS_TEST_ASSERT_MSG_EQ (classifier->Classify (ipA, MakeUdpPayload (1000, 2000), &flowA, &packetId), true, "");
+  NS_TEST_EXPECT_MSG_EQ (packetId, 0, "first packet of a flow has id 0");
+  NS_TEST_ASSERT_MSG_EQ (classifier->Classify (ipB, MakeUdpPayload (2000, 1000), &flowB, &packetId), true, "");
+  NS_TEST_EXPECT_MSG_NE (flowA, flowB, "reverse direction is a different flow");
+
+  FlowId flow;
+  for (uint32_t i = 1; i <= 5; i++)
+    {
+      classifier->Classify (ipA, MakeUdpPayload (1000, 2000), &flow, &packetId);
+      NS_TEST_EXPECT_MSG_EQ (flow, flowA, "");
+      NS_TEST_EXPECT_MSG_EQ (packetId, i, "packet ids are sequential within a flow");
+    }
+
+  Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (flowB);
+  NS_TEST_EXPECT_MSG_EQ (t.sourceAddress, Ipv4Address ("10.0.0.2"), "");
+  NS_TEST_EXPECT_MSG_EQ (t.sourcePort, 2000, "");
+  NS_TEST_EXPECT_MSG_EQ (t.destinationPort, 1000, "");
+
+  Ipv4Header icmp = ipA;
+  icmp.SetProtocol (1);
+  NS_TEST_EXPECT_MSG_EQ (classifier->Classify (icmp, MakeUdpPayload (1000, 2000), &flow, &packetId), false,
+                         "only TCP and UDP are classified");
+}
+
+class Ipv4FlowClassifierTagFreeTestCase : public TestCase
+{
+public:
+  Ipv4FlowClassifierTagFreeTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4FlowClassifierTagFreeTestCase::Ipv4FlowClassifierTagFreeTestCase ()
+  : TestCase ("Ipv4FlowClassifier tag-free identification")
+{
+}
+
+void
+Ipv4FlowClassifierTagFreeTestCase::DoRun (void)
+{
+  Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+  classifier->SetTagFree (true);
+  FlowId flow, found;
+  FlowPacketId packetId, foundPacketId;
+
+  Ipv4Header ip = MakeIpv4Header ("10.1.0.1", "10.2.0.1", 4321);
+  NS_TEST_EXPECT_MSG_EQ (classifier->Lookup (ip, MakeUdpPayload (9, 9), &found, &foundPacketId), false,
+                         "unknown flows are not found");
+
+  NS_TEST_ASSERT_MSG_EQ (classifier->Classify (ip, MakeUdpPayload (9, 9), &flow, &packetId), true, "");
+  NS_TEST_EXPECT_MSG_EQ (packetId, 4321, "packet id is the IPv4 identification");
+
+  // a later hop sees the same headers, possibly with a different TTL
+  ip.SetTtl (12);
+  NS_TEST_ASSERT_MSG_EQ (classifier->Lookup (ip, MakeUdpPayload (9, 9), &found, &foundPacketId), true, "");
+  NS_TEST_EXPECT_MSG_EQ (found, flow, "");
+  NS_TEST_EXPECT_MSG_EQ (foundPacketId, packetId, "");
+
+  // the identification wraps around while packets are in flight
+  Ipv4Header last = MakeIpv4Header ("10.1.0.1", "10.2.0.1", 65535);
+  Ipv4Header wrapped = MakeIpv4Header ("10.1.0.1", "10.2.0.1", 1);
+  FlowPacketId lastId, wrappedId;
+  classifier->Classify (last, MakeUdpPayload (9, 9), &flow, &lastId);
+  classifier->Classify (wrapped, MakeUdpPayload (9, 9), &flow, &wrappedId);
+  NS_TEST_EXPECT_MSG_NE (wrappedId, 1, "the packet id of a wrapped identification is not reused");
+  NS_TEST_EXPECT_MSG_NE (wrappedId, lastId, "");
+  NS_TEST_ASSERT_MSG_EQ (classifier->Lookup (last, MakeUdpPayload (9, 9), &found, &foundPacketId), true, "");
+  NS_TEST_EXPECT_MSG_EQ (foundPacketId, lastId, "a packet sent before the wrap-around is still found");
+  NS_TEST_ASSERT_MSG_EQ (classifier->Lookup (wrapped, MakeUdpPayload (9, 9), &found, &foundPacketId), true, "");
+  NS_TEST_EXPECT_MSG_EQ (foundPacketId, wrappedId, "");
+}
+
+static class Ipv4FlowClassifierTestSuite : public TestSuite
+{
+public:
+  Ipv4FlowClassifierTestSuite ()
+    : TestSuite ("ipv4-flow-classifier", UNIT)
+  {
+    AddTestCase (new Ipv4FlowClassifierTestCase (), TestCase::QUICK);
+    AddTestCase (new Ipv4FlowClassifierTagFreeTestCase (), TestCase::QUICK);
+  }
+} g_ipv4FlowClassifierTestSuite;
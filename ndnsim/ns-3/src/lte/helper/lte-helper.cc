@@ -200,6 +200,15 @@ TypeId LteHelper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteHelper::m_usePdschForCqiGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("UseSubframeAbstraction",
+                   "If true, the eNBs send each DL subframe as a single signal "
+                   "carrying both the control and the data, and the UEs deliver "
+                   "the control messages sent without data directly to their eNB, "
+                   "which saves simulation events. It sets the SubframeAbstraction "
+                   "attribute of the LteEnbPhy and LteUePhy installed.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteHelper::m_useSubframeAbstraction),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -210,6 +219,7 @@ LteHelper::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_downlinkChannel = 0;
   m_uplinkChannel = 0;
+  m_enbPhys.clear ();
   Object::DoDispose ();
 }
 
@@ -419,6 +429,11 @@ LteHelper::InstallSingleEnbDevice (Ptr<Node> n)
   Ptr<LteSpectrumPhy> ulPhy = CreateObject<LteSpectrumPhy> ();
 
   Ptr<LteEnbPhy> phy = CreateObject<LteEnbPhy> (dlPhy, ulPhy);
+  phy->SetAttribute ("SubframeAbstraction", BooleanValue (m_useSubframeAbstraction));
+  if (m_useSubframeAbstraction)
+    {
+      m_enbPhys[cellId] = phy;
+    }
 
   Ptr<LteHarqPhy> harq = Create<LteHarqPhy> ();
   dlPhy->SetHarqPhyModule (harq);
@@ -588,6 +603,11 @@ LteHelper::InstallSingleUeDevice (Ptr<Node> n)
   Ptr<LteSpectrumPhy> ulPhy = CreateObject<LteSpectrumPhy> ();
 
   Ptr<LteUePhy> phy = CreateObject<LteUePhy> (dlPhy, ulPhy);
+  phy->SetAttribute ("SubframeAbstraction", BooleanValue (m_useSubframeAbstraction));
+  if (m_useSubframeAbstraction)
+    {
+      phy->SetEnbPhyLookupCallback (MakeCallback (&LteHelper::GetEnbPhy, this));
+    }
 
   Ptr<LteHarqPhy> harq = Create<LteHarqPhy> ();
   dlPhy->SetHarqPhyModule (harq);
@@ -1041,6 +1061,17 @@ LteHelper::DoDeActivateDedicatedEpsBearer (Ptr<NetDevice> ueDevice, Ptr<NetDevic
   enbRrc->DoSendReleaseDataRadioBearer (imsi,rnti,bearerId);
 }
 
+Ptr<LteEnbPhy>
+LteHelper::GetEnbPhy (uint16_t cellId) const
+{
+  std::map<uint16_t, Ptr<LteEnbPhy> >::const_iterator it = m_enbPhys.find (cellId);
+  if (it == m_enbPhys.end ())
+    {
+      return 0;
+    }
+  return it->second;
+}
+
 
 void 
 LteHelper::ActivateDataRadioBearer (NetDeviceContainer ueDevices, EpsBearer bearer)
@@ -38,6 +38,8 @@
 #include <ns3/epc-tft.h>
 #include <ns3/mobility-model.h>
 
+#include <map>
+
 namespace ns3 {
 
 
@@ -637,6 +639,14 @@ private:
    */
   void DoDeActivateDedicatedEpsBearer (Ptr<NetDevice> ueDevice, Ptr<NetDevice> enbDevice, uint8_t bearerId);
 
+  /**
+   * \param cellId the cell ID of an eNodeB installed by this helper
+   * \return the PHY of the eNodeB, or 0 if the cell ID is unknown
+   *
+   * Given to the UE PHYs, which need it with the subframe abstraction.
+   */
+  Ptr<LteEnbPhy> GetEnbPhy (uint16_t cellId) const;
+
 
   /// The downlink LTE channel used in the simulation.
   Ptr<SpectrumChannel> m_downlinkChannel;
@@ -731,6 +741,13 @@ private:
    * DL-CQI will be calculated from PDCCH as signal and PDCCH as interference.
    */
   bool m_usePdschForCqiGeneration;
+  /**
+   * The `UseSubframeAbstraction` attribute. If true, the PHYs installed
+   * abstract the timing of the control and data portions of the subframes.
+   */
+  bool m_useSubframeAbstraction;
+  /// The PHYs of the eNodeBs installed with the subframe abstraction, by cell ID
+  std::map<uint16_t, Ptr<LteEnbPhy> > m_enbPhys;
 
 }; // end of `class LteHelper`
 
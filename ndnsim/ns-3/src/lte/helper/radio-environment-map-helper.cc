@@ -40,6 +40,7 @@
 
 #include <fstream>
 #include <limits>
+#include <vector>
 
 namespace ns3 {
 
@@ -48,6 +49,7 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_directComputation (false)
 {
 }
 
@@ -62,6 +64,7 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_capturePhy = 0;
 }
 
 TypeId
@@ -144,6 +147,14 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("DirectComputation",
+                   "If true, the signals transmitted are recorded once, and the SINR of every point "
+                   "of the map is computed directly from them, without deploying listeners and running "
+                   "the simulation for each batch of MaxPointsPerIteration points. "
+                   "The map is the same, provided the losses do not change with time (e.g. no fading)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_directComputation),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -220,12 +231,26 @@ RadioEnvironmentMapHelper::DelayedInstall ()
   NS_LOG_FUNCTION (this);
   m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
   m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
-  
+
   if ((double)m_xRes * (double) m_yRes < (double) m_maxPointsPerIteration)
     {
       m_maxPointsPerIteration = m_xRes * m_yRes;
     }
-  
+
+  if (m_directComputation)
+    {
+      // record the signals transmitted while the listeners of the first
+      // iteration would receive them; without a position, the capture
+      // listener gets them without any loss
+      m_capturePhy = CreateObject<RemSpectrumPhy> ();
+      m_capturePhy->SetRxSpectrumModel (LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth));
+      m_capturePhy->SetUseDataChannel (m_useDataChannel);
+      m_capturePhy->SetRecordSignals (true);
+      m_channel->AddRx (m_capturePhy);
+      Simulator::Schedule (Seconds (0.0006), &RadioEnvironmentMapHelper::ComputeDirectly, this);
+      return;
+    }
+
   for (uint32_t i = 0; i < m_maxPointsPerIteration; ++i)
     {
       RemPoint p;
@@ -340,6 +365,72 @@ RadioEnvironmentMapHelper::PrintAndReset ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::ComputeDirectly ()
+{
+  NS_LOG_FUNCTION (this);
+  m_capturePhy->Deactivate ();
+  const std::vector<Ptr<SpectrumSignalParameters> > &signals = m_capturePhy->GetRecordedSignals ();
+  NS_LOG_LOGIC (signals.size () << " signals recorded");
+
+  // the loss models may keep state per pair of mobility models, such as
+  // the shadowing of BuildingsPropagationLossModel: as with the
+  // iterations, the n-th point of the map uses the n-th mobility model of
+  // a pool of MaxPointsPerIteration ones, modulo the size of the pool
+  std::vector<Ptr<MobilityModel> > mobilities;
+  for (uint32_t i = 0; i < m_maxPointsPerIteration; ++i)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+      mobility->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+      mobilities.push_back (mobility);
+    }
+
+  RemPoint p;
+  p.phy = CreateObject<RemSpectrumPhy> ();
+  p.bmm = mobilities.front ();
+  p.phy->SetRxSpectrumModel (LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth));
+  p.phy->SetMobility (p.bmm);
+  p.phy->SetUseDataChannel (m_useDataChannel);
+  p.phy->SetRbId (m_rbId);
+  m_channel->AddRx (p.phy);
+  // the listener only receives the signals computed below
+  p.phy->Deactivate ();
+  m_rem.push_back (p);
+
+  // same points, in the same order, as with the iterations
+  uint32_t pointIndex = 0;
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      for (double y = m_yMin; y < m_yMax + 0.5*m_yStep ; y += m_yStep)
+        {
+          p.bmm = mobilities[pointIndex++ % m_maxPointsPerIteration];
+          p.phy->SetMobility (p.bmm);
+          p.bmm->SetPosition (Vector (x, y, m_z));
+          BuildingsHelper::MakeConsistent (p.bmm);
+          for (std::vector<Ptr<SpectrumSignalParameters> >::const_iterator it = signals.begin ();
+               it != signals.end ();
+               ++it)
+            {
+              Ptr<SpectrumValue> rxPsd = m_channel->GetRxPowerSpectralDensity (*it, p.phy);
+              if (rxPsd != 0)
+                {
+                  p.phy->AddSignal (*rxPsd);
+                }
+            }
+          m_outFile << x << "\t"
+                    << y << "\t"
+                    << m_z << "\t"
+                    << p.phy->GetSinr (m_noisePower)
+                    << "\n";
+          p.phy->Reset ();
+        }
+    }
+
+  m_capturePhy->Reset ();
+  Finalize ();
+}
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
@@ -105,6 +105,17 @@ private:
   /// Go through every listener, write the computed SINR, and then reset it.
   void PrintAndReset ();
 
+  /**
+   * Compute the whole map at once from the signals received by m_capturePhy,
+   * instead of running one iteration per batch of listeners. A single
+   * listener is moved from point to point, and the channel computes the
+   * signals it would receive. Like the listeners of the iterations, it
+   * takes the mobility models of a pool of MaxPointsPerIteration ones in
+   * turn, so that the losses drawn per pair of mobility models, such as
+   * the shadowing, are not shared by all the points.
+   */
+  void ComputeDirectly ();
+
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
@@ -152,6 +163,10 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_directComputation;  ///< The `DirectComputation` attribute.
+  /// Listener without position recording the signals transmitted, in direct computation.
+  Ptr<RemSpectrumPhy> m_capturePhy;
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
@@ -516,18 +516,15 @@ FdBetFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  // the LCs of the UE are contiguous, starting from the smallest LC id
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0)); (it != m_rlcBufferReq.end ()) && ((*it).first.m_rnti == rnti); it++)
     {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
         {
           lcActive++;
         }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
     }
   return (lcActive);
 
@@ -505,18 +505,15 @@ FdMtFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  // the LCs of the UE are contiguous, starting from the smallest LC id
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0)); (it != m_rlcBufferReq.end ()) && ((*it).first.m_rnti == rnti); it++)
     {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
         {
           lcActive++;
         }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
     }
   return (lcActive);
 
@@ -1011,114 +1008,114 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
 
 
 
-  for (int i = 0; i < rbgNum; i++)
+  // evaluate the metric of every UE on every free RBG, and then give each
+  // RBG to the UE with the best metric
+  m_ueTable.Reset (rbgNum);
+  m_ueTable.SetRbgRates (m_amc, rbgSize);
+  std::set <uint16_t>::iterator it;
+  for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
     {
-      NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
-      if (rbgMap.at (i) == false)
+      m_ueTable.AddUe ((*it));
+    }
+  m_ueTable.CountActiveLcs (m_rlcBufferReq);
+  it = m_flowStatsDl.begin ();
+  for (uint32_t ue = 0; ue < m_ueTable.GetNUes (); ue++, it++)
+    {
+      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it));
+      if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it))))
         {
-          std::set <uint16_t>::iterator it;
-          std::set <uint16_t>::iterator itMax = m_flowStatsDl.end ();
-          double rcqiMax = 0.0;
-          for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+          // UE already allocated for HARQ or without HARQ process available -> drop it
+          if (itRnti != rntiAllocated.end ())
             {
-              std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it));
-              if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it))))
-                {
-                  // UE already allocated for HARQ or without HARQ process available -> drop it
-                  if (itRnti != rntiAllocated.end ())
-                  {
-                    NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it));
-                  }
-                  if (!HarqProcessAvailability ((*it)))
-                  {
-                    NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it));
-                  }
-                  continue;
-                }
+              NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it));
+            }
+          if (!HarqProcessAvailability ((*it)))
+            {
+              NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it));
+            }
+          continue;
+        }
+      if (m_ueTable.GetActiveLcs (ue) == 0)
+        {
+          // this UE has no data to transmit
+          continue;
+        }
+      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+      itCqi = m_a30CqiRxed.find ((*it));
+      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      itTxMode = m_uesTxMode.find ((*it));
+      if (itTxMode == m_uesTxMode.end ())
+        {
+          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it));
+        }
+      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+      std::vector <uint8_t> noCqi (nLayer, 1);  // start with lowest value
+      for (int i = 0; i < rbgNum; i++)
+        {
+          if (rbgMap.at (i) == true)
+            {
+              continue;
+            }
+          const std::vector <uint8_t> &sbCqi = (itCqi == m_a30CqiRxed.end ()) ? noCqi : (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
+          uint8_t cqi1 = sbCqi.at (0);
+          uint8_t cqi2 = 1;
+          if (sbCqi.size () > 1)
+            {
+              cqi2 = sbCqi.at (1);
+            }
 
-              std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-              itCqi = m_a30CqiRxed.find ((*it));
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
-              itTxMode = m_uesTxMode.find ((*it));
-              if (itTxMode == m_uesTxMode.end ())
-                {
-                  NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it));
-                }
-              int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
+          if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+            {
+              double achievableRate = 0.0;
+              for (uint8_t k = 0; k < nLayer; k++)
                 {
-                  for (uint8_t k = 0; k < nLayer; k++)
+                  if (sbCqi.size () > k)
                     {
-                      sbCqi.push_back (1);  // start with lowest value
+                      achievableRate += m_ueTable.GetRbgRate (sbCqi.at (k));
                     }
-                }
-              else
-                {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                }
-              uint8_t cqi1 = sbCqi.at (0);
-              uint8_t cqi2 = 1;
-              if (sbCqi.size () > 1)
-                {
-                  cqi2 = sbCqi.at (1);
-                }
-              if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-                {
-                  if (LcActivePerFlow ((*it)) > 0)
+                  else
                     {
-                      // this UE has data to transmit
-                      double achievableRate = 0.0;
-                      uint8_t mcs = 0;
-                      for (uint8_t k = 0; k < nLayer; k++)
-                        {
-                          if (sbCqi.size () > k)
-                            {
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (k));
-                            }
-                          else
-                            {
-                              // no info on this subband -> worst MCS
-                              mcs = 0;
-                            }
-                          achievableRate += ((m_amc->GetTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
-                        }
-
-                      double rcqi = achievableRate;
-                      NS_LOG_INFO (this << " RNTI " << (*it) << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " RCQI " << rcqi);
-
-                      if (rcqi > rcqiMax)
-                        {
-                          rcqiMax = rcqi;
-                          itMax = it;
-                        }
+                      // no info on this subband -> worst MCS
+                      achievableRate += m_ueTable.GetLowestRbgRate ();
                     }
-                }   // end if cqi
-              
-            } // end for m_rlcBufferReq
+                }
 
-          if (itMax == m_flowStatsDl.end ())
+              double rcqi = achievableRate;
+              NS_LOG_INFO (this << " RNTI " << (*it) << " RBG " << i << " achievableRate " << achievableRate << " RCQI " << rcqi);
+              m_ueTable.SetMetric (i, ue, rcqi);
+            }   // end if cqi
+        }
+    }
+
+  for (int i = 0; i < rbgNum; i++)
+    {
+      NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
+      if (rbgMap.at (i) == false)
+        {
+          int32_t ueMax = m_ueTable.GetBestUe (i);
+          if (ueMax == -1)
             {
               // no UE available for this RB
               NS_LOG_INFO (this << " any UE found");
             }
           else
             {
+              uint16_t rntiMax = m_ueTable.GetRnti (ueMax);
               rbgMap.at (i) = true;
               std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-              itMap = allocationMap.find ((*itMax));
+              itMap = allocationMap.find (rntiMax);
               if (itMap == allocationMap.end ())
                 {
                   // insert new element
                   std::vector <uint16_t> tempMap;
                   tempMap.push_back (i);
-                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > ((*itMax), tempMap));
+                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > (rntiMax, tempMap));
                 }
               else
                 {
                   (*itMap).second.push_back (i);
                 }
-              NS_LOG_INFO (this << " UE assigned " << (*itMax));
+              NS_LOG_INFO (this << " UE assigned " << rntiMax);
             }
         } // end for RBG free
     } // end for RBGs
@@ -32,6 +32,7 @@
 #include <ns3/nstime.h>
 #include <ns3/lte-amc.h>
 #include <ns3/lte-ffr-sap.h>
+#include <ns3/ff-mac-ue-table.h>
 
 // value for SINR outside the range defined by FF-API, used to indicate that there
 // is no CQI for this element
@@ -175,6 +176,11 @@ private:
 
   Ptr<LteAmc> m_amc;
 
+  /*
+  * Dense table of the UEs used for the DL allocation of a TTI
+  */
+  FfMacUeTable m_ueTable;
+
   /*
    * Vectors of UE's LC info
   */
@@ -563,18 +563,15 @@ FdTbfqFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  // the LCs of the UE are contiguous, starting from the smallest LC id
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0)); (it != m_rlcBufferReq.end ()) && ((*it).first.m_rnti == rnti); it++)
     {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
         {
           lcActive++;
         }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
     }
   return (lcActive);
 
@@ -1222,10 +1219,10 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
 	        uint32_t rlcBufSize = 0;
           uint8_t lcid = 0;
           std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlcBuf;
-          for (itRlcBuf = m_rlcBufferReq.begin (); itRlcBuf != m_rlcBufferReq.end (); itRlcBuf++)
+          // the LCs of the UE are contiguous: take the last one
+          for (itRlcBuf = m_rlcBufferReq.lower_bound (LteFlowId_t ((*itMax).first, 0)); (itRlcBuf != m_rlcBufferReq.end ()) && ((*itRlcBuf).first.m_rnti == (*itMax).first); itRlcBuf++)
 	          {
-              if ( (*itRlcBuf).first.m_rnti == (*itMax).first )
-                lcid = (*itRlcBuf).first.m_lcId;
+              lcid = (*itRlcBuf).first.m_lcId;
 	          }
           LteFlowId_t flow ((*itMax).first, lcid);
           itRlcBuf = m_rlcBufferReq.find (flow);
@@ -0,0 +1,158 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/ff-mac-ue-table.h>
+#include <ns3/lte-amc.h>
+#include <ns3/log.h>
+#include <ns3/assert.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FfMacUeTable");
+
+FfMacUeTable::FfMacUeTable ()
+  : m_rbgNum (0),
+    m_metricsValid (false),
+    m_lowestRbgRate (0)
+{
+}
+
+void
+FfMacUeTable::Reset (uint16_t rbgNum)
+{
+  NS_LOG_FUNCTION (this << rbgNum);
+  m_rbgNum = rbgNum;
+  m_rnti.clear ();
+  m_activeLcs.clear ();
+  m_metricsValid = false;
+}
+
+uint32_t
+FfMacUeTable::AddUe (uint16_t rnti)
+{
+  NS_ASSERT_MSG (m_rnti.empty () || m_rnti.back () < rnti, "UEs must be added in increasing RNTI order");
+  NS_ASSERT_MSG (!m_metricsValid, "UEs must be added before the metrics are set");
+  m_rnti.push_back (rnti);
+  m_activeLcs.push_back (0);
+  return m_rnti.size () - 1;
+}
+
+uint32_t
+FfMacUeTable::GetNUes () const
+{
+  return m_rnti.size ();
+}
+
+uint16_t
+FfMacUeTable::GetRnti (uint32_t ue) const
+{
+  return m_rnti[ue];
+}
+
+void
+FfMacUeTable::CountActiveLcs (const std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>& rlcBufferReq)
+{
+  NS_LOG_FUNCTION (this);
+  // both the LCs and the UEs are sorted by RNTI
+  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::const_iterator it = rlcBufferReq.begin ();
+  for (uint32_t ue = 0; ue < m_rnti.size (); ue++)
+    {
+      m_activeLcs[ue] = 0;
+      while (it != rlcBufferReq.end () && (*it).first.m_rnti < m_rnti[ue])
+        {
+          it++;
+        }
+      while (it != rlcBufferReq.end () && (*it).first.m_rnti == m_rnti[ue])
+        {
+          if (((*it).second.m_rlcTransmissionQueueSize > 0)
+              || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+              || ((*it).second.m_rlcStatusPduSize > 0))
+            {
+              m_activeLcs[ue]++;
+            }
+          it++;
+        }
+    }
+}
+
+uint16_t
+FfMacUeTable::GetActiveLcs (uint32_t ue) const
+{
+  return m_activeLcs[ue];
+}
+
+void
+FfMacUeTable::SetMetric (uint16_t rbg, uint32_t ue, double metric)
+{
+  NS_ASSERT (rbg < m_rbgNum && ue < m_rnti.size ());
+  if (!m_metricsValid)
+    {
+      m_metrics.assign ((size_t)m_rbgNum * m_rnti.size (), 0.0);
+      m_metricsValid = true;
+    }
+  m_metrics[(size_t)rbg * m_rnti.size () + ue] = metric;
+}
+
+int32_t
+FfMacUeTable::GetBestUe (uint16_t rbg) const
+{
+  NS_ASSERT (rbg < m_rbgNum);
+  if (!m_metricsValid)
+    {
+      return -1;
+    }
+  uint32_t nUes = m_rnti.size ();
+  const double *metrics = &m_metrics[(size_t)rbg * nUes];
+  int32_t best = -1;
+  double bestMetric = 0.0;
+  for (uint32_t ue = 0; ue < nUes; ue++)
+    {
+      if (metrics[ue] > bestMetric)
+        {
+          bestMetric = metrics[ue];
+          best = ue;
+        }
+    }
+  return best;
+}
+
+void
+FfMacUeTable::SetRbgRates (Ptr<LteAmc> amc, int rbgSize)
+{
+  NS_LOG_FUNCTION (this << rbgSize);
+  m_rbgRates.resize (16);
+  for (int cqi = 0; cqi < 16; cqi++)
+    {
+      int mcs = amc->GetMcsFromCqi (cqi);
+      m_rbgRates[cqi] = ((amc->GetTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
+    }
+  m_lowestRbgRate = ((amc->GetTbSizeFromMcs (0, rbgSize) / 8) / 0.001);
+}
+
+double
+FfMacUeTable::GetRbgRate (uint8_t cqi) const
+{
+  NS_ASSERT_MSG (cqi < m_rbgRates.size (), "CQI must be in [0..15] = " << (uint16_t) cqi);
+  return m_rbgRates[cqi];
+}
+
+double
+FfMacUeTable::GetLowestRbgRate () const
+{
+  return m_lowestRbgRate;
+}
+
+} // namespace ns3
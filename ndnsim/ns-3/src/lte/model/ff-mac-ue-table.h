@@ -0,0 +1,142 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_UE_TABLE_H
+#define FF_MAC_UE_TABLE_H
+
+#include <ns3/lte-common.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class LteAmc;
+
+/**
+ * \ingroup ff-api
+ * \brief Dense per-TTI table of the UEs of a scheduler
+ *
+ * The schedulers keep the state of the UEs in maps indexed by RNTI, which
+ * are costly to look up for every UE and every RBG of a TTI. At the
+ * beginning of the DL allocation, a scheduler adds its candidate UEs to
+ * this table, in increasing RNTI order, and then works with their index:
+ * the number of active LCs of all the UEs is counted in a single pass
+ * over the RLC buffers, the metric of each UE on each RBG is stored in a
+ * contiguous row per RBG, and the RBGs are allocated by a search of the
+ * largest metric of their row.
+ */
+class FfMacUeTable
+{
+public:
+  FfMacUeTable ();
+
+  /**
+   * Forget the UEs of the previous TTI
+   *
+   * \param rbgNum the number of RBGs of the TTI
+   */
+  void Reset (uint16_t rbgNum);
+
+  /**
+   * Add a UE; the UEs must be added in increasing RNTI order, before the
+   * first call to CountActiveLcs or SetMetric
+   *
+   * \param rnti the RNTI of the UE
+   * \return the index of the UE
+   */
+  uint32_t AddUe (uint16_t rnti);
+
+  /**
+   * \return the number of UEs in the table
+   */
+  uint32_t GetNUes () const;
+
+  /**
+   * \param ue the index of a UE
+   * \return the RNTI of the UE
+   */
+  uint16_t GetRnti (uint32_t ue) const;
+
+  /**
+   * Count the active LCs of every UE, i.e., the LCs with data to transmit,
+   * in a single pass over the RLC buffer status of the scheduler
+   *
+   * \param rlcBufferReq the RLC buffer status of the LCs
+   */
+  void CountActiveLcs (const std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>& rlcBufferReq);
+
+  /**
+   * \param ue the index of a UE
+   * \return the number of active LCs of the UE, as counted by CountActiveLcs
+   */
+  uint16_t GetActiveLcs (uint32_t ue) const;
+
+  /**
+   * Set the metric of a UE on an RBG; the metrics not set are 0
+   *
+   * \param rbg the RBG
+   * \param ue the index of the UE
+   * \param metric the metric; the UEs with a metric not greater than 0
+   * never get the RBG
+   */
+  void SetMetric (uint16_t rbg, uint32_t ue, double metric);
+
+  /**
+   * Find the UE which should get an RBG
+   *
+   * \param rbg the RBG
+   * \return the index of the UE with the largest metric on the RBG (the
+   * first one, if several UEs have it), or -1 if no metric is greater than 0
+   */
+  int32_t GetBestUe (uint16_t rbg) const;
+
+  /**
+   * Compute the rate of an RBG for each CQI, to avoid looking up the AMC
+   * tables for each UE and RBG
+   *
+   * \param amc the AMC module of the scheduler
+   * \param rbgSize the number of RBs in an RBG
+   */
+  void SetRbgRates (Ptr<LteAmc> amc, int rbgSize);
+
+  /**
+   * \param cqi a CQI
+   * \return the achievable rate (bytes/s) of an RBG with this CQI, on one
+   * layer
+   */
+  double GetRbgRate (uint8_t cqi) const;
+
+  /**
+   * \return the achievable rate (bytes/s) of an RBG with the lowest MCS, on
+   * one layer
+   */
+  double GetLowestRbgRate () const;
+
+private:
+  uint16_t m_rbgNum;                 ///< number of RBGs
+  std::vector<uint16_t> m_rnti;      ///< RNTI of each UE
+  std::vector<uint16_t> m_activeLcs; ///< active LCs of each UE
+  std::vector<double> m_metrics;     ///< metrics of the UEs, RBG after RBG
+  bool m_metricsValid;               ///< whether m_metrics is sized for the UEs
+  std::vector<double> m_rbgRates;    ///< rate of an RBG for each CQI
+  double m_lowestRbgRate;            ///< rate of an RBG with MCS 0
+};
+
+
+} // namespace ns3
+
+#endif /* FF_MAC_UE_TABLE_H */
@@ -26,6 +26,7 @@
 #include <ns3/simulator.h>
 #include <ns3/attribute-accessor-helper.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 
 
 #include "lte-enb-phy.h"
@@ -66,6 +67,14 @@ static const Time DL_DATA_DURATION = NanoSeconds (785714 -1);
  */
 static const Time DL_CTRL_DELAY_FROM_SUBFRAME_START = NanoSeconds (214286);
 
+/**
+ * Duration of a whole DL subframe, when the control and the data portions
+ * are sent as a single signal.
+ * Equals to "TTI length - margin".
+ * 1 nanosecond margin is added to avoid overlapping simulator events.
+ */
+static const Time DL_SUBFRAME_DURATION = NanoSeconds (1000000 - 1);
+
 ////////////////////////////////////////
 // member SAP forwarders
 ////////////////////////////////////////
@@ -145,7 +154,8 @@ LteEnbPhy::LteEnbPhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_srsPeriodicity (0),
     m_srsStartTime (Seconds (0)),
     m_currentSrsOffset (0),
-    m_interferenceSampleCounter (0)
+    m_interferenceSampleCounter (0),
+    m_subframeAbstraction (false)
 {
   m_enbPhySapProvider = new EnbMemberLteEnbPhySapProvider (this);
   m_enbCphySapProvider = new MemberLteEnbCphySapProvider<LteEnbPhy> (this);
@@ -191,6 +201,16 @@ LteEnbPhy::GetTypeId (void)
                    MakeUintegerAccessor (&LteEnbPhy::SetMacChDelay, 
                                          &LteEnbPhy::GetMacChDelay),
                    MakeUintegerChecker<uint8_t> ())
+    .AddAttribute ("SubframeAbstraction",
+                   "If true, the control and the data portions of each DL "
+                   "subframe are sent as a single signal lasting the whole "
+                   "subframe, whose control messages are delivered at the "
+                   "end of the subframe. This saves simulation events "
+                   "at the price of the intra-subframe timing. All the "
+                   "eNBs sharing a channel should use the same value.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteEnbPhy::m_subframeAbstraction),
+                   MakeBooleanChecker ())
     .AddTraceSource ("ReportUeSinr",
                      "Report UEs' averaged linear SINR",
                      MakeTraceSourceAccessor (&LteEnbPhy::m_reportUeSinr),
@@ -478,7 +498,8 @@ LteEnbPhy::CreateTxPowerSpectralDensity ()
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<SpectrumValue> psd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (m_dlEarfcn, m_dlBandwidth, m_txPower, GetDownlinkSubChannels ());
+  // copy the shared PSD, which is cheaper than building it again
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (*LteSpectrumValueHelper::GetTxPowerSpectralDensity (m_dlEarfcn, m_dlBandwidth, m_txPower, m_listOfDownlinkSubchannel));
 
   return psd;
 }
@@ -744,11 +765,18 @@ LteEnbPhy::StartSubFrame (void)
         }
     }
 
-  SendControlChannels (ctrlMsg);
+  Ptr<PacketBurst> pb = GetPacketBurst ();
+  if (m_subframeAbstraction)
+    {
+      SendSubframe (ctrlMsg, pb);
+    }
+  else
+    {
+      SendControlChannels (ctrlMsg);
+    }
 
   // send data frame
-  Ptr<PacketBurst> pb = GetPacketBurst ();
-  if (pb)
+  if (pb && !m_subframeAbstraction)
     {
       Simulator::Schedule (DL_CTRL_DELAY_FROM_SUBFRAME_START, // ctrl frame fixed to 3 symbols
                            &LteEnbPhy::SendDataChannels,
@@ -797,6 +825,31 @@ LteEnbPhy::SendDataChannels (Ptr<PacketBurst> pb)
   m_downlinkSpectrumPhy->StartTxDataFrame (pb, ctrlMsgList, DL_DATA_DURATION);
 }
 
+void
+LteEnbPhy::SendSubframe (std::list<Ptr<LteControlMessage> > ctrlMsgList, Ptr<PacketBurst> pb)
+{
+  NS_LOG_FUNCTION (this << " eNB " << m_cellId << " start tx subframe");
+  // the control portion spans the full bandwidth
+  std::vector <int> dlRb;
+  for (uint8_t i = 0; i < m_dlBandwidth; i++)
+    {
+      dlRb.push_back (i);
+    }
+  SetDownlinkSubChannels (dlRb);
+  Ptr<SpectrumValue> dataPsd;
+  if (pb)
+    {
+      m_listOfDownlinkSubchannel = m_dlDataRbMap;
+      dataPsd = CreateTxPowerSpectralDensityWithPowerAllocation ();
+    }
+  bool pss = false;
+  if ((m_nrSubFrames == 1) || (m_nrSubFrames == 6))
+    {
+      pss = true;
+    }
+  m_downlinkSpectrumPhy->StartTxDlFrame (pb, ctrlMsgList, pss, dataPsd, DL_SUBFRAME_DURATION);
+}
+
 
 void
 LteEnbPhy::EndSubFrame (void)
@@ -230,6 +230,14 @@ public:
   */
   void SendDataChannels (Ptr<PacketBurst> pb);
 
+  /**
+  * \brief Send the PDCCH, PCFICH and PDSCH as a single signal lasting the
+  * whole subframe (SubframeAbstraction attribute)
+  * \param ctrlMsgList the list of control messages of PDCCH
+  * \param pb the PacketBurst to be sent, if any
+  */
+  void SendSubframe (std::list<Ptr<LteControlMessage> > ctrlMsgList, Ptr<PacketBurst> pb);
+
   /**
   * \param m the UL-CQI to be queued
   */
@@ -433,6 +441,12 @@ private:
    */
   TracedCallback<PhyTransmissionStatParameters> m_dlPhyTransmission;
 
+  /**
+   * The `SubframeAbstraction` attribute. If true, each DL subframe is sent
+   * as a single signal.
+   */
+  bool m_subframeAbstraction;
+
 }; // end of `class LteEnbPhy`
 
 
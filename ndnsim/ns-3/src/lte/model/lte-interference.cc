@@ -188,17 +188,21 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+      // computed in place, in members that keep their storage across chunks
+      m_interf = *m_allSignals;
+      m_interf -= *m_rxSignal;
+      m_interf += *m_noise;
 
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      m_sinr = *m_rxSignal;
+      m_sinr /= m_interf;
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (sinr, duration);
+          (*it)->EvaluateChunk (m_sinr, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (interf, duration);
+          (*it)->EvaluateChunk (m_interf, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
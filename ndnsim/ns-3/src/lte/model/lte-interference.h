@@ -135,6 +135,9 @@ private:
 
   Ptr<const SpectrumValue> m_noise;
 
+  SpectrumValue m_interf; ///< interference plus noise of the last chunk, kept to reuse its storage
+  SpectrumValue m_sinr;   ///< SINR of the last chunk, kept to reuse its storage
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
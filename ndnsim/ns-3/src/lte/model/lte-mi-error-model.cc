@@ -31,6 +31,7 @@
 
 
 #include <list>
+#include <map>
 #include <vector>
 #include <ns3/log.h>
 #include <ns3/pointer.h>
@@ -330,11 +331,9 @@ LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, ui
   
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  
   for (uint32_t i = 0; i < map.size (); i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
+      double sinrLin = sinr[map.at (i)];
       if (mcs <= MI_QPSK_MAX_ID) // QPSK
         {
 
@@ -460,11 +459,10 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
   NS_LOG_FUNCTION (sinr);
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  Values::iterator sinrIt = sinrCopy.ValuesBegin ();
+  Values::const_iterator sinrIt = sinr.ConstValuesBegin ();
   uint16_t rb = 0;
-  NS_ASSERT (sinrIt!=sinrCopy.ValuesEnd ());
-  while (sinrIt!=sinrCopy.ValuesEnd ())
+  NS_ASSERT (sinrIt!=sinr.ConstValuesEnd ());
+  while (sinrIt!=sinr.ConstValuesEnd ())
     {
       double sinrLin = *sinrIt;
       if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
@@ -545,36 +543,33 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
 
 
 
-TbStats_t
-LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory)
+/**
+ * Code block segmentation of a TB
+ */
+struct CbSegmentation
 {
-  NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
+  uint32_t C;      ///< no. of codeblocks
+  uint32_t Cplus;  ///< no. of codeblocks with size K+
+  uint32_t Kplus;  ///< K+
+  uint32_t Cminus; ///< no. of codeblocks with size K-
+  uint32_t Kminus; ///< K-
+};
 
-  double tbMi = Mib(sinr, map, mcs);
-  double MI = 0.0;
-  double Reff = 0.0;
-  NS_ASSERT (mcs < 29);
-  if (miHistory.size ()>0)
-    {
-      // evaluate R_eff and MI_eff
-      uint16_t codeBitsSum = 0;
-      double miSum = 0.0;
-      for (uint16_t i = 0; i < miHistory.size (); i++)
-        {
-          NS_LOG_DEBUG (" Sum MI " << miHistory.at (i).m_mi << " Ci " << miHistory.at (i).m_codeBits);
-          codeBitsSum += miHistory.at (i).m_codeBits;
-          miSum += (miHistory.at (i).m_mi*miHistory.at (i).m_codeBits);
-        }
-      codeBitsSum += (((double)size*8.0) / McsEcrTable [mcs]);
-      miSum += (tbMi*(((double)size*8.0) / McsEcrTable [mcs]));
-      Reff = miHistory.at (0).m_infoBits / (double)codeBitsSum; // information bits are the size of the first TB
-      MI = miSum / (double)codeBitsSum;      
-    }
-  else
+/// The segmentations already computed, by TB size
+static std::map<uint16_t, CbSegmentation> g_cbSegmentationMap;
+
+/**
+ * \param size the size in bytes of the TB
+ * \return the code block segmentation of the TB, computed once for each size
+ */
+static const CbSegmentation &
+GetCbSegmentation (uint16_t size)
+{
+  std::map<uint16_t, CbSegmentation>::const_iterator it = g_cbSegmentationMap.find (size);
+  if (it != g_cbSegmentationMap.end ())
     {
-      MI = tbMi;
+      return it->second;
     }
-  NS_LOG_DEBUG (" MI " << MI << " Reff " << Reff << " HARQ " << miHistory.size ());
   // estimate CB size (according to sec 5.1.2 of TS 36.212)
   uint16_t Z = 6144; // max size of a codeblock (including CRC)
   uint32_t B = size * 8;
@@ -667,6 +662,52 @@ LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std:
     }
   NS_LOG_INFO ("--------------------LteMiErrorModel: TB size of " << B << " needs of " << B1 << " bits reparted in " << C << " CBs as "<< Cplus << " block(s) of " << Kplus << " and " << Cminus << " of " << Kminus);
 
+  CbSegmentation cbs;
+  cbs.C = C;
+  cbs.Cplus = Cplus;
+  cbs.Kplus = Kplus;
+  cbs.Cminus = Cminus;
+  cbs.Kminus = Kminus;
+  return g_cbSegmentationMap.insert (std::make_pair (size, cbs)).first->second;
+}
+
+TbStats_t
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory)
+{
+  NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
+
+  double tbMi = Mib(sinr, map, mcs);
+  double MI = 0.0;
+  double Reff = 0.0;
+  NS_ASSERT (mcs < 29);
+  if (miHistory.size ()>0)
+    {
+      // evaluate R_eff and MI_eff
+      uint16_t codeBitsSum = 0;
+      double miSum = 0.0;
+      for (uint16_t i = 0; i < miHistory.size (); i++)
+        {
+          NS_LOG_DEBUG (" Sum MI " << miHistory.at (i).m_mi << " Ci " << miHistory.at (i).m_codeBits);
+          codeBitsSum += miHistory.at (i).m_codeBits;
+          miSum += (miHistory.at (i).m_mi*miHistory.at (i).m_codeBits);
+        }
+      codeBitsSum += (((double)size*8.0) / McsEcrTable [mcs]);
+      miSum += (tbMi*(((double)size*8.0) / McsEcrTable [mcs]));
+      Reff = miHistory.at (0).m_infoBits / (double)codeBitsSum; // information bits are the size of the first TB
+      MI = miSum / (double)codeBitsSum;      
+    }
+  else
+    {
+      MI = tbMi;
+    }
+  NS_LOG_DEBUG (" MI " << MI << " Reff " << Reff << " HARQ " << miHistory.size ());
+  const CbSegmentation &cbs = GetCbSegmentation (size);
+  uint32_t C = cbs.C;
+  uint32_t Cplus = cbs.Cplus;
+  uint32_t Kplus = cbs.Kplus;
+  uint32_t Cminus = cbs.Cminus;
+  uint32_t Kminus = cbs.Kminus;
+
   double errorRate = 1.0;
   uint8_t ecrId = 0;
   if (miHistory.size ()==0)
@@ -536,6 +536,75 @@ LteSpectrumPhy::StartTxDlCtrlFrame (std::list<Ptr<LteControlMessage> > ctrlMsgLi
 }
 
 
+bool
+LteSpectrumPhy::StartTxDlFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, bool pss, Ptr<const SpectrumValue> dataPsd, Time duration)
+{
+  NS_LOG_FUNCTION (this << pb << " PSS " << (uint16_t)pss);
+  NS_LOG_LOGIC (this << " state: " << m_state);
+
+  m_phyTxStartTrace (pb);
+
+  switch (m_state)
+  {
+    case RX_DATA:
+    case RX_DL_CTRL:
+    case RX_UL_SRS:
+      NS_FATAL_ERROR ("cannot TX while RX: according to FDD channel acces, the physical layer for transmission cannot be used for reception");
+      break;
+
+    case TX_DATA:
+    case TX_DL_CTRL:
+    case TX_UL_SRS:
+      NS_FATAL_ERROR ("cannot TX while already TX: the MAC should avoid this");
+      break;
+
+    case IDLE:
+    {
+      /*
+      m_txPsd must be setted by the device, according to
+      (i) the available subchannel for transmission
+      (ii) the power transmission
+      */
+      NS_ASSERT (m_txPsd);
+      m_txPacketBurst = pb;
+
+      ChangeState (TX_DATA);
+      NS_ASSERT (m_channel);
+      Ptr<LteSpectrumSignalParametersDlFrame> txParams = Create<LteSpectrumSignalParametersDlFrame> ();
+      txParams->duration = duration;
+      txParams->txPhy = GetObject<SpectrumPhy> ();
+      txParams->txAntenna = m_antenna;
+      txParams->psd = m_txPsd;
+      txParams->cellId = m_cellId;
+      txParams->pss = pss;
+      txParams->ctrlMsgList = ctrlMsgList;
+      txParams->packetBurst = pb;
+      if (pb)
+        {
+          NS_ASSERT (dataPsd);
+          Ptr<SpectrumValue> ratio = Create<SpectrumValue> (m_txPsd->GetSpectrumModel ());
+          Values::const_iterator itCtrl = m_txPsd->ConstValuesBegin ();
+          Values::const_iterator itData = dataPsd->ConstValuesBegin ();
+          for (Values::iterator it = ratio->ValuesBegin (); it != ratio->ValuesEnd (); ++it, ++itCtrl, ++itData)
+            {
+              *it = (*itCtrl > 0) ? (*itData / *itCtrl) : 0;
+            }
+          txParams->dataPsdRatio = ratio;
+        }
+      m_channel->StartTx (txParams);
+      m_endTxEvent = Simulator::Schedule (duration, &LteSpectrumPhy::EndTxData, this);
+    }
+    return false;
+    break;
+
+    default:
+      NS_FATAL_ERROR ("unknown state");
+      return true;
+      break;
+  }
+}
+
+
 bool
 LteSpectrumPhy::StartTxUlSrsFrame ()
 {
@@ -644,11 +713,24 @@ LteSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
   Ptr<LteSpectrumSignalParametersDataFrame> lteDataRxParams = DynamicCast<LteSpectrumSignalParametersDataFrame> (spectrumRxParams);
   Ptr<LteSpectrumSignalParametersDlCtrlFrame> lteDlCtrlRxParams = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (spectrumRxParams);
   Ptr<LteSpectrumSignalParametersUlSrsFrame> lteUlSrsRxParams = DynamicCast<LteSpectrumSignalParametersUlSrsFrame> (spectrumRxParams);
+  Ptr<LteSpectrumSignalParametersDlFrame> lteDlRxParams = DynamicCast<LteSpectrumSignalParametersDlFrame> (spectrumRxParams);
   if (lteDataRxParams != 0)
     {
       m_interferenceData->AddSignal (rxPsd, duration);
       StartRxData (lteDataRxParams);
     }
+  else if (lteDlRxParams != 0)
+    {
+      // a whole subframe: its control portion interferes with the control
+      // and its data portion, if any, with the data of the other cells
+      m_interferenceCtrl->AddSignal (rxPsd, duration);
+      Ptr<SpectrumValue> rxDataPsd = lteDlRxParams->CreateDataPsd ();
+      if (rxDataPsd)
+        {
+          m_interferenceData->AddSignal (rxDataPsd, duration);
+        }
+      StartRxDlFrame (lteDlRxParams, rxDataPsd);
+    }
   else if (lteDlCtrlRxParams!=0)
     {
       m_interferenceCtrl->AddSignal (rxPsd, duration);
@@ -828,6 +910,77 @@ LteSpectrumPhy::StartRxDlCtrl (Ptr<LteSpectrumSignalParametersDlCtrlFrame> lteDl
 
 
 
+void
+LteSpectrumPhy::StartRxDlFrame (Ptr<LteSpectrumSignalParametersDlFrame> lteDlRxParams, Ptr<const SpectrumValue> rxDataPsd)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_ASSERT (lteDlRxParams != 0);
+  uint16_t cellId = lteDlRxParams->cellId;
+
+  switch (m_state)
+    {
+    case TX_DATA:
+    case TX_DL_CTRL:
+    case TX_UL_SRS:
+    case RX_DATA:
+    case RX_UL_SRS:
+      NS_FATAL_ERROR ("unexpected event in state " << m_state);
+      break;
+
+    case RX_DL_CTRL:
+    case IDLE:
+      // check presence of PSS for UE measuerements
+      if (lteDlRxParams->pss == true)
+        {
+          if (!m_ltePhyRxPssCallback.IsNull ())
+            {
+              m_ltePhyRxPssCallback (cellId, lteDlRxParams->psd);
+            }
+        }
+
+      if (m_state == RX_DL_CTRL)
+        {
+          NS_ASSERT_MSG (m_cellId != cellId, "any other DL subframe should be from a different cell");
+          NS_LOG_LOGIC (this << " ignoring other DL subframe (cellId="
+                        << cellId  << ", m_cellId=" << m_cellId << ")");
+        }
+      else if (cellId == m_cellId)
+        {
+          NS_LOG_LOGIC (this << " synchronized with this signal (cellId=" << cellId << ")");
+
+          NS_ASSERT (m_rxControlMessageList.empty ());
+          NS_ASSERT (m_rxPacketBurstList.empty ());
+          m_firstRxStart = Simulator::Now ();
+          m_firstRxDuration = lteDlRxParams->duration;
+          NS_LOG_LOGIC (this << " scheduling EndRx with delay " << lteDlRxParams->duration);
+
+          m_rxControlMessageList = lteDlRxParams->ctrlMsgList;
+          if (lteDlRxParams->packetBurst)
+            {
+              m_rxPacketBurstList.push_back (lteDlRxParams->packetBurst);
+              m_interferenceData->StartRx (rxDataPsd);
+              m_phyRxStartTrace (lteDlRxParams->packetBurst);
+            }
+          m_endRxDlCtrlEvent = Simulator::Schedule (lteDlRxParams->duration, &LteSpectrumPhy::EndRxDlFrame, this);
+          ChangeState (RX_DL_CTRL);
+          m_interferenceCtrl->StartRx (lteDlRxParams->psd);
+        }
+      else
+        {
+          NS_LOG_LOGIC (this << " not synchronizing with this signal (cellId="
+                        << cellId  << ", m_cellId=" << m_cellId << ")");
+        }
+      break;
+
+    default:
+      NS_FATAL_ERROR ("unknown state");
+      break;
+    }
+
+  NS_LOG_LOGIC (this << " state: " << m_state);
+}
+
 
 void
 LteSpectrumPhy::StartRxUlSrs (Ptr<LteSpectrumSignalParametersUlSrsFrame> lteUlSrsRxParams)
@@ -1174,6 +1327,25 @@ LteSpectrumPhy::EndRxDlCtrl ()
   m_rxControlMessageList.clear ();
 }
 
+void
+LteSpectrumPhy::EndRxDlFrame ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_state == RX_DL_CTRL);
+
+  // the control portion first: the DCIs it carries set the TBs expected
+  // in the data portion
+  std::list<Ptr<PacketBurst> > rxPacketBurstList;
+  rxPacketBurstList.swap (m_rxPacketBurstList);
+  EndRxDlCtrl ();
+  if (!rxPacketBurstList.empty ())
+    {
+      m_rxPacketBurstList.swap (rxPacketBurstList);
+      ChangeState (RX_DATA);
+      EndRxData ();
+    }
+}
+
 void
 LteSpectrumPhy::EndRxUlSrs ()
 {
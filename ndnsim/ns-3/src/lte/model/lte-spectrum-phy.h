@@ -80,6 +80,7 @@ class AntennaModel;
 class LteControlMessage;
 struct LteSpectrumSignalParametersDataFrame;
 struct LteSpectrumSignalParametersDlCtrlFrame;
+struct LteSpectrumSignalParametersDlFrame;
 struct LteSpectrumSignalParametersUlSrsFrame;
 
 
@@ -180,6 +181,7 @@ public:
   void StartRx (Ptr<SpectrumSignalParameters> params);
   void StartRxData (Ptr<LteSpectrumSignalParametersDataFrame> params);
   void StartRxDlCtrl (Ptr<LteSpectrumSignalParametersDlCtrlFrame> lteDlCtrlRxParams);
+  void StartRxDlFrame (Ptr<LteSpectrumSignalParametersDlFrame> lteDlRxParams, Ptr<const SpectrumValue> rxDataPsd);
   void StartRxUlSrs (Ptr<LteSpectrumSignalParametersUlSrsFrame> lteUlSrsRxParams);
 
   void SetHarqPhyModule (Ptr<LteHarqPhy> harq);
@@ -235,6 +237,22 @@ public:
   * started, false otherwise.
   */
   bool StartTxDlCtrlFrame (std::list<Ptr<LteControlMessage> > ctrlMsgList, bool pss);
+
+  /**
+  * Start a transmission of a whole DL subframe, i.e., of its control and
+  * data portions as a single signal; the current tx PSD is the one of
+  * the control portion
+  *
+  * @param pb the burst of packets to be transmitted in PDSCH, 0 if none
+  * @param ctrlMsgList the burst of control messages to be transmitted
+  * @param pss the flag for transmitting the primary synchronization signal
+  * @param dataPsd the PSD of the PDSCH, 0 if no packets are transmitted
+  * @param duration the duration of the subframe
+  *
+  * @return true if an error occurred and the transmission was not
+  * started, false otherwise.
+  */
+  bool StartTxDlFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, bool pss, Ptr<const SpectrumValue> dataPsd, Time duration);
   
   
   /**
@@ -426,6 +444,7 @@ private:
   void EndTxUlSrs ();
   void EndRxData ();
   void EndRxDlCtrl ();
+  void EndRxDlFrame ();
   void EndRxUlSrs ();
   
   void SetTxModeGain (uint8_t txMode, double gain);
@@ -24,6 +24,8 @@
 #include <ns3/ptr.h>
 #include <ns3/lte-spectrum-signal-parameters.h>
 #include <ns3/lte-control-messages.h>
+#include <ns3/spectrum-converter.h>
+#include <map>
 
 
 namespace ns3 {
@@ -120,6 +122,63 @@ LteSpectrumSignalParametersDlCtrlFrame::Copy ()
 }
 
 
+LteSpectrumSignalParametersDlFrame::LteSpectrumSignalParametersDlFrame ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteSpectrumSignalParametersDlFrame::LteSpectrumSignalParametersDlFrame (const LteSpectrumSignalParametersDlFrame& p)
+: LteSpectrumSignalParametersDlCtrlFrame (p)
+{
+  NS_LOG_FUNCTION (this << &p);
+  if (p.packetBurst)
+    {
+      packetBurst = p.packetBurst->Copy ();
+    }
+  dataPsdRatio = p.dataPsdRatio;
+}
+
+Ptr<SpectrumSignalParameters>
+LteSpectrumSignalParametersDlFrame::Copy ()
+{
+  NS_LOG_FUNCTION (this);
+  // see LteSpectrumSignalParameters::Copy
+  Ptr<LteSpectrumSignalParametersDlFrame> lssp (new LteSpectrumSignalParametersDlFrame (*this), false);
+  return lssp;
+}
+
+Ptr<SpectrumValue>
+LteSpectrumSignalParametersDlFrame::CreateDataPsd () const
+{
+  NS_LOG_FUNCTION (this);
+  if (dataPsdRatio == 0)
+    {
+      return 0;
+    }
+  Ptr<SpectrumValue> dataPsd = Create<SpectrumValue> (*psd);
+  Ptr<const SpectrumModel> rxModel = psd->GetSpectrumModel ();
+  if (dataPsdRatio->GetSpectrumModel () == rxModel)
+    {
+      (*dataPsd) *= (*dataPsdRatio);
+    }
+  else
+    {
+      // the channel converted the signal to the SpectrumModel of the
+      // receiver: convert the ratio as well, which averages it over the
+      // frequencies of each band of the receiver
+      static std::map<std::pair<SpectrumModelUid_t, SpectrumModelUid_t>, SpectrumConverter> converters;
+      std::pair<SpectrumModelUid_t, SpectrumModelUid_t> key (dataPsdRatio->GetSpectrumModelUid (), rxModel->GetUid ());
+      std::map<std::pair<SpectrumModelUid_t, SpectrumModelUid_t>, SpectrumConverter>::iterator it = converters.find (key);
+      if (it == converters.end ())
+        {
+          it = converters.insert (std::make_pair (key, SpectrumConverter (dataPsdRatio->GetSpectrumModel (), rxModel))).first;
+        }
+      (*dataPsd) *= (*(it->second.Convert (dataPsdRatio)));
+    }
+  return dataPsd;
+}
+
+
 LteSpectrumSignalParametersUlSrsFrame::LteSpectrumSignalParametersUlSrsFrame ()
 {
   NS_LOG_FUNCTION (this);
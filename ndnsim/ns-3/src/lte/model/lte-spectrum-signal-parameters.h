@@ -123,6 +123,56 @@ struct LteSpectrumSignalParametersDlCtrlFrame : public SpectrumSignalParameters
 
 
 
+/**
+* \ingroup lte
+*
+* Signal parameters for a whole Lte DL subframe, used when the eNB
+* abstracts the subframe structure (see the SubframeAbstraction attribute
+* of LteEnbPhy): the control portion (RS, PCFICH and PDCCH) and the data
+* portion (PDSCH) are transmitted as a single signal lasting the whole
+* subframe. The inherited psd is the PSD of the control portion, which
+* spans the whole bandwidth.
+*/
+struct LteSpectrumSignalParametersDlFrame : public LteSpectrumSignalParametersDlCtrlFrame
+{
+
+  // inherited from SpectrumSignalParameters
+  virtual Ptr<SpectrumSignalParameters> Copy ();
+
+  /**
+  * default constructor
+  */
+  LteSpectrumSignalParametersDlFrame ();
+
+  /**
+  * copy constructor
+  */
+  LteSpectrumSignalParametersDlFrame (const LteSpectrumSignalParametersDlFrame& p);
+
+  /**
+  * Compute the PSD of the data portion of the subframe, as seen by the
+  * receiver of this signal. Since the propagation loss is the same for
+  * the two portions of the subframe, it is the PSD of the control portion
+  * scaled by dataPsdRatio.
+  *
+  * \return the PSD of the data portion, or 0 if no data is transmitted
+  */
+  Ptr<SpectrumValue> CreateDataPsd () const;
+
+  /**
+  * The packet burst being transmitted in the PDSCH, 0 if none
+  */
+  Ptr<PacketBurst> packetBurst;
+
+  /**
+  * The ratio, per frequency, between the transmitted PSD of the data
+  * portion and the one of the control portion, 0 if no data is transmitted
+  */
+  Ptr<const SpectrumValue> dataPsdRatio;
+};
+
+
+
 /**
 * \ingroup lte
 *
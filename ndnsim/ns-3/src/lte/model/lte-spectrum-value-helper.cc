@@ -255,6 +255,63 @@ LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint16_t earfcn, uint8_t t
   return txPsd;
 }
 
+/**
+ * Identifies a TX PSD built by LteSpectrumValueHelper::CreateTxPowerSpectralDensity
+ */
+struct LteTxPsdId
+{
+  uint16_t earfcn;             ///< carrier frequency
+  uint8_t bandwidth;           ///< bandwidth in number of RBs
+  double powerTx;              ///< total power in dBm
+  std::vector<int> activeRbs;  ///< active RBs
+};
+
+bool
+operator < (const LteTxPsdId& a, const LteTxPsdId& b)
+{
+  if (a.earfcn != b.earfcn)
+    {
+      return a.earfcn < b.earfcn;
+    }
+  if (a.bandwidth != b.bandwidth)
+    {
+      return a.bandwidth < b.bandwidth;
+    }
+  if (a.powerTx != b.powerTx)
+    {
+      return a.powerTx < b.powerTx;
+    }
+  return a.activeRbs < b.activeRbs;
+}
+
+/// The shared TX PSDs; emptied when it grows beyond LTE_TX_PSD_MAP_MAX_SIZE
+static std::map<LteTxPsdId, Ptr<const SpectrumValue> > g_lteTxPsdMap;
+static const size_t LTE_TX_PSD_MAP_MAX_SIZE = 4096;
+
+Ptr<const SpectrumValue>
+LteSpectrumValueHelper::GetTxPowerSpectralDensity (uint16_t earfcn, uint8_t txBandwidthConfiguration, double powerTx, const std::vector <int> &activeRbs)
+{
+  NS_LOG_FUNCTION (earfcn << (uint16_t) txBandwidthConfiguration << powerTx << activeRbs);
+  LteTxPsdId key;
+  key.earfcn = earfcn;
+  key.bandwidth = txBandwidthConfiguration;
+  key.powerTx = powerTx;
+  key.activeRbs = activeRbs;
+  std::map<LteTxPsdId, Ptr<const SpectrumValue> >::iterator it = g_lteTxPsdMap.find (key);
+  if (it != g_lteTxPsdMap.end ())
+    {
+      return it->second;
+    }
+  if (g_lteTxPsdMap.size () >= LTE_TX_PSD_MAP_MAX_SIZE)
+    {
+      // bound the memory used when there are many different RB allocations
+      g_lteTxPsdMap.clear ();
+    }
+  Ptr<const SpectrumValue> txPsd = CreateTxPowerSpectralDensity (earfcn, txBandwidthConfiguration, powerTx, activeRbs);
+  g_lteTxPsdMap.insert (std::make_pair (key, txPsd));
+  return txPsd;
+}
+
 Ptr<SpectrumValue>
 LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint16_t earfcn, uint8_t txBandwidthConfiguration, double powerTx, std::map<int, double> powerTxMap, std::vector <int> activeRbs)
 {
@@ -112,6 +112,27 @@ public:
                                                           double powerTx,
                                                           std::vector <int> activeRbs);
 
+  /**
+   * get the shared spectrum value representing the power spectral
+   * density of a signal to be transmitted, with the same value as
+   * CreateTxPowerSpectralDensity. The instances are kept and returned
+   * again for the same parameters, which avoids building the same PSD
+   * every subframe; hence they are constant, and callers that need to
+   * modify the PSD must copy it.
+   *
+   * \param earfcn the carrier frequency (EARFCN) of the transmission
+   * \param bandwidth the Transmission Bandwidth Configuration in
+   * number of resource blocks
+   * \param powerTx the total power in dBm over the whole bandwidth
+   * \param activeRbs the list of Active Resource Blocks (PRBs)
+   *
+   * \return a pointer to the shared SpectrumValue representing the TX Power Spectral Density in W/Hz for each Resource Block
+   */
+  static Ptr<const SpectrumValue> GetTxPowerSpectralDensity (uint16_t earfcn,
+                                                       uint8_t bandwidth,
+                                                       double powerTx,
+                                                       const std::vector <int> &activeRbs);
+
   /**
    * create a spectrum value representing the power spectral
    * density of a signal to be transmitted. See 3GPP TS 36.101 for
@@ -153,7 +153,8 @@ LteUePhy::LteUePhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_pssReceived (false),
     m_ueMeasurementsFilterPeriod (MilliSeconds (200)),
     m_ueMeasurementsFilterLast (MilliSeconds (0)),
-    m_rsrpSinrSampleCounter (0)
+    m_rsrpSinrSampleCounter (0),
+    m_subframeAbstraction (false)
 {
   m_amc = CreateObject <LteAmc> ();
   m_powerControl = CreateObject <LteUePowerControl> ();
@@ -180,6 +181,8 @@ LteUePhy::DoDispose ()
   NS_LOG_FUNCTION (this);
   delete m_uePhySapProvider;
   delete m_ueCphySapProvider;
+  m_servingEnbPhy = 0;
+  m_enbPhyLookup = MakeNullCallback<Ptr<LteEnbPhy>, uint16_t> ();
   LtePhy::DoDispose ();
 }
 
@@ -294,6 +297,16 @@ LteUePhy::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteUePhy::m_enableUplinkPowerControl),
                    MakeBooleanChecker ())
+    .AddAttribute ("SubframeAbstraction",
+                   "If true, the control messages sent in a subframe "
+                   "without data (PUCCH) are delivered directly to the "
+                   "serving eNB at the end of the subframe, instead of "
+                   "being carried by a null bandwidth signal. The eNBs "
+                   "should use the same value of their attribute with the "
+                   "same name.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteUePhy::m_subframeAbstraction),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -462,8 +475,8 @@ Ptr<SpectrumValue>
 LteUePhy::CreateTxPowerSpectralDensity ()
 {
   NS_LOG_FUNCTION (this);
-  LteSpectrumValueHelper psdHelper;
-  Ptr<SpectrumValue> psd = psdHelper.CreateTxPowerSpectralDensity (m_ulEarfcn, m_ulBandwidth, m_txPower, GetSubChannelsForTransmission ());
+  // copy the shared PSD, which is cheaper than building it again
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (*LteSpectrumValueHelper::GetTxPowerSpectralDensity (m_ulEarfcn, m_ulBandwidth, m_txPower, m_subChannelsForTransmission));
 
   return psd;
 }
@@ -1137,7 +1150,18 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
                 }
 
               SetSubChannelsForTransmission (dlRb);
-              m_uplinkSpectrumPhy->StartTxDataFrame (pb, ctrlMsg, UL_DATA_DURATION);
+              if (m_subframeAbstraction)
+                {
+                  // the signal would carry no power: skip the channel
+                  NS_ASSERT (m_servingEnbPhy);
+                  Simulator::ScheduleWithContext (m_servingEnbPhy->GetDevice ()->GetNode ()->GetId (),
+                                                  UL_DATA_DURATION, &LteEnbPhy::ReceiveLteControlMessageList,
+                                                  m_servingEnbPhy, ctrlMsg);
+                }
+              else
+                {
+                  m_uplinkSpectrumPhy->StartTxDataFrame (pb, ctrlMsg, UL_DATA_DURATION);
+                }
             }
           else
             {
@@ -1197,6 +1221,7 @@ LteUePhy::DoReset ()
   m_ulConfigured = false;
   m_raPreambleId = 255; // value out of range
   m_raRnti = 11; // value out of range
+  m_servingEnbPhy = 0;
   m_rsrpSinrSampleCounter = 0;
   m_p10CqiLast = Simulator::Now ();
   m_a30CqiLast = Simulator::Now ();
@@ -1252,6 +1277,13 @@ LteUePhy::DoSynchronizeWithEnb (uint16_t cellId)
   m_downlinkSpectrumPhy->SetCellId (cellId);
   m_uplinkSpectrumPhy->SetCellId (cellId);
 
+  if (m_subframeAbstraction)
+    {
+      NS_ASSERT_MSG (!m_enbPhyLookup.IsNull (), "SubframeAbstraction needs the eNB PHY lookup of the LteHelper");
+      m_servingEnbPhy = m_enbPhyLookup (cellId);
+      NS_ASSERT_MSG (m_servingEnbPhy, "Unable to find eNB with CellId =" << cellId);
+    }
+
   // configure DL for receiving the BCH with the minimum bandwidth
   DoSetDlBandwidth (6);
 
@@ -1435,6 +1467,13 @@ LteUePhy::SetHarqPhyModule (Ptr<LteHarqPhy> harq)
   m_harqPhyModule = harq;
 }
 
+void
+LteUePhy::SetEnbPhyLookupCallback (EnbPhyLookupCallback cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_enbPhyLookup = cb;
+}
+
 
 LteUePhy::State
 LteUePhy::GetState () const
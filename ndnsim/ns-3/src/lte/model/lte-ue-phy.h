@@ -230,6 +230,18 @@ public:
    */
   void SetHarqPhyModule (Ptr<LteHarqPhy> harq);
 
+  /**
+   * Callback returning the PHY of the eNB with the given cell id
+   */
+  typedef Callback<Ptr<LteEnbPhy>, uint16_t> EnbPhyLookupCallback;
+
+  /**
+   * \brief Set the lookup of the eNB PHYs, needed with SubframeAbstraction
+   *
+   * \param cb the callback returning the PHY of the eNB of a cell id
+   */
+  void SetEnbPhyLookupCallback (EnbPhyLookupCallback cb);
+
   /**
    * \return The current state
    */
@@ -475,6 +487,16 @@ private:
   Ptr<SpectrumValue> m_noisePsd; ///< Noise power spectral density for
                                  ///the configured bandwidth 
 
+  /**
+   * The `SubframeAbstraction` attribute. If true, the control messages
+   * sent without data are delivered directly to the serving eNB.
+   */
+  bool m_subframeAbstraction;
+  /// PHY of the serving eNB, only known with SubframeAbstraction
+  Ptr<LteEnbPhy> m_servingEnbPhy;
+  /// Lookup of the eNB PHYs by cell id, set by the LteHelper
+  EnbPhyLookupCallback m_enbPhyLookup;
+
 }; // end of `class LteUePhy`
 
 
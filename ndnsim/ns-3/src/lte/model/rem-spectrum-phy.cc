@@ -43,7 +43,8 @@ RemSpectrumPhy::RemSpectrumPhy ()
     m_sumPower (0),
     m_active (true),
     m_useDataChannel (false),
-    m_rbId (-1)
+    m_rbId (-1),
+    m_recordSignals (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -128,55 +129,56 @@ RemSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
 
   if (m_active)
     {
+      bool processed;
       if (m_useDataChannel)
         {
-          Ptr<LteSpectrumSignalParametersDataFrame> lteDlDataRxParams = DynamicCast<LteSpectrumSignalParametersDataFrame> (params);
-          if (lteDlDataRxParams != 0)
+          processed = (DynamicCast<LteSpectrumSignalParametersDataFrame> (params) != 0);
+          Ptr<LteSpectrumSignalParametersDlFrame> dlParams = DynamicCast<LteSpectrumSignalParametersDlFrame> (params);
+          if (dlParams != 0 && dlParams->dataPsdRatio != 0)
             {
-              NS_LOG_DEBUG ("StartRx data");
-              double power = 0;
-              if (m_rbId >= 0)
-                {
-                  power = (*(params->psd))[m_rbId] * 180000;
-                }
-              else
-                {
-                  power = Integral (*(params->psd));
-                }
-
-              m_sumPower += power;
-              if (power > m_referenceSignalPower)
-                {
-                  m_referenceSignalPower = power;
-                }
+              // keep only the data portion of a whole DL subframe
+              params = dlParams->Copy ();
+              params->psd = dlParams->CreateDataPsd ();
+              processed = true;
             }
+          NS_LOG_DEBUG ("StartRx data " << processed);
         }
       else
         {
-          Ptr<LteSpectrumSignalParametersDlCtrlFrame> lteDlCtrlRxParams = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (params);
-          if (lteDlCtrlRxParams != 0)
+          processed = (DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (params) != 0);
+          NS_LOG_DEBUG ("StartRx control " << processed);
+        }
+      if (processed)
+        {
+          AddSignal (*(params->psd));
+          if (m_recordSignals)
             {
-              NS_LOG_DEBUG ("StartRx control");
-              double power = 0;
-              if (m_rbId >= 0)
-                {
-                  power = (*(params->psd))[m_rbId] * 180000;
-                }
-              else
-                {
-                  power = Integral (*(params->psd));
-                }
-
-              m_sumPower += power;
-              if (power > m_referenceSignalPower)
-                {
-                  m_referenceSignalPower = power;
-                }
+              m_recordedSignals.push_back (params);
             }
         }
     }
 }
 
+void
+RemSpectrumPhy::AddSignal (const SpectrumValue& psd)
+{
+  double power = 0;
+  if (m_rbId >= 0)
+    {
+      power = psd[m_rbId] * 180000;
+    }
+  else
+    {
+      power = Integral (psd);
+    }
+
+  m_sumPower += power;
+  if (power > m_referenceSignalPower)
+    {
+      m_referenceSignalPower = power;
+    }
+}
+
 void
 RemSpectrumPhy::SetRxSpectrumModel (Ptr<const SpectrumModel> m)
 {
@@ -207,6 +209,7 @@ RemSpectrumPhy::Reset ()
 {
   m_referenceSignalPower = 0;
   m_sumPower = 0;
+  m_recordedSignals.clear ();
 }
 
 void
@@ -221,5 +224,17 @@ RemSpectrumPhy::SetRbId (int32_t rbId)
   m_rbId = rbId;
 }
 
+void
+RemSpectrumPhy::SetRecordSignals (bool value)
+{
+  m_recordSignals = value;
+}
+
+const std::vector<Ptr<SpectrumSignalParameters> > &
+RemSpectrumPhy::GetRecordedSignals () const
+{
+  return m_recordedSignals;
+}
+
 
 } // namespace ns3
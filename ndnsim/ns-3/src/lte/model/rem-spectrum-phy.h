@@ -31,6 +31,7 @@
 #include <ns3/spectrum-channel.h>
 #include <string>
 #include <fstream>
+#include <vector>
 
 namespace ns3 {
 
@@ -114,6 +115,26 @@ public:
    */
   void SetRbId (int32_t rbId);
 
+  /**
+   * Account for a signal of the processed channel, as StartRx does
+   *
+   * \param psd the PSD with which the signal is received
+   */
+  void AddSignal (const SpectrumValue& psd);
+
+  /**
+   * set the recording of the signals received
+   *
+   * \param value if true, the parameters of the signals of the processed
+   * channel will be kept, until the next Reset
+   */
+  void SetRecordSignals (bool value);
+
+  /**
+   * \return the parameters of the signals recorded since the last Reset
+   */
+  const std::vector<Ptr<SpectrumSignalParameters> > & GetRecordedSignals () const;
+
 private:
   Ptr<MobilityModel> m_mobility;
   Ptr<const SpectrumModel> m_rxSpectrumModel;
@@ -126,6 +147,9 @@ private:
   bool m_useDataChannel;
   int32_t m_rbId;
 
+  bool m_recordSignals;
+  std::vector<Ptr<SpectrumSignalParameters> > m_recordedSignals;
+
 };
 
 
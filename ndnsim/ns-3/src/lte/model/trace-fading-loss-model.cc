@@ -38,8 +38,36 @@ NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel);
   
 
 
+/**
+ * Identifies the gains loaded from a fading trace
+ */
+struct FadingTraceId
+{
+  std::string fileName; ///< the trace file
+  uint32_t rbNum;       ///< number of RBs of the trace
+  uint32_t samplesNum;  ///< number of samples of the trace
+};
+
+static bool
+operator < (const FadingTraceId& a, const FadingTraceId& b)
+{
+  if (a.fileName != b.fileName)
+    {
+      return a.fileName < b.fileName;
+    }
+  if (a.rbNum != b.rbNum)
+    {
+      return a.rbNum < b.rbNum;
+    }
+  return a.samplesNum < b.samplesNum;
+}
+
+/// The fading traces loaded, each one loaded only once for all the models
+static std::map<FadingTraceId, std::vector<double> > g_fadingGainsMap;
+
 TraceFadingLossModel::TraceFadingLossModel ()
-  : m_streamsAssigned (false)
+  : m_fadingGains (0),
+    m_streamsAssigned (false)
 {
   NS_LOG_FUNCTION (this);
   SetNext (NULL);
@@ -48,7 +76,6 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -120,28 +147,35 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
+  FadingTraceId id;
+  id.fileName = m_traceFile;
+  id.rbNum = m_rbNum;
+  id.samplesNum = m_samplesNum;
+  std::map<FadingTraceId, FadingGains>::iterator it = g_fadingGainsMap.find (id);
+  if (it == g_fadingGainsMap.end ())
     {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
-    }
+      std::ifstream ifTraceFile;
+      ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
+      if (!ifTraceFile.good ())
+        {
+          NS_LOG_INFO (this << " File: " << m_traceFile);
+          NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
+        }
 
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
-    {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
+      // the file holds the fading (dB) of each sample, RB after RB
+      FadingGains gains ((size_t)m_rbNum * m_samplesNum);
+      for (uint32_t i = 0; i < m_rbNum; i++)
         {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
+          for (uint32_t j = 0; j < m_samplesNum; j++)
+            {
+              double sample;
+              ifTraceFile >> sample;
+              gains[(size_t)j * m_rbNum + i] = std::pow (10., sample / 10);
+            }
         }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
+      it = g_fadingGainsMap.insert (std::make_pair (id, gains)).first;
     }
+  m_fadingGains = &it->second;
   m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
   m_lastWindowUpdate = Simulator::Now ();
 }
@@ -188,12 +222,11 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
         }
       ChannelRealizationId_t mobilityPair = std::make_pair (a,b);
       m_startVariableMap.insert (std::pair<ChannelRealizationId_t,Ptr<UniformRandomVariable> > (mobilityPair, startV));
-      m_windowOffsetsMap.insert (std::pair<ChannelRealizationId_t,int> (mobilityPair, startV->GetValue ()));
+      itOff = m_windowOffsetsMap.insert (std::pair<ChannelRealizationId_t,int> (mobilityPair, startV->GetValue ())).first;
     }
 
   
   Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
-  Values::iterator vit = rxPsd->ValuesBegin ();
   
   //Vector aSpeedVector = a->GetVelocity ();
   //Vector bSpeedVector = b->GetVelocity ();
@@ -201,32 +234,20 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingGains != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
-  int subChannel = 0;
-  while (vit != rxPsd->ValuesEnd ())
+  NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index);
+
+  // apply the gains of all the RBs at once, in a loop the compiler can vectorize
+  size_t rbNum = rxPsd->GetSpectrumModel ()->GetNumBands ();
+  NS_ASSERT_MSG (rbNum <= m_rbNum, "The fading trace has fewer RBs than the signal");
+  const double *gain = &(*m_fadingGains)[(size_t)index * m_rbNum];
+  double *power = &(*rxPsd)[0];
+  for (size_t subChannel = 0; subChannel < rbNum; subChannel++)
     {
-      NS_ASSERT (subChannel < 100);
-      if (*vit != 0.)
-        {
-          double fading = m_fadingTrace.at (subChannel).at (index);
-          NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
-          double power = *vit; // in Watt/Hz
-          power = 10 * std::log10 (180000 * power); // in dB
-
-          NS_LOG_LOGIC (this << subChannel << *vit  << power << fading);
-
-          *vit = std::pow (10., ((power + fading) / 10)) / 180000; // in Watt
-
-          NS_LOG_LOGIC (this << subChannel << *vit);
-
-        }
-
-      ++vit;
-      ++subChannel;
-
+      power[subChannel] *= gain[subChannel];
     }
 
   NS_LOG_LOGIC (this << *rxPsd);
@@ -250,6 +271,7 @@ TraceFadingLossModel::AssignStreams (int64_t stream)
       NS_ASSERT_MSG (m_currentStream <= m_lastStream, "not enough streams, consider increasing the StreamSetSize attribute");
       (*itVar).second->SetStream (m_currentStream);
       m_currentStream += 1;
+      itVar++;
     }
   return m_streamSetSize;
 }
@@ -100,19 +100,19 @@ private:
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap;
   
   /**
-   * Vector with fading samples in time domain (for a fixed RB)
+   * Linear fading gains of a trace, sample after sample: the gains of all
+   * the RBs of a sample are contiguous
    */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
+  typedef std::vector<double> FadingGains;
 
 
   
   std::string m_traceFile;
   
-  FadingTrace m_fadingTrace;
+  /**
+   * The gains of the trace, shared by all the models using the same trace
+   */
+  const FadingGains *m_fadingGains;
 
   
   Time m_traceLength;
@@ -0,0 +1,285 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <cmath>
+#include <vector>
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/integer.h>
+#include <ns3/uinteger.h>
+#include <ns3/string.h>
+#include <ns3/node-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/buildings-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/radio-environment-map-helper.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRadioEnvironmentMap");
+
+/**
+ * Generate the same Radio Environment Map of three sectorized eNBs with
+ * and without the DirectComputation attribute, and check that the maps
+ * are the same.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  /**
+   * \param rbId the RB the map is generated for, -1 for all
+   */
+  LteRadioEnvironmentMapTestCase (int32_t rbId);
+  virtual ~LteRadioEnvironmentMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run a simulation generating a map
+   *
+   * \param fileName the file the map is written to
+   * \param direct the DirectComputation attribute
+   */
+  void GenerateRem (std::string fileName, bool direct);
+
+  int32_t m_rbId;
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (int32_t rbId)
+  : TestCase ("REM computed directly, RbId " + std::string (rbId < 0 ? "all" : "single")),
+    m_rbId (rbId)
+{
+}
+
+LteRadioEnvironmentMapTestCase::~LteRadioEnvironmentMapTestCase ()
+{
+}
+
+void
+LteRadioEnvironmentMapTestCase::GenerateRem (std::string fileName, bool direct)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (65));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 30));
+  positionAlloc->Add (Vector (0, 0, 30));
+  positionAlloc->Add (Vector (300, 100, 30));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+
+  for (uint32_t i = 0; i < enbNodes.GetN (); i++)
+    {
+      lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (120.0 * i));
+      lteHelper->InstallEnbDevice (enbNodes.Get (i));
+    }
+
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue ("/ChannelList/0"));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (500.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (15));
+  remHelper->SetAttribute ("YMin", DoubleValue (-150.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (250.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (11));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (40));
+  remHelper->SetAttribute ("RbId", IntegerValue (m_rbId));
+  remHelper->SetAttribute ("DirectComputation", BooleanValue (direct));
+  remHelper->Install ();
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  std::string iteratedFile = CreateTempDirFilename ("rem-iterated.out");
+  std::string directFile = CreateTempDirFilename ("rem-direct.out");
+  GenerateRem (iteratedFile, false);
+  GenerateRem (directFile, true);
+
+  std::ifstream iterated (iteratedFile.c_str ());
+  std::ifstream direct (directFile.c_str ());
+  uint32_t points = 0;
+  double x, y, z, sinr;
+  while (iterated >> x >> y >> z >> sinr)
+    {
+      double directX, directY, directZ, directSinr;
+      NS_TEST_ASSERT_MSG_EQ ((bool)(direct >> directX >> directY >> directZ >> directSinr), true,
+                             "Missing point in the direct map");
+      NS_TEST_ASSERT_MSG_EQ_TOL (directX, x, 1e-6, "Wrong x");
+      NS_TEST_ASSERT_MSG_EQ_TOL (directY, y, 1e-6, "Wrong y");
+      NS_TEST_ASSERT_MSG_EQ_TOL (directZ, z, 1e-6, "Wrong z");
+      NS_TEST_ASSERT_MSG_EQ_TOL (directSinr, sinr, 1e-5 * sinr, "Wrong SINR at " << x << ", " << y);
+      ++points;
+    }
+  NS_TEST_ASSERT_MSG_EQ (points, 15 * 11, "Wrong number of points");
+  NS_TEST_ASSERT_MSG_EQ ((bool)(direct >> x), false, "Extra point in the direct map");
+}
+
+
+/**
+ * Generate the Radio Environment Map of one eNB with the
+ * HybridBuildingsPropagationLossModel, without shadowing and then with
+ * shadowing, with and without the DirectComputation attribute. The
+ * shadowing is drawn in another order by the two modes, hence the maps
+ * differ, but the difference between the SINR with and without shadowing
+ * must have the same spread in both modes.
+ */
+class LteRadioEnvironmentMapShadowingTestCase : public TestCase
+{
+public:
+  LteRadioEnvironmentMapShadowingTestCase ();
+  virtual ~LteRadioEnvironmentMapShadowingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run a simulation generating a map
+   *
+   * \param direct the DirectComputation attribute
+   * \param sigma the ShadowSigmaOutdoor attribute of the loss model
+   * \returns the SINR of the points of the map, in dB
+   */
+  std::vector<double> GenerateRem (bool direct, double sigma);
+
+  /**
+   * \param sinrs the SINR of the points of a map with shadowing
+   * \param reference the SINR of the points of the map without shadowing
+   * \returns the standard deviation of the shadowing of the map
+   */
+  double GetShadowingSigma (const std::vector<double> &sinrs, const std::vector<double> &reference);
+};
+
+LteRadioEnvironmentMapShadowingTestCase::LteRadioEnvironmentMapShadowingTestCase ()
+  : TestCase ("REM computed directly with shadowing")
+{
+}
+
+LteRadioEnvironmentMapShadowingTestCase::~LteRadioEnvironmentMapShadowingTestCase ()
+{
+}
+
+std::vector<double>
+LteRadioEnvironmentMapShadowingTestCase::GenerateRem (bool direct, double sigma)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::HybridBuildingsPropagationLossModel"));
+  lteHelper->SetPathlossModelAttribute ("ShadowSigmaOutdoor", DoubleValue (sigma));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 30));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  BuildingsHelper::Install (enbNodes);
+  lteHelper->InstallEnbDevice (enbNodes);
+
+  std::string fileName = CreateTempDirFilename ("rem-shadowing.out");
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue ("/ChannelList/0"));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-500.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (500.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (15));
+  remHelper->SetAttribute ("YMin", DoubleValue (-500.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (500.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (11));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (40));
+  remHelper->SetAttribute ("DirectComputation", BooleanValue (direct));
+  remHelper->Install ();
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::vector<double> sinrs;
+  std::ifstream file (fileName.c_str ());
+  double x, y, z, sinr;
+  while (file >> x >> y >> z >> sinr)
+    {
+      sinrs.push_back (10 * std::log10 (sinr));
+    }
+  return sinrs;
+}
+
+double
+LteRadioEnvironmentMapShadowingTestCase::GetShadowingSigma (const std::vector<double> &sinrs,
+                                                             const std::vector<double> &reference)
+{
+  double sum = 0;
+  double sumSquares = 0;
+  for (uint32_t i = 0; i < sinrs.size (); ++i)
+    {
+      double shadowing = reference[i] - sinrs[i];
+      sum += shadowing;
+      sumSquares += shadowing * shadowing;
+    }
+  double mean = sum / sinrs.size ();
+  return std::sqrt (sumSquares / sinrs.size () - mean * mean);
+}
+
+void
+LteRadioEnvironmentMapShadowingTestCase::DoRun (void)
+{
+  const double sigma = 7.0;
+  std::vector<double> reference = GenerateRem (false, 0.0);
+  NS_TEST_ASSERT_MSG_EQ (reference.size (), 15 * 11, "Wrong number of points");
+  std::vector<double> iterated = GenerateRem (false, sigma);
+  std::vector<double> direct = GenerateRem (true, sigma);
+  NS_TEST_ASSERT_MSG_EQ (iterated.size (), reference.size (), "Wrong number of points in the iterated map");
+  NS_TEST_ASSERT_MSG_EQ (direct.size (), reference.size (), "Wrong number of points in the direct map");
+
+  double iteratedSigma = GetShadowingSigma (iterated, reference);
+  double directSigma = GetShadowingSigma (direct, reference);
+  NS_LOG_INFO ("shadowing sigma: iterated " << iteratedSigma << " dB, direct " << directSigma << " dB");
+  NS_TEST_EXPECT_MSG_EQ_TOL (iteratedSigma, sigma, 0.25 * sigma, "Wrong shadowing in the iterated map");
+  NS_TEST_EXPECT_MSG_EQ_TOL (directSigma, sigma, 0.25 * sigma, "Wrong shadowing in the direct map");
+}
+
+
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite;
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase (-1), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase (3), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapShadowingTestCase (), TestCase::QUICK);
+}
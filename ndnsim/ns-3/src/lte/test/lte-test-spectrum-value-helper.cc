@@ -138,6 +138,53 @@ LteTxPsdTestCase::DoRun (void)
 
 
 
+/**
+ * Check that GetTxPowerSpectralDensity returns the same instance for the
+ * same parameters, with the value built by CreateTxPowerSpectralDensity
+ */
+class LteSharedTxPsdTestCase : public TestCase
+{
+public:
+  LteSharedTxPsdTestCase ();
+  virtual ~LteSharedTxPsdTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteSharedTxPsdTestCase::LteSharedTxPsdTestCase ()
+  :   TestCase ("shared TX PSD")
+{
+}
+
+LteSharedTxPsdTestCase::~LteSharedTxPsdTestCase ()
+{
+}
+
+void
+LteSharedTxPsdTestCase::DoRun (void)
+{
+  std::vector<int> activeRbs;
+  activeRbs.push_back (0);
+  activeRbs.push_back (3);
+  activeRbs.push_back (7);
+  Ptr<const SpectrumValue> shared = LteSpectrumValueHelper::GetTxPowerSpectralDensity (500, 25, 30, activeRbs);
+  Ptr<SpectrumValue> expected = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (500, 25, 30, activeRbs);
+  NS_TEST_ASSERT_MSG_EQ (shared->GetSpectrumModelUid (), expected->GetSpectrumModelUid (), "SpectrumModel UID mismatch");
+  NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL ((*shared), (*expected), 0.0000001, "SpectrumValues not equal");
+  NS_TEST_ASSERT_MSG_EQ (LteSpectrumValueHelper::GetTxPowerSpectralDensity (500, 25, 30, activeRbs), shared, "PSD not shared");
+
+  Ptr<const SpectrumValue> other = LteSpectrumValueHelper::GetTxPowerSpectralDensity (500, 25, 20, activeRbs);
+  NS_TEST_ASSERT_MSG_NE (other, shared, "PSD shared for a different power");
+  activeRbs.push_back (8);
+  other = LteSpectrumValueHelper::GetTxPowerSpectralDensity (500, 25, 30, activeRbs);
+  NS_TEST_ASSERT_MSG_NE (other, shared, "PSD shared for different RBs");
+  expected = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (500, 25, 30, activeRbs);
+  NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL ((*other), (*expected), 0.0000001, "SpectrumValues not equal");
+}
+
+
+
 
 class LteSpectrumValueHelperTestSuite : public TestSuite
 {
@@ -1649,6 +1696,6 @@ LteSpectrumValueHelperTestSuite::LteSpectrumValueHelperTestSuite ()
   spectrumValue_txpowdB30nrb100run2earfcn500[99] = 5.555555555556e-08;
   AddTestCase (new LteTxPsdTestCase ("txpowdB30nrb100run2earfcn500", 500, 100, 30.000000, activeRbs_txpowdB30nrb100run2earfcn500, spectrumValue_txpowdB30nrb100run2earfcn500), TestCase::QUICK);
 
-
+  AddTestCase (new LteSharedTxPsdTestCase (), TestCase::QUICK);
 
 }
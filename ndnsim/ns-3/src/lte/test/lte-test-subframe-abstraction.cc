@@ -0,0 +1,176 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/string.h>
+#include <ns3/node-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/lte-ue-net-device.h>
+#include <ns3/radio-bearer-stats-calculator.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestSubframeAbstraction");
+
+/**
+ * Run the same scenario of two interfering cells, with saturated DL and
+ * UL traffic, with and without the UseSubframeAbstraction attribute of
+ * the LteHelper, and check that every UE gets exactly the same DL and UL
+ * throughput.
+ */
+class LteSubframeAbstractionTestCase : public TestCase
+{
+public:
+  /**
+   * \param errorModel whether the PHY error models are enabled
+   */
+  LteSubframeAbstractionTestCase (bool errorModel);
+  virtual ~LteSubframeAbstractionTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run a simulation
+   *
+   * \param abstraction the UseSubframeAbstraction attribute
+   * \param dlRxData the bytes received in DL by each UE
+   * \param ulRxData the bytes received in UL from each UE
+   */
+  void RunScenario (bool abstraction, std::vector<uint64_t> &dlRxData, std::vector<uint64_t> &ulRxData);
+
+  bool m_errorModel;
+};
+
+LteSubframeAbstractionTestCase::LteSubframeAbstractionTestCase (bool errorModel)
+  : TestCase ("Subframe abstraction, error model " + std::string (errorModel ? "enabled" : "disabled")),
+    m_errorModel (errorModel)
+{
+}
+
+LteSubframeAbstractionTestCase::~LteSubframeAbstractionTestCase ()
+{
+}
+
+void
+LteSubframeAbstractionTestCase::RunScenario (bool abstraction, std::vector<uint64_t> &dlRxData, std::vector<uint64_t> &ulRxData)
+{
+  Config::SetDefault ("ns3::LteSpectrumPhy::CtrlErrorModelEnabled", BooleanValue (m_errorModel));
+  Config::SetDefault ("ns3::LteSpectrumPhy::DataErrorModelEnabled", BooleanValue (m_errorModel));
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("UseSubframeAbstraction", BooleanValue (abstraction));
+  lteHelper->SetSchedulerType ("ns3::PfFfMacScheduler");
+
+  // two cells, the UEs of each cell between the eNBs
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (2);
+  ueNodes.Create (6);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 0));
+  positionAlloc->Add (Vector (1000, 0, 0));
+  positionAlloc->Add (Vector (100, 0, 0));
+  positionAlloc->Add (Vector (300, 50, 0));
+  positionAlloc->Add (Vector (450, -50, 0));
+  positionAlloc->Add (Vector (900, 0, 0));
+  positionAlloc->Add (Vector (700, 50, 0));
+  positionAlloc->Add (Vector (550, -50, 0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // the same random streams in both simulations
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  lteHelper->AssignStreams (ueDevs, stream);
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i / 3));
+    }
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  double statsStartTime = 0.300; // need to allow for RRC connection establishment + SRS
+  double statsDuration = 0.4;
+  Simulator::Stop (Seconds (statsStartTime + statsDuration - 0.000001));
+
+  lteHelper->EnableRlcTraces ();
+  Ptr<RadioBearerStatsCalculator> rlcStats = lteHelper->GetRlcStats ();
+  rlcStats->SetAttribute ("StartTime", TimeValue (Seconds (statsStartTime)));
+  rlcStats->SetAttribute ("EpochDuration", TimeValue (Seconds (statsDuration)));
+  // keep the trace files out of the current directory
+  rlcStats->SetAttribute ("DlRlcOutputFilename", StringValue (CreateTempDirFilename ("DlRlcStats.txt")));
+  rlcStats->SetAttribute ("UlRlcOutputFilename", StringValue (CreateTempDirFilename ("UlRlcStats.txt")));
+
+  Simulator::Run ();
+
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      uint64_t imsi = ueDevs.Get (i)->GetObject<LteUeNetDevice> ()->GetImsi ();
+      dlRxData.push_back (rlcStats->GetDlRxData (imsi, 3));
+      ulRxData.push_back (rlcStats->GetUlRxData (imsi, 3));
+      NS_LOG_INFO ("abstraction " << abstraction << " imsi " << imsi
+                   << " DL bytes " << dlRxData.back () << " UL bytes " << ulRxData.back ());
+    }
+
+  Simulator::Destroy ();
+}
+
+void
+LteSubframeAbstractionTestCase::DoRun (void)
+{
+  std::vector<uint64_t> dlRxData;
+  std::vector<uint64_t> ulRxData;
+  RunScenario (false, dlRxData, ulRxData);
+  std::vector<uint64_t> dlRxDataAbstraction;
+  std::vector<uint64_t> ulRxDataAbstraction;
+  RunScenario (true, dlRxDataAbstraction, ulRxDataAbstraction);
+
+  for (uint32_t i = 0; i < dlRxData.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (dlRxData.at (i), 0, "No DL data for UE " << i);
+      NS_TEST_ASSERT_MSG_GT (ulRxData.at (i), 0, "No UL data for UE " << i);
+      NS_TEST_ASSERT_MSG_EQ (dlRxDataAbstraction.at (i), dlRxData.at (i), "Wrong DL data for UE " << i);
+      NS_TEST_ASSERT_MSG_EQ (ulRxDataAbstraction.at (i), ulRxData.at (i), "Wrong UL data for UE " << i);
+    }
+}
+
+
+class LteSubframeAbstractionTestSuite : public TestSuite
+{
+public:
+  LteSubframeAbstractionTestSuite ();
+};
+
+static LteSubframeAbstractionTestSuite g_lteSubframeAbstractionTestSuite;
+
+LteSubframeAbstractionTestSuite::LteSubframeAbstractionTestSuite ()
+  : TestSuite ("lte-subframe-abstraction", SYSTEM)
+{
+  AddTestCase (new LteSubframeAbstractionTestCase (false), TestCase::QUICK);
+  AddTestCase (new LteSubframeAbstractionTestCase (true), TestCase::QUICK);
+}
@@ -0,0 +1,176 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <fstream>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/trace-fading-loss-model.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTraceFadingTest");
+
+/**
+ * Load a small trace, whose fading in RB rb at sample k is k + 0.1 rb dB,
+ * and check the gains applied by the TraceFadingLossModel: all the RBs of
+ * a signal take the same sample, RBs without power stay without power, and
+ * the sample of a link advances every millisecond.
+ */
+class LteTraceFadingTestCase : public TestCase
+{
+public:
+  LteTraceFadingTestCase ();
+  virtual ~LteTraceFadingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param psd the received PSD
+   * \return the sample the fading of the PSD was taken from, -1 if the
+   * RBs do not match the same sample
+   */
+  int GetSample (Ptr<const SpectrumValue> psd);
+
+  /**
+   * Compute the received PSD of the link and check the sample it was
+   * taken from.
+   *
+   * \param expected the expected sample, -1 to record it without check
+   */
+  void CheckSample (int expected);
+
+  static const uint32_t RB_NUM = 3;
+  static const uint32_t SAMPLES_NUM = 10;
+
+  Ptr<TraceFadingLossModel> m_fading;
+  Ptr<MobilityModel> m_a;
+  Ptr<MobilityModel> m_b;
+  Ptr<SpectrumValue> m_txPsd;
+  int m_firstSample;
+};
+
+LteTraceFadingTestCase::LteTraceFadingTestCase ()
+  : TestCase ("trace fading gains"),
+    m_firstSample (-1)
+{
+}
+
+LteTraceFadingTestCase::~LteTraceFadingTestCase ()
+{
+}
+
+int
+LteTraceFadingTestCase::GetSample (Ptr<const SpectrumValue> psd)
+{
+  double fading = 10 * std::log10 ((*psd)[0] / (*m_txPsd)[0]);
+  int sample = (int)(fading + 0.5);
+  for (uint32_t rb = 0; rb < RB_NUM; rb++)
+    {
+      if ((*m_txPsd)[rb] == 0)
+        {
+          if ((*psd)[rb] != 0)
+            {
+              return -1;
+            }
+          continue;
+        }
+      double expected = (*m_txPsd)[rb] * std::pow (10., (sample + 0.1 * rb) / 10);
+      if (std::fabs ((*psd)[rb] - expected) > 1e-9 * expected)
+        {
+          return -1;
+        }
+    }
+  return sample;
+}
+
+void
+LteTraceFadingTestCase::CheckSample (int expected)
+{
+  int sample = GetSample (m_fading->CalcRxPowerSpectralDensity (m_txPsd, m_a, m_b));
+  NS_TEST_ASSERT_MSG_NE (sample, -1, "RBs faded with different samples");
+  if (expected == -1)
+    {
+      m_firstSample = sample;
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (sample, (m_firstSample + expected) % static_cast<int> (SAMPLES_NUM), "Wrong sample");
+    }
+}
+
+void
+LteTraceFadingTestCase::DoRun (void)
+{
+  std::string traceFile = CreateTempDirFilename ("fading_trace.fad");
+  std::ofstream trace (traceFile.c_str ());
+  for (uint32_t rb = 0; rb < RB_NUM; rb++)
+    {
+      for (uint32_t k = 0; k < SAMPLES_NUM; k++)
+        {
+          trace << k + 0.1 * rb << " ";
+        }
+    }
+  trace.close ();
+
+  m_fading = CreateObject<TraceFadingLossModel> ();
+  m_fading->SetAttribute ("TraceFilename", StringValue (traceFile));
+  m_fading->SetAttribute ("TraceLength", TimeValue (MilliSeconds (SAMPLES_NUM)));
+  m_fading->SetAttribute ("SamplesNum", UintegerValue (SAMPLES_NUM));
+  m_fading->SetAttribute ("WindowSize", TimeValue (MilliSeconds (5)));
+  m_fading->SetAttribute ("RbNum", UintegerValue (RB_NUM));
+  m_fading->Initialize ();
+
+  m_a = CreateObject<ConstantPositionMobilityModel> ();
+  m_b = CreateObject<ConstantPositionMobilityModel> ();
+
+  std::vector<double> freqs;
+  freqs.push_back (2.1e9);
+  freqs.push_back (2.10018e9);
+  freqs.push_back (2.10036e9);
+  m_txPsd = Create<SpectrumValue> (Create<SpectrumModel> (freqs));
+  (*m_txPsd)[0] = 1e-16;
+  (*m_txPsd)[1] = 0;
+  (*m_txPsd)[2] = 3e-17;
+
+  Simulator::Schedule (MilliSeconds (0), &LteTraceFadingTestCase::CheckSample, this, -1);
+  Simulator::Schedule (MilliSeconds (1), &LteTraceFadingTestCase::CheckSample, this, 1);
+  Simulator::Schedule (MilliSeconds (3), &LteTraceFadingTestCase::CheckSample, this, 3);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+
+class LteTraceFadingTestSuite : public TestSuite
+{
+public:
+  LteTraceFadingTestSuite ();
+};
+
+static LteTraceFadingTestSuite g_lteTraceFadingTestSuite;
+
+LteTraceFadingTestSuite::LteTraceFadingTestSuite ()
+  : TestSuite ("lte-trace-fading", UNIT)
+{
+  AddTestCase (new LteTraceFadingTestCase (), TestCase::QUICK);
+}
@@ -39,6 +39,11 @@
  *
  * One packet is sent from each left leaf node.  The packet sinks on the
  * right leaf nodes output logging information when they receive the packet.
+ *
+ * With --shm=1, the two logical processors are two processes of the same
+ * host exchanging messages through shared memory, and MPI is not used:
+ *
+ *   ./waf --run "simple-distributed --shm=1"
  */
 
 #include "ns3/core-module.h"
@@ -65,16 +70,16 @@ NS_LOG_COMPONENT_DEFINE ("SimpleDistributed");
 int
 main (int argc, char *argv[])
 {
-#ifdef NS3_MPI
-
   bool nix = true;
   bool nullmsg = false;
+  bool shm = false;
   bool tracing = false;
 
   // Parse command line
   CommandLine cmd;
   cmd.AddValue ("nix", "Enable the use of nix-vector or global routing", nix);
   cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+  cmd.AddValue ("shm", "Run the two LPs as processes sharing memory instead of MPI tasks (implies nullmsg)", shm);
   cmd.AddValue ("tracing", "Enable pcap tracing", tracing);
   cmd.Parse (argc, argv);
 
@@ -90,8 +95,16 @@ main (int argc, char *argv[])
                          StringValue ("ns3::DistributedSimulatorImpl"));
     }
 
-  // Enable parallel simulator with the command line arguments
-  MpiInterface::Enable (&argc, &argv);
+  if (shm)
+    {
+      // Fork the second LP, communicating through shared memory
+      MpiInterface::Enable (2);
+    }
+  else
+    {
+      // Enable parallel simulator with the command line arguments
+      MpiInterface::Enable (&argc, &argv);
+    }
 
   LogComponentEnable ("PacketSink", LOG_LEVEL_INFO);
 
@@ -279,7 +292,4 @@ main (int argc, char *argv[])
   // Exit the MPI execution environment
   MpiInterface::Disable ();
   return 0;
-#else
-  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
-#endif
 }
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mpi-partition-helper.h"
+#include "ns3/graph-partitioner.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpiPartitionHelper");
+
+MpiPartitionHelper::MpiPartitionHelper ()
+  : m_minLookahead (Seconds (0)),
+    m_imbalance (0.05),
+    m_lookahead (Time::Max ()),
+    m_cutTraffic (0)
+{
+}
+
+void
+MpiPartitionHelper::SetNodeWeight (Ptr<Node> node, double weight)
+{
+  NS_LOG_FUNCTION (this << node << weight);
+  if (node->GetId () >= m_nodeWeight.size ())
+    {
+      m_nodeWeight.resize (node->GetId () + 1, 1.0);
+    }
+  m_nodeWeight[node->GetId ()] = weight;
+}
+
+void
+MpiPartitionHelper::AddLink (Ptr<Node> a, Ptr<Node> b, Time delay, double traffic)
+{
+  NS_LOG_FUNCTION (this << a << b << delay << traffic);
+  Link link;
+  link.a = a->GetId ();
+  link.b = b->GetId ();
+  link.delay = delay;
+  link.traffic = traffic;
+  m_links.push_back (link);
+}
+
+void
+MpiPartitionHelper::SetMinLookahead (Time lookahead)
+{
+  m_minLookahead = lookahead;
+}
+
+void
+MpiPartitionHelper::SetImbalance (double imbalance)
+{
+  m_imbalance = imbalance;
+}
+
+std::vector<uint32_t>
+MpiPartitionHelper::Partition (uint32_t nSystems)
+{
+  NS_LOG_FUNCTION (this << nSystems);
+  uint32_t n = NodeList::GetNNodes ();
+
+  // the cost of cutting a link is relative to the shortest cuttable link
+  Time reference = Time::Max ();
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      if (i->delay.IsStrictlyPositive () && i->delay >= m_minLookahead && i->delay < reference)
+        {
+          reference = i->delay;
+        }
+    }
+
+  GraphPartitioner partitioner;
+  partitioner.SetNVertices (n);
+  partitioner.SetImbalance (m_imbalance);
+  for (uint32_t i = 0; i < n && i < m_nodeWeight.size (); i++)
+    {
+      partitioner.SetVertexWeight (i, m_nodeWeight[i]);
+    }
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      NS_ASSERT_MSG (i->a < n && i->b < n, "Link between nodes missing from the NodeList");
+      if (!i->delay.IsStrictlyPositive () || i->delay < m_minLookahead)
+        {
+          partitioner.AddUncuttableEdge (i->a, i->b);
+        }
+      else
+        {
+          partitioner.AddEdge (i->a, i->b, i->traffic * reference.GetDouble () / i->delay.GetDouble ());
+        }
+    }
+
+  std::vector<uint32_t> parts = partitioner.Partition (nSystems);
+
+  m_lookahead = Time::Max ();
+  m_cutTraffic = 0;
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      if (parts[i->a] != parts[i->b])
+        {
+          m_cutTraffic += i->traffic;
+          if (i->delay < m_lookahead)
+            {
+              m_lookahead = i->delay;
+            }
+        }
+    }
+  NS_LOG_INFO ("Partitioned " << n << " nodes in " << nSystems << " systems, lookahead "
+                              << m_lookahead << ", cut traffic " << m_cutTraffic);
+  return parts;
+}
+
+void
+MpiPartitionHelper::Install (uint32_t nSystems)
+{
+  NS_LOG_FUNCTION (this << nSystems);
+  std::vector<uint32_t> parts = Partition (nSystems);
+  for (uint32_t i = 0; i < parts.size (); i++)
+    {
+      NodeList::GetNode (i)->SetAttribute ("SystemId", UintegerValue (parts[i]));
+    }
+}
+
+Time
+MpiPartitionHelper::GetLookahead (void) const
+{
+  return m_lookahead;
+}
+
+double
+MpiPartitionHelper::GetCutTraffic (void) const
+{
+  return m_cutTraffic;
+}
+
+} // namespace ns3
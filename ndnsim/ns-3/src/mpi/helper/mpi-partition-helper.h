@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MPI_PARTITION_HELPER_H
+#define NS3_MPI_PARTITION_HELPER_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class Node;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Assign the nodes of a distributed simulation to the ranks.
+ *
+ * The helper is given the links of the topology, with their delay and
+ * an estimate of the traffic they carry, and the expected load of the
+ * nodes. It splits the nodes of the NodeList in balanced parts with
+ * GraphPartitioner, making cut links as rare and as long as possible:
+ * the cost of cutting a link is its traffic multiplied by the ratio of
+ * the reference delay to the link delay, so that low delay links, which
+ * limit the lookahead of the ranks, stay inside a rank. Links shorter
+ * than the minimum lookahead are never cut.
+ *
+ * Since the point-to-point helper decides whether a channel is remote
+ * from the system ids of its nodes, Install must be called after the
+ * nodes are created but before the devices are installed:
+ *
+ * \code
+ *   MpiPartitionHelper partition;
+ *   for (...)
+ *     {
+ *       partition.AddLink (a, b, delay);
+ *     }
+ *   partition.Install (MpiInterface::GetSize ());
+ *   // install the point-to-point devices
+ * \endcode
+ *
+ * The partition is deterministic, so every rank computes the same one.
+ */
+class MpiPartitionHelper
+{
+public:
+  MpiPartitionHelper ();
+
+  /**
+   * \param node a node
+   * \param weight expected load of the node, relative to the default of 1
+   */
+  void SetNodeWeight (Ptr<Node> node, double weight);
+
+  /**
+   * \param a first end of the link
+   * \param b second end of the link
+   * \param delay propagation delay of the link
+   * \param traffic expected traffic of the link, relative to the default of 1
+   */
+  void AddLink (Ptr<Node> a, Ptr<Node> b, Time delay, double traffic = 1.0);
+
+  /**
+   * \param lookahead links shorter than this delay are never cut
+   *
+   * By default, only links with no delay are uncuttable.
+   */
+  void SetMinLookahead (Time lookahead);
+
+  /**
+   * \param imbalance allowed excess of the load of a rank over the average,
+   *        e.g. 0.05 (the default) for 5%
+   */
+  void SetImbalance (double imbalance);
+
+  /**
+   * \param nSystems number of ranks
+   * \return the rank of each node of the NodeList, indexed by node id
+   */
+  std::vector<uint32_t> Partition (uint32_t nSystems);
+
+  /**
+   * \param nSystems number of ranks
+   *
+   * Partition the nodes and set the SystemId attribute of each node of
+   * the NodeList accordingly.
+   */
+  void Install (uint32_t nSystems);
+
+  /**
+   * \return the smallest delay of the links cut by the last partition,
+   *         or Time::Max () if no link is cut
+   */
+  Time GetLookahead (void) const;
+
+  /**
+   * \return the total traffic of the links cut by the last partition
+   */
+  double GetCutTraffic (void) const;
+
+private:
+  /// A link of the topology
+  struct Link
+  {
+    uint32_t a;     //!< id of the first node
+    uint32_t b;     //!< id of the second node
+    Time delay;     //!< link delay
+    double traffic; //!< expected link traffic
+  };
+
+  std::vector<double> m_nodeWeight; //!< weight of the nodes, indexed by id
+  std::vector<Link> m_links;        //!< links of the topology
+  Time m_minLookahead;              //!< delay below which links are not cut
+  double m_imbalance;               //!< allowed load imbalance
+  Time m_lookahead;                 //!< lookahead of the last partition
+  double m_cutTraffic;              //!< traffic cut by the last partition
+};
+
+} // namespace ns3
+
+#endif /* NS3_MPI_PARTITION_HELPER_H */
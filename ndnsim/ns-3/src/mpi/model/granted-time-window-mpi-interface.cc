@@ -20,6 +20,7 @@
 // This object contains static methods that provide an easy interface
 // to the necessary MPI information.
 
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <list>
@@ -44,27 +45,26 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GrantedTimeWindowMpiInterface");
 
+/*
+ * Each message holds the packets sent to a rank during a time window,
+ * one after the other, each one preceded by its receive time (uint64_t),
+ * destination node, destination device and serialized size (uint32_t).
+ */
+static const uint32_t PACKET_HEADER_SIZE = sizeof (uint64_t) + 3 * sizeof (uint32_t);
+
 SentBuffer::SentBuffer ()
 {
-  m_buffer = 0;
   m_request = 0;
 }
 
 SentBuffer::~SentBuffer ()
 {
-  delete [] m_buffer;
 }
 
-uint8_t*
-SentBuffer::GetBuffer ()
+std::vector<uint8_t>&
+SentBuffer::GetData ()
 {
-  return m_buffer;
-}
-
-void
-SentBuffer::SetBuffer (uint8_t* buffer)
-{
-  m_buffer = buffer;
+  return m_data;
 }
 
 #ifdef NS3_MPI
@@ -82,11 +82,10 @@ bool                  GrantedTimeWindowMpiInterface::m_enabled = false;
 uint32_t              GrantedTimeWindowMpiInterface::m_rxCount = 0;
 uint32_t              GrantedTimeWindowMpiInterface::m_txCount = 0;
 std::list<SentBuffer> GrantedTimeWindowMpiInterface::m_pendingTx;
-
-#ifdef NS3_MPI
-MPI_Request* GrantedTimeWindowMpiInterface::m_requests;
-char**       GrantedTimeWindowMpiInterface::m_pRxBuffers;
-#endif
+std::vector<std::vector<uint8_t> > GrantedTimeWindowMpiInterface::m_txBuffers;
+std::vector<std::vector<uint8_t> > GrantedTimeWindowMpiInterface::m_freeBuffers;
+std::vector<uint8_t> GrantedTimeWindowMpiInterface::m_rxBuffer;
+std::unordered_map<uint64_t, Ptr<MpiReceiver> > GrantedTimeWindowMpiInterface::m_receivers;
 
 TypeId 
 GrantedTimeWindowMpiInterface::GetTypeId (void)
@@ -104,13 +103,10 @@ GrantedTimeWindowMpiInterface::Destroy ()
   NS_LOG_FUNCTION (this);
 
 #ifdef NS3_MPI
-  for (uint32_t i = 0; i < GetSize (); ++i)
-    {
-      delete [] m_pRxBuffers[i];
-    }
-  delete [] m_pRxBuffers;
-  delete [] m_requests;
-
+  m_txBuffers.clear ();
+  m_freeBuffers.clear ();
+  m_rxBuffer.clear ();
+  m_receivers.clear ();
   m_pendingTx.clear ();
 #endif
 }
@@ -173,15 +169,7 @@ GrantedTimeWindowMpiInterface::Enable (int* pargc, char*** pargv)
   MPI_Comm_size (MPI_COMM_WORLD, reinterpret_cast <int *> (&m_size));
   m_enabled = true;
   m_initialized = true;
-  // Post a non-blocking receive for all peers
-  m_pRxBuffers = new char*[m_size];
-  m_requests = new MPI_Request[m_size];
-  for (uint32_t i = 0; i < GetSize (); ++i)
-    {
-      m_pRxBuffers[i] = new char[MAX_MPI_MSG_SIZE];
-      MPI_Irecv (m_pRxBuffers[i], MAX_MPI_MSG_SIZE, MPI_CHAR, MPI_ANY_SOURCE, 0,
-                 MPI_COMM_WORLD, &m_requests[i]);
-    }
+  m_txBuffers.resize (m_size);
 #else
   NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
 #endif
@@ -193,93 +181,157 @@ GrantedTimeWindowMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, ui
   NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
 
 #ifdef NS3_MPI
-  SentBuffer sendBuf;
-  m_pendingTx.push_back (sendBuf);
-  std::list<SentBuffer>::reverse_iterator i = m_pendingTx.rbegin (); // Points to the last element
-
-  uint32_t serializedSize = p->GetSerializedSize ();
-  uint8_t* buffer =  new uint8_t[serializedSize + 16];
-  i->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t t = rxTime.GetInteger ();
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = t;
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = node;
-  *pData++ = dev;
-  // Serialize the packet
-  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
-
   // Find the system id for the destination node
   Ptr<Node> destNode = NodeList::GetNode (node);
   uint32_t nodeSysId = destNode->GetSystemId ();
+  std::vector<uint8_t> &buffer = m_txBuffers[nodeSysId];
 
-  MPI_Isend (reinterpret_cast<void *> (i->GetBuffer ()), serializedSize + 16, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (i->GetRequest ()));
+  // Append the time, dest node, dest device and size, then the packet
+  uint32_t serializedSize = p->GetSerializedSize ();
+  std::size_t offset = buffer.size ();
+  buffer.resize (offset + PACKET_HEADER_SIZE + serializedSize);
+  uint8_t* data = &buffer[offset];
+  uint64_t t = rxTime.GetInteger ();
+  std::memcpy (data, &t, sizeof (t));
+  data += sizeof (t);
+  std::memcpy (data, &node, sizeof (node));
+  data += sizeof (node);
+  std::memcpy (data, &dev, sizeof (dev));
+  data += sizeof (dev);
+  std::memcpy (data, &serializedSize, sizeof (serializedSize));
+  data += sizeof (serializedSize);
+  p->Serialize (data, serializedSize);
   m_txCount++;
+
+  if (buffer.size () >= MPI_AGGREGATE_FLUSH_SIZE)
+    {
+      Flush (nodeSysId);
+    }
+#else
+  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+#endif
+}
+
+void
+GrantedTimeWindowMpiInterface::Flush (uint32_t rank)
+{
+  NS_LOG_FUNCTION (rank);
+
+#ifdef NS3_MPI
+  m_pendingTx.push_back (SentBuffer ());
+  SentBuffer &sent = m_pendingTx.back ();
+  sent.GetData ().swap (m_txBuffers[rank]);
+  if (!m_freeBuffers.empty ())
+    {
+      m_txBuffers[rank].swap (m_freeBuffers.back ());
+      m_freeBuffers.pop_back ();
+    }
+  MPI_Isend (&sent.GetData ()[0], sent.GetData ().size (), MPI_CHAR, rank,
+             0, MPI_COMM_WORLD, sent.GetRequest ());
+#endif
+}
+
+void
+GrantedTimeWindowMpiInterface::FlushSendBuffers ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+#ifdef NS3_MPI
+  for (uint32_t rank = 0; rank < m_txBuffers.size (); ++rank)
+    {
+      if (!m_txBuffers[rank].empty ())
+        {
+          Flush (rank);
+        }
+    }
 #else
   NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
 #endif
 }
 
+Ptr<MpiReceiver>
+GrantedTimeWindowMpiInterface::GetReceiver (uint32_t node, uint32_t dev)
+{
+  uint64_t key = (static_cast<uint64_t> (node) << 32) | dev;
+  std::unordered_map<uint64_t, Ptr<MpiReceiver> >::const_iterator it = m_receivers.find (key);
+  if (it != m_receivers.end ())
+    {
+      return it->second;
+    }
+
+  // Find the correct node/device to schedule receive event
+  Ptr<Node> pNode = NodeList::GetNode (node);
+  Ptr<MpiReceiver> pMpiRec = 0;
+  uint32_t nDevices = pNode->GetNDevices ();
+  for (uint32_t i = 0; i < nDevices; ++i)
+    {
+      Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
+      if (pThisDev->GetIfIndex () == dev)
+        {
+          pMpiRec = pThisDev->GetObject<MpiReceiver> ();
+          break;
+        }
+    }
+  NS_ASSERT (pNode && pMpiRec);
+  m_receivers[key] = pMpiRec;
+  return pMpiRec;
+}
+
 void
 GrantedTimeWindowMpiInterface::ReceiveMessages ()
 { 
   NS_LOG_FUNCTION_NOARGS ();
 
 #ifdef NS3_MPI
-  // Poll the non-block reads to see if data arrived
+  // Poll for arrived messages, each one holding a batch of packets
   while (true)
     {
       int flag = 0;
-      int index = 0;
       MPI_Status status;
 
-      MPI_Testany (MpiInterface::GetSize (), m_requests, &index, &flag, &status);
+      MPI_Iprobe (MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &flag, &status);
       if (!flag)
         {
           break;        // No more messages
         }
       int count;
       MPI_Get_count (&status, MPI_CHAR, &count);
-      m_rxCount++; // Count this receive
-
-      // Get the meta data first
-      uint64_t* pTime = reinterpret_cast<uint64_t *> (m_pRxBuffers[index]);
-      uint64_t time = *pTime++;
-      uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-      uint32_t node = *pData++;
-      uint32_t dev  = *pData++;
-
-      Time rxTime (time);
-
-      count -= sizeof (time) + sizeof (node) + sizeof (dev);
-
-      Ptr<Packet> p = Create<Packet> (reinterpret_cast<uint8_t *> (pData), count, true);
-
-      // Find the correct node/device to schedule receive event
-      Ptr<Node> pNode = NodeList::GetNode (node);
-      Ptr<MpiReceiver> pMpiRec = 0;
-      uint32_t nDevices = pNode->GetNDevices ();
-      for (uint32_t i = 0; i < nDevices; ++i)
+      if (m_rxBuffer.size () < static_cast<std::size_t> (count))
         {
-          Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
-          if (pThisDev->GetIfIndex () == dev)
-            {
-              pMpiRec = pThisDev->GetObject<MpiReceiver> ();
-              break;
-            }
+          m_rxBuffer.resize (count);
         }
+      MPI_Recv (&m_rxBuffer[0], count, MPI_CHAR, status.MPI_SOURCE, 0,
+                MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
-      NS_ASSERT (pNode && pMpiRec);
-
-      // Schedule the rx event
-      Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
-                                      &MpiReceiver::Receive, pMpiRec, p);
-
-      // Re-queue the next read
-      MPI_Irecv (m_pRxBuffers[index], MAX_MPI_MSG_SIZE, MPI_CHAR, MPI_ANY_SOURCE, 0,
-                 MPI_COMM_WORLD, &m_requests[index]);
+      const uint8_t* data = &m_rxBuffer[0];
+      const uint8_t* end = data + count;
+      while (data + PACKET_HEADER_SIZE <= end)
+        {
+          // Get the meta data first
+          uint64_t time;
+          uint32_t node;
+          uint32_t dev;
+          uint32_t size;
+          std::memcpy (&time, data, sizeof (time));
+          data += sizeof (time);
+          std::memcpy (&node, data, sizeof (node));
+          data += sizeof (node);
+          std::memcpy (&dev, data, sizeof (dev));
+          data += sizeof (dev);
+          std::memcpy (&size, data, sizeof (size));
+          data += sizeof (size);
+          NS_ASSERT (data + size <= end);
+
+          m_rxCount++; // Count this receive
+
+          Time rxTime (time);
+          Ptr<Packet> p = Create<Packet> (data, size, true);
+          data += size;
+
+          // Schedule the rx event
+          Simulator::ScheduleWithContext (node, rxTime - Simulator::Now (),
+                                          &MpiReceiver::Receive, GetReceiver (node, dev), p);
+        }
     }
 #else
   NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
@@ -301,7 +353,10 @@ GrantedTimeWindowMpiInterface::TestSendComplete ()
       std::list<SentBuffer>::iterator current = i; // Save current for erasing
       i++;                                    // Advance to next
       if (flag)
-        { // This message is complete
+        { // This message is complete, keep its memory for later sends
+          m_freeBuffers.push_back (std::vector<uint8_t> ());
+          m_freeBuffers.back ().swap (current->GetData ());
+          m_freeBuffers.back ().clear ();
           m_pendingTx.erase (current);
         }
     }
@@ -25,6 +25,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 #include "ns3/nstime.h"
 #include "ns3/buffer.h"
@@ -45,13 +47,20 @@ namespace ns3 {
  */
 const uint32_t MAX_MPI_MSG_SIZE = 2000;
 
+/**
+ * size above which the packets aggregated for a rank are sent
+ * without waiting for the end of the time window
+ */
+const uint32_t MPI_AGGREGATE_FLUSH_SIZE = 65536;
+
 /**
  * \ingroup mpi
  *
  * \brief Tracks non-blocking sends
  *
  * This class is used to keep track of the asynchronous non-blocking
- * sends that have been posted.
+ * sends that have been posted. The data of a completed send is given
+ * back to the interface, so that its memory is reused by later sends.
  */
 class SentBuffer
 {
@@ -60,24 +69,21 @@ public:
   ~SentBuffer ();
 
   /**
-   * \return pointer to sent buffer
-   */
-  uint8_t* GetBuffer ();
-  /**
-   * \param buffer pointer to sent buffer
+   * \return the data being sent
    */
-  void SetBuffer (uint8_t* buffer);
+  std::vector<uint8_t>& GetData ();
   /**
    * \return MPI request
    */
   MPI_Request* GetRequest ();
 
 private:
-  uint8_t* m_buffer;
+  std::vector<uint8_t> m_data;
   MPI_Request m_request;
 };
 
 class Packet;
+class MpiReceiver;
 
 /**
  * \ingroup mpi
@@ -128,9 +134,18 @@ public:
    * \param node destination node
    * \param dev destination device
    *
-   * Serialize and send a packet to the specified node and net device
+   * Serialize a packet for the specified node and net device. The
+   * packets for a given rank are aggregated in a single message, sent
+   * by FlushSendBuffers or when it reaches MPI_AGGREGATE_FLUSH_SIZE.
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * Send the packets aggregated for each rank.
+   *
+   * Must be called before computing the LBTS, so that the packets
+   * counted as sent are actually on their way.
+   */
+  static void FlushSendBuffers ();
   /**
    * Check for received messages complete
    */
@@ -149,6 +164,19 @@ public:
   static uint32_t GetTxCount ();
 
 private:
+  /**
+   * \param rank destination rank
+   *
+   * Post the non-blocking send of the packets aggregated for rank.
+   */
+  static void Flush (uint32_t rank);
+  /**
+   * \param node node id
+   * \param dev device interface index
+   * \return the receiver of the device
+   */
+  static Ptr<MpiReceiver> GetReceiver (uint32_t node, uint32_t dev);
+
   static uint32_t m_sid;
   static uint32_t m_size;
 
@@ -160,11 +188,17 @@ private:
   static bool     m_initialized;
   static bool     m_enabled;
 
-  // Pending non-blocking receives
-  static MPI_Request* m_requests;
+  // Packets aggregated for each rank, not sent yet
+  static std::vector<std::vector<uint8_t> > m_txBuffers;
+
+  // Data of completed sends, kept for reuse
+  static std::vector<std::vector<uint8_t> > m_freeBuffers;
+
+  // Data buffer for reads
+  static std::vector<uint8_t> m_rxBuffer;
 
-  // Data buffers for non-blocking reads
-  static char**   m_pRxBuffers;
+  // Receiver of each device, indexed by node id and interface index
+  static std::unordered_map<uint64_t, Ptr<MpiReceiver> > m_receivers;
 
   // List of pending non-blocking sends
   static std::list<SentBuffer> m_pendingTx;
@@ -0,0 +1,531 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "graph-partitioner.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GraphPartitioner");
+
+/// Marker of an unset vertex or part index
+static const uint32_t NONE = 0xffffffff;
+
+/// Number of passes of the refinement at each level
+static const uint32_t REFINE_PASSES = 8;
+
+GraphPartitioner::GraphPartitioner ()
+  : m_imbalance (0.05)
+{
+}
+
+void
+GraphPartitioner::SetNVertices (uint32_t n)
+{
+  m_vertexWeight.assign (n, 1.0);
+  m_edges.clear ();
+  m_uncuttable.clear ();
+}
+
+uint32_t
+GraphPartitioner::GetNVertices (void) const
+{
+  return m_vertexWeight.size ();
+}
+
+void
+GraphPartitioner::SetVertexWeight (uint32_t v, double weight)
+{
+  NS_ASSERT (v < m_vertexWeight.size () && weight >= 0);
+  m_vertexWeight[v] = weight;
+}
+
+void
+GraphPartitioner::AddEdge (uint32_t a, uint32_t b, double weight)
+{
+  NS_ASSERT (a < m_vertexWeight.size () && b < m_vertexWeight.size () && weight >= 0);
+  Edge e = { a, b, weight };
+  m_edges.push_back (e);
+}
+
+void
+GraphPartitioner::AddUncuttableEdge (uint32_t a, uint32_t b)
+{
+  NS_ASSERT (a < m_vertexWeight.size () && b < m_vertexWeight.size ());
+  Edge e = { a, b, 0 };
+  m_uncuttable.push_back (e);
+}
+
+void
+GraphPartitioner::SetImbalance (double imbalance)
+{
+  NS_ASSERT (imbalance >= 0);
+  m_imbalance = imbalance;
+}
+
+void
+GraphPartitioner::BuildGraph (const std::vector<double> &vertexWeight,
+                              const std::vector<Edge> &edges, Graph &g)
+{
+  uint32_t n = vertexWeight.size ();
+  g.vertexWeight = vertexWeight;
+
+  std::vector<uint32_t> start (n + 1, 0);
+  for (std::vector<Edge>::const_iterator e = edges.begin (); e != edges.end (); ++e)
+    {
+      if (e->a != e->b)
+        {
+          start[e->a + 1]++;
+          start[e->b + 1]++;
+        }
+    }
+  for (uint32_t v = 0; v < n; v++)
+    {
+      start[v + 1] += start[v];
+    }
+  std::vector<uint32_t> fill (start.begin (), start.end () - 1);
+  std::vector<uint32_t> rawAdj (start[n]);
+  std::vector<double> rawWeight (start[n]);
+  for (std::vector<Edge>::const_iterator e = edges.begin (); e != edges.end (); ++e)
+    {
+      if (e->a != e->b)
+        {
+          rawAdj[fill[e->a]] = e->b;
+          rawWeight[fill[e->a]++] = e->weight;
+          rawAdj[fill[e->b]] = e->a;
+          rawWeight[fill[e->b]++] = e->weight;
+        }
+    }
+
+  // merge parallel edges
+  g.xadj.assign (1, 0);
+  g.adj.clear ();
+  g.adjWeight.clear ();
+  g.adj.reserve (start[n]);
+  g.adjWeight.reserve (start[n]);
+  std::vector<uint32_t> where (n, NONE);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      uint32_t first = g.adj.size ();
+      for (uint32_t i = start[v]; i < start[v + 1]; i++)
+        {
+          uint32_t u = rawAdj[i];
+          if (where[u] != NONE && where[u] >= first)
+            {
+              g.adjWeight[where[u]] += rawWeight[i];
+            }
+          else
+            {
+              where[u] = g.adj.size ();
+              g.adj.push_back (u);
+              g.adjWeight.push_back (rawWeight[i]);
+            }
+        }
+      g.xadj.push_back (g.adj.size ());
+    }
+}
+
+void
+GraphPartitioner::Coarsen (const Graph &g, double maxVertexWeight, Graph &coarse, std::vector<uint32_t> &map)
+{
+  uint32_t n = g.GetN ();
+
+  // visit low degree vertices first, so that they still find a free neighbor
+  std::vector<std::pair<uint32_t, uint32_t> > order (n);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      order[v] = std::make_pair (g.xadj[v + 1] - g.xadj[v], v);
+    }
+  std::sort (order.begin (), order.end ());
+
+  // heavy-edge matching
+  std::vector<uint32_t> match (n, NONE);
+  for (uint32_t o = 0; o < n; o++)
+    {
+      uint32_t v = order[o].second;
+      if (match[v] != NONE)
+        {
+          continue;
+        }
+      uint32_t best = NONE;
+      double bestWeight = -1;
+      for (uint32_t i = g.xadj[v]; i < g.xadj[v + 1]; i++)
+        {
+          uint32_t u = g.adj[i];
+          if (match[u] == NONE && g.adjWeight[i] > bestWeight
+              && g.vertexWeight[v] + g.vertexWeight[u] <= maxVertexWeight)
+            {
+              best = u;
+              bestWeight = g.adjWeight[i];
+            }
+        }
+      if (best == NONE)
+        {
+          match[v] = v;
+        }
+      else
+        {
+          match[v] = best;
+          match[best] = v;
+        }
+    }
+
+  map.assign (n, NONE);
+  uint32_t nCoarse = 0;
+  for (uint32_t v = 0; v < n; v++)
+    {
+      if (map[v] == NONE)
+        {
+          map[v] = nCoarse;
+          map[match[v]] = nCoarse;
+          nCoarse++;
+        }
+    }
+
+  std::vector<double> weight (nCoarse, 0);
+  std::vector<Edge> edges;
+  for (uint32_t v = 0; v < n; v++)
+    {
+      weight[map[v]] += g.vertexWeight[v];
+      for (uint32_t i = g.xadj[v]; i < g.xadj[v + 1]; i++)
+        {
+          if (v < g.adj[i] && map[v] != map[g.adj[i]])
+            {
+              Edge e = { map[v], map[g.adj[i]], g.adjWeight[i] };
+              edges.push_back (e);
+            }
+        }
+    }
+  BuildGraph (weight, edges, coarse);
+}
+
+void
+GraphPartitioner::InitialPartition (const Graph &g, uint32_t k, std::vector<uint32_t> &parts)
+{
+  uint32_t n = g.GetN ();
+  double total = 0;
+  for (uint32_t v = 0; v < n; v++)
+    {
+      total += g.vertexWeight[v];
+    }
+
+  // gain of adding a vertex to the part being grown: weight of its edges
+  // to the part minus weight of its other edges
+  std::vector<double> degree (n, 0);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      for (uint32_t i = g.xadj[v]; i < g.xadj[v + 1]; i++)
+        {
+          degree[v] += g.adjWeight[i];
+        }
+    }
+
+  parts.assign (n, NONE);
+  std::vector<double> gain (n);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      gain[v] = -degree[v];
+    }
+  uint32_t next = 0;
+  for (uint32_t p = 0; p < k; p++)
+    {
+      if (p == k - 1)
+        {
+          for (uint32_t v = 0; v < n; v++)
+            {
+              if (parts[v] == NONE)
+                {
+                  parts[v] = p;
+                }
+            }
+          break;
+        }
+
+      // grow the part from a seed, always adding the free vertex with the
+      // highest gain
+      // parts overshoot their target by up to a vertex, so spread the
+      // remaining weight over the remaining parts
+      double target = total / (k - p);
+      std::priority_queue<std::pair<double, int64_t> > frontier;
+      double weight = 0;
+      while (weight < target)
+        {
+          uint32_t v = NONE;
+          while (!frontier.empty ())
+            {
+              std::pair<double, int64_t> top = frontier.top ();
+              frontier.pop ();
+              uint32_t u = -top.second;
+              if (parts[u] == NONE && gain[u] == top.first)
+                {
+                  v = u;
+                  break;
+                }
+            }
+          if (v == NONE)
+            {
+              while (next < n && parts[next] != NONE)
+                {
+                  next++;
+                }
+              if (next == n)
+                {
+                  break;
+                }
+              v = next;
+            }
+          parts[v] = p;
+          weight += g.vertexWeight[v];
+          for (uint32_t i = g.xadj[v]; i < g.xadj[v + 1]; i++)
+            {
+              uint32_t u = g.adj[i];
+              if (parts[u] == NONE)
+                {
+                  gain[u] += 2 * g.adjWeight[i];
+                  frontier.push (std::make_pair (gain[u], -static_cast<int64_t> (u)));
+                }
+            }
+        }
+      total -= weight;
+      for (uint32_t v = 0; v < n; v++)
+        {
+          gain[v] = -degree[v];
+        }
+    }
+}
+
+void
+GraphPartitioner::Refine (const Graph &g, uint32_t k, double maxPartWeight, std::vector<uint32_t> &parts)
+{
+  uint32_t n = g.GetN ();
+  std::vector<double> partWeight (k, 0);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      partWeight[parts[v]] += g.vertexWeight[v];
+    }
+
+  std::vector<double> conn (k, 0);
+  std::vector<uint32_t> stamp (k, NONE);
+  std::vector<uint32_t> touched;
+  for (uint32_t pass = 0; pass < REFINE_PASSES; pass++)
+    {
+      uint32_t moved = 0;
+      for (uint32_t v = 0; v < n; v++)
+        {
+          uint32_t own = parts[v];
+          double w = g.vertexWeight[v];
+          touched.clear ();
+          for (uint32_t i = g.xadj[v]; i < g.xadj[v + 1]; i++)
+            {
+              uint32_t q = parts[g.adj[i]];
+              if (stamp[q] != v)
+                {
+                  stamp[q] = v;
+                  conn[q] = 0;
+                  touched.push_back (q);
+                }
+              conn[q] += g.adjWeight[i];
+            }
+          double internal = stamp[own] == v ? conn[own] : 0;
+          bool overloaded = partWeight[own] > maxPartWeight;
+
+          uint32_t best = own;
+          double bestGain = 0;
+          for (std::vector<uint32_t>::const_iterator q = touched.begin (); q != touched.end (); ++q)
+            {
+              if (*q == own || partWeight[*q] + w > maxPartWeight)
+                {
+                  continue;
+                }
+              double gain = conn[*q] - internal;
+              bool better;
+              if (best == own)
+                {
+                  better = gain > 0 || overloaded
+                    || (gain == 0 && partWeight[*q] + w < partWeight[own]);
+                }
+              else
+                {
+                  better = gain > bestGain
+                    || (gain == bestGain && partWeight[*q] < partWeight[best]);
+                }
+              if (better)
+                {
+                  best = *q;
+                  bestGain = gain;
+                }
+            }
+          if (best == own && overloaded)
+            {
+              // no neighboring part can take the vertex, use the lightest part
+              uint32_t lightest = std::min_element (partWeight.begin (), partWeight.end ()) - partWeight.begin ();
+              if (lightest != own && partWeight[lightest] + w <= maxPartWeight)
+                {
+                  best = lightest;
+                }
+            }
+          if (best != own)
+            {
+              partWeight[own] -= w;
+              partWeight[best] += w;
+              parts[v] = best;
+              moved++;
+            }
+        }
+      if (moved == 0)
+        {
+          break;
+        }
+    }
+}
+
+std::vector<uint32_t>
+GraphPartitioner::Partition (uint32_t k) const
+{
+  NS_LOG_FUNCTION (this << k);
+  NS_ASSERT (k > 0);
+  uint32_t n = m_vertexWeight.size ();
+  if (k == 1 || n == 0)
+    {
+      return std::vector<uint32_t> (n, 0);
+    }
+
+  // collapse the uncuttable edges first
+  std::vector<uint32_t> root (n);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      root[v] = v;
+    }
+  for (std::vector<Edge>::const_iterator e = m_uncuttable.begin (); e != m_uncuttable.end (); ++e)
+    {
+      uint32_t a = e->a;
+      uint32_t b = e->b;
+      while (root[a] != a)
+        {
+          a = root[a] = root[root[a]];
+        }
+      while (root[b] != b)
+        {
+          b = root[b] = root[root[b]];
+        }
+      if (a < b)
+        {
+          root[b] = a;
+        }
+      else
+        {
+          root[a] = b;
+        }
+    }
+  std::vector<uint32_t> super (n);
+  std::vector<uint32_t> id (n, NONE);
+  std::vector<double> weight;
+  for (uint32_t v = 0; v < n; v++)
+    {
+      uint32_t r = v;
+      while (root[r] != r)
+        {
+          r = root[r];
+        }
+      if (id[r] == NONE)
+        {
+          id[r] = weight.size ();
+          weight.push_back (0);
+        }
+      super[v] = id[r];
+      weight[super[v]] += m_vertexWeight[v];
+    }
+  std::vector<Edge> edges;
+  edges.reserve (m_edges.size ());
+  double total = 0;
+  for (uint32_t v = 0; v < weight.size (); v++)
+    {
+      total += weight[v];
+    }
+  for (std::vector<Edge>::const_iterator e = m_edges.begin (); e != m_edges.end (); ++e)
+    {
+      if (super[e->a] != super[e->b])
+        {
+          Edge coarse = { super[e->a], super[e->b], e->weight };
+          edges.push_back (coarse);
+        }
+    }
+
+  std::vector<Graph> graphs (1);
+  std::vector<std::vector<uint32_t> > maps;
+  BuildGraph (weight, edges, graphs[0]);
+
+  uint32_t coarsenTo = std::max<uint32_t> (15 * k, 60);
+  double maxVertexWeight = 1.5 * total / coarsenTo;
+  while (graphs.back ().GetN () > coarsenTo)
+    {
+      Graph coarse;
+      std::vector<uint32_t> map;
+      Coarsen (graphs.back (), maxVertexWeight, coarse, map);
+      if (coarse.GetN () > 0.95 * graphs.back ().GetN ())
+        {
+          break;
+        }
+      graphs.push_back (coarse);
+      maps.push_back (map);
+    }
+  NS_LOG_LOGIC ("coarsened " << n << " vertices to " << graphs.back ().GetN ()
+                             << " in " << maps.size () << " levels");
+
+  double maxPartWeight = (1 + m_imbalance) * total / k;
+  std::vector<uint32_t> parts;
+  InitialPartition (graphs.back (), k, parts);
+  Refine (graphs.back (), k, maxPartWeight, parts);
+  for (uint32_t level = maps.size (); level-- > 0; )
+    {
+      std::vector<uint32_t> fine (graphs[level].GetN ());
+      for (uint32_t v = 0; v < fine.size (); v++)
+        {
+          fine[v] = parts[maps[level][v]];
+        }
+      Refine (graphs[level], k, maxPartWeight, fine);
+      parts.swap (fine);
+    }
+
+  std::vector<uint32_t> result (n);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      result[v] = parts[super[v]];
+    }
+  return result;
+}
+
+double
+GraphPartitioner::GetEdgeCut (const std::vector<uint32_t> &parts) const
+{
+  NS_ASSERT (parts.size () == m_vertexWeight.size ());
+  double cut = 0;
+  for (std::vector<Edge>::const_iterator e = m_edges.begin (); e != m_edges.end (); ++e)
+    {
+      if (parts[e->a] != parts[e->b])
+        {
+          cut += e->weight;
+        }
+    }
+  return cut;
+}
+
+} // namespace ns3
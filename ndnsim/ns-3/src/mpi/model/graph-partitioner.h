@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_GRAPH_PARTITIONER_H
+#define NS3_GRAPH_PARTITIONER_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Multilevel k-way partitioner of weighted undirected graphs.
+ *
+ * Splits the vertices of a graph in k parts of balanced total vertex
+ * weight while minimizing the total weight of the edges whose end points
+ * are in different parts (the edge cut). Edges can also be marked as
+ * uncuttable, so that their end points always end up in the same part.
+ *
+ * The graph is repeatedly coarsened by collapsing heavy-edge matchings,
+ * the coarsest graph is split by greedy graph growing, and the partition
+ * is projected back level by level with a greedy boundary refinement at
+ * each level.
+ *
+ * The algorithm is deterministic: the same graph always gives the same
+ * partition, so that every rank of a distributed simulation can compute
+ * it independently.
+ */
+class GraphPartitioner
+{
+public:
+  GraphPartitioner ();
+
+  /**
+   * \param n number of vertices of the graph
+   *
+   * Set the number of vertices, all with weight 1, and remove all edges.
+   */
+  void SetNVertices (uint32_t n);
+
+  /**
+   * \return the number of vertices of the graph
+   */
+  uint32_t GetNVertices (void) const;
+
+  /**
+   * \param v vertex index
+   * \param weight vertex weight (estimated load)
+   */
+  void SetVertexWeight (uint32_t v, double weight);
+
+  /**
+   * \param a first end point
+   * \param b second end point
+   * \param weight cost of cutting the edge; parallel edges add up
+   *
+   * Add an edge between vertices a and b.
+   */
+  void AddEdge (uint32_t a, uint32_t b, double weight);
+
+  /**
+   * \param a first end point
+   * \param b second end point
+   *
+   * Add an edge that must not be cut: a and b always get the same part.
+   */
+  void AddUncuttableEdge (uint32_t a, uint32_t b);
+
+  /**
+   * \param imbalance allowed excess of a part weight over the average,
+   *        e.g. 0.05 for 5%
+   */
+  void SetImbalance (double imbalance);
+
+  /**
+   * \param k number of parts
+   * \return the part (between 0 and k - 1) of each vertex
+   */
+  std::vector<uint32_t> Partition (uint32_t k) const;
+
+  /**
+   * \param parts the part of each vertex
+   * \return the total weight of the edges between different parts
+   */
+  double GetEdgeCut (const std::vector<uint32_t> &parts) const;
+
+private:
+  /// A weighted edge
+  struct Edge
+  {
+    uint32_t a;    //!< first end point
+    uint32_t b;    //!< second end point
+    double weight; //!< edge weight
+  };
+
+  /// A graph in compressed sparse row form
+  struct Graph
+  {
+    std::vector<double> vertexWeight;  //!< weight of each vertex
+    std::vector<uint32_t> xadj;        //!< start of the neighbors of each vertex in adj
+    std::vector<uint32_t> adj;         //!< neighbors
+    std::vector<double> adjWeight;     //!< weight of the edge to each neighbor
+    /// \return the number of vertices
+    uint32_t GetN (void) const
+    {
+      return vertexWeight.size ();
+    }
+  };
+
+  /**
+   * \param vertexWeight weight of each vertex
+   * \param edges edges between the vertices, parallel edges are merged
+   * \param [out] g the graph built
+   */
+  static void BuildGraph (const std::vector<double> &vertexWeight,
+                          const std::vector<Edge> &edges, Graph &g);
+
+  /**
+   * \param g the graph to coarsen
+   * \param maxVertexWeight maximum weight of a coarse vertex
+   * \param [out] coarse the coarse graph
+   * \param [out] map the coarse vertex of each vertex of g
+   */
+  static void Coarsen (const Graph &g, double maxVertexWeight, Graph &coarse, std::vector<uint32_t> &map);
+
+  /**
+   * \param g the graph to split
+   * \param k number of parts
+   * \param [out] parts the part of each vertex
+   */
+  static void InitialPartition (const Graph &g, uint32_t k, std::vector<uint32_t> &parts);
+
+  /**
+   * \param g the graph
+   * \param k number of parts
+   * \param maxPartWeight maximum weight of a part
+   * \param [in,out] parts the part of each vertex
+   */
+  static void Refine (const Graph &g, uint32_t k, double maxPartWeight, std::vector<uint32_t> &parts);
+
+  std::vector<double> m_vertexWeight; //!< weight of each vertex
+  std::vector<Edge> m_edges;          //!< cuttable edges
+  std::vector<Edge> m_uncuttable;     //!< uncuttable edges
+  double m_imbalance;                 //!< allowed part weight imbalance
+};
+
+} // namespace ns3
+
+#endif /* NS3_GRAPH_PARTITIONER_H */
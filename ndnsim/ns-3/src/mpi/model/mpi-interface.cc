@@ -27,6 +27,7 @@
 
 #include "null-message-mpi-interface.h"
 #include "granted-time-window-mpi-interface.h"
+#include "shared-memory-interface.h"
 
 namespace ns3 {
 
@@ -108,6 +109,28 @@ MpiInterface::Enable (int* pargc, char*** pargv)
   g_parallelCommunicationInterface->Enable (pargc, pargv);
 }
 
+void
+MpiInterface::Enable (uint32_t nSystems)
+{
+  StringValue simulationTypeValue;
+  if (GlobalValue::GetValueByNameFailSafe ("SimulatorImplementationType", simulationTypeValue)
+      && simulationTypeValue.Get () != "ns3::NullMessageSimulatorImpl")
+    {
+      NS_LOG_WARN ("Shared memory communication requires ns3::NullMessageSimulatorImpl; setting SimulatorImplementationType to it");
+    }
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue ("ns3::NullMessageSimulatorImpl"));
+
+  g_parallelCommunicationInterface = new SharedMemoryInterface (nSystems);
+  g_parallelCommunicationInterface->Enable (0, 0);
+}
+
+ParallelCommunicationInterface*
+MpiInterface::GetParallelCommunicationInterface ()
+{
+  return g_parallelCommunicationInterface;
+}
+
 void
 MpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t node, uint32_t dev)
 {
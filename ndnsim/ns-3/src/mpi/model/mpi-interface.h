@@ -80,6 +80,20 @@ public:
    * Enable is invoked.
    */
   static void Enable (int* pargc, char*** pargv);
+  /**
+   * \param nSystems number of parallel tasks
+   *
+   * \brief Sets up the shared memory communication interface.
+   *
+   * Runs the simulation on a single host without MPI: the process is
+   * forked in nSystems processes, which exchange packets and Null
+   * Messages through shared memory.  The calling process gets system
+   * id 0 and the forked ones system ids 1 to nSystems - 1; all of them
+   * return from Enable and run the rest of the program.  Only the
+   * ns3::NullMessageSimulatorImpl simulator implementation is supported,
+   * SimulatorImplementationType is set accordingly.
+   */
+  static void Enable (uint32_t nSystems);
   /**
    * Terminates the parallel environment.
    * This function must be called after Destroy ()
@@ -94,6 +108,10 @@ public:
    * Serialize and send a packet to the specified node and net device
    */
   static void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * \return the communication interface in use, or 0 if none is enabled
+   */
+  static ParallelCommunicationInterface* GetParallelCommunicationInterface ();
 private:
 
   /**
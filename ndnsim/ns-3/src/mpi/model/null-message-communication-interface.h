@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_NULL_MESSAGE_COMMUNICATION_INTERFACE_H
+#define NS3_NULL_MESSAGE_COMMUNICATION_INTERFACE_H
+
+#include "parallel-communication-interface.h"
+
+namespace ns3 {
+
+class RemoteChannelBundle;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Pure virtual base class for the communication layers usable
+ * by the Null Message simulator implementation.
+ *
+ * On top of sending packets, the layer carries Null Messages and lets
+ * NullMessageSimulatorImpl wait for the messages of its neighbors.
+ * Each message sent or received, packet or Null Message, is reported to
+ * the RemoteChannelBundle of the remote task (RemoteChannelBundle::NotifySent
+ * and RemoteChannelBundle::NotifyReceived), which updates its guarantee time.
+ */
+class NullMessageCommunicationInterface : public ParallelCommunicationInterface
+{
+public:
+  /**
+   * \param guaranteeUpdate guarantee update time for the Null Message
+   * \param bundle the destination bundle for the Null Message.
+   * \param request true to ask the remote task for a Null Message in return
+   *
+   * \brief Send a Null Message across the specified bundle.
+   */
+  virtual void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle,
+                                bool request) = 0;
+  /**
+   * Non-blocking check for received messages complete.  Will
+   * receive all messages that are queued up locally.
+   */
+  virtual void ReceiveMessagesNonBlocking () = 0;
+  /**
+   * Blocking message receive.  Will block until at least one message
+   * has been received.
+   */
+  virtual void ReceiveMessagesBlocking () = 0;
+  /**
+   * Check for completed sends
+   */
+  virtual void TestSendComplete () = 0;
+  /**
+   * \brief Initialize send and receive buffers.
+   *
+   * This method should be called after all links have been added to the RemoteChannelBundle
+   * manager to setup any required send and receive buffers.
+   */
+  virtual void InitializeSendReceiveBuffers (void) = 0;
+};
+
+} // namespace ns3
+
+#endif /* NS3_NULL_MESSAGE_COMMUNICATION_INTERFACE_H */
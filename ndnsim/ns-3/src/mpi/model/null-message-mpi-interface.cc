@@ -221,6 +221,7 @@ NullMessageMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t
 
   Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
   *pTime++ = guarantee_update.GetTimeStep ();
+  RemoteChannelBundleManager::Find (nodeSysId)->NotifySent (RemoteChannelBundle::PACKET, guarantee_update);
 
   uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
   *pData++ = node;
@@ -237,9 +238,10 @@ NullMessageMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t
 }
 
 void
-NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<RemoteChannelBundle> bundle)
+NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<RemoteChannelBundle> bundle,
+                                          bool request)
 {
-  NS_LOG_FUNCTION (guarantee_update.GetTimeStep () << bundle);
+  NS_LOG_FUNCTION (guarantee_update.GetTimeStep () << bundle << request);
 
   NS_ASSERT (g_enabled);
 
@@ -257,11 +259,13 @@ NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<Remo
   *pTime++ = 0;
   *pTime++ = guarantee_update.GetInteger ();
   uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = 0;
+  *pData++ = request ? 1 : 0;
   *pData++ = 0;
 
   // Find the system id for the destination MPI rank
   uint32_t nodeSysId = bundle->GetSystemId ();
+  bundle->NotifySent (request ? RemoteChannelBundle::NULL_MESSAGE_REQUEST : RemoteChannelBundle::NULL_MESSAGE,
+                      guarantee_update);
 
   MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
              0, MPI_COMM_WORLD, (iter->GetRequest ()));
@@ -370,7 +374,12 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
           Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (status.MPI_SOURCE);
           NS_ASSERT (bundle);
 
-          bundle->SetGuaranteeTime (Time (guaranteeUpdate));
+          RemoteChannelBundle::MessageType type = RemoteChannelBundle::PACKET;
+          if (rxTime == Time (0))
+            {
+              type = node ? RemoteChannelBundle::NULL_MESSAGE_REQUEST : RemoteChannelBundle::NULL_MESSAGE;
+            }
+          bundle->NotifyReceived (type, Time (guaranteeUpdate));
 
           // Re-queue the next read
           MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, status.MPI_SOURCE, 0,
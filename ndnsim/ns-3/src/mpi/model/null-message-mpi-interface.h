@@ -22,7 +22,7 @@
 #ifndef NS3_NULLMESSAGE_MPI_INTERFACE_H
 #define NS3_NULLMESSAGE_MPI_INTERFACE_H
 
-#include "parallel-communication-interface.h"
+#include "null-message-communication-interface.h"
 
 #include <ns3/nstime.h>
 #include <ns3/buffer.h>
@@ -85,7 +85,7 @@ private:
  * \brief Interface between ns-3 and MPI for the Null Message
  * distributed simulation implementation.
  */
-class NullMessageMpiInterface : public ParallelCommunicationInterface
+class NullMessageMpiInterface : public NullMessageCommunicationInterface
 {
 public:
 
@@ -161,24 +161,25 @@ public:
    *
    * uint64_t 0 must be zero for Null Message
    * uint64_t guarantee time
-   * uint32_t 0 must be zero for Null Message
+   * uint32_t 0 for a Null Message, 1 for a Null Message request
    * uint32_t 0 must be zero for Null Message
    */
-  static void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle);
+  virtual void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle,
+                                bool request);
   /**
    * Non-blocking check for received messages complete.  Will
    * receive all messages that are queued up locally.
    */
-  static void ReceiveMessagesNonBlocking ();
+  virtual void ReceiveMessagesNonBlocking ();
   /**
    * Blocking message receive.  Will block until at least one message
    * has been received.
    */
-  static void ReceiveMessagesBlocking ();
+  virtual void ReceiveMessagesBlocking ();
   /**
    * Check for completed sends
    */
-  static void TestSendComplete ();
+  virtual void TestSendComplete ();
 
   /**
    * \brief Initialize send and receive buffers.
@@ -186,7 +187,7 @@ public:
    * This method should be called after all links have been added to the RemoteChannelBundle
    * manager to setup any required send and receive buffers.
    */
-  static void InitializeSendReceiveBuffers (void);
+  virtual void InitializeSendReceiveBuffers (void);
 
 private:
 
@@ -21,7 +21,7 @@
 
 #include "null-message-simulator-impl.h"
 
-#include "null-message-mpi-interface.h"
+#include "null-message-communication-interface.h"
 #include "remote-channel-bundle-manager.h"
 #include "remote-channel-bundle.h"
 #include "mpi-interface.h"
@@ -32,12 +32,16 @@
 #include <ns3/channel.h>
 #include <ns3/node-container.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/string.h>
 #include <ns3/ptr.h>
 #include <ns3/pointer.h>
 #include <ns3/assert.h>
 #include <ns3/log.h>
 
+#include <chrono>
 #include <cmath>
+#include <sstream>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -61,15 +65,33 @@ NullMessageSimulatorImpl::GetTypeId (void)
                    DoubleValue (1.0),
                    MakeDoubleAccessor (&NullMessageSimulatorImpl::m_schedulerTune),
                    MakeDoubleChecker<double> (0.01,1.0))
+    .AddAttribute ("DemandDriven",
+                   "Only send Null Messages when a blocked neighbor asks for one, "
+                   "instead of periodically",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NullMessageSimulatorImpl::m_demandDriven),
+                   MakeBooleanChecker ())
+    .AddAttribute ("StatisticsFile",
+                   "If not empty, prefix of the file where each task writes the message "
+                   "counts and blocked time of its remote channel bundles",
+                   StringValue (""),
+                   MakeStringAccessor (&NullMessageSimulatorImpl::m_statisticsFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
 NullMessageSimulatorImpl::NullMessageSimulatorImpl ()
 {
-#ifdef NS3_MPI
   NS_LOG_FUNCTION (this);
 
+  m_communication = dynamic_cast<NullMessageCommunicationInterface*> (MpiInterface::GetParallelCommunicationInterface ());
+  if (m_communication == 0)
+    {
+      NS_FATAL_ERROR ("Can't use Null Message simulator without MPI compiled in and enabled, "
+                      "or shared memory communication enabled");
+    }
+
   m_myId = MpiInterface::GetSystemId ();
   m_systemCount = MpiInterface::GetSize ();
 
@@ -87,18 +109,17 @@ NullMessageSimulatorImpl::NullMessageSimulatorImpl ()
   m_events = 0;
 
   m_safeTime = Seconds (0);
+  m_demandDriven = false;
 
   NS_ASSERT (g_instance == 0);
   g_instance = this;
-
-#else
-  NS_FATAL_ERROR ("Can't use Null Message simulator without MPI compiled in");
-#endif
 }
 
 NullMessageSimulatorImpl::~NullMessageSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  // another simulation may follow, e.g. after MpiInterface::Enable (n)
+  g_instance = 0;
 }
 
 void
@@ -131,6 +152,12 @@ NullMessageSimulatorImpl::Destroy ()
         }
     }
 
+  if (!m_statisticsFile.empty ())
+    {
+      WriteStatistics ();
+    }
+  m_bundles.clear ();
+
   RemoteChannelBundleManager::Destroy();
   MpiInterface::Destroy ();
 }
@@ -202,7 +229,7 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
     }
 
   // Completed setup of remote channel bundles.  Setup send and receive buffers.
-  NullMessageMpiInterface::InitializeSendReceiveBuffers ();
+  m_communication->InitializeSendReceiveBuffers ();
 
   // Initialized to 0 as we don't have a simulation start time.
   m_safeTime = Time (0);
@@ -266,6 +293,11 @@ NullMessageSimulatorImpl::ScheduleNullMessageEvent (Ptr<RemoteChannelBundle> bun
 {
   NS_LOG_FUNCTION (this << bundle);
 
+  if (m_demandDriven)
+    {
+      return;
+    }
+
   Time delay (m_schedulerTune * bundle->GetDelay ().GetTimeStep ());
 
   bundle->SetEventId (Simulator::Schedule (delay, &NullMessageSimulatorImpl::NullMessageEventHandler, 
@@ -277,6 +309,11 @@ NullMessageSimulatorImpl::RescheduleNullMessageEvent (Ptr<RemoteChannelBundle> b
 {
   NS_LOG_FUNCTION (this << bundle);
 
+  if (m_demandDriven)
+    {
+      return;
+    }
+
   Simulator::Cancel (bundle->GetEventId ());
 
   Time delay (m_schedulerTune * bundle->GetDelay ().GetTimeStep ());
@@ -305,6 +342,16 @@ NullMessageSimulatorImpl::Run (void)
 
   RemoteChannelBundleManager::InitializeNullMessageEvents ();
 
+  m_bundles.clear ();
+  for (uint32_t i = 0; i < m_systemCount; ++i)
+    {
+      Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (i);
+      if (bundle)
+        {
+          m_bundles.push_back (bundle);
+        }
+    }
+
   // Stop will be set if stop is called by simulation.
   m_stop = false;
   while (!IsFinished ())
@@ -318,10 +365,107 @@ NullMessageSimulatorImpl::Run (void)
         }
       else
         {
+          if (m_demandDriven)
+            {
+              RequestNullMessages (nextTime);
+            }
           // Block until packet or Null Message has been received.
           HandleArrivingMessagesBlocking ();
         }
     }
+
+  if (m_demandDriven)
+    {
+      // Neighbors may still be waiting for the end of this task; give
+      // them the last guarantee time it can offer.
+      Time next = Min (NextOrMaximum (), GetSafeTime ());
+      for (std::vector<Ptr<RemoteChannelBundle> >::const_iterator i = m_bundles.begin ();
+           i != m_bundles.end (); ++i)
+        {
+          Time guarantee = next + (*i)->GetDelay ();
+          if (guarantee > (*i)->GetSentGuaranteeTime ())
+            {
+              m_communication->SendNullMessage (guarantee, *i, false);
+            }
+        }
+      m_communication->TestSendComplete ();
+    }
+}
+
+void
+NullMessageSimulatorImpl::RequestNullMessages (Time nextTime)
+{
+  NS_LOG_FUNCTION (this << nextTime);
+
+  Time next = Min (nextTime, GetSafeTime ());
+  for (std::vector<Ptr<RemoteChannelBundle> >::const_iterator i = m_bundles.begin ();
+       i != m_bundles.end (); ++i)
+    {
+      Ptr<RemoteChannelBundle> bundle = *i;
+      if (bundle->GetGuaranteeTime () < nextTime && !bundle->IsNullMessageRequestPending ())
+        {
+          // The request carries the current guarantee time of this
+          // task, so that the neighbor can make progress too.
+          Time guarantee = Max (next + bundle->GetDelay (), bundle->GetSentGuaranteeTime ());
+          m_communication->SendNullMessage (guarantee, bundle, true);
+        }
+    }
+}
+
+void
+NullMessageSimulatorImpl::AnswerNullMessageRequests (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time next = Min (NextOrMaximum (), GetSafeTime ());
+  for (std::vector<Ptr<RemoteChannelBundle> >::const_iterator i = m_bundles.begin ();
+       i != m_bundles.end (); ++i)
+    {
+      Ptr<RemoteChannelBundle> bundle = *i;
+      if (!bundle->IsNullMessageRequested ())
+        {
+          continue;
+        }
+      // Only answer when there is something new to tell; otherwise the
+      // request is kept until the local time advances.
+      Time guarantee = next + bundle->GetDelay ();
+      if (guarantee > bundle->GetSentGuaranteeTime ())
+        {
+          m_communication->SendNullMessage (guarantee, bundle, false);
+        }
+    }
+}
+
+Time
+NullMessageSimulatorImpl::NextOrMaximum (void) const
+{
+  if (m_events->IsEmpty ())
+    {
+      return GetMaximumSimulationTime ();
+    }
+  return Next ();
+}
+
+void
+NullMessageSimulatorImpl::WriteStatistics (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  std::ostringstream name;
+  name << m_statisticsFile << "-" << m_myId << ".txt";
+  std::ofstream os (name.str ().c_str ());
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Could not open " << name.str () << " to write the Null Message statistics");
+      return;
+    }
+  os << "# remote delay packetsSent packetsReceived nullSent nullReceived "
+     << "requestsSent requestsReceived blockedTime" << std::endl;
+  for (std::vector<Ptr<RemoteChannelBundle> >::const_iterator i = m_bundles.begin ();
+       i != m_bundles.end (); ++i)
+    {
+      (*i)->PrintStatistics (os);
+    }
 }
 
 void
@@ -329,12 +473,17 @@ NullMessageSimulatorImpl::HandleArrivingMessagesNonBlocking (void)
 {
   NS_LOG_FUNCTION (this);
 
-  NullMessageMpiInterface::ReceiveMessagesNonBlocking ();
+  m_communication->ReceiveMessagesNonBlocking ();
 
   CalculateSafeTime ();
 
+  if (m_demandDriven)
+    {
+      AnswerNullMessageRequests ();
+    }
+
   // Check for send completes
-  NullMessageMpiInterface::TestSendComplete ();
+  m_communication->TestSendComplete ();
 }
 
 void
@@ -342,12 +491,37 @@ NullMessageSimulatorImpl::HandleArrivingMessagesBlocking (void)
 {
   NS_LOG_FUNCTION (this);
 
-  NullMessageMpiInterface::ReceiveMessagesBlocking ();
+  // The bundles that are behind the next local event are the ones this
+  // task is waiting for
+  Time nextTime = Next ();
+  std::vector<RemoteChannelBundle*> behind;
+  for (std::vector<Ptr<RemoteChannelBundle> >::const_iterator i = m_bundles.begin ();
+       i != m_bundles.end (); ++i)
+    {
+      if ((*i)->GetGuaranteeTime () < nextTime)
+        {
+          behind.push_back (PeekPointer (*i));
+        }
+    }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  m_communication->ReceiveMessagesBlocking ();
+  double blocked = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+
+  for (std::vector<RemoteChannelBundle*>::const_iterator i = behind.begin (); i != behind.end (); ++i)
+    {
+      (*i)->AddBlockedTime (blocked);
+    }
 
   CalculateSafeTime ();
 
+  if (m_demandDriven)
+    {
+      AnswerNullMessageRequests ();
+    }
+
   // Check for send completes
-  NullMessageMpiInterface::TestSendComplete ();
+  m_communication->TestSendComplete ();
 }
 
 void
@@ -588,7 +762,7 @@ void NullMessageSimulatorImpl::NullMessageEventHandler(RemoteChannelBundle* bund
   NS_LOG_FUNCTION (this << bundle);
 
   Time time = Min (Next (), GetSafeTime ()) + bundle->GetDelay ();
-  NullMessageMpiInterface::SendNullMessage (time, bundle);
+  m_communication->SendNullMessage (time, bundle, false);
 
   ScheduleNullMessageEvent (bundle);
 }
@@ -600,5 +774,11 @@ NullMessageSimulatorImpl::GetInstance (void)
   NS_ASSERT (g_instance != 0);
   return g_instance;
 }
+
+NullMessageCommunicationInterface*
+NullMessageSimulatorImpl::GetCommunicationInterface (void) const
+{
+  return m_communication;
+}
 } // namespace ns3
 
@@ -28,6 +28,8 @@
 #include <ns3/ptr.h>
 
 #include <list>
+#include <vector>
+#include <string>
 #include <iostream>
 #include <fstream>
 
@@ -35,12 +37,23 @@ namespace ns3 {
 
 class NullMessageEvent;
 class NullMessageMpiInterface;
+class NullMessageCommunicationInterface;
+class SharedMemoryInterface;
 class RemoteChannelBundle;
 
 /**
  * \ingroup mpi
  *
  * \brief Simulator implementation using MPI and a Null Message algorithm.
+ *
+ * The messages are exchanged through MPI (NullMessageMpiInterface) or,
+ * on a single host, through shared memory (SharedMemoryInterface).
+ *
+ * By default Null Messages are sent periodically on every bundle (see
+ * the SchedulerTune attribute).  With the DemandDriven attribute, they
+ * are only sent when a neighbor asks for one because it is blocked;
+ * the guarantee time piggybacked on each packet is then the only other
+ * source of lookahead information.
  */
 class NullMessageSimulatorImpl : public SimulatorImpl
 {
@@ -79,9 +92,15 @@ public:
    */
   static NullMessageSimulatorImpl * GetInstance (void);
 
+  /**
+   * \return the communication layer used to exchange messages
+   */
+  NullMessageCommunicationInterface * GetCommunicationInterface (void) const;
+
 private:
   friend class NullMessageEvent;
   friend class NullMessageMpiInterface;
+  friend class SharedMemoryInterface;
   friend class RemoteChannelBundleManager;
 
   /**
@@ -94,6 +113,32 @@ private:
    */
   void HandleArrivingMessagesBlocking (void);
 
+  /**
+   * \param nextTime time of the next local event
+   *
+   * Ask for a Null Message on every bundle whose guarantee time is
+   * before nextTime and that has no request pending.
+   */
+  void RequestNullMessages (Time nextTime);
+
+  /**
+   * Send a Null Message on every bundle whose remote task asked for one,
+   * as soon as it carries a guarantee time later than the last one sent.
+   */
+  void AnswerNullMessageRequests (void);
+
+  /**
+   * \return the time of the next local event, or the maximum
+   * simulation time if there is none.
+   */
+  Time NextOrMaximum (void) const;
+
+  /**
+   * Write the statistics of every bundle to the file given by the
+   * StatisticsFile attribute, suffixed by the system id.
+   */
+  void WriteStatistics (void) const;
+
   virtual void DoDispose (void);
 
   /**
@@ -201,10 +246,31 @@ private:
    */
   double m_schedulerTune;
 
+  /*
+   * Only send Null Messages when asked by a blocked neighbor.
+   */
+  bool m_demandDriven;
+
+  /*
+   * Prefix of the file where the statistics of the bundles are written
+   * at the end of the simulation, empty if not written.
+   */
+  std::string m_statisticsFile;
+
+  /*
+   * The remote channel bundles of this task.
+   */
+  std::vector<Ptr<RemoteChannelBundle> > m_bundles;
+
   /*
    * Singleton instance.
    */
   static NullMessageSimulatorImpl* g_instance;
+
+  /**
+   * Communication layer used to exchange messages.
+   */
+  NullMessageCommunicationInterface* m_communication;
 };
 
 } // namespace ns3
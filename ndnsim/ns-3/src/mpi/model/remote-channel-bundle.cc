@@ -21,11 +21,13 @@
 
 #include "remote-channel-bundle.h"
 
-#include "null-message-mpi-interface.h"
+#include "null-message-communication-interface.h"
 #include "null-message-simulator-impl.h"
 
 #include <ns3/simulator.h>
 
+#include <algorithm>
+
 namespace ns3 {
 
 #define NS_TIME_INFINITY ns3::Time (0x7fffffffffffffffLL)
@@ -42,15 +44,27 @@ TypeId RemoteChannelBundle::GetTypeId (void)
 RemoteChannelBundle::RemoteChannelBundle ()
   : m_remoteSystemId (-1),
     m_guaranteeTime (0),
-    m_delay (NS_TIME_INFINITY)
+    m_delay (NS_TIME_INFINITY),
+    m_sentGuaranteeTime (0),
+    m_nullMessageRequested (false),
+    m_nullMessageRequestPending (false),
+    m_blockedTime (0)
 {
+  std::fill (m_sent, m_sent + 3, 0);
+  std::fill (m_received, m_received + 3, 0);
 }
 
 RemoteChannelBundle::RemoteChannelBundle (const uint32_t remoteSystemId)
   : m_remoteSystemId (remoteSystemId),
     m_guaranteeTime (0),
-    m_delay (NS_TIME_INFINITY)
+    m_delay (NS_TIME_INFINITY),
+    m_sentGuaranteeTime (0),
+    m_nullMessageRequested (false),
+    m_nullMessageRequestPending (false),
+    m_blockedTime (0)
 {
+  std::fill (m_sent, m_sent + 3, 0);
+  std::fill (m_received, m_received + 3, 0);
 }
 
 void
@@ -107,7 +121,75 @@ RemoteChannelBundle::GetSize (void) const
 void 
 RemoteChannelBundle::Send(Time time)
 {
-  NullMessageMpiInterface::SendNullMessage (time, this);  
+  NullMessageSimulatorImpl::GetInstance ()->GetCommunicationInterface ()->SendNullMessage (time, this, false);
+}
+
+void
+RemoteChannelBundle::NotifySent (MessageType type, Time guarantee)
+{
+  m_sent[type]++;
+  m_sentGuaranteeTime = Max (m_sentGuaranteeTime, guarantee);
+  if (type == NULL_MESSAGE_REQUEST)
+    {
+      // The remote task does not take a request as an answer to its own,
+      // so it still has to be answered
+      m_nullMessageRequestPending = true;
+    }
+  else
+    {
+      m_nullMessageRequested = false;
+    }
+}
+
+void
+RemoteChannelBundle::NotifyReceived (MessageType type, Time guarantee)
+{
+  m_received[type]++;
+  SetGuaranteeTime (guarantee);
+  if (type == NULL_MESSAGE_REQUEST)
+    {
+      // A request crossing ours does not answer it: the remote task
+      // answers as soon as it has a later guarantee time to offer.
+      m_nullMessageRequested = true;
+    }
+  else
+    {
+      m_nullMessageRequestPending = false;
+    }
+}
+
+Time
+RemoteChannelBundle::GetSentGuaranteeTime (void) const
+{
+  return m_sentGuaranteeTime;
+}
+
+bool
+RemoteChannelBundle::IsNullMessageRequested (void) const
+{
+  return m_nullMessageRequested;
+}
+
+bool
+RemoteChannelBundle::IsNullMessageRequestPending (void) const
+{
+  return m_nullMessageRequestPending;
+}
+
+void
+RemoteChannelBundle::AddBlockedTime (double seconds)
+{
+  m_blockedTime += seconds;
+}
+
+void
+RemoteChannelBundle::PrintStatistics (std::ostream &os) const
+{
+  os << m_remoteSystemId << " " << m_delay.GetSeconds ()
+     << " " << m_sent[PACKET] << " " << m_received[PACKET]
+     << " " << m_sent[NULL_MESSAGE] << " " << m_received[NULL_MESSAGE]
+     << " " << m_sent[NULL_MESSAGE_REQUEST] << " " << m_received[NULL_MESSAGE_REQUEST]
+     << " " << m_blockedTime << std::endl;
 }
 
 std::ostream& operator<< (std::ostream& out, ns3::RemoteChannelBundle& bundle )
@@ -47,6 +47,16 @@ class RemoteChannelBundle : public Object
 public:
   static TypeId GetTypeId (void);
 
+  /**
+   * Kinds of messages exchanged with the remote task.
+   */
+  enum MessageType
+  {
+    PACKET,              //!< a packet, carrying a guarantee time
+    NULL_MESSAGE,        //!< a Null Message
+    NULL_MESSAGE_REQUEST //!< a Null Message asking for a Null Message in return
+  };
+
   RemoteChannelBundle ();
 
   RemoteChannelBundle (const uint32_t remoteSystemId);
@@ -109,6 +119,52 @@ public:
    */
   void Send(Time time);
 
+  /**
+   * \param type kind of message sent
+   * \param guarantee guarantee time carried by the message
+   *
+   * Account for a message sent to the remote task.
+   */
+  void NotifySent (MessageType type, Time guarantee);
+
+  /**
+   * \param type kind of message received
+   * \param guarantee guarantee time carried by the message
+   *
+   * Account for a message received from the remote task and update
+   * the guarantee time of the bundle.
+   */
+  void NotifyReceived (MessageType type, Time guarantee);
+
+  /**
+   * \return the last guarantee time sent to the remote task
+   */
+  Time GetSentGuaranteeTime (void) const;
+
+  /**
+   * \return true if the remote task asked for a Null Message that was
+   * not sent yet
+   */
+  bool IsNullMessageRequested (void) const;
+
+  /**
+   * \return true if a Null Message was requested from the remote task
+   * and no message arrived since
+   */
+  bool IsNullMessageRequestPending (void) const;
+
+  /**
+   * \param seconds wall clock time spent waiting on this bundle
+   */
+  void AddBlockedTime (double seconds);
+
+  /**
+   * \param os output stream
+   *
+   * Print the message counts and blocked time of the bundle on one line.
+   */
+  void PrintStatistics (std::ostream &os) const;
+
   /**
    * Output for debugging purposes.
    */
@@ -144,6 +200,33 @@ private:
    */
   EventId m_nullEventId;
 
+  /*
+   * Last guarantee time sent to the remote task.
+   */
+  Time m_sentGuaranteeTime;
+
+  /*
+   * The remote task is waiting for a Null Message from this task.
+   */
+  bool m_nullMessageRequested;
+
+  /*
+   * This task is waiting for a Null Message from the remote task.
+   */
+  bool m_nullMessageRequestPending;
+
+  /*
+   * Number of messages sent and received, by MessageType.
+   */
+  uint64_t m_sent[3];
+  uint64_t m_received[3];
+
+  /*
+   * Wall clock time spent blocked while the guarantee time of the
+   * bundle was behind the next local event, in seconds.
+   */
+  double m_blockedTime;
+
 };
 
 }
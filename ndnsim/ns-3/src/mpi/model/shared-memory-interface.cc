@@ -0,0 +1,519 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "shared-memory-interface.h"
+
+#include "null-message-simulator-impl.h"
+#include "remote-channel-bundle-manager.h"
+#include "remote-channel-bundle.h"
+
+#include "ns3/mpi-receiver.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <signal.h>
+#include <sys/prctl.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SharedMemoryInterface");
+
+/**
+ * A ring holds records made of a header (uint32_t size, uint32_t flags)
+ * and of the message, padded to 8 bytes.  A record never wraps around
+ * the end of the ring: a padding record fills the end of the ring
+ * instead.
+ */
+static const uint32_t RECORD_HEADER_SIZE = 2 * sizeof (uint32_t);
+/// Flag of the padding records
+static const uint32_t RECORD_PADDING = 1;
+/// Size of the message header: time, guarantee time, node and device
+static const uint32_t MESSAGE_HEADER_SIZE = 2 * sizeof (uint64_t) + 2 * sizeof (uint32_t);
+/// Number of empty polls of a blocking receive before yielding the processor
+static const uint32_t SPINS_BEFORE_YIELD = 1000;
+
+/**
+ * The two counters are on their own cache lines, since each one is
+ * written by a different task.
+ */
+struct SharedMemoryInterface::Ring
+{
+  std::atomic<uint64_t> head; //!< bytes written, by the writer
+  char pad0[64 - sizeof (std::atomic<uint64_t>)]; //!< cache line padding
+  std::atomic<uint64_t> tail; //!< bytes read, by the reader
+  char pad1[64 - sizeof (std::atomic<uint64_t>)]; //!< cache line padding
+
+  /// \return the ring data
+  uint8_t* GetData (void)
+  {
+    return reinterpret_cast<uint8_t*> (this + 1);
+  }
+};
+
+/**
+ * \param size a size in bytes
+ * \return size rounded up to a multiple of 8
+ */
+static uint32_t
+RoundUp (uint32_t size)
+{
+  return (size + 7) & ~7U;
+}
+
+SharedMemoryInterface::SharedMemoryInterface (uint32_t nSystems)
+  : m_sid (0),
+    m_size (nSystems),
+    m_enabled (false),
+    m_map (0),
+    m_mapSize (0),
+    m_ringStride (sizeof (Ring) + SHARED_MEMORY_RING_SIZE),
+    m_reservedRing (0),
+    m_reservedHead (0)
+{
+  NS_LOG_FUNCTION (this << nSystems);
+  NS_ASSERT_MSG (nSystems > 0, "Need at least one task");
+}
+
+SharedMemoryInterface::~SharedMemoryInterface ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SharedMemoryInterface::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  m_pending.assign (m_size, std::deque<std::vector<uint8_t> > ());
+  m_neighbors.clear ();
+}
+
+uint32_t
+SharedMemoryInterface::GetSystemId ()
+{
+  return m_sid;
+}
+
+uint32_t
+SharedMemoryInterface::GetSize ()
+{
+  return m_size;
+}
+
+bool
+SharedMemoryInterface::IsEnabled ()
+{
+  return m_enabled;
+}
+
+void
+SharedMemoryInterface::Enable (int* pargc, char*** pargv)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_enabled);
+
+  m_mapSize = static_cast<std::size_t> (m_size) * m_size * m_ringStride;
+  void *map = mmap (0, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("Couldn't map " << m_mapSize << " bytes of shared memory: " << std::strerror (errno));
+    }
+  m_map = static_cast<uint8_t*> (map);
+  for (uint32_t from = 0; from < m_size; ++from)
+    {
+      for (uint32_t to = 0; to < m_size; ++to)
+        {
+          Ring *ring = new (m_map + (static_cast<std::size_t> (from) * m_size + to) * m_ringStride) Ring;
+          ring->head.store (0);
+          ring->tail.store (0);
+        }
+    }
+  NS_ASSERT_MSG (GetRing (0, 0)->head.is_lock_free (), "Shared memory rings need lock-free atomics");
+  m_pending.resize (m_size);
+
+  // Don't let the children print what the parent buffered
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::fflush (0);
+
+  for (uint32_t rank = 1; rank < m_size; ++rank)
+    {
+      pid_t pid = fork ();
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("Couldn't fork task " << rank << ": " << std::strerror (errno));
+        }
+      if (pid == 0)
+        {
+          m_sid = rank;
+          m_children.clear ();
+#ifdef __linux__
+          // Don't outlive the task that forked us
+          prctl (PR_SET_PDEATHSIG, SIGTERM);
+#endif
+          break;
+        }
+      m_children.push_back (pid);
+    }
+
+  m_enabled = true;
+  NS_LOG_INFO ("Task " << m_sid << " of " << m_size << " started");
+}
+
+void
+SharedMemoryInterface::Disable ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_map)
+    {
+      munmap (m_map, m_mapSize);
+      m_map = 0;
+    }
+  for (std::vector<pid_t>::const_iterator i = m_children.begin (); i != m_children.end (); ++i)
+    {
+      int status = 0;
+      if (waitpid (*i, &status, 0) < 0 || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          NS_LOG_WARN ("Task with pid " << *i << " failed");
+        }
+    }
+  m_children.clear ();
+  m_pending.clear ();
+  m_enabled = false;
+}
+
+SharedMemoryInterface::Ring*
+SharedMemoryInterface::GetRing (uint32_t from, uint32_t to) const
+{
+  return reinterpret_cast<Ring*> (m_map + (static_cast<std::size_t> (from) * m_size + to) * m_ringStride);
+}
+
+void
+SharedMemoryInterface::InitializeSendReceiveBuffers (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_enabled);
+
+  m_neighbors.clear ();
+  for (uint32_t rank = 0; rank < m_size; ++rank)
+    {
+      if (RemoteChannelBundleManager::Find (rank))
+        {
+          m_neighbors.push_back (rank);
+        }
+    }
+}
+
+uint8_t*
+SharedMemoryInterface::ReserveInRing (Ring* ring, uint32_t size)
+{
+  uint32_t record = RECORD_HEADER_SIZE + RoundUp (size);
+  if (record > SHARED_MEMORY_RING_SIZE / 2)
+    {
+      NS_FATAL_ERROR ("Message of " << size << " bytes too large for the shared memory rings");
+    }
+
+  uint64_t head = ring->head.load (std::memory_order_relaxed);
+  uint64_t tail = ring->tail.load (std::memory_order_acquire);
+  uint64_t room = SHARED_MEMORY_RING_SIZE - (head - tail);
+  uint32_t offset = head % SHARED_MEMORY_RING_SIZE;
+  uint32_t toEnd = SHARED_MEMORY_RING_SIZE - offset;
+  uint8_t* data = ring->GetData ();
+
+  if (record > toEnd)
+    {
+      if (toEnd + record > room)
+        {
+          return 0;
+        }
+      // fill the end of the ring and start over
+      uint32_t header[2] = { toEnd - RECORD_HEADER_SIZE, RECORD_PADDING };
+      std::memcpy (data + offset, header, sizeof (header));
+      head += toEnd;
+      offset = 0;
+    }
+  else if (record > room)
+    {
+      return 0;
+    }
+
+  uint32_t header[2] = { size, 0 };
+  std::memcpy (data + offset, header, sizeof (header));
+  m_reservedHead = head + record;
+  return data + offset + RECORD_HEADER_SIZE;
+}
+
+uint8_t*
+SharedMemoryInterface::Reserve (uint32_t rank, uint32_t size)
+{
+  Ring* ring = GetRing (m_sid, rank);
+  FlushPending (rank);
+  if (m_pending[rank].empty ())
+    {
+      uint8_t* data = ReserveInRing (ring, size);
+      if (data)
+        {
+          m_reservedRing = ring;
+          return data;
+        }
+    }
+  // Keep the message until there is room for it, after the ones
+  // already waiting
+  m_reservedRing = 0;
+  m_pending[rank].push_back (std::vector<uint8_t> (size));
+  return &m_pending[rank].back ()[0];
+}
+
+void
+SharedMemoryInterface::Commit (void)
+{
+  if (m_reservedRing)
+    {
+      m_reservedRing->head.store (m_reservedHead, std::memory_order_release);
+      m_reservedRing = 0;
+    }
+}
+
+void
+SharedMemoryInterface::FlushPending (uint32_t rank)
+{
+  std::deque<std::vector<uint8_t> > &pending = m_pending[rank];
+  Ring* ring = GetRing (m_sid, rank);
+  while (!pending.empty ())
+    {
+      uint8_t* data = ReserveInRing (ring, pending.front ().size ());
+      if (data == 0)
+        {
+          break;
+        }
+      std::memcpy (data, &pending.front ()[0], pending.front ().size ());
+      ring->head.store (m_reservedHead, std::memory_order_release);
+      pending.pop_front ();
+    }
+}
+
+void
+SharedMemoryInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
+  NS_ASSERT (m_enabled);
+
+  // Find the system id for the destination node
+  Ptr<Node> destNode = NodeList::GetNode (node);
+  uint32_t nodeSysId = destNode->GetSystemId ();
+
+  uint32_t serializedSize = p->GetSerializedSize ();
+  uint8_t* data = Reserve (nodeSysId, MESSAGE_HEADER_SIZE + serializedSize);
+
+  // Add the time, guarantee time, dest node and dest device
+  uint64_t t = rxTime.GetInteger ();
+  std::memcpy (data, &t, sizeof (t));
+  data += sizeof (t);
+  Time guaranteeUpdate = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
+  uint64_t guarantee = guaranteeUpdate.GetInteger ();
+  std::memcpy (data, &guarantee, sizeof (guarantee));
+  data += sizeof (guarantee);
+  RemoteChannelBundleManager::Find (nodeSysId)->NotifySent (RemoteChannelBundle::PACKET, guaranteeUpdate);
+  std::memcpy (data, &node, sizeof (node));
+  data += sizeof (node);
+  std::memcpy (data, &dev, sizeof (dev));
+  data += sizeof (dev);
+  // Serialize the packet
+  p->Serialize (data, serializedSize);
+  Commit ();
+
+  NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+}
+
+void
+SharedMemoryInterface::SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle,
+                                        bool request)
+{
+  NS_LOG_FUNCTION (this << guaranteeUpdate.GetTimeStep () << bundle << request);
+  NS_ASSERT (m_enabled);
+
+  uint8_t* data = Reserve (bundle->GetSystemId (), MESSAGE_HEADER_SIZE);
+  std::memset (data, 0, MESSAGE_HEADER_SIZE);
+  uint64_t guarantee = guaranteeUpdate.GetInteger ();
+  std::memcpy (data + sizeof (uint64_t), &guarantee, sizeof (guarantee));
+  // A request has the node field set to 1
+  uint32_t node = request ? 1 : 0;
+  std::memcpy (data + 2 * sizeof (uint64_t), &node, sizeof (node));
+  Commit ();
+
+  bundle->NotifySent (request ? RemoteChannelBundle::NULL_MESSAGE_REQUEST : RemoteChannelBundle::NULL_MESSAGE,
+                      guaranteeUpdate);
+}
+
+uint32_t
+SharedMemoryInterface::ReceiveFrom (uint32_t rank)
+{
+  Ring* ring = GetRing (rank, m_sid);
+  uint8_t* data = ring->GetData ();
+  uint64_t tail = ring->tail.load (std::memory_order_relaxed);
+  uint64_t head = ring->head.load (std::memory_order_acquire);
+  uint32_t received = 0;
+  Ptr<RemoteChannelBundle> bundle;
+
+  while (tail != head)
+    {
+      const uint8_t* record = data + tail % SHARED_MEMORY_RING_SIZE;
+      uint32_t header[2];
+      std::memcpy (header, record, sizeof (header));
+      if (header[1] & RECORD_PADDING)
+        {
+          tail += RECORD_HEADER_SIZE + header[0];
+          continue;
+        }
+
+      // Get the meta data first
+      const uint8_t* message = record + RECORD_HEADER_SIZE;
+      uint64_t time;
+      uint64_t guaranteeUpdate;
+      uint32_t node;
+      uint32_t dev;
+      std::memcpy (&time, message, sizeof (time));
+      std::memcpy (&guaranteeUpdate, message + sizeof (time), sizeof (guaranteeUpdate));
+      std::memcpy (&node, message + 2 * sizeof (uint64_t), sizeof (node));
+      std::memcpy (&dev, message + 2 * sizeof (uint64_t) + sizeof (node), sizeof (dev));
+
+      Time rxTime (time);
+
+      // rxtime == 0 means this is a Null Message
+      if (rxTime > Time (0))
+        {
+          Ptr<Packet> p = Create<Packet> (message + MESSAGE_HEADER_SIZE, header[0] - MESSAGE_HEADER_SIZE, true);
+
+          // Find the correct node/device to schedule receive event
+          Ptr<Node> pNode = NodeList::GetNode (node);
+          Ptr<MpiReceiver> pMpiRec = 0;
+          uint32_t nDevices = pNode->GetNDevices ();
+          for (uint32_t i = 0; i < nDevices; ++i)
+            {
+              Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
+              if (pThisDev->GetIfIndex () == dev)
+                {
+                  pMpiRec = pThisDev->GetObject<MpiReceiver> ();
+                  break;
+                }
+            }
+          NS_ASSERT (pNode && pMpiRec);
+
+          // Schedule the rx event
+          Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
+                                          &MpiReceiver::Receive, pMpiRec, p);
+        }
+
+      // Update guarantee time for both packet receives and Null Messages.
+      if (!bundle)
+        {
+          bundle = RemoteChannelBundleManager::Find (rank);
+          NS_ASSERT (bundle);
+        }
+      RemoteChannelBundle::MessageType type = RemoteChannelBundle::PACKET;
+      if (rxTime == Time (0))
+        {
+          type = node ? RemoteChannelBundle::NULL_MESSAGE_REQUEST : RemoteChannelBundle::NULL_MESSAGE;
+        }
+      bundle->NotifyReceived (type, Time (guaranteeUpdate));
+
+      tail += RECORD_HEADER_SIZE + RoundUp (header[0]);
+      // Give the room back to the writer as soon as possible
+      ring->tail.store (tail, std::memory_order_release);
+      ++received;
+    }
+  ring->tail.store (tail, std::memory_order_release);
+  return received;
+}
+
+void
+SharedMemoryInterface::ReceiveMessagesNonBlocking ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_enabled);
+
+  for (std::vector<uint32_t>::const_iterator i = m_neighbors.begin (); i != m_neighbors.end (); ++i)
+    {
+      ReceiveFrom (*i);
+    }
+}
+
+void
+SharedMemoryInterface::ReceiveMessagesBlocking ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_enabled);
+
+  if (m_neighbors.empty ())
+    {
+      // Not communicating with anyone.
+      return;
+    }
+
+  uint32_t spins = 0;
+  while (true)
+    {
+      // The neighbors may be waiting for our pending messages
+      TestSendComplete ();
+
+      uint32_t received = 0;
+      for (std::vector<uint32_t>::const_iterator i = m_neighbors.begin (); i != m_neighbors.end (); ++i)
+        {
+          received += ReceiveFrom (*i);
+        }
+      if (received)
+        {
+          break;
+        }
+      if (++spins == SPINS_BEFORE_YIELD)
+        {
+          sched_yield ();
+          spins = 0;
+        }
+    }
+}
+
+void
+SharedMemoryInterface::TestSendComplete ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (uint32_t rank = 0; rank < m_pending.size (); ++rank)
+    {
+      if (!m_pending[rank].empty ())
+        {
+          FlushPending (rank);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_SHARED_MEMORY_INTERFACE_H
+#define NS3_SHARED_MEMORY_INTERFACE_H
+
+#include "null-message-communication-interface.h"
+
+#include <sys/types.h>
+#include <deque>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * size in bytes of the ring carrying the messages from one
+ * task to another; a message must fit in half of it
+ */
+const uint32_t SHARED_MEMORY_RING_SIZE = 1 << 20;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Interface between ns-3 tasks running on the same host, for the
+ * Null Message distributed simulation implementation.
+ *
+ * Enable maps an anonymous shared memory region, then forks the process
+ * so that each task is a process.  The region holds one ring per
+ * ordered pair of tasks; each ring has a single writer and a single
+ * reader, which only share two atomic counters, so no lock and no
+ * system call is needed to exchange a message.  The buffer format of
+ * the messages is the one of NullMessageMpiInterface.
+ *
+ * A message that does not fit in its ring is kept by the sender and
+ * written later, by TestSendComplete or while waiting for messages.
+ * Blocking receives spin on the rings, yielding the processor from time
+ * to time so that more tasks than processors can still make progress.
+ */
+class SharedMemoryInterface : public NullMessageCommunicationInterface
+{
+public:
+  /**
+   * \param nSystems number of tasks
+   */
+  SharedMemoryInterface (uint32_t nSystems);
+  ~SharedMemoryInterface ();
+
+  /**
+   * Delete all pending messages
+   */
+  virtual void Destroy ();
+  /**
+   * \return system id of this task
+   */
+  virtual uint32_t GetSystemId ();
+  /**
+   * \return number of tasks
+   */
+  virtual uint32_t GetSize ();
+  /**
+   * \return true if interface is enabled
+   */
+  virtual bool IsEnabled ();
+  /**
+   * \param pargc unused
+   * \param pargv unused
+   *
+   * Map the shared memory and fork the tasks.
+   */
+  virtual void Enable (int* pargc, char*** pargv);
+  /**
+   * Unmap the shared memory.  In the task with system id 0, wait for
+   * the end of the other tasks.
+   */
+  virtual void Disable ();
+  /**
+   * \param p packet to send
+   * \param rxTime received time at destination node
+   * \param node destination node
+   * \param dev destination device
+   *
+   * Serialize a packet in the ring to the task of the specified node.
+   */
+  virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * \param guaranteeUpdate guarantee update time for the Null Message
+   * \param bundle the destination bundle for the Null Message.
+   * \param request true to ask the remote task for a Null Message in return
+   *
+   * \brief Send a Null Message across the specified bundle.
+   */
+  virtual void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle,
+                                bool request);
+  /**
+   * Receive all the messages written in the rings from the neighbors.
+   */
+  virtual void ReceiveMessagesNonBlocking ();
+  /**
+   * Wait until at least one message has been received.
+   */
+  virtual void ReceiveMessagesBlocking ();
+  /**
+   * Write the pending messages that now fit in their ring.
+   */
+  virtual void TestSendComplete ();
+  /**
+   * Find the neighbors of this task from the RemoteChannelBundle manager.
+   */
+  virtual void InitializeSendReceiveBuffers (void);
+
+private:
+  /// Shared counters of a ring, followed in memory by the ring data
+  struct Ring;
+
+  /**
+   * \param from writing task
+   * \param to reading task
+   * \return the ring from task from to task to
+   */
+  Ring* GetRing (uint32_t from, uint32_t to) const;
+
+  /**
+   * \param rank destination task
+   * \param size size of the message
+   * \return where to write the message
+   *
+   * The message is published by Commit.
+   */
+  uint8_t* Reserve (uint32_t rank, uint32_t size);
+
+  /**
+   * Publish the message written at the location returned by Reserve.
+   */
+  void Commit (void);
+
+  /**
+   * \param ring the ring to write to
+   * \param size size of the message
+   * \return where to write the message in the ring, or 0 if it is full
+   */
+  uint8_t* ReserveInRing (Ring* ring, uint32_t size);
+
+  /**
+   * \param rank destination task
+   *
+   * Write the pending messages to rank that fit in the ring.
+   */
+  void FlushPending (uint32_t rank);
+
+  /**
+   * \param rank source task
+   * \return the number of messages received
+   *
+   * Receive all the messages in the ring from rank.
+   */
+  uint32_t ReceiveFrom (uint32_t rank);
+
+  uint32_t m_sid;                  //!< system id of this task
+  uint32_t m_size;                 //!< number of tasks
+  bool m_enabled;                  //!< true once the tasks are forked
+  uint8_t* m_map;                  //!< shared memory region
+  std::size_t m_mapSize;           //!< size of the shared memory region
+  std::size_t m_ringStride;        //!< distance between two rings in the region
+  std::vector<pid_t> m_children;   //!< forked tasks (in task 0 only)
+  std::vector<uint32_t> m_neighbors; //!< tasks sharing a link with this one
+
+  /// Messages waiting for room in the ring of each destination
+  std::vector<std::deque<std::vector<uint8_t> > > m_pending;
+
+  Ring* m_reservedRing;            //!< ring of the reserved message, 0 if pending
+  uint64_t m_reservedHead;         //!< ring head once the reserved message is published
+};
+
+} // namespace ns3
+
+#endif /* NS3_SHARED_MEMORY_INTERFACE_H */
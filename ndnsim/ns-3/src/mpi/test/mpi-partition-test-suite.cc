@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/graph-partitioner.h"
+#include "ns3/mpi-partition-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Two cliques joined by a single edge must be split along that edge.
+ */
+class GraphPartitionerCliquesTest : public TestCase
+{
+public:
+  GraphPartitionerCliquesTest ();
+private:
+  virtual void DoRun (void);
+};
+
+GraphPartitionerCliquesTest::GraphPartitionerCliquesTest ()
+  : TestCase ("Two cliques joined by a bridge")
+{
+}
+
+void
+GraphPartitionerCliquesTest::DoRun (void)
+{
+  GraphPartitioner partitioner;
+  partitioner.SetNVertices (20);
+  for (uint32_t c = 0; c < 2; c++)
+    {
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          for (uint32_t j = i + 1; j < 10; j++)
+            {
+              // interleave the cliques so that vertex order does not help
+              partitioner.AddEdge (2 * i + c, 2 * j + c, 1);
+            }
+        }
+    }
+  partitioner.AddEdge (0, 1, 1);
+
+  std::vector<uint32_t> parts = partitioner.Partition (2);
+  NS_TEST_ASSERT_MSG_EQ (parts.size (), 20, "one part per vertex");
+  NS_TEST_EXPECT_MSG_EQ (partitioner.GetEdgeCut (parts), 1, "only the bridge is cut");
+  for (uint32_t v = 2; v < 20; v++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (parts[v], parts[v % 2], "vertex " << v << " not with its clique");
+    }
+}
+
+/**
+ * A large grid is split in balanced parts, with a cut close to the
+ * optimal one, the same way every time.
+ */
+class GraphPartitionerGridTest : public TestCase
+{
+public:
+  GraphPartitionerGridTest ();
+private:
+  virtual void DoRun (void);
+};
+
+GraphPartitionerGridTest::GraphPartitionerGridTest ()
+  : TestCase ("Balanced and deterministic partition of a grid")
+{
+}
+
+void
+GraphPartitionerGridTest::DoRun (void)
+{
+  const uint32_t side = 64;
+  const uint32_t k = 4;
+  GraphPartitioner partitioner;
+  partitioner.SetNVertices (side * side);
+  for (uint32_t x = 0; x < side; x++)
+    {
+      for (uint32_t y = 0; y < side; y++)
+        {
+          if (x + 1 < side)
+            {
+              partitioner.AddEdge (x * side + y, (x + 1) * side + y, 1);
+            }
+          if (y + 1 < side)
+            {
+              partitioner.AddEdge (x * side + y, x * side + y + 1, 1);
+            }
+        }
+    }
+  partitioner.SetImbalance (0.05);
+
+  std::vector<uint32_t> parts = partitioner.Partition (k);
+  std::vector<uint32_t> size (k, 0);
+  for (uint32_t v = 0; v < parts.size (); v++)
+    {
+      NS_TEST_ASSERT_MSG_LT (parts[v], k, "part out of range");
+      size[parts[v]]++;
+    }
+  for (uint32_t p = 0; p < k; p++)
+    {
+      NS_TEST_EXPECT_MSG_LT_OR_EQ (size[p], 1.05 * side * side / k, "part " << p << " too large");
+    }
+  // four quadrants cut 2 * side edges; stay within twice that
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (partitioner.GetEdgeCut (parts), 4 * side, "edge cut too large");
+
+  std::vector<uint32_t> again = partitioner.Partition (k);
+  NS_TEST_EXPECT_MSG_EQ ((again == parts), true, "partition not deterministic");
+}
+
+/**
+ * Weighted nodes, uncuttable links and lookahead of the helper.
+ */
+class MpiPartitionHelperTest : public TestCase
+{
+public:
+  MpiPartitionHelperTest ();
+private:
+  virtual void DoRun (void);
+};
+
+MpiPartitionHelperTest::MpiPartitionHelperTest ()
+  : TestCase ("MpiPartitionHelper sets the system ids")
+{
+}
+
+void
+MpiPartitionHelperTest::DoRun (void)
+{
+  // a ring of 8 nodes: the two 10ms links should be the ones cut, and
+  // the 1us links, below the minimum lookahead, must not be cut
+  NodeContainer nodes;
+  nodes.Create (8);
+  MpiPartitionHelper partition;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      Time delay = MilliSeconds (1);
+      if (i == 1 || i == 5)
+        {
+          delay = MilliSeconds (10);
+        }
+      else if (i == 3 || i == 7)
+        {
+          delay = MicroSeconds (1);
+        }
+      partition.AddLink (nodes.Get (i), nodes.Get ((i + 1) % 8), delay);
+    }
+  partition.SetMinLookahead (MicroSeconds (100));
+  partition.Install (2);
+
+  NS_TEST_EXPECT_MSG_EQ (partition.GetLookahead (), MilliSeconds (10), "lookahead");
+  NS_TEST_EXPECT_MSG_EQ (partition.GetCutTraffic (), 2, "cut traffic");
+  NS_TEST_EXPECT_MSG_EQ (nodes.Get (3)->GetSystemId (), nodes.Get (4)->GetSystemId (), "uncuttable link cut");
+  NS_TEST_EXPECT_MSG_EQ (nodes.Get (7)->GetSystemId (), nodes.Get (0)->GetSystemId (), "uncuttable link cut");
+  NS_TEST_EXPECT_MSG_NE (nodes.Get (1)->GetSystemId (), nodes.Get (2)->GetSystemId (), "long link not cut");
+  NS_TEST_EXPECT_MSG_NE (nodes.Get (5)->GetSystemId (), nodes.Get (6)->GetSystemId (), "long link not cut");
+
+  Simulator::Destroy ();
+}
+
+class MpiPartitionTestSuite : public TestSuite
+{
+public:
+  MpiPartitionTestSuite ();
+};
+
+MpiPartitionTestSuite::MpiPartitionTestSuite ()
+  : TestSuite ("mpi-partition", UNIT)
+{
+  AddTestCase (new GraphPartitionerCliquesTest, TestCase::QUICK);
+  AddTestCase (new GraphPartitionerGridTest, TestCase::QUICK);
+  AddTestCase (new MpiPartitionHelperTest, TestCase::QUICK);
+}
+
+static MpiPartitionTestSuite g_mpiPartitionTestSuite;
@@ -24,6 +24,8 @@
 #include "channel-list.h"
 #include "channel.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("ChannelList");
@@ -75,6 +77,11 @@ public:
    */
   uint32_t GetNChannels (void);
 
+  /**
+   * \param n number of channels to make room for.
+   */
+  void Reserve (uint32_t n);
+
   /**
    * \brief Get the channel list object
    * \returns the channel list
@@ -201,6 +208,17 @@ ChannelListPriv::GetNChannels (void)
   return m_channels.size ();
 }
 
+void
+ChannelListPriv::Reserve (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  if (n > m_channels.capacity ())
+    {
+      // grow geometrically, so that many small reservations stay linear
+      m_channels.reserve (std::max<std::size_t> (n, 2 * m_channels.capacity ()));
+    }
+}
+
 Ptr<Channel>
 ChannelListPriv::GetChannel (uint32_t n)
 {
@@ -245,4 +263,11 @@ ChannelList::GetNChannels (void)
   return ChannelListPriv::Get ()->GetNChannels ();
 }
 
+void
+ChannelList::Reserve (uint32_t n)
+{
+  NS_LOG_FUNCTION (n);
+  ChannelListPriv::Get ()->Reserve (n);
+}
+
 } // namespace ns3
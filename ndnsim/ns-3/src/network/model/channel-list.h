@@ -68,6 +68,15 @@ public:
    * \returns the number of channels currently in the list.
    */
   static uint32_t GetNChannels (void);
+  /**
+   * \param n number of channels the list should be able to hold.
+   *
+   * Pre-allocate room for n channels, to avoid repeated reallocation
+   * of the list when large topologies are built.  The room grows at
+   * least geometrically, so calling this before each of many small
+   * batches is cheap.
+   */
+  static void Reserve (uint32_t n);
 };
 
 } // namespace ns3
@@ -27,6 +27,8 @@
 #include "node-list.h"
 #include "node.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NodeList");
@@ -78,6 +80,11 @@ public:
    */
   uint32_t GetNNodes (void);
 
+  /**
+   * \param n number of nodes to make room for.
+   */
+  void Reserve (uint32_t n);
+
   /**
    * \brief Get the node list object
    * \returns the node list
@@ -201,6 +208,17 @@ NodeListPriv::GetNNodes (void)
   return m_nodes.size ();
 }
 
+void
+NodeListPriv::Reserve (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  if (n > m_nodes.capacity ())
+    {
+      // grow geometrically, so that many small reservations stay linear
+      m_nodes.reserve (std::max<std::size_t> (n, 2 * m_nodes.capacity ()));
+    }
+}
+
 Ptr<Node>
 NodeListPriv::GetNode (uint32_t n)
 {
@@ -249,5 +267,11 @@ NodeList::GetNNodes (void)
   NS_LOG_FUNCTION_NOARGS ();
   return NodeListPriv::Get ()->GetNNodes ();
 }
+void
+NodeList::Reserve (uint32_t n)
+{
+  NS_LOG_FUNCTION (n);
+  NodeListPriv::Get ()->Reserve (n);
+}
 
 } // namespace ns3
@@ -70,6 +70,15 @@ public:
    * \returns the number of nodes currently in the list.
    */
   static uint32_t GetNNodes (void);
+  /**
+   * \param n number of nodes the list should be able to hold.
+   *
+   * Pre-allocate room for n nodes, to avoid repeated reallocation
+   * of the list when large topologies are built.  The room grows at
+   * least geometrically, so calling this before each of many small
+   * batches is cheap.
+   */
+  static void Reserve (uint32_t n);
 };
 
 } // namespace ns3
@@ -65,4 +65,17 @@
  * current node extracts the appropriate neighbor-index from the 
  * nix-vector and transmits the packet through the corresponding 
  * net-device.  This continues until the packet reaches the destination.
+ *
+ * When many flows start at the same time, the BFS run for each new
+ * destination can stall the simulation.  Setting the attribute
+ * ns3::Ipv4NixVectorRouting::PrecomputeAllPairs computes instead, when
+ * the simulation starts, one BFS tree per node and keeps for every node
+ * a compact array of the parent of each destination in its tree; the 
+ * nix-vector of a new destination is then built by walking this array,
+ * and is the one the on-demand BFS would build.
+ * The BFS runs can be spread over several threads with the attribute
+ * ns3::Ipv4NixVectorRouting::PrecomputeThreads.  The arrays use memory
+ * proportional to the square of the number of nodes, and they are
+ * recomputed after a topology change.  Routes requested for a specific
+ * output interface still use the on-demand BFS.
  * */
@@ -21,10 +21,16 @@
 #include <queue>
 #include <iomanip>
 
+#include "ns3/core-config.h"
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/names.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ns3/ipv4-list-routing.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 
 #include "ipv4-nix-vector-routing.h"
 
@@ -35,6 +41,12 @@ NS_LOG_COMPONENT_DEFINE ("Ipv4NixVectorRouting");
 NS_OBJECT_ENSURE_REGISTERED (Ipv4NixVectorRouting);
 
 bool Ipv4NixVectorRouting::g_isCacheDirty = false;
+const uint32_t Ipv4NixVectorRouting::NO_PARENT;
+bool Ipv4NixVectorRouting::g_allPairsValid = false;
+std::vector< std::vector<uint32_t> > Ipv4NixVectorRouting::g_allPairsNeighbors;
+std::vector< std::vector<uint8_t> > Ipv4NixVectorRouting::g_allPairsUsable;
+std::vector< std::vector<uint32_t> > Ipv4NixVectorRouting::g_allPairsParent;
+std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> Ipv4NixVectorRouting::g_allPairsNodeByIp;
 
 TypeId 
 Ipv4NixVectorRouting::GetTypeId (void)
@@ -43,12 +55,26 @@ Ipv4NixVectorRouting::GetTypeId (void)
     .SetParent<Ipv4RoutingProtocol> ()
     .SetGroupName ("NixVectorRouting")
     .AddConstructor<Ipv4NixVectorRouting> ()
+    .AddAttribute ("PrecomputeAllPairs",
+                   "Compute the routes between all pairs of nodes when the simulation starts "
+                   "(and after each topology change), instead of running a BFS for each new "
+                   "destination.  Uses memory proportional to the square of the number of nodes.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4NixVectorRouting::m_precomputeAllPairs),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PrecomputeThreads",
+                   "Number of threads used to compute the routes between all pairs of nodes.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&Ipv4NixVectorRouting::m_precomputeThreads),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
 
 Ipv4NixVectorRouting::Ipv4NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_precomputeAllPairs (false),
+    m_precomputeThreads (1),
+    m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -76,9 +102,28 @@ Ipv4NixVectorRouting::DoDispose ()
   m_node = 0;
   m_ipv4 = 0;
 
+  // the tables refer to node ids which are about to be reused
+  ClearAllPairsTables ();
+
   Ipv4RoutingProtocol::DoDispose ();
 }
 
+void
+Ipv4NixVectorRouting::DoInitialize ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  // build the tables when the simulation starts rather than
+  // when the first packet is sent
+  CheckCacheStateAndFlush ();
+  if (m_precomputeAllPairs && !g_allPairsValid)
+    {
+      BuildAllPairsTables ();
+    }
+
+  Ipv4RoutingProtocol::DoInitialize ();
+}
+
 
 void
 Ipv4NixVectorRouting::SetNode (Ptr<Node> node)
@@ -105,6 +150,7 @@ Ipv4NixVectorRouting::FlushGlobalNixRoutingCache (void) const
       rp->FlushNixCache ();
       rp->FlushIpv4RouteCache ();
     }
+  ClearAllPairsTables ();
 }
 
 void
@@ -128,6 +174,22 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
 
   Ptr<NixVector> nixVector = Create<NixVector> ();
 
+  if (m_precomputeAllPairs && !oif)
+    {
+      if (!g_allPairsValid)
+        {
+          BuildAllPairsTables ();
+        }
+      std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>::const_iterator iter;
+      iter = g_allPairsNodeByIp.find (dest);
+      if (iter == g_allPairsNodeByIp.end ())
+        {
+          NS_LOG_ERROR ("No routing path exists");
+          return 0;
+        }
+      return GetNixVectorPrecomputed (source, NodeList::GetNode (iter->second));
+    }
+
   // not in cache, must build the nix vector
   // First, we have to figure out the nodes 
   // associated with these IPs
@@ -166,6 +228,181 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
     }
 }
 
+Ptr<NixVector>
+Ipv4NixVectorRouting::GetNixVectorPrecomputed (Ptr<Node> source, Ptr<Node> dest)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  /// \internal
+  /// Do not process packets to self (see \bugid{1308})
+  if (source == dest)
+    {
+      NS_LOG_DEBUG ("Do not processs packets to self");
+      return 0;
+    }
+
+  uint32_t sourceId = source->GetId ();
+  const std::vector<uint32_t> &parent = g_allPairsParent.at (sourceId);
+  uint32_t current = dest->GetId ();
+  if (parent.at (current) == NO_PARENT)
+    {
+      NS_LOG_ERROR ("No routing path exists");
+      return 0;
+    }
+
+  // walk the BFS tree of the source from the destination, as
+  // BuildNixVector does, with the same neighbor index at each hop:
+  // the last one leading to the child
+  Ptr<NixVector> nixVector = Create<NixVector> ();
+  while (current != sourceId)
+    {
+      uint32_t parentId = parent[current];
+      const std::vector<uint32_t> &neighbors = g_allPairsNeighbors[parentId];
+      uint32_t index = 0;
+      for (uint32_t i = 0; i < neighbors.size (); i++)
+        {
+          if (neighbors[i] == current)
+            {
+              index = i;
+            }
+        }
+      nixVector->AddNeighborIndex (index, nixVector->BitCount (neighbors.size ()));
+      current = parentId;
+    }
+  return nixVector;
+}
+
+void
+Ipv4NixVectorRouting::BuildAllPairsTables (void)
+{
+  NS_LOG_FUNCTION (this << m_precomputeThreads);
+
+  uint32_t numberOfNodes = NodeList::GetNNodes ();
+  g_allPairsNeighbors.assign (numberOfNodes, std::vector<uint32_t> ());
+  g_allPairsUsable.assign (numberOfNodes, std::vector<uint8_t> ());
+  g_allPairsNodeByIp.clear ();
+
+  // Flatten the topology into plain arrays first: the BFS runs below
+  // may be spread over several threads, and must not touch any ns-3
+  // object.  Neighbors are numbered as in BuildNixVector.
+  for (uint32_t n = 0; n < numberOfNodes; n++)
+    {
+      Ptr<Node> node = NodeList::GetNode (n);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      if (ipv4)
+        {
+          for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+            {
+              for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+                {
+                  // keep the first node owning an address, as GetNodeByIp
+                  g_allPairsNodeByIp.insert (std::make_pair (ipv4->GetAddress (i, j).GetLocal (), n));
+                }
+            }
+        }
+
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+          if (localNetDevice->IsBridge ())
+            {
+              continue;
+            }
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+
+          bool usable = localNetDevice->IsLinkUp ();
+          if (ipv4)
+            {
+              int32_t interfaceIndex = ipv4->GetInterfaceForDevice (localNetDevice);
+              usable = usable && interfaceIndex != -1 && ipv4->IsUp (interfaceIndex);
+            }
+
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              g_allPairsNeighbors[n].push_back ((*iter)->GetNode ()->GetId ());
+              g_allPairsUsable[n].push_back (usable);
+            }
+        }
+    }
+
+  g_allPairsParent.assign (numberOfNodes, std::vector<uint32_t> ());
+
+#ifdef HAVE_PTHREAD_H
+  if (m_precomputeThreads > 1)
+    {
+      std::vector< Ptr<SystemThread> > threads;
+      for (uint32_t t = 0; t < m_precomputeThreads; t++)
+        {
+          threads.push_back (Create<SystemThread> (MakeBoundCallback (&Ipv4NixVectorRouting::AllPairsWorker,
+                                                                      t, m_precomputeThreads)));
+          threads.back ()->Start ();
+        }
+      for (uint32_t t = 0; t < threads.size (); t++)
+        {
+          threads[t]->Join ();
+        }
+    }
+  else
+#endif
+    {
+      AllPairsWorker (0, 1);
+    }
+
+  g_allPairsValid = true;
+}
+
+void
+Ipv4NixVectorRouting::AllPairsWorker (uint32_t first, uint32_t stride)
+{
+  uint32_t numberOfNodes = g_allPairsNeighbors.size ();
+  std::vector<uint32_t> queue (numberOfNodes);
+
+  for (uint32_t source = first; source < numberOfNodes; source += stride)
+    {
+      // same order of visit as BFS, so the same tree; the source is
+      // its own parent
+      std::vector<uint32_t> &parent = g_allPairsParent[source];
+      parent.assign (numberOfNodes, NO_PARENT);
+      parent[source] = source;
+
+      uint32_t head = 0;
+      uint32_t tail = 0;
+      queue[tail++] = source;
+      while (head != tail)
+        {
+          uint32_t current = queue[head++];
+          const std::vector<uint32_t> &neighbors = g_allPairsNeighbors[current];
+          const std::vector<uint8_t> &usable = g_allPairsUsable[current];
+          for (uint32_t index = 0; index < neighbors.size (); index++)
+            {
+              uint32_t remote = neighbors[index];
+              if (!usable[index] || parent[remote] != NO_PARENT)
+                {
+                  continue;
+                }
+              parent[remote] = current;
+              queue[tail++] = remote;
+            }
+        }
+    }
+}
+
+void
+Ipv4NixVectorRouting::ClearAllPairsTables (void)
+{
+  g_allPairsValid = false;
+  std::vector< std::vector<uint32_t> > ().swap (g_allPairsNeighbors);
+  std::vector< std::vector<uint8_t> > ().swap (g_allPairsUsable);
+  std::vector< std::vector<uint32_t> > ().swap (g_allPairsParent);
+  g_allPairsNodeByIp.clear ();
+}
+
 Ptr<NixVector>
 Ipv4NixVectorRouting::GetNixVectorInCache (Ipv4Address address)
 {
@@ -680,8 +917,11 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
   *os << "NixCache:" << std::endl;
   if (m_nixCache.size () > 0)
     {
+      // the caches are unordered: sort them by destination for printing
+      std::map<Ipv4Address, Ptr<NixVector> > sortedNixCache (m_nixCache.begin (), m_nixCache.end ());
       *os << "Destination     NixVector" << std::endl;
-      for (NixMap_t::const_iterator it = m_nixCache.begin (); it != m_nixCache.end (); it++)
+      for (std::map<Ipv4Address, Ptr<NixVector> >::const_iterator it = sortedNixCache.begin ();
+           it != sortedNixCache.end (); it++)
         {
           std::ostringstream dest;
           dest << it->first;
@@ -692,8 +932,10 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
   *os << "Ipv4RouteCache:" << std::endl;
   if (m_ipv4RouteCache.size () > 0)
     {
+      std::map<Ipv4Address, Ptr<Ipv4Route> > sortedRouteCache (m_ipv4RouteCache.begin (), m_ipv4RouteCache.end ());
       *os << "Destination     Gateway         Source            OutputDevice" << std::endl;
-      for (Ipv4RouteMap_t::const_iterator it = m_ipv4RouteCache.begin (); it != m_ipv4RouteCache.end (); it++)
+      for (std::map<Ipv4Address, Ptr<Ipv4Route> >::const_iterator it = sortedRouteCache.begin ();
+           it != sortedRouteCache.end (); it++)
         {
           std::ostringstream dest, gw, src;
           dest << it->second->GetDestination ();
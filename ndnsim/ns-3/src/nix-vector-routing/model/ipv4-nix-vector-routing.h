@@ -22,6 +22,8 @@
 #define IPV4_NIX_VECTOR_ROUTING_H
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "ns3/channel.h"
 #include "ns3/node-container.h"
@@ -38,12 +40,12 @@ namespace ns3 {
  * \ingroup nix-vector-routing
  * Map of Ipv4Address to NixVector
  */
-typedef std::map<Ipv4Address, Ptr<NixVector> > NixMap_t;
+typedef std::unordered_map<Ipv4Address, Ptr<NixVector>, Ipv4AddressHash> NixMap_t;
 /**
  * \ingroup nix-vector-routing
  * Map of Ipv4Address to Ipv4Route
  */
-typedef std::map<Ipv4Address, Ptr<Ipv4Route> > Ipv4RouteMap_t;
+typedef std::unordered_map<Ipv4Address, Ptr<Ipv4Route>, Ipv4AddressHash> Ipv4RouteMap_t;
 
 /**
  * \ingroup nix-vector-routing
@@ -114,6 +116,21 @@ private:
    * corresponding to the given Ipv4Address */
   Ptr<Node> GetNodeByIp (Ipv4Address);
 
+  /* builds the nix-vector by walking the precomputed BFS tree
+   * of the source, as BuildNixVector does */
+  Ptr<NixVector> GetNixVectorPrecomputed (Ptr<Node> source, Ptr<Node> dest);
+
+  /* computes the BFS trees of all the nodes, running one BFS
+   * per node, spread over PrecomputeThreads threads */
+  void BuildAllPairsTables (void);
+
+  /* runs the BFS of the sources first, first + stride, ... and
+   * fills in their parent tables */
+  static void AllPairsWorker (uint32_t first, uint32_t stride);
+
+  /* frees the precomputed all-pairs tables */
+  static void ClearAllPairsTables (void);
+
   /* Recurses the parent vector, created by BFS and actually builds the nixvector */
   bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
 
@@ -147,6 +164,7 @@ private:
             Ptr<NetDevice> oif);
 
   void DoDispose (void);
+  void DoInitialize (void);
 
   /* From Ipv4RoutingProtocol */
   virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
@@ -171,6 +189,27 @@ private:
    */
   static bool g_isCacheDirty;
 
+  /* 
+   * Precomputed all-pairs BFS trees, shared by all the nodes.
+   * g_allPairsNeighbors[n] lists the neighbors of node n by nix index
+   * and g_allPairsUsable[n] tells whether each of them can be reached
+   * (interface and link up).  g_allPairsParent[s][d] is the parent of
+   * node d in the BFS tree of node s, the one BFS would build, or
+   * NO_PARENT.
+   */
+  static const uint32_t NO_PARENT = 0xffffffff;
+  static bool g_allPairsValid;
+  static std::vector< std::vector<uint32_t> > g_allPairsNeighbors;
+  static std::vector< std::vector<uint8_t> > g_allPairsUsable;
+  static std::vector< std::vector<uint32_t> > g_allPairsParent;
+  static std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> g_allPairsNodeByIp;
+
+  /* Use the precomputed all-pairs tables instead of on-demand BFS */
+  bool m_precomputeAllPairs;
+
+  /* Number of threads used to build the all-pairs tables */
+  uint32_t m_precomputeThreads;
+
   /* Cache stores nix-vectors based on destination ip */
   mutable NixMap_t m_nixCache;
 
@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+
+using namespace ns3;
+
+/**
+ * Make sure that the precomputed all-pairs nix vectors are the ones of
+ * the on-demand BFS, on a topology with parallel links and several
+ * shortest paths:
+ *
+ *        ==       ==
+ *     n0 ---- n1 ---- n2 ---- n4
+ *      |               |      |
+ *      +----- n3 ------+      |
+ *             |               |
+ *             +------ n5 -----+
+ *
+ * n0-n1 and n1-n2 are made of two parallel links, and n3, n4 and n5
+ * share a broadcast channel.
+ */
+class Ipv4NixVectorRoutingPrecomputeTestCase : public TestCase
+{
+public:
+  Ipv4NixVectorRoutingPrecomputeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the topology, route a packet from every node to every address,
+   * and print the routing tables.
+   *
+   * \param precompute the PrecomputeAllPairs attribute
+   * \param threads the PrecomputeThreads attribute
+   * \returns the routes and the routing tables of all the nodes
+   */
+  std::string RouteAll (bool precompute, uint32_t threads);
+};
+
+Ipv4NixVectorRoutingPrecomputeTestCase::Ipv4NixVectorRoutingPrecomputeTestCase ()
+  : TestCase ("Compare the precomputed nix vectors with the on-demand BFS")
+{
+}
+
+std::string
+Ipv4NixVectorRoutingPrecomputeTestCase::RouteAll (bool precompute, uint32_t threads)
+{
+  NodeContainer nodes;
+  nodes.Create (6);
+
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (nixRouting);
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.0");
+  NetDeviceContainer n0n1a = simple.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  address.Assign (n0n1a);
+  address.NewNetwork ();
+  NetDeviceContainer n0n1b = simple.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  address.Assign (n0n1b);
+  address.NewNetwork ();
+  address.Assign (simple.Install (NodeContainer (nodes.Get (1), nodes.Get (2))));
+  address.NewNetwork ();
+  address.Assign (simple.Install (NodeContainer (nodes.Get (1), nodes.Get (2))));
+  address.NewNetwork ();
+  address.Assign (simple.Install (NodeContainer (nodes.Get (0), nodes.Get (3))));
+  address.NewNetwork ();
+  address.Assign (simple.Install (NodeContainer (nodes.Get (3), nodes.Get (2))));
+  address.NewNetwork ();
+  address.Assign (simple.Install (NodeContainer (nodes.Get (2), nodes.Get (4))));
+  address.NewNetwork ();
+  NodeContainer shared (nodes.Get (3), nodes.Get (4));
+  shared.Add (nodes.Get (5));
+  address.Assign (simple.Install (shared));
+
+  for (uint32_t n = 0; n < nodes.GetN (); n++)
+    {
+      Ptr<Ipv4RoutingProtocol> routing = nodes.Get (n)->GetObject<Ipv4> ()->GetRoutingProtocol ();
+      routing->SetAttribute ("PrecomputeAllPairs", BooleanValue (precompute));
+      routing->SetAttribute ("PrecomputeThreads", UintegerValue (threads));
+    }
+
+  std::ostringstream os;
+  for (uint32_t n = 0; n < nodes.GetN (); n++)
+    {
+      Ptr<Ipv4> ipv4 = nodes.Get (n)->GetObject<Ipv4> ();
+      for (uint32_t d = 0; d < nodes.GetN (); d++)
+        {
+          if (d == n)
+            {
+              // no route to self
+              continue;
+            }
+          Ptr<Ipv4> destIpv4 = nodes.Get (d)->GetObject<Ipv4> ();
+          // interface 0 is the loopback
+          for (uint32_t i = 1; i < destIpv4->GetNInterfaces (); i++)
+            {
+              Ipv4Header header;
+              header.SetDestination (destIpv4->GetAddress (i, 0).GetLocal ());
+              Socket::SocketErrno sockerr;
+              Ptr<Packet> packet = Create<Packet> ();
+              Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol ()->RouteOutput (packet, header, 0, sockerr);
+              os << "n" << n << " to " << header.GetDestination () << ": ";
+              if (route)
+                {
+                  os << "device " << route->GetOutputDevice ()->GetIfIndex ()
+                     << " gateway " << route->GetGateway ();
+                }
+              else
+                {
+                  os << "no route";
+                }
+              os << std::endl;
+            }
+        }
+    }
+
+  // the tables hold the whole nix vectors
+  for (uint32_t n = 0; n < nodes.GetN (); n++)
+    {
+      os << "n" << n << std::endl;
+      nodes.Get (n)->GetObject<Ipv4> ()->GetRoutingProtocol ()->PrintRoutingTable (Create<OutputStreamWrapper> (&os));
+    }
+
+  // the second of the parallel links from n0 to n1 is used, by both modes
+  Ipv4Header header;
+  header.SetDestination (n0n1b.Get (1)->GetNode ()->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ());
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = nodes.Get (0)->GetObject<Ipv4> ()->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), header, 0, sockerr);
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), n0n1b.Get (0), "Wrong parallel link from n0 to n1");
+
+  Simulator::Destroy ();
+  return os.str ();
+}
+
+void
+Ipv4NixVectorRoutingPrecomputeTestCase::DoRun (void)
+{
+  std::string onDemand = RouteAll (false, 1);
+  NS_TEST_EXPECT_MSG_EQ (RouteAll (true, 1), onDemand, "The precomputed routes differ from the on-demand ones");
+  NS_TEST_EXPECT_MSG_EQ (RouteAll (true, 3), onDemand, "The routes precomputed by several threads differ from the on-demand ones");
+}
+
+
+class Ipv4NixVectorRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv4NixVectorRoutingTestSuite ();
+};
+
+Ipv4NixVectorRoutingTestSuite::Ipv4NixVectorRoutingTestSuite ()
+  : TestSuite ("ipv4-nix-vector-routing", UNIT)
+{
+  AddTestCase (new Ipv4NixVectorRoutingPrecomputeTestCase (), TestCase::QUICK);
+}
+
+static Ipv4NixVectorRoutingTestSuite g_ipv4NixVectorRoutingTestSuite;
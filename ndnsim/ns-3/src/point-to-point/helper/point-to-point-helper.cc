@@ -28,6 +28,7 @@
 #include "ns3/config.h"
 #include "ns3/packet.h"
 #include "ns3/names.h"
+#include "ns3/channel-list.h"
 #include "ns3/mpi-interface.h"
 #include "ns3/mpi-receiver.h"
 
@@ -232,6 +233,45 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
 {
   NetDeviceContainer container;
 
+  // If MPI is enabled, we need to see if both nodes have the same system id 
+  // (rank), and the rank is the same as this instance.  If both are true, 
+  //use a normal p2p channel, otherwise use a remote channel
+  bool remote = false;
+  if (MpiInterface::IsEnabled ())
+    {
+      uint32_t currSystemId = MpiInterface::GetSystemId ();
+      remote = a->GetSystemId () != currSystemId || b->GetSystemId () != currSystemId;
+    }
+  InstallLink (a, b, remote, container);
+
+  return container;
+}
+
+NetDeviceContainer
+PointToPointHelper::InstallLinks (const NodeContainer &from, const NodeContainer &to)
+{
+  NS_ASSERT_MSG (from.GetN () == to.GetN (), "Both node containers must hold one node per link");
+  NetDeviceContainer container;
+
+  ChannelList::Reserve (ChannelList::GetNChannels () + from.GetN ());
+  bool mpiEnabled = MpiInterface::IsEnabled ();
+  uint32_t currSystemId = mpiEnabled ? MpiInterface::GetSystemId () : 0;
+
+  NodeContainer::Iterator a = from.Begin ();
+  NodeContainer::Iterator b = to.Begin ();
+  for (; a != from.End (); ++a, ++b)
+    {
+      bool remote = mpiEnabled
+        && ((*a)->GetSystemId () != currSystemId || (*b)->GetSystemId () != currSystemId);
+      InstallLink (*a, *b, remote, container);
+    }
+
+  return container;
+}
+
+void
+PointToPointHelper::InstallLink (Ptr<Node> a, Ptr<Node> b, bool remote, NetDeviceContainer &container)
+{
   Ptr<PointToPointNetDevice> devA = m_deviceFactory.Create<PointToPointNetDevice> ();
   devA->SetAddress (Mac48Address::Allocate ());
   a->AddDevice (devA);
@@ -242,23 +282,9 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
   b->AddDevice (devB);
   Ptr<Queue> queueB = m_queueFactory.Create<Queue> ();
   devB->SetQueue (queueB);
-  // If MPI is enabled, we need to see if both nodes have the same system id 
-  // (rank), and the rank is the same as this instance.  If both are true, 
-  //use a normal p2p channel, otherwise use a remote channel
-  bool useNormalChannel = true;
   Ptr<PointToPointChannel> channel = 0;
 
-  if (MpiInterface::IsEnabled ())
-    {
-      uint32_t n1SystemId = a->GetSystemId ();
-      uint32_t n2SystemId = b->GetSystemId ();
-      uint32_t currSystemId = MpiInterface::GetSystemId ();
-      if (n1SystemId != currSystemId || n2SystemId != currSystemId) 
-        {
-          useNormalChannel = false;
-        }
-    }
-  if (useNormalChannel)
+  if (!remote)
     {
       channel = m_channelFactory.Create<PointToPointChannel> ();
     }
@@ -277,8 +303,6 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
   devB->Attach (channel);
   container.Add (devA);
   container.Add (devB);
-
-  return container;
 }
 
 NetDeviceContainer 
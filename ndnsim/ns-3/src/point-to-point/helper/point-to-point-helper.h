@@ -163,7 +163,33 @@ public:
    */
   NetDeviceContainer Install (std::string aNode, std::string bNode);
 
+  /**
+   * \param from first node of each link
+   * \param to second node of each link
+   * \return a NetDeviceContainer holding, for each link i, the device
+   *         installed on from.Get (i) followed by the device installed
+   *         on to.Get (i)
+   *
+   * Install from.GetN () links at once, link i connecting from.Get (i)
+   * to to.Get (i). This is equivalent to calling Install (Ptr<Node>, Ptr<Node>)
+   * for each pair, but room for the new channels is reserved in the
+   * ns3::ChannelList up front and the MPI configuration is looked up only
+   * once, which matters when building topologies with millions of links.
+   */
+  NetDeviceContainer InstallLinks (const NodeContainer &from, const NodeContainer &to);
+
 private:
+  /**
+   * \brief Create the devices and the channel of one link.
+   *
+   * \param a first node
+   * \param b second node
+   * \param remote true if a ns3::PointToPointRemoteChannel must be used
+   * \param container container the two new devices are added to
+   */
+  void InstallLink (Ptr<Node> a, Ptr<Node> b, bool remote, NetDeviceContainer &container);
+
+
   /**
    * \brief Enable pcap output the indicated net device.
    *
@@ -0,0 +1,355 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/data-rate.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/packet.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/point-to-point-helper.h"
+
+using namespace ns3;
+
+/**
+ * Run the null message simulator on tasks forked by
+ * MpiInterface::Enable (n), which communicate through shared memory.
+ *
+ * Node i belongs to task i, and the nodes are linked in a ring (a single
+ * link for 2 tasks).  Every node sends packets to the next one, except
+ * the last node of a ring of 3 tasks or more, which stays idle.  Each
+ * task checks that its nodes receive every packet at the time it would
+ * on a local link, and writes the result and the statistics of its
+ * remote channel bundles to files.  Task 0 checks them once the other
+ * tasks have ended.
+ *
+ * With the DemandDriven attribute, the null messages must only be sent
+ * in answer to a request, and the tasks must still get to the end of the
+ * simulation.
+ */
+class PointToPointRemoteChannelTestCase : public TestCase
+{
+public:
+  /**
+   * \param tasks the number of tasks
+   * \param demandDriven the DemandDriven attribute of the simulator
+   */
+  PointToPointRemoteChannelTestCase (uint32_t tasks, bool demandDriven);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * A flow of packets from one node to another.
+   */
+  struct Flow
+  {
+    Ptr<NetDevice> sender;   //!< sending device
+    Ptr<NetDevice> receiver; //!< receiving device
+    bool idle;               //!< true if no packet is sent
+    std::vector<Time> sent;  //!< send times
+    uint32_t received;       //!< packets received
+    uint32_t late;           //!< packets received at the wrong time
+  };
+
+  /**
+   * Message counts of a remote channel bundle, as written in the
+   * statistics file of the null message simulator.
+   */
+  struct BundleStatistics
+  {
+    uint32_t packetsSent;      //!< packets sent
+    uint32_t packetsReceived;  //!< packets received
+    uint32_t nullSent;         //!< null messages sent
+    uint32_t nullReceived;     //!< null messages received
+    uint32_t requestsSent;     //!< null message requests sent
+    uint32_t requestsReceived; //!< null message requests received
+  };
+
+  /**
+   * \param flow the flow index
+   */
+  void Send (uint32_t flow);
+
+  /**
+   * \param flow the flow index
+   * \param device the receiving device
+   * \param packet the packet received
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (uint32_t flow, Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  /**
+   * \param task a task
+   * \returns the statistics of the bundles of the task, by remote task
+   */
+  std::vector<BundleStatistics> ReadStatistics (uint32_t task);
+
+  uint32_t m_tasks;           //!< number of tasks
+  bool m_demandDriven;        //!< true if the null messages are sent on demand
+  std::vector<Flow> m_flows;  //!< the flows
+  Time m_delay;               //!< delay of the links
+  Time m_txTime;              //!< transmission time of a packet
+};
+
+PointToPointRemoteChannelTestCase::PointToPointRemoteChannelTestCase (uint32_t tasks, bool demandDriven)
+  : TestCase (std::string (demandDriven ? "Demand-driven null" : "Null")
+              + " messages through shared memory between " + std::string (1, '0' + tasks) + " tasks"),
+    m_tasks (tasks),
+    m_demandDriven (demandDriven)
+{
+}
+
+void
+PointToPointRemoteChannelTestCase::Send (uint32_t flow)
+{
+  m_flows[flow].sender->Send (Create<Packet> (1000), m_flows[flow].receiver->GetAddress (), 0x0800);
+}
+
+bool
+PointToPointRemoteChannelTestCase::Receive (uint32_t flow, Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                            uint16_t protocol, const Address &from)
+{
+  Flow &f = m_flows[flow];
+  if (f.received >= f.sent.size () || Simulator::Now () != f.sent[f.received] + m_txTime + m_delay)
+    {
+      f.late++;
+    }
+  f.received++;
+  return true;
+}
+
+std::vector<PointToPointRemoteChannelTestCase::BundleStatistics>
+PointToPointRemoteChannelTestCase::ReadStatistics (uint32_t task)
+{
+  std::ostringstream name;
+  name << CreateTempDirFilename ("null-message") << "-" << task << ".txt";
+  std::ifstream file (name.str ().c_str ());
+  std::vector<BundleStatistics> statistics (m_tasks);
+  std::string line;
+  while (std::getline (file, line))
+    {
+      if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+      std::istringstream is (line);
+      uint32_t remote;
+      double delay;
+      BundleStatistics s;
+      is >> remote >> delay >> s.packetsSent >> s.packetsReceived >> s.nullSent >> s.nullReceived
+         >> s.requestsSent >> s.requestsReceived;
+      if (is && remote < m_tasks)
+        {
+          statistics[remote] = s;
+        }
+    }
+  return statistics;
+}
+
+void
+PointToPointRemoteChannelTestCase::DoRun (void)
+{
+  const uint32_t packets = 5;
+  Config::SetDefault ("ns3::NullMessageSimulatorImpl::StatisticsFile", StringValue (CreateTempDirFilename ("null-message")));
+  Config::SetDefault ("ns3::NullMessageSimulatorImpl::DemandDriven", BooleanValue (m_demandDriven));
+  MpiInterface::Enable (m_tasks);
+  uint32_t systemId = MpiInterface::GetSystemId ();
+
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < m_tasks; i++)
+    {
+      nodes.Create (1, i);
+    }
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("8Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  m_delay = MilliSeconds (10);
+  // payload and PPP header
+  m_txTime = DataRate ("8Mbps").CalculateBytesTxTime (1002);
+
+  m_flows.clear ();
+  if (m_tasks == 2)
+    {
+      NetDeviceContainer link = p2p.Install (nodes.Get (0), nodes.Get (1));
+      Flow f;
+      f.idle = false;
+      f.received = 0;
+      f.late = 0;
+      f.sender = link.Get (0);
+      f.receiver = link.Get (1);
+      m_flows.push_back (f);
+      f.sender = link.Get (1);
+      f.receiver = link.Get (0);
+      m_flows.push_back (f);
+    }
+  else
+    {
+      for (uint32_t i = 0; i < m_tasks; i++)
+        {
+          NetDeviceContainer link = p2p.Install (nodes.Get (i), nodes.Get ((i + 1) % m_tasks));
+          Flow f;
+          f.idle = (i == m_tasks - 1);
+          f.received = 0;
+          f.late = 0;
+          f.sender = link.Get (0);
+          f.receiver = link.Get (1);
+          m_flows.push_back (f);
+        }
+    }
+
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      Flow &f = m_flows[i];
+      for (uint32_t k = 0; !f.idle && k < packets; k++)
+        {
+          f.sent.push_back (Seconds (1 + k) + MilliSeconds (100 * i));
+        }
+      // only the task of a node runs its events
+      if (f.sender->GetNode ()->GetSystemId () == systemId)
+        {
+          for (uint32_t k = 0; k < f.sent.size (); k++)
+            {
+              Simulator::ScheduleWithContext (f.sender->GetNode ()->GetId (), f.sent[k],
+                                              &PointToPointRemoteChannelTestCase::Send, this, i);
+            }
+        }
+      if (f.receiver->GetNode ()->GetSystemId () == systemId)
+        {
+          f.receiver->SetReceiveCallback (MakeCallback (&PointToPointRemoteChannelTestCase::Receive, this).Bind (i));
+        }
+    }
+
+  Simulator::Stop (Seconds (packets + 2));
+  Simulator::Run ();
+
+  std::ostringstream resultName;
+  resultName << CreateTempDirFilename ("result") << "-" << systemId << ".txt";
+  std::ofstream result (resultName.str ().c_str ());
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      if (m_flows[i].receiver->GetNode ()->GetSystemId () == systemId)
+        {
+          result << i << " " << m_flows[i].received << " " << m_flows[i].late << std::endl;
+        }
+    }
+  result.close ();
+  m_flows.clear ();
+  Simulator::Destroy ();
+
+  if (systemId != 0)
+    {
+      // the other tasks are copies of the test runner: they stop here
+      MpiInterface::Disable ();
+      _exit (0);
+    }
+  // wait for the other tasks
+  MpiInterface::Disable ();
+  Config::Reset ();
+
+  uint32_t flows = 0;
+  for (uint32_t task = 0; task < m_tasks; task++)
+    {
+      std::ostringstream name;
+      name << CreateTempDirFilename ("result") << "-" << task << ".txt";
+      std::ifstream file (name.str ().c_str ());
+      uint32_t flow, received, late;
+      while (file >> flow >> received >> late)
+        {
+          bool idle = (m_tasks > 2 && flow == m_tasks - 1);
+          NS_TEST_EXPECT_MSG_EQ (received, idle ? 0 : packets, "Wrong number of packets in flow " << flow);
+          NS_TEST_EXPECT_MSG_EQ (late, 0, "Packets received at the wrong time in flow " << flow);
+          flows++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (flows, (m_tasks == 2 ? 2 : m_tasks), "Missing results of a task");
+
+  uint32_t requests = 0;
+  std::vector<std::vector<BundleStatistics> > statistics;
+  for (uint32_t task = 0; task < m_tasks; task++)
+    {
+      statistics.push_back (ReadStatistics (task));
+    }
+  for (uint32_t a = 0; a < m_tasks; a++)
+    {
+      for (uint32_t b = 0; b < m_tasks; b++)
+        {
+          bool neighbors = (a != b) && (m_tasks == 2 || (a + 1) % m_tasks == b || (b + 1) % m_tasks == a);
+          if (!neighbors)
+            {
+              continue;
+            }
+          const BundleStatistics &ab = statistics[a][b];
+          const BundleStatistics &ba = statistics[b][a];
+          // every message written in the rings is received
+          NS_TEST_EXPECT_MSG_EQ (ab.packetsSent, ba.packetsReceived, "Packets lost from task " << a << " to " << b);
+          NS_TEST_EXPECT_MSG_EQ (ab.requestsSent, ba.requestsReceived, "Requests lost from task " << a << " to " << b);
+          if (m_demandDriven)
+            {
+              // the end of the simulation is announced, but the remote
+              // task may have ended before reading it
+              NS_TEST_EXPECT_MSG_LT_OR_EQ (ba.nullReceived, ab.nullSent, "Null messages from nowhere to task " << b);
+              NS_TEST_EXPECT_MSG_GT_OR_EQ (ba.nullReceived + 1, ab.nullSent, "Null messages lost from task " << a << " to " << b);
+              // apart from the initial guarantee time and the end of the
+              // simulation, each null message answers a request
+              NS_TEST_EXPECT_MSG_LT_OR_EQ (ab.nullSent, ab.requestsReceived + 2,
+                                           "Unrequested null messages from task " << a << " to " << b);
+              requests += ab.requestsSent;
+            }
+          else
+            {
+              NS_TEST_EXPECT_MSG_EQ (ab.nullSent, ba.nullReceived, "Null messages lost from task " << a << " to " << b);
+              // the guarantee times are sent periodically
+              NS_TEST_EXPECT_MSG_GT (ab.nullSent, 0, "No null message from task " << a << " to " << b);
+              NS_TEST_EXPECT_MSG_EQ (ab.requestsSent, 0, "Null message requests from task " << a << " to " << b);
+            }
+        }
+    }
+  if (m_demandDriven)
+    {
+      NS_TEST_EXPECT_MSG_GT (requests, 0, "No null message was requested");
+    }
+}
+
+
+class PointToPointRemoteChannelTestSuite : public TestSuite
+{
+public:
+  PointToPointRemoteChannelTestSuite ();
+};
+
+PointToPointRemoteChannelTestSuite::PointToPointRemoteChannelTestSuite ()
+  : TestSuite ("point-to-point-remote-channel", UNIT)
+{
+  AddTestCase (new PointToPointRemoteChannelTestCase (2, false), TestCase::QUICK);
+  AddTestCase (new PointToPointRemoteChannelTestCase (3, false), TestCase::QUICK);
+  AddTestCase (new PointToPointRemoteChannelTestCase (2, true), TestCase::QUICK);
+  AddTestCase (new PointToPointRemoteChannelTestCase (3, true), TestCase::QUICK);
+}
+
+static PointToPointRemoteChannelTestSuite g_pointToPointRemoteChannelTestSuite;
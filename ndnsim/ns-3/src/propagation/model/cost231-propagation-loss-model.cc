@@ -174,6 +174,27 @@ Cost231PropagationLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel
   return txPowerDbm + GetLoss (a, b);
 }
 
+void
+Cost231PropagationLossModel::DoCalcRxPowers (const PropagationLossBatch &batch, Ptr<MobilityModel> a,
+                                             const std::vector<Ptr<MobilityModel> > &b, double *rxPowerDbm) const
+{
+  // same computation as GetLoss, with the terms which do not depend on the
+  // distance summed up front in the same order
+  const double *distance = &batch.distance[0];
+  uint32_t n = batch.distance.size ();
+  double frequency_MHz = m_frequency * 1e-6;
+  double C_H = 0.8 + ((1.11 * std::log10(frequency_MHz)) - 0.7) * m_SSAntennaHeight - (1.56 * std::log10(frequency_MHz));
+  double fixedLoss = 46.3 + (33.9 * std::log10(frequency_MHz)) - (13.82 * std::log10 (m_BSAntennaHeight)) - C_H;
+  double slope = 44.9 - 6.55 * std::log10 (m_BSAntennaHeight);
+  double minDistance = m_minDistance;
+  double shadowing = m_shadowing;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double loss_in_db = fixedLoss + (slope * std::log10 (distance[i] * 1e-3)) + shadowing;
+      rxPowerDbm[i] += (distance[i] <= minDistance) ? 0.0 : (0 - loss_in_db);
+    }
+}
+
 int64_t
 Cost231PropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -139,6 +139,8 @@ private:
   Cost231PropagationLossModel & operator = (const Cost231PropagationLossModel &);
 
   virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (const PropagationLossBatch &batch, Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b, double *rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
   double m_BSAntennaHeight; //!< BS Antenna Height [m]
   double m_SSAntennaHeight; //!< SS Antenna Height [m]
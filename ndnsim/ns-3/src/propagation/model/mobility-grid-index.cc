@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mobility-grid-index.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityGridIndex");
+
+MobilityGridIndex::MobilityGridIndex ()
+  : m_cellSize (0.0)
+{
+}
+
+MobilityGridIndex::~MobilityGridIndex ()
+{
+  Clear (0.0);
+}
+
+bool
+MobilityGridIndex::IsMoving (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  return (velocity.x != 0 || velocity.y != 0 || velocity.z != 0);
+}
+
+bool
+MobilityGridIndex::Cell::operator < (const Cell &o) const
+{
+  if (x != o.x)
+    {
+      return x < o.x;
+    }
+  if (y != o.y)
+    {
+      return y < o.y;
+    }
+  return z < o.z;
+}
+
+void
+MobilityGridIndex::Clear (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  for (std::map<Ptr<MobilityModel>, std::vector<uint32_t> >::iterator it = m_mobilityItems.begin ();
+       it != m_mobilityItems.end (); ++it)
+    {
+      it->first->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&MobilityGridIndex::CourseChanged, this));
+    }
+  m_mobilityItems.clear ();
+  m_grid.clear ();
+  m_unindexed.clear ();
+  m_entries.clear ();
+  m_cellSize = cellSize;
+}
+
+double
+MobilityGridIndex::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+void
+MobilityGridIndex::Add (uint32_t item, Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << item << mobility);
+  NS_ASSERT_MSG (m_cellSize > 0, "The cell size must be set before adding items");
+  if (item >= m_entries.size ())
+    {
+      m_entries.resize (item + 1);
+    }
+  if (mobility != 0)
+    {
+      std::vector<uint32_t> &items = m_mobilityItems[mobility];
+      if (items.empty ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MobilityGridIndex::CourseChanged, this));
+        }
+      items.push_back (item);
+    }
+  Insert (item, mobility);
+}
+
+MobilityGridIndex::Cell
+MobilityGridIndex::GetCell (const Vector &position) const
+{
+  Cell cell;
+  cell.x = (int64_t)std::floor (position.x / m_cellSize);
+  cell.y = (int64_t)std::floor (position.y / m_cellSize);
+  cell.z = (int64_t)std::floor (position.z / m_cellSize);
+  return cell;
+}
+
+void
+MobilityGridIndex::Insert (uint32_t item, Ptr<const MobilityModel> mobility)
+{
+  Entry &entry = m_entries[item];
+  entry.unindexed = (mobility == 0 || IsMoving (mobility));
+  if (entry.unindexed)
+    {
+      m_unindexed.push_back (item);
+    }
+  else
+    {
+      entry.cell = GetCell (mobility->GetPosition ());
+      m_grid[entry.cell].push_back (item);
+    }
+}
+
+void
+MobilityGridIndex::Remove (uint32_t item)
+{
+  const Entry &entry = m_entries[item];
+  std::vector<uint32_t> *items = &m_unindexed;
+  std::map<Cell, std::vector<uint32_t> >::iterator cell;
+  if (!entry.unindexed)
+    {
+      cell = m_grid.find (entry.cell);
+      NS_ASSERT (cell != m_grid.end ());
+      items = &cell->second;
+    }
+  items->erase (std::find (items->begin (), items->end (), item));
+  if (!entry.unindexed && items->empty ())
+    {
+      m_grid.erase (cell);
+    }
+}
+
+void
+MobilityGridIndex::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<Ptr<MobilityModel>, std::vector<uint32_t> >::const_iterator it =
+    m_mobilityItems.find (ConstCast<MobilityModel> (mobility));
+  NS_ASSERT (it != m_mobilityItems.end ());
+  for (std::vector<uint32_t>::const_iterator item = it->second.begin (); item != it->second.end (); ++item)
+    {
+      Remove (*item);
+      Insert (*item, mobility);
+    }
+}
+
+std::vector<uint32_t>
+MobilityGridIndex::GetNearby (const Vector &position) const
+{
+  std::vector<uint32_t> nearby (m_unindexed);
+  Cell center = GetCell (position);
+  Cell cell;
+  for (cell.x = center.x - 1; cell.x <= center.x + 1; cell.x++)
+    {
+      for (cell.y = center.y - 1; cell.y <= center.y + 1; cell.y++)
+        {
+          for (cell.z = center.z - 1; cell.z <= center.z + 1; cell.z++)
+            {
+              std::map<Cell, std::vector<uint32_t> >::const_iterator it = m_grid.find (cell);
+              if (it != m_grid.end ())
+                {
+                  nearby.insert (nearby.end (), it->second.begin (), it->second.end ());
+                }
+            }
+        }
+    }
+  std::sort (nearby.begin (), nearby.end ());
+  return nearby;
+}
+
+} // namespace ns3
@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_GRID_INDEX_H
+#define MOBILITY_GRID_INDEX_H
+
+#include "ns3/mobility-model.h"
+#include "ns3/vector.h"
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ * \brief Spatial index of the positions of a set of mobility models
+ *
+ * The channels use it to skip the receivers that are too far from a
+ * transmitter.  Each item, numbered from 0, is kept in a uniform grid of
+ * cubic cells, and moved to its new cell when its mobility model fires
+ * its CourseChange trace.  The items whose mobility model is moving, see
+ * IsMoving(), and the items without a mobility model are not in a cell:
+ * they are returned by every query.
+ */
+class MobilityGridIndex
+{
+public:
+  MobilityGridIndex ();
+  ~MobilityGridIndex ();
+
+  /**
+   * A moving mobility model changes its position without firing its
+   * CourseChange trace.  Hence, the spatial index does not put it in a
+   * cell, and the caches of the losses, which are only invalidated by
+   * course changes, are not used for it.
+   *
+   * \param mobility a mobility model
+   * \returns true if the mobility model has a non-zero velocity
+   */
+  static bool IsMoving (Ptr<const MobilityModel> mobility);
+
+  /**
+   * Remove all the items and stop listening to the course changes.
+   *
+   * \param cellSize the side of the cells of the items added next
+   */
+  void Clear (double cellSize);
+
+  /**
+   * \returns the side of the cells
+   */
+  double GetCellSize (void) const;
+
+  /**
+   * Add an item, and listen to the course changes of its mobility model.
+   *
+   * \param item the item, numbered from 0
+   * \param mobility the mobility model of the item, possibly 0
+   */
+  void Add (uint32_t item, Ptr<MobilityModel> mobility);
+
+  /**
+   * \param position a position
+   * \returns the sorted items that may be within the cell size from the
+   * position: the items in the cells next to the position, and the items
+   * that are not in a cell
+   */
+  std::vector<uint32_t> GetNearby (const Vector &position) const;
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  MobilityGridIndex (const MobilityGridIndex &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  MobilityGridIndex & operator = (const MobilityGridIndex &);
+
+  /**
+   * The coordinates of a cell.
+   */
+  struct Cell
+  {
+    int64_t x; //!< x coordinate
+    int64_t y; //!< y coordinate
+    int64_t z; //!< z coordinate
+    /**
+     * \param o another cell
+     * \returns true if this cell is before the other one
+     */
+    bool operator < (const Cell &o) const;
+  };
+
+  /**
+   * Where an item is in the index.
+   */
+  struct Entry
+  {
+    Cell cell;      //!< cell holding the item
+    bool unindexed; //!< true if the item is moving or has no mobility model, instead of in a cell
+  };
+
+  /**
+   * \param position a position
+   * \returns the cell holding the position
+   */
+  Cell GetCell (const Vector &position) const;
+
+  /**
+   * Put an item in its cell, or in the unindexed list.
+   *
+   * \param item the item
+   * \param mobility its mobility model, possibly 0
+   */
+  void Insert (uint32_t item, Ptr<const MobilityModel> mobility);
+
+  /**
+   * Remove an item from its cell or from the unindexed list.
+   *
+   * \param item the item
+   */
+  void Remove (uint32_t item);
+
+  /**
+   * Move the items using a mobility model to their new cell.
+   *
+   * \param mobility the mobility model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  double m_cellSize;                                  //!< side of the cells
+  std::map<Cell, std::vector<uint32_t> > m_grid;      //!< the items with a fixed position, by cell
+  std::vector<uint32_t> m_unindexed;                  //!< the items that are moving or have no mobility model
+  std::vector<Entry> m_entries;                       //!< where each item is
+  std::map<Ptr<MobilityModel>, std::vector<uint32_t> > m_mobilityItems; //!< the items using each mobility model
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_GRID_INDEX_H */
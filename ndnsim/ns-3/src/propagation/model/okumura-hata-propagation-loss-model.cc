@@ -74,17 +74,23 @@ OkumuraHataPropagationLossModel::~OkumuraHataPropagationLossModel ()
 
 double
 OkumuraHataPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  return GetLoss (a->GetDistanceFrom (b), a->GetPosition ().z, b->GetPosition ().z);
+}
+
+double
+OkumuraHataPropagationLossModel::GetLoss (double distance, double za, double zb) const
 {
   double loss = 0.0;
   double fmhz = m_frequency / 1e6;
-  double dist = a->GetDistanceFrom (b) / 1000.0; 
+  double dist = distance / 1000.0;
   if (m_frequency <= 1.500e9)
     {
       // standard Okumura Hata 
       // see eq. (4.4.1) in the COST 231 final report
       double log_f = std::log10 (fmhz);
-      double hb = (a->GetPosition ().z > b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
-      double hm = (a->GetPosition ().z < b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
+      double hb = (za > zb ? za : zb);
+      double hm = (za < zb ? za : zb);
       NS_ASSERT_MSG (hb > 0 && hm > 0, "nodes' height must be greater then 0");
       double log_aHeight = 13.82 * std::log10 (hb);
       double log_bHeight = 0.0;
@@ -104,7 +110,7 @@ OkumuraHataPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityMode
           log_bHeight = 0.8 + (1.1 * log_f - 0.7) * hm - 1.56 * log_f;
         }
 
-      NS_LOG_INFO (this << " logf " << 26.16 * log_f << " loga " << log_aHeight << " X " << (((44.9 - (6.55 * std::log10 (hb)) )) * std::log10 (a->GetDistanceFrom (b))) << " logb " << log_bHeight);
+      NS_LOG_INFO (this << " logf " << 26.16 * log_f << " loga " << log_aHeight << " X " << (((44.9 - (6.55 * std::log10 (hb)) )) * std::log10 (distance)) << " logb " << log_bHeight);
       loss = 69.55 + (26.16 * log_f) - log_aHeight + (((44.9 - (6.55 * std::log10 (hb)) )) * std::log10 (dist)) - log_bHeight;
       if (m_environment == SubUrbanEnvironment)
         {
@@ -122,8 +128,8 @@ OkumuraHataPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityMode
       // see eq. (4.4.3) in the COST 231 final report
 
       double log_f = std::log10 (fmhz);
-      double hb = (a->GetPosition ().z > b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
-      double hm = (a->GetPosition ().z < b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
+      double hb = (za > zb ? za : zb);
+      double hm = (za < zb ? za : zb);
       NS_ASSERT_MSG (hb > 0 && hm > 0, "nodes' height must be greater then 0");
       double log_aHeight = 13.82 * std::log10 (hb);
       double log_bHeight = 0.0;
@@ -152,6 +158,22 @@ OkumuraHataPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return (txPowerDbm - GetLoss (a, b));
 }
 
+void
+OkumuraHataPropagationLossModel::DoCalcRxPowers (const PropagationLossBatch &batch,
+                                                 Ptr<MobilityModel> a,
+                                                 const std::vector<Ptr<MobilityModel> > &b,
+                                                 double *rxPowerDbm) const
+{
+  const double *distance = &batch.distance[0];
+  const Vector *rxPosition = &batch.rxPosition[0];
+  uint32_t n = batch.distance.size ();
+  double za = batch.txPosition.z;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      rxPowerDbm[i] -= GetLoss (distance[i], za, rxPosition[i].z);
+    }
+}
+
 int64_t
 OkumuraHataPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -78,9 +78,23 @@ private:
    */
   OkumuraHataPropagationLossModel & operator = (const OkumuraHataPropagationLossModel &);
 
+  /**
+   * \param distance the distance between the two nodes (m)
+   * \param za the height of the first node (m)
+   * \param zb the height of the second node (m)
+   *
+   * \return the loss in dBm for the propagation between
+   * the two nodes
+   */
+  double GetLoss (double distance, double za, double zb) const;
+
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (const PropagationLossBatch &batch,
+                               Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               double *rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
   
   EnvironmentType m_environment;  //!< Environment Scenario
@@ -22,6 +22,7 @@
  */
 
 #include "propagation-loss-model.h"
+#include "mobility-grid-index.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/boolean.h"
@@ -29,6 +30,7 @@
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -81,6 +83,61 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+void
+PropagationLossModel::CalcRxPowers (double txPowerDbm,
+                                    Ptr<MobilityModel> a,
+                                    const std::vector<Ptr<MobilityModel> > &b,
+                                    std::vector<double> &rxPowerDbm) const
+{
+  uint32_t n = b.size ();
+  rxPowerDbm.assign (n, txPowerDbm);
+  if (n == 0)
+    {
+      return;
+    }
+  m_batch.txPosition = a->GetPosition ();
+  m_batch.rxPosition.resize (n);
+  m_batch.distance.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_batch.rxPosition[i] = b[i]->GetPosition ();
+    }
+  // same computation as MobilityModel::GetDistanceFrom
+  Vector tx = m_batch.txPosition;
+  const Vector *rx = &m_batch.rxPosition[0];
+  double *distance = &m_batch.distance[0];
+  for (uint32_t i = 0; i < n; i++)
+    {
+      distance[i] = CalculateDistance (tx, rx[i]);
+    }
+  CalcRxPowers (m_batch, a, b, &rxPowerDbm[0]);
+}
+
+void
+PropagationLossModel::CalcRxPowers (const PropagationLossBatch &batch,
+                                    Ptr<MobilityModel> a,
+                                    const std::vector<Ptr<MobilityModel> > &b,
+                                    double *rxPowerDbm) const
+{
+  DoCalcRxPowers (batch, a, b, rxPowerDbm);
+  if (m_next != 0)
+    {
+      m_next->CalcRxPowers (batch, a, b, rxPowerDbm);
+    }
+}
+
+void
+PropagationLossModel::DoCalcRxPowers (const PropagationLossBatch &batch,
+                                      Ptr<MobilityModel> a,
+                                      const std::vector<Ptr<MobilityModel> > &b,
+                                      double *rxPowerDbm) const
+{
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      rxPowerDbm[i] = DoCalcRxPower (rxPowerDbm[i], a, b[i]);
+    }
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -269,6 +326,26 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - std::max (lossDb, m_minLoss);
 }
 
+void
+FriisPropagationLossModel::DoCalcRxPowers (const PropagationLossBatch &batch,
+                                           Ptr<MobilityModel> a,
+                                           const std::vector<Ptr<MobilityModel> > &b,
+                                           double *rxPowerDbm) const
+{
+  // same computation as DoCalcRxPower
+  const double *distance = &batch.distance[0];
+  uint32_t n = batch.distance.size ();
+  double numerator = m_lambda * m_lambda;
+  double systemLoss = m_systemLoss;
+  double minLoss = m_minLoss;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double denominator = 16 * M_PI * M_PI * distance[i] * distance[i] * systemLoss;
+      double lossDb = -10 * log10 (numerator / denominator);
+      rxPowerDbm[i] -= (distance[i] <= 0) ? minLoss : std::max (lossDb, minLoss);
+    }
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -442,6 +519,38 @@ TwoRayGroundPropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+void
+TwoRayGroundPropagationLossModel::DoCalcRxPowers (const PropagationLossBatch &batch,
+                                                  Ptr<MobilityModel> a,
+                                                  const std::vector<Ptr<MobilityModel> > &b,
+                                                  double *rxPowerDbm) const
+{
+  // same computation as DoCalcRxPower
+  const double *distance = &batch.distance[0];
+  const Vector *rxPosition = &batch.rxPosition[0];
+  uint32_t n = batch.distance.size ();
+  double txAntHeight = batch.txPosition.z + m_heightAboveZ;
+  double heightAboveZ = m_heightAboveZ;
+  double lambda = m_lambda;
+  double systemLoss = m_systemLoss;
+  double minDistance = m_minDistance;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double rxAntHeight = rxPosition[i].z + heightAboveZ;
+      double dCross = (4 * M_PI * txAntHeight * rxAntHeight) / lambda;
+      double tmp = M_PI * distance[i];
+      double pr = 10 * std::log10 ((lambda * lambda) / (16 * tmp * tmp * systemLoss));
+      tmp = txAntHeight * rxAntHeight;
+      double rayNumerator = tmp * tmp;
+      tmp = distance[i] * distance[i];
+      double rayPr = 10 * std::log10 (rayNumerator / (tmp * tmp * systemLoss));
+      if (distance[i] > minDistance)
+        {
+          rxPowerDbm[i] += (distance[i] <= dCross) ? pr : rayPr;
+        }
+    }
+}
+
 int64_t
 TwoRayGroundPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -531,6 +640,26 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+void
+LogDistancePropagationLossModel::DoCalcRxPowers (const PropagationLossBatch &batch,
+                                                 Ptr<MobilityModel> a,
+                                                 const std::vector<Ptr<MobilityModel> > &b,
+                                                 double *rxPowerDbm) const
+{
+  // same computation as DoCalcRxPower
+  const double *distance = &batch.distance[0];
+  uint32_t n = batch.distance.size ();
+  double exponent = m_exponent;
+  double referenceDistance = m_referenceDistance;
+  double referenceLoss = m_referenceLoss;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double pathLossDb = 10 * exponent * std::log10 (distance[i] / referenceDistance);
+      double rxc = -referenceLoss - pathLossDb;
+      rxPowerDbm[i] += (distance[i] <= referenceDistance) ? 0 : rxc;
+    }
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -632,6 +761,49 @@ ThreeLogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - pathLossDb;
 }
 
+void
+ThreeLogDistancePropagationLossModel::DoCalcRxPowers (const PropagationLossBatch &batch,
+                                                      Ptr<MobilityModel> a,
+                                                      const std::vector<Ptr<MobilityModel> > &b,
+                                                      double *rxPowerDbm) const
+{
+  // same computation as DoCalcRxPower, with the losses of the complete
+  // fields summed up front in the same order
+  const double *distance = &batch.distance[0];
+  uint32_t n = batch.distance.size ();
+  double distance0 = m_distance0;
+  double distance1 = m_distance1;
+  double distance2 = m_distance2;
+  double exponent0 = m_exponent0;
+  double exponent1 = m_exponent1;
+  double exponent2 = m_exponent2;
+  double loss0 = m_referenceLoss;
+  double loss1 = loss0 + 10 * exponent0 * std::log10 (distance1 / distance0);
+  double loss2 = loss1 + 10 * exponent1 * std::log10 (distance2 / distance1);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double d = distance[i];
+      double pathLossDb;
+      if (d < distance0)
+        {
+          pathLossDb = 0;
+        }
+      else if (d < distance1)
+        {
+          pathLossDb = loss0 + 10 * exponent0 * std::log10 (d / distance0);
+        }
+      else if (d < distance2)
+        {
+          pathLossDb = loss1 + 10 * exponent1 * std::log10 (d / distance1);
+        }
+      else
+        {
+          pathLossDb = loss2 + 10 * exponent2 * std::log10 (d / distance2);
+        }
+      rxPowerDbm[i] -= pathLossDb;
+    }
+}
+
 int64_t
 ThreeLogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -927,4 +1099,146 @@ RangePropagationLossModel::DoAssignStreams (int64_t stream)
 
 // ------------------------------------------------------------------------- //
 
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model",
+                   "The first loss model of the deterministic chain whose "
+                   "loss is cached for each pair of nodes.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : PropagationLossModel ()
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+  Clear ();
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  Clear ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  Clear ();
+  m_model = model;
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+CachedPropagationLossModel::Clear (void)
+{
+  // the callback must be of the same type as the one connected by the
+  // const GetIndex to compare equal
+  const CachedPropagationLossModel *self = this;
+  for (std::vector<Ptr<const MobilityModel> >::iterator it = m_mobilities.begin ();
+       it != m_mobilities.end (); ++it)
+    {
+      ConstCast<MobilityModel> (*it)->TraceDisconnectWithoutContext ("CourseChange",
+        MakeCallback (&CachedPropagationLossModel::CourseChanged, self));
+    }
+  m_indices.clear ();
+  m_mobilities.clear ();
+  m_losses.clear ();
+}
+
+uint32_t
+CachedPropagationLossModel::GetIndex (Ptr<MobilityModel> mobility) const
+{
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (PeekPointer (mobility));
+  if (it != m_indices.end ())
+    {
+      return it->second;
+    }
+  mobility->TraceConnectWithoutContext ("CourseChange",
+    MakeCallback (&CachedPropagationLossModel::CourseChanged, this));
+  uint32_t index = m_mobilities.size ();
+  m_indices[PeekPointer (mobility)] = index;
+  m_mobilities.push_back (mobility);
+  m_losses.push_back (std::vector<double> ());
+  return index;
+}
+
+void
+CachedPropagationLossModel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (PeekPointer (mobility));
+  NS_ASSERT (it != m_indices.end ());
+  uint32_t index = it->second;
+  m_losses[index].clear ();
+  for (std::vector<std::vector<double> >::iterator row = m_losses.begin (); row != m_losses.end (); ++row)
+    {
+      if (index < row->size ())
+        {
+          (*row)[index] = std::numeric_limits<double>::quiet_NaN ();
+        }
+    }
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No model to cache");
+  if (MobilityGridIndex::IsMoving (a) || MobilityGridIndex::IsMoving (b))
+    {
+      // the loss to a moving node changes without course change
+      return m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+  uint32_t dst = GetIndex (b);
+  std::vector<double> &losses = m_losses[GetIndex (a)];
+  if (dst < losses.size () && !std::isnan (losses[dst]))
+    {
+      return txPowerDbm - losses[dst];
+    }
+  double rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  if (losses.size () <= dst)
+    {
+      losses.resize (dst + 1, std::numeric_limits<double>::quiet_NaN ());
+    }
+  losses[dst] = txPowerDbm - rxPowerDbm;
+  NS_LOG_LOGIC ("loss " << losses[dst] << " dB cached");
+  return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
+// ------------------------------------------------------------------------- //
+
 } // namespace ns3
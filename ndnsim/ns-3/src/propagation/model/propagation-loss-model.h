@@ -27,7 +27,10 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3 {
 
@@ -38,6 +41,23 @@ namespace ns3 {
 
 class MobilityModel;
 
+/**
+ * \ingroup propagation
+ *
+ * \brief The geometry of a transmission to many receivers, see
+ * PropagationLossModel::CalcRxPowers
+ *
+ * The positions of the receivers and their distances from the transmitter
+ * are read once for the whole chain of loss models, and stored in
+ * contiguous arrays that the models can process in plain loops.
+ */
+struct PropagationLossBatch
+{
+  Vector txPosition;              //!< Position of the transmitter
+  std::vector<Vector> rxPosition; //!< Position of each receiver
+  std::vector<double> distance;   //!< Distance from the transmitter to each receiver (m)
+};
+
 /**
  * \ingroup propagation
  *
@@ -93,6 +113,25 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * Returns the Rx Power of a transmission at many receivers, taking into
+   * account all the PropagationLossModel(s) chained to the current one.
+   *
+   * The result is the same as calling CalcRxPower for each receiver in
+   * turn, but the positions of the nodes are read once, and each model of
+   * the chain processes the whole batch in a single call.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param rxPowerDbm the reception power at each destination (in dBm),
+   * resized to the number of destinations
+   */
+  void CalcRxPowers (double txPowerDbm,
+                     Ptr<MobilityModel> a,
+                     const std::vector<Ptr<MobilityModel> > &b,
+                     std::vector<double> &rxPowerDbm) const;
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -134,6 +173,35 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
 
+  /**
+   * Applies this model and the ones chained to it to a batch of receivers.
+   *
+   * \param batch the positions and distances of the receivers
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param rxPowerDbm the power of each destination (in dBm), updated in place
+   */
+  void CalcRxPowers (const PropagationLossBatch &batch,
+                     Ptr<MobilityModel> a,
+                     const std::vector<Ptr<MobilityModel> > &b,
+                     double *rxPowerDbm) const;
+
+  /**
+   * Applies only this particular PropagationLossModel to a batch of
+   * receivers. The default implementation calls DoCalcRxPower for each
+   * receiver; the models which only depend on the positions override it
+   * with a loop over the arrays of the batch.
+   *
+   * \param batch the positions and distances of the receivers
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param rxPowerDbm the power of each destination (in dBm), updated in place
+   */
+  virtual void DoCalcRxPowers (const PropagationLossBatch &batch,
+                               Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               double *rxPowerDbm) const;
+
   /**
    * Subclasses must implement this; those not using random variables
    * can return zero
@@ -141,6 +209,7 @@ private:
   virtual int64_t DoAssignStreams (int64_t stream) = 0;
 
   Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
+  mutable PropagationLossBatch m_batch; //!< Storage of the last batch, reused by CalcRxPowers
 };
 
 /**
@@ -321,6 +390,10 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (const PropagationLossBatch &batch,
+                               Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               double *rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -441,6 +514,10 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (const PropagationLossBatch &batch,
+                               Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               double *rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -529,6 +606,10 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (const PropagationLossBatch &batch,
+                               Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               double *rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -612,6 +693,10 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (const PropagationLossBatch &batch,
+                               Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               double *rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   double m_distance0; //!< Beginning of the first (near) distance field
@@ -849,6 +934,109 @@ private:
   double m_range; //!< Maximum Transmission Range (meters)
 };
 
+/**
+ * \ingroup propagation
+ *
+ * \brief Caches the loss computed by another chain of loss models for each
+ * pair of nodes, until one of the nodes moves.
+ *
+ * The loss of the chain set through the Model attribute is computed once
+ * for each (source, destination) pair of mobility models, and then reused
+ * until either mobility model fires its CourseChange trace. The loss is
+ * never cached for a mobility model with a non-zero velocity, whose
+ * position changes without course change (see MobilityGridIndex::IsMoving).
+ * This saves
+ * the computation of the distance and of the logarithms of models such as
+ * LogDistancePropagationLossModel for every transmission when the nodes
+ * do not move. The cached chain must be deterministic, i.e., give the
+ * same loss for the same positions, and independent of the transmit
+ * power: random fading models, e.g., NakagamiPropagationLossModel, should
+ * be chained after this model with SetNext() instead, so that they are
+ * still computed for each transmission:
+ *
+ * \code
+ *   Ptr<CachedPropagationLossModel> cached = CreateObject<CachedPropagationLossModel> ();
+ *   cached->SetModel (CreateObject<LogDistancePropagationLossModel> ());
+ *   cached->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+ * \endcode
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the first loss model of the chain whose loss is cached
+   *
+   * Setting the model clears the cache.
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+
+  /**
+   * \return the first loss model of the chain whose loss is cached
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  CachedPropagationLossModel (const CachedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /**
+   * Get the index of a node in the cache, connecting to its CourseChange
+   * trace the first time it is seen
+   *
+   * \param mobility the mobility model of the node
+   * \returns the index of the node
+   */
+  uint32_t GetIndex (Ptr<MobilityModel> mobility) const;
+
+  /**
+   * Invalidate the losses from and to a node which moved
+   *
+   * \param mobility the mobility model of the node
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+
+  /// Disconnect from the mobility models and clear the cache
+  void Clear (void);
+
+  Ptr<PropagationLossModel> m_model; //!< the first model of the cached chain
+  /// the index of each node in the cache
+  mutable std::unordered_map<const MobilityModel *, uint32_t> m_indices;
+  /// the mobility model of each node, by index
+  mutable std::vector<Ptr<const MobilityModel> > m_mobilities;
+  /// the losses (dB, positive) from each node to the nodes with a lower
+  /// index than the size of its row, NaN if not computed
+  mutable std::vector<std::vector<double> > m_losses;
+};
+
 } // namespace ns3
 
 #endif /* PROPAGATION_LOSS_MODEL_H */
@@ -22,7 +22,11 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/okumura-hata-propagation-loss-model.h"
+#include "ns3/cost231-propagation-loss-model.h"
+#include "ns3/enum.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -436,6 +440,203 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check that a cached model gives the same loss as the model it caches
+   * \param cached the cached model
+   * \param model the model it caches
+   * \param a the first node
+   * \param b the second node
+   */
+  void CheckLoss (Ptr<PropagationLossModel> cached, Ptr<PropagationLossModel> model,
+                  Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::CheckLoss (Ptr<PropagationLossModel> cached, Ptr<PropagationLossModel> model,
+                                               Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+{
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (10, a, b), model->CalcRxPower (10, a, b), 1e-9,
+                             "Loss incorrect at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100,0,0));
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  c->SetPosition (Vector (0,200,0));
+
+  // the loss of a log distance model is the same with and without cache
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> cached = CreateObject<CachedPropagationLossModel> ();
+  cached->SetModel (logDistance);
+  double tolerance = 1e-9;
+  for (int i = 0; i < 2; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (10, a, b), logDistance->CalcRxPower (10, a, b), tolerance, "Loss a -> b incorrect");
+      NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (-20, b, a), logDistance->CalcRxPower (-20, b, a), tolerance, "Loss b -> a incorrect");
+      NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (0, a, c), logDistance->CalcRxPower (0, a, c), tolerance, "Loss a -> c incorrect");
+    }
+  b->SetPosition (Vector (300,0,0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (10, a, b), logDistance->CalcRxPower (10, a, b), tolerance, "Loss a -> b incorrect after b moved");
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (10, b, a), logDistance->CalcRxPower (10, b, a), tolerance, "Loss b -> a incorrect after b moved");
+  a->SetPosition (Vector (0,-100,0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (10, a, b), logDistance->CalcRxPower (10, a, b), tolerance, "Loss a -> b incorrect after a moved");
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (10, c, a), logDistance->CalcRxPower (10, c, a), tolerance, "Loss c -> a incorrect after a moved");
+
+  // the loss is computed once per pair until a node moves, and the next
+  // models of the chain are still applied
+  Ptr<MatrixPropagationLossModel> matrix = CreateObject<MatrixPropagationLossModel> ();
+  matrix->SetLoss (a, b, 10, /*symmetric = */ false);
+  matrix->SetLoss (b, a, 20, /*symmetric = */ false);
+  Ptr<MatrixPropagationLossModel> next = CreateObject<MatrixPropagationLossModel> ();
+  next->SetDefaultLoss (1);
+  cached->SetModel (matrix);
+  cached->SetNext (next);
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (0, a, b), -11, "Loss a -> b incorrect");
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (0, b, a), -21, "Loss b -> a incorrect");
+  matrix->SetLoss (a, b, 30);
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (5, a, b), -6, "Loss a -> b not cached");
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (5, b, a), -16, "Loss b -> a not cached");
+  next->SetDefaultLoss (2);
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (5, a, b), -7, "Next model not applied");
+  b->SetPosition (Vector (300,0,0));
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (0, a, b), -32, "Loss a -> b not updated after b moved");
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (0, b, a), -32, "Loss b -> a not updated after b moved");
+
+  // a node moving at a constant velocity fires no course change, so
+  // its losses are not cached
+  Ptr<ConstantVelocityMobilityModel> d = CreateObject<ConstantVelocityMobilityModel> ();
+  d->SetPosition (Vector (100,0,0));
+  d->SetVelocity (Vector (10,0,0));
+  Ptr<CachedPropagationLossModel> velocityCached = CreateObject<CachedPropagationLossModel> ();
+  velocityCached->SetModel (logDistance);
+  for (int i = 0; i < 3; ++i)
+    {
+      Simulator::Schedule (Seconds (i), &CachedPropagationLossModelTestCase::CheckLoss, this,
+                           velocityCached, logDistance, a, d);
+      Simulator::Schedule (Seconds (i), &CachedPropagationLossModelTestCase::CheckLoss, this,
+                           velocityCached, logDistance, d, a);
+    }
+  Simulator::Run ();
+  velocityCached->Dispose ();
+
+  cached->Dispose ();
+  // a disposed cache no longer follows the nodes
+  a->SetPosition (Vector (0,0,0));
+  Simulator::Destroy ();
+}
+
+class BatchPropagationLossModelTestCase : public TestCase
+{
+public:
+  BatchPropagationLossModelTestCase ();
+  virtual ~BatchPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check that CalcRxPowers gives the same powers as CalcRxPower
+   * \param model the model to check
+   * \param name the name of the model in the messages
+   */
+  void CheckBatch (Ptr<PropagationLossModel> model, std::string name);
+
+  Ptr<MobilityModel> m_tx;                    //!< the transmitter
+  std::vector<Ptr<MobilityModel> > m_rx;      //!< the receivers
+};
+
+BatchPropagationLossModelTestCase::BatchPropagationLossModelTestCase ()
+  : TestCase ("Test the batch computation of the received powers")
+{
+}
+
+BatchPropagationLossModelTestCase::~BatchPropagationLossModelTestCase ()
+{
+}
+
+void
+BatchPropagationLossModelTestCase::CheckBatch (Ptr<PropagationLossModel> model, std::string name)
+{
+  std::vector<double> rxPowerDbm;
+  model->CalcRxPowers (17, m_tx, m_rx, rxPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), m_rx.size (), name << ": wrong number of powers");
+  for (uint32_t i = 0; i < m_rx.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (rxPowerDbm[i], model->CalcRxPower (17, m_tx, m_rx[i]), 1e-9,
+                                 name << ": wrong power at receiver " << i);
+    }
+}
+
+void
+BatchPropagationLossModelTestCase::DoRun (void)
+{
+  m_tx = CreateObject<ConstantPositionMobilityModel> ();
+  m_tx->SetPosition (Vector (0, 0, 30));
+  // receivers in the near field, in each field of the three log distance
+  // model and on both sides of the two ray crossover distance
+  double distances[] = { 0.5, 2, 50, 120, 250, 1000, 5000, 20000 };
+  for (uint32_t i = 0; i < sizeof (distances) / sizeof (distances[0]); i++)
+    {
+      Ptr<MobilityModel> rx = CreateObject<ConstantPositionMobilityModel> ();
+      rx->SetPosition (Vector (distances[i] * 0.6, distances[i] * 0.8, 1.5 + i));
+      m_rx.push_back (rx);
+    }
+
+  std::vector<double> rxPowerDbm (3, 0);
+  Ptr<PropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  friis->CalcRxPowers (17, m_tx, std::vector<Ptr<MobilityModel> > (), rxPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), 0, "Powers of an empty batch");
+
+  CheckBatch (friis, "Friis");
+  CheckBatch (CreateObject<TwoRayGroundPropagationLossModel> (), "TwoRayGround");
+  CheckBatch (CreateObject<LogDistancePropagationLossModel> (), "LogDistance");
+  CheckBatch (CreateObject<ThreeLogDistancePropagationLossModel> (), "ThreeLogDistance");
+  CheckBatch (CreateObject<OkumuraHataPropagationLossModel> (), "OkumuraHata");
+  Ptr<OkumuraHataPropagationLossModel> okumuraHata = CreateObject<OkumuraHataPropagationLossModel> ();
+  okumuraHata->SetAttribute ("Frequency", DoubleValue (900e6));
+  okumuraHata->SetAttribute ("CitySize", EnumValue (SmallCity));
+  CheckBatch (okumuraHata, "OkumuraHata 900 MHz");
+  Ptr<Cost231PropagationLossModel> cost231 = CreateObject<Cost231PropagationLossModel> ();
+  cost231->SetAttribute ("MinDistance", DoubleValue (100));
+  CheckBatch (cost231, "Cost231");
+
+  // a chain mixing batch models and a model computed pair by pair
+  Ptr<PropagationLossModel> chain = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  Ptr<MatrixPropagationLossModel> matrix = CreateObject<MatrixPropagationLossModel> ();
+  matrix->SetDefaultLoss (3);
+  matrix->SetLoss (m_tx, m_rx[2], 10);
+  chain->SetNext (matrix);
+  matrix->SetNext (CreateObject<FriisPropagationLossModel> ());
+  CheckBatch (chain, "Chain");
+
+  m_tx = 0;
+  m_rx.clear ();
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +651,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new BatchPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -26,6 +26,7 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -34,6 +35,8 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <utility>
 #include "multi-model-spectrum-channel.h"
@@ -76,6 +79,10 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_numDevices (0),
+    m_maxRange (0.0),
+    m_cachePathLoss (false),
+    m_indexValid (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -89,6 +96,16 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  ClearIndex ();
+  for (std::map<Ptr<MobilityModel>, uint32_t>::iterator it = m_mobilityVersions.begin ();
+       it != m_mobilityVersions.end ();
+       ++it)
+    {
+      it->first->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&MultiModelSpectrumChannel::CourseChanged, this));
+    }
+  m_mobilityVersions.clear ();
+  m_pathLossCache.clear ();
+  m_convertedPsdMap.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -113,6 +130,28 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "The distance in meters beyond which transmissions are "
+                   "not passed to the receiving PHY, whatever the loss.  "
+                   "The receivers are then kept in a spatial index so that "
+                   "the receivers out of range are not even considered, "
+                   "which reduces the computational load when there are "
+                   "many receivers.  The default value 0 considers all "
+                   "receivers.  Tune this value with care, as for MaxLossDb.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("CachePathLoss",
+                   "If true, the loss due to the antennas and to the "
+                   "single-frequency PropagationLossModel is computed once "
+                   "for each pair of TX and RX PHYs, and again only after "
+                   "the mobility model of one of them reported a course "
+                   "change.  Only enable it if this loss does not change "
+                   "otherwise, e.g., if the PropagationLossModel does not "
+                   "model fast fading.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_cachePathLoss),
+                   MakeBooleanChecker ())
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -165,6 +204,8 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
     }
 
   ++m_numDevices;
+  // the phy may have a new spectrum model or a new mobility model
+  m_indexValid = false;
 
   RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.find (rxSpectrumModelUid);
 
@@ -266,6 +307,18 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // with MaxRange, only the receivers that may be in range are considered
+  bool cull = (m_maxRange > 0 && txMobility != 0);
+  std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > > nearbyRx;
+  if (cull)
+    {
+      if (!m_indexValid || m_index.GetCellSize () != m_maxRange)
+        {
+          BuildIndex ();
+        }
+      nearbyRx = GetNearbyRx (txMobility);
+    }
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -273,6 +326,17 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC (" rxSpectrumModelUids " << rxSpectrumModelUid);
 
+      std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > >::const_iterator nearbyIterator;
+      if (cull)
+        {
+          nearbyIterator = nearbyRx.find (rxSpectrumModelUid);
+          if (nearbyIterator == nearbyRx.end ())
+            {
+              NS_LOG_LOGIC ("no receiver in range");
+              continue;
+            }
+        }
+
       Ptr <SpectrumValue> convertedTxPowerSpectrum;
       if (txSpectrumModelUid == rxSpectrumModelUid)
         {
@@ -284,90 +348,284 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           NS_LOG_LOGIC (" converting txPowerSpectrum SpectrumModelUids" << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
           SpectrumConverterMap_t::const_iterator rxConverterIterator = txInfoIteratorerator->second.m_spectrumConverterMap.find (rxSpectrumModelUid);
           NS_ASSERT (rxConverterIterator != txInfoIteratorerator->second.m_spectrumConverterMap.end ());
-          convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
+          // converted into a buffer kept for this RX SpectrumModel, each receiver gets a copy
+          Ptr<SpectrumValue> &convertedBuffer = m_convertedPsdMap[rxSpectrumModelUid];
+          if (convertedBuffer == 0)
+            {
+              convertedBuffer = Create<SpectrumValue> ();
+            }
+          rxConverterIterator->second.Convert (*txParams->psd, *convertedBuffer);
+          convertedTxPowerSpectrum = convertedBuffer;
         }
 
-
-      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
-           ++rxPhyIterator)
+      if (cull)
         {
-          NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
-                         "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
-
-          if ((*rxPhyIterator) != txParams->txPhy)
+          for (std::vector<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = nearbyIterator->second.begin ();
+               rxPhyIterator != nearbyIterator->second.end ();
+               ++rxPhyIterator)
+            {
+              StartTxToRx (txParams, txMobility, convertedTxPowerSpectrum, *rxPhyIterator);
+            }
+        }
+      else
+        {
+          for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
+               rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+               ++rxPhyIterator)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
-
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-
-              if (txMobility && receiverMobility)
-                {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
-                }
-
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
-                {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
-                }
-              else
-                {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
-                }
+              StartTxToRx (txParams, txMobility, convertedTxPowerSpectrum, *rxPhyIterator);
             }
         }
+    }
+
+}
+
+void
+MultiModelSpectrumChannel::StartTxToRx (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                                        Ptr<SpectrumValue> convertedTxPowerSpectrum, Ptr<SpectrumPhy> rxPhy)
+{
+  NS_ASSERT_MSG (rxPhy->GetRxSpectrumModel ()->GetUid () == convertedTxPowerSpectrum->GetSpectrumModelUid (),
+                 "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
+
+  if (rxPhy == txParams->txPhy)
+    {
+      return;
+    }
+
+  NS_LOG_LOGIC (" copying signal parameters " << txParams);
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+  if (convertedTxPowerSpectrum != txParams->psd)
+    {
+      // the copy of the parameters already holds a copy of the TX PSD
+      rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+    }
+  Time delay = MicroSeconds (0);
+
+  Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+
+  if (txMobility && receiverMobility)
+    {
+      double pathLossDb = GetPathLossDb (rxParams, txMobility, rxPhy, receiverMobility);
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
+      m_pathLossTrace (txParams->txPhy, rxPhy, pathLossDb);
+      if ( pathLossDb > m_maxLossDb)
+        {
+          // beyond range
+          return;
+        }
+      double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+      *(rxParams->psd) *= pathGainLinear;              
+
+      if (m_spectrumPropagationLoss)
+        {
+          rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+        }
+
+      if (m_propagationDelay)
+        {
+          delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+        }
+    }
+
+  Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode =  netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                      rxParams, rxPhy);
+    }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                           rxParams, rxPhy);
+    }
+}
+
+Ptr<SpectrumValue>
+MultiModelSpectrumChannel::GetRxPowerSpectralDensity (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumPhy> rxPhy)
+{
+  NS_LOG_FUNCTION (this << txParams << rxPhy);
+  NS_ASSERT (txParams->txPhy);
+  NS_ASSERT (txParams->psd);
+
+  Ptr<SpectrumValue> rxPsd;
+  SpectrumModelUid_t rxSpectrumModelUid = rxPhy->GetRxSpectrumModel ()->GetUid ();
+  if (txParams->psd->GetSpectrumModelUid () == rxSpectrumModelUid)
+    {
+      rxPsd = Copy<SpectrumValue> (txParams->psd);
+    }
+  else
+    {
+      TxSpectrumModelInfoMap_t::const_iterator txInfoIterator = FindAndEventuallyAddTxSpectrumModel (txParams->psd->GetSpectrumModel ());
+      SpectrumConverterMap_t::const_iterator rxConverterIterator = txInfoIterator->second.m_spectrumConverterMap.find (rxSpectrumModelUid);
+      NS_ASSERT_MSG (rxConverterIterator != txInfoIterator->second.m_spectrumConverterMap.end (),
+                     "the SpectrumModel of the receiver is unknown (i.e., AddRx should be called first)");
+      rxPsd = rxConverterIterator->second.Convert (txParams->psd);
+    }
+
+  Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+  if (txMobility && receiverMobility)
+    {
+      double pathLossDb = GetPathLossDb (txParams, txMobility, rxPhy, receiverMobility);
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+      if (pathLossDb > m_maxLossDb)
+        {
+          return 0;
+        }
+      *rxPsd *= std::pow (10.0, (-pathLossDb) / 10.0);
+      if (m_spectrumPropagationLoss)
+        {
+          rxPsd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxPsd, txMobility, receiverMobility);
+        }
+    }
+  return rxPsd;
+}
+
+double
+MultiModelSpectrumChannel::GetPathLossDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                                          Ptr<SpectrumPhy> rxPhy, Ptr<MobilityModel> receiverMobility)
+{
+  // the losses of moving phys change without course change
+  bool cache = m_cachePathLoss
+    && !MobilityGridIndex::IsMoving (txMobility) && !MobilityGridIndex::IsMoving (receiverMobility);
+  uint32_t txVersion = 0;
+  uint32_t rxVersion = 0;
+  std::pair<Ptr<SpectrumPhy>, Ptr<SpectrumPhy> > key (txParams->txPhy, rxPhy);
+  if (cache)
+    {
+      txVersion = TrackMobility (txMobility);
+      rxVersion = TrackMobility (receiverMobility);
+      PathLossCache_t::const_iterator it = m_pathLossCache.find (key);
+      // a SpectrumPhy may also have been given another mobility model,
+      // which is kept alive by m_mobilityVersions
+      if (it != m_pathLossCache.end ()
+          && it->second.txMobility == PeekPointer (txMobility)
+          && it->second.rxMobility == PeekPointer (receiverMobility)
+          && it->second.txVersion == txVersion
+          && it->second.rxVersion == rxVersion)
+        {
+          NS_LOG_LOGIC ("cached pathLoss = " << it->second.pathLossDb << " dB");
+          return it->second.pathLossDb;
+        }
+    }
+
+  double pathLossDb = 0;
+  if (txParams->txAntenna != 0)
+    {
+      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+      double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+      pathLossDb -= txAntennaGain;
+    }
+  Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+      pathLossDb -= rxAntennaGain;
+    }
+  if (m_propagationLoss)
+    {
+      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+      pathLossDb -= propagationGainDb;
+    }
+
+  if (cache)
+    {
+      PathLossEntry entry;
+      entry.pathLossDb = pathLossDb;
+      entry.txMobility = PeekPointer (txMobility);
+      entry.rxMobility = PeekPointer (receiverMobility);
+      entry.txVersion = txVersion;
+      entry.rxVersion = rxVersion;
+      m_pathLossCache[key] = entry;
+    }
+  return pathLossDb;
+}
+
+uint32_t
+MultiModelSpectrumChannel::TrackMobility (Ptr<MobilityModel> mobility)
+{
+  std::map<Ptr<MobilityModel>, uint32_t>::iterator it = m_mobilityVersions.find (mobility);
+  if (it == m_mobilityVersions.end ())
+    {
+      NS_LOG_LOGIC ("tracking the course changes of " << mobility);
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MultiModelSpectrumChannel::CourseChanged, this));
+      it = m_mobilityVersions.insert (std::make_pair (mobility, 0)).first;
+    }
+  return it->second;
+}
 
+void
+MultiModelSpectrumChannel::BuildIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  ClearIndex ();
+  m_index.Clear (m_maxRange);
+  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+       rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+       ++rxInfoIterator)
+    {
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator phyIt = rxInfoIterator->second.m_rxPhySet.begin ();
+           phyIt != rxInfoIterator->second.m_rxPhySet.end ();
+           ++phyIt)
+        {
+          m_index.Add (m_indexedPhys.size (), (*phyIt)->GetMobility ());
+          m_indexedPhys.push_back (*phyIt);
+          m_indexedRxSpectrumModelUids.push_back (rxInfoIterator->first);
+        }
     }
+  m_indexValid = true;
+}
 
+void
+MultiModelSpectrumChannel::ClearIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_index.Clear (0.0);
+  m_indexedPhys.clear ();
+  m_indexedRxSpectrumModelUids.clear ();
+  m_indexValid = false;
+}
+
+void
+MultiModelSpectrumChannel::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<Ptr<MobilityModel>, uint32_t>::iterator it = m_mobilityVersions.find (ConstCast<MobilityModel> (mobility));
+  NS_ASSERT (it != m_mobilityVersions.end ());
+  // the cached losses computed with the previous version are now ignored
+  ++it->second;
+}
+
+std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > >
+MultiModelSpectrumChannel::GetNearbyRx (Ptr<MobilityModel> txMobility) const
+{
+  std::vector<uint32_t> candidates = m_index.GetNearby (txMobility->GetPosition ());
+  std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > > nearbyRx;
+  for (std::vector<uint32_t>::const_iterator i = candidates.begin (); i != candidates.end (); ++i)
+    {
+      // receivers without a mobility model are always considered, as without MaxRange
+      Ptr<MobilityModel> receiverMobility = m_indexedPhys[*i]->GetMobility ();
+      if (receiverMobility && txMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+        {
+          continue;
+        }
+      nearbyRx[m_indexedRxSpectrumModelUids[*i]].push_back (m_indexedPhys[*i]);
+    }
+  // start the receptions in the same order as without MaxRange
+  for (std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > >::iterator it = nearbyRx.begin ();
+       it != nearbyRx.end ();
+       ++it)
+    {
+      std::sort (it->second.begin (), it->second.end ());
+    }
+  return nearbyRx;
 }
 
 void
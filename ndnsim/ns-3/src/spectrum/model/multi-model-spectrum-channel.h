@@ -27,11 +27,14 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/mobility-grid-index.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
+class MobilityModel;
 
 typedef std::map<SpectrumModelUid_t, SpectrumConverter> SpectrumConverterMap_t;
 
@@ -82,6 +85,20 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * Two attributes reduce the cost of a transmission when there are many
+ * receivers.  If MaxRange is set, the receivers farther than MaxRange from
+ * the transmitter are skipped: their positions are kept in a uniform grid
+ * of cubic cells of MaxRange side, updated when their mobility models
+ * report a course change, so only the receivers in the cells next to the
+ * transmitter, the moving receivers and the receivers without a mobility
+ * model are considered.  If CachePathLoss is true, the loss computed from
+ * the antenna gains and the PropagationLossModel is kept for each pair of
+ * SpectrumPhy, and computed again only after one of them reported a course
+ * change; the cache is not used for moving SpectrumPhy.  It should only be
+ * enabled if the loss does not change between two course changes, e.g.,
+ * without fast fading in the PropagationLossModel and without
+ * reconfiguration of the antennas.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -97,6 +114,7 @@ public:
   virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
   virtual void AddRx (Ptr<SpectrumPhy> phy);
   virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+  virtual Ptr<SpectrumValue> GetRxPowerSpectralDensity (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumPhy> rxPhy);
 
 
   // inherited from Channel
@@ -132,6 +150,78 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * apply the propagation models to a transmission and schedule its
+   * reception by a SpectrumPhy
+   *
+   * @param txParams the parameters of the transmission
+   * @param txMobility the mobility model of the transmitter
+   * @param convertedTxPowerSpectrum the TX PSD converted to the RX SpectrumModel
+   * @param rxPhy the receiver
+   */
+  void StartTxToRx (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                    Ptr<SpectrumValue> convertedTxPowerSpectrum, Ptr<SpectrumPhy> rxPhy);
+
+  /**
+   * compute the single-frequency loss between two SpectrumPhy, or take it
+   * from the cache
+   *
+   * @param txParams the parameters of the transmission
+   * @param txMobility the mobility model of the transmitter
+   * @param rxPhy the receiver
+   * @param receiverMobility the mobility model of the receiver
+   *
+   * @return the loss in dB due to the antennas and the PropagationLossModel
+   */
+  double GetPathLossDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                        Ptr<SpectrumPhy> rxPhy, Ptr<MobilityModel> receiverMobility);
+
+  /**
+   * Cached single-frequency loss between two SpectrumPhy.
+   */
+  struct PathLossEntry
+  {
+    double pathLossDb;   //!< loss in dB
+    const MobilityModel *txMobility; //!< TX mobility model the loss was computed with
+    const MobilityModel *rxMobility; //!< RX mobility model the loss was computed with
+    uint32_t txVersion;  //!< version of the TX mobility model the loss was computed with
+    uint32_t rxVersion;  //!< version of the RX mobility model the loss was computed with
+  };
+
+  typedef std::map<std::pair<Ptr<SpectrumPhy>, Ptr<SpectrumPhy> >, PathLossEntry> PathLossCache_t;
+
+  /**
+   * @param mobility a mobility model
+   * @return the number of course changes of the mobility model, after
+   * starting to listen to them if it is new
+   */
+  uint32_t TrackMobility (Ptr<MobilityModel> mobility);
+
+  /**
+   * put all the receivers in the spatial index
+   */
+  void BuildIndex (void);
+
+  /**
+   * empty the spatial index
+   */
+  void ClearIndex (void);
+
+  /**
+   * invalidate the cached losses of the SpectrumPhy instances using a
+   * mobility model
+   *
+   * @param mobility the mobility model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  /**
+   * @param txMobility the mobility model of the transmitter
+   * @return the receivers that may be within MaxRange of the transmitter,
+   * sorted, for each RX SpectrumModel
+   */
+  std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > > GetNearbyRx (Ptr<MobilityModel> txMobility) const;
+
 
 
   /**
@@ -173,6 +263,22 @@ private:
 
   double m_maxLossDb;
 
+  double m_maxRange;      //!< distance beyond which receivers are skipped, 0 to consider all of them
+  bool m_cachePathLoss;   //!< true if the single-frequency losses are cached
+
+  bool m_indexValid;      //!< true if the spatial index holds every receiver
+  MobilityGridIndex m_index; //!< spatial index of the receivers, by index in m_indexedPhys
+  std::vector<Ptr<SpectrumPhy> > m_indexedPhys; //!< the receivers in the spatial index
+  std::vector<SpectrumModelUid_t> m_indexedRxSpectrumModelUids; //!< the RX SpectrumModel of each receiver in the spatial index
+  std::map<Ptr<MobilityModel>, uint32_t> m_mobilityVersions; //!< the number of course changes of the tracked mobility models
+  PathLossCache_t m_pathLossCache; //!< the cached single-frequency losses
+
+  /**
+   * for each RX SpectrumModel, the buffer the TX PSD is converted into,
+   * reused by every transmission
+   */
+  std::map<SpectrumModelUid_t, Ptr<SpectrumValue> > m_convertedPsdMap;
+
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
 };
 
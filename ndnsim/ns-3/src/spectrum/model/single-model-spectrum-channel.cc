@@ -134,6 +134,33 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
+  // compute the propagation gains of all the receivers in a single pass
+  // over the loss models
+  m_rxMobility.clear ();
+  if (senderMobility)
+    {
+      for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
+           rxPhyIterator != m_phyList.end ();
+           ++rxPhyIterator)
+        {
+          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          if ((*rxPhyIterator) != txParams->txPhy && receiverMobility)
+            {
+              m_rxMobility.push_back (receiverMobility);
+            }
+        }
+    }
+  if (m_propagationLoss)
+    {
+      m_propagationLoss->CalcRxPowers (0, senderMobility, m_rxMobility, m_propagationGainDb);
+    }
+  else
+    {
+      m_propagationGainDb.assign (m_rxMobility.size (), 0);
+    }
+  m_rxMobility.clear ();
+
+  uint32_t k = 0;
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
        ++rxPhyIterator)
@@ -148,28 +175,8 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if (senderMobility && receiverMobility)
             {
-              double pathLossDb = 0;
-              if (rxParams->txAntenna != 0)
-                {
-                  Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-                  double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                  NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                  pathLossDb -= txAntennaGain;
-                }
-              Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-              if (rxAntenna != 0)
-                {
-                  Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-                  double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                  NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                  pathLossDb -= rxAntennaGain;
-                }
-              if (m_propagationLoss)
-                {
-                  double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
-                  NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                  pathLossDb -= propagationGainDb;
-                }                    
+              double pathLossDb = GetPathLossDb (rxParams, senderMobility, *rxPhyIterator, receiverMobility,
+                                                 m_propagationGainDb[k++]);
               NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
               m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
               if ( pathLossDb > m_maxLossDb)
@@ -210,6 +217,70 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 }
 
+double
+SingleModelSpectrumChannel::GetPathLossDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> senderMobility,
+                                           Ptr<SpectrumPhy> rxPhy, Ptr<MobilityModel> receiverMobility) const
+{
+  double propagationGainDb = 0;
+  if (m_propagationLoss)
+    {
+      propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
+    }
+  return GetPathLossDb (txParams, senderMobility, rxPhy, receiverMobility, propagationGainDb);
+}
+
+double
+SingleModelSpectrumChannel::GetPathLossDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> senderMobility,
+                                           Ptr<SpectrumPhy> rxPhy, Ptr<MobilityModel> receiverMobility,
+                                           double propagationGainDb) const
+{
+  double pathLossDb = 0;
+  if (txParams->txAntenna != 0)
+    {
+      Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+      double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+      pathLossDb -= txAntennaGain;
+    }
+  Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
+      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+      pathLossDb -= rxAntennaGain;
+    }
+  NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+  pathLossDb -= propagationGainDb;
+  return pathLossDb;
+}
+
+Ptr<SpectrumValue>
+SingleModelSpectrumChannel::GetRxPowerSpectralDensity (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumPhy> rxPhy)
+{
+  NS_LOG_FUNCTION (this << txParams << rxPhy);
+  NS_ASSERT (txParams->txPhy);
+  NS_ASSERT (*(txParams->psd->GetSpectrumModel ()) == *(rxPhy->GetRxSpectrumModel ()));
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txParams->psd);
+  Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
+  Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+  if (senderMobility && receiverMobility)
+    {
+      double pathLossDb = GetPathLossDb (txParams, senderMobility, rxPhy, receiverMobility);
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+      if (pathLossDb > m_maxLossDb)
+        {
+          return 0;
+        }
+      *rxPsd *= std::pow (10.0, (-pathLossDb) / 10.0);
+      if (m_spectrumPropagationLoss)
+        {
+          rxPsd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxPsd, senderMobility, receiverMobility);
+        }
+    }
+  return rxPsd;
+}
+
 void
 SingleModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
@@ -28,6 +28,8 @@
 
 namespace ns3 {
 
+class MobilityModel;
+
 
 
 /**
@@ -52,6 +54,7 @@ public:
   virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
   virtual void AddRx (Ptr<SpectrumPhy> phy);
   virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+  virtual Ptr<SpectrumValue> GetRxPowerSpectralDensity (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumPhy> rxPhy);
 
 
   // inherited from Channel
@@ -74,6 +77,34 @@ private:
    */
   void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Compute the loss from a transmitter to a receiver, antenna gains
+   * included
+   *
+   * @param txParams the parameters of the signal transmitted
+   * @param senderMobility the mobility of the transmitter
+   * @param rxPhy the receiver
+   * @param receiverMobility the mobility of the receiver
+   * @return the loss in dB
+   */
+  double GetPathLossDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> senderMobility,
+                        Ptr<SpectrumPhy> rxPhy, Ptr<MobilityModel> receiverMobility) const;
+
+  /**
+   * Compute the loss from a transmitter to a receiver, antenna gains
+   * included, from the gain of the propagation loss model
+   *
+   * @param txParams the parameters of the signal transmitted
+   * @param senderMobility the mobility of the transmitter
+   * @param rxPhy the receiver
+   * @param receiverMobility the mobility of the receiver
+   * @param propagationGainDb the gain of the propagation loss model
+   * @return the loss in dB
+   */
+  double GetPathLossDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> senderMobility,
+                        Ptr<SpectrumPhy> rxPhy, Ptr<MobilityModel> receiverMobility,
+                        double propagationGainDb) const;
+
   /**
    * list of SpectrumPhy instances attached to
    * the channel
@@ -110,6 +141,17 @@ private:
   double m_maxLossDb;
 
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
+
+  /**
+   * mobility models of the receivers of the current transmission
+   */
+  std::vector<Ptr<MobilityModel> > m_rxMobility;
+
+  /**
+   * gain of the propagation loss model for each receiver of the
+   * current transmission
+   */
+  std::vector<double> m_propagationGainDb;
 };
 
 
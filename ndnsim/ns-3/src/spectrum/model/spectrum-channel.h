@@ -95,6 +95,19 @@ public:
    */
   virtual void AddRx (Ptr<SpectrumPhy> phy) = 0;
 
+  /**
+   * Compute the PSD with which a SpectrumPhy would receive a signal, as
+   * StartTx does, but without scheduling the reception. This allows to
+   * evaluate the signal at many positions without running the simulator.
+   *
+   * @param txParams the parameters of the signal transmitted
+   * @param rxPhy the receiving SpectrumPhy; it must have been added to the
+   * channel with AddRx
+   *
+   * @return the PSD received, or 0 if the signal does not reach rxPhy
+   */
+  virtual Ptr<SpectrumValue> GetRxPowerSpectralDensity (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumPhy> rxPhy) = 0;
+
   /**
    * TracedCallback signature for path loss calculation events.
    *
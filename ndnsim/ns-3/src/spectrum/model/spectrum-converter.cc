@@ -42,18 +42,31 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
   for (Bands::const_iterator toit = toSpectrumModel->Begin (); toit != toSpectrumModel->End (); ++toit)
     {
       std::vector<double> coeffs;
+      size_t start = 0;
+      size_t end = 0;
+      size_t i = 0;
 
-      for (Bands::const_iterator fromit = fromSpectrumModel->Begin (); fromit != fromSpectrumModel->End (); ++fromit)
+      for (Bands::const_iterator fromit = fromSpectrumModel->Begin (); fromit != fromSpectrumModel->End (); ++fromit, ++i)
         {
           double c = GetCoefficient (*fromit, *toit);
           NS_LOG_LOGIC ("(" << fromit->fl << ","  << fromit->fh << ")"
                             << " --> " <<
                         "(" << toit->fl << "," << toit->fh << ")"
                             << " = " << c);
+          if (c != 0)
+            {
+              if (end == 0)
+                {
+                  start = i;
+                }
+              end = i + 1;
+            }
           coeffs.push_back (c);
         }
 
-      m_conversionMatrix.push_back (coeffs);
+      // keep only the range of non-zero coefficients
+      m_conversionStart.push_back (start);
+      m_conversionMatrix.push_back (std::vector<double> (coeffs.begin () + start, coeffs.begin () + std::max (start, end)));
     }
 
 }
@@ -73,34 +86,40 @@ double SpectrumConverter::GetCoefficient (const BandInfo& from, const BandInfo&
 Ptr<SpectrumValue>
 SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
 {
-  NS_ASSERT ( *(fvvf->GetSpectrumModel ()) == *m_fromSpectrumModel);
-
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
+  Convert (*fvvf, *tvvf);
+  return tvvf;
+}
+
+
+void
+SpectrumConverter::Convert (const SpectrumValue& fvvf, SpectrumValue& tvvf) const
+{
+  NS_ASSERT ( *(fvvf.GetSpectrumModel ()) == *m_fromSpectrumModel);
 
-  Values::iterator tvit = tvvf->ValuesBegin ();
+  if (tvvf.GetSpectrumModel () != m_toSpectrumModel)
+    {
+      tvvf = SpectrumValue (m_toSpectrumModel);
+    }
 
+  Values::iterator tvit = tvvf.ValuesBegin ();
+  const double *fv = &(*fvvf.ConstValuesBegin ());
 
-  for (std::vector<std::vector<double> >::const_iterator toit = m_conversionMatrix.begin ();
-       toit != m_conversionMatrix.end ();
-       ++toit)
+  for (size_t row = 0; row < m_conversionMatrix.size (); ++row)
     {
-      NS_ASSERT (tvit != tvvf->ValuesEnd ());
-      Values::const_iterator fvit = fvvf->ConstValuesBegin ();
+      NS_ASSERT (tvit != tvvf.ValuesEnd ());
+      const std::vector<double> &coeffs = m_conversionMatrix[row];
+      const double *v = fv + m_conversionStart[row];
+      NS_ASSERT (m_conversionStart[row] + coeffs.size () <= (size_t)(fvvf.ConstValuesEnd () - fvvf.ConstValuesBegin ()));
 
       double sum = 0;
-      for (std::vector<double>::const_iterator fromit = toit->begin ();
-           fromit != toit->end ();
-           ++fromit)
+      for (size_t i = 0; i < coeffs.size (); ++i)
         {
-          NS_ASSERT (fvit != fvvf->ConstValuesEnd ());
-          sum += (*fvit) * (*fromit);
-          ++fvit;
+          sum += v[i] * coeffs[i];
         }
       *tvit = sum;
       ++tvit;
     }
-
-  return tvvf;
 }
 
 
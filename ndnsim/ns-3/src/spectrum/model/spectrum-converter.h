@@ -65,6 +65,16 @@ public:
    */
   Ptr<SpectrumValue> Convert (Ptr<const SpectrumValue> vvf) const;
 
+  /**
+   * Convert a particular ValueVsFreq instance into an existing one,
+   * reusing its storage
+   *
+   * @param vvf the ValueVsFreq instance to be converted
+   * @param result the ValueVsFreq instance receiving the converted
+   * values; it is reset to the SpectrumModel this converter converts to
+   */
+  void Convert (const SpectrumValue& vvf, SpectrumValue& result) const;
+
 
 private:
   /**
@@ -78,7 +88,14 @@ private:
    */
   double GetCoefficient (const BandInfo& from, const BandInfo& to) const;
 
-  std::vector<std::vector<double> > m_conversionMatrix; // /< matrix of conversion coefficients
+  /**
+   * The conversion matrix is sparse: the bands of a SpectrumModel are
+   * sorted, so the "from" bands overlapping a "to" band are contiguous.
+   * For each "to" band, only the coefficients from the first to the last
+   * overlapping "from" band are stored.
+   */
+  std::vector<std::vector<double> > m_conversionMatrix; // /< non-zero range of each row of the matrix of conversion coefficients
+  std::vector<size_t> m_conversionStart; // /< index of the "from" band of the first coefficient of each row
   Ptr<const SpectrumModel> m_fromSpectrumModel;  // /<  the SpectrumModel this SpectrumConverter instance can convert from
   Ptr<const SpectrumModel> m_toSpectrumModel;    // /<  the SpectrumModel this SpectrumConverter instance can convert to
 
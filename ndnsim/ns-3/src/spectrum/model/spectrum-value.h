@@ -53,6 +53,12 @@ typedef std::vector<double> Values;
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
  * propagation losses, spectral masks, etc.
+ *
+ * Each binary operator returns a new SpectrumValue.  In code that runs
+ * for every signal or every chunk, prefer the compound assignment
+ * operators and AddScaled on a SpectrumValue that is kept between calls:
+ * they work in place, without allocation, and their loops are simple
+ * enough for the compiler to vectorize them.
  */
 class SpectrumValue : public SimpleRefCount<SpectrumValue>
 {
@@ -408,6 +414,17 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Add to *this the product of a SpectrumValue and a scalar, in a
+   * single pass and without temporary, i.e., *this += x * s.
+   *
+   * @param x the SpectrumValue to scale
+   * @param s the scale factor
+   *
+   * @return a reference to *this
+   */
+  SpectrumValue& AddScaled (const SpectrumValue& x, double s);
+
 
 
   /**
@@ -0,0 +1,368 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <ns3/core-module.h>
+#include <ns3/test.h>
+#include <ns3/spectrum-module.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <cmath>
+#include <sstream>
+
+
+NS_LOG_COMPONENT_DEFINE ("MultiModelSpectrumChannelTest");
+
+using namespace ns3;
+
+
+/**
+ * A SpectrumPhy that counts the signals it receives and sums their power.
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+public:
+  CountingSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel);
+
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice () const;
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  uint32_t m_received;
+  double m_power;
+
+private:
+  Ptr<MobilityModel> m_mobility;
+  Ptr<const SpectrumModel> m_rxSpectrumModel;
+};
+
+CountingSpectrumPhy::CountingSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel)
+  : m_received (0),
+    m_power (0),
+    m_rxSpectrumModel (rxSpectrumModel)
+{
+}
+
+void
+CountingSpectrumPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+CountingSpectrumPhy::GetDevice () const
+{
+  return 0;
+}
+
+void
+CountingSpectrumPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+CountingSpectrumPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+CountingSpectrumPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+CountingSpectrumPhy::GetRxSpectrumModel () const
+{
+  return m_rxSpectrumModel;
+}
+
+Ptr<AntennaModel>
+CountingSpectrumPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+CountingSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_received++;
+  m_power += Sum (*params->psd);
+}
+
+
+/**
+ * A log distance loss model that counts its invocations.
+ */
+class CountingPropagationLossModel : public PropagationLossModel
+{
+public:
+  CountingPropagationLossModel ();
+
+  uint32_t m_calls;
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+};
+
+CountingPropagationLossModel::CountingPropagationLossModel ()
+  : m_calls (0)
+{
+}
+
+double
+CountingPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                             Ptr<MobilityModel> a,
+                                             Ptr<MobilityModel> b) const
+{
+  const_cast<CountingPropagationLossModel *> (this)->m_calls++;
+  return txPowerDbm - 40 - 30 * std::log10 (a->GetDistanceFrom (b));
+}
+
+int64_t
+CountingPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+
+/**
+ * A transmitter at the origin sends a signal at 1 s, 2 s and 5 s to five
+ * receivers: one 50 m away; one 350 m away and moved 60 m away at 3 s;
+ * one moving at 200 m/s toward the transmitter, 840 m away at 1 s and 40 m
+ * away at 5 s; one without mobility model; and one using another
+ * SpectrumModel 80 m away.  Check that MaxRange skips the receivers out of
+ * range, and that CachePathLoss only computes the loss again after a
+ * course change or for moving receivers, without changing the received
+ * power.
+ */
+class MultiModelSpectrumChannelTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelTestCase (double maxRange, bool cachePathLoss);
+
+private:
+  virtual void DoRun (void);
+  static std::string Name (double maxRange, bool cachePathLoss);
+  void StartTx (Ptr<SpectrumChannel> channel, Ptr<SpectrumSignalParameters> params);
+
+  double m_maxRange;
+  bool m_cachePathLoss;
+};
+
+std::string
+MultiModelSpectrumChannelTestCase::Name (double maxRange, bool cachePathLoss)
+{
+  std::ostringstream oss;
+  oss << "Check MultiModelSpectrumChannel with MaxRange " << maxRange
+      << (cachePathLoss ? " and" : " and no") << " path loss cache";
+  return oss.str ();
+}
+
+MultiModelSpectrumChannelTestCase::MultiModelSpectrumChannelTestCase (double maxRange, bool cachePathLoss)
+  : TestCase (Name (maxRange, cachePathLoss)),
+    m_maxRange (maxRange),
+    m_cachePathLoss (cachePathLoss)
+{
+}
+
+void
+MultiModelSpectrumChannelTestCase::StartTx (Ptr<SpectrumChannel> channel, Ptr<SpectrumSignalParameters> params)
+{
+  channel->StartTx (params);
+}
+
+void
+MultiModelSpectrumChannelTestCase::DoRun (void)
+{
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("MaxRange", DoubleValue (m_maxRange));
+  channel->SetAttribute ("CachePathLoss", BooleanValue (m_cachePathLoss));
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  channel->AddPropagationLossModel (loss);
+
+  std::vector<double> freqs1;
+  std::vector<double> freqs2;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      freqs1.push_back (2.4e9 + i * 1e6);
+      freqs2.push_back (2.4e9 + i * 2e6);
+    }
+  Ptr<SpectrumModel> model1 = Create<SpectrumModel> (freqs1);
+  Ptr<SpectrumModel> model2 = Create<SpectrumModel> (freqs2);
+
+  Ptr<CountingSpectrumPhy> tx = CreateObject<CountingSpectrumPhy> (model1);
+  Ptr<ConstantPositionMobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  tx->SetMobility (txMobility);
+
+  Ptr<CountingSpectrumPhy> rx[5];
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      rx[i] = CreateObject<CountingSpectrumPhy> (i == 4 ? model2 : model1);
+    }
+  Ptr<ConstantPositionMobilityModel> nearMobility = CreateObject<ConstantPositionMobilityModel> ();
+  nearMobility->SetPosition (Vector (50, 0, 0));
+  rx[0]->SetMobility (nearMobility);
+  Ptr<ConstantPositionMobilityModel> farMobility = CreateObject<ConstantPositionMobilityModel> ();
+  farMobility->SetPosition (Vector (0, 350, 0));
+  rx[1]->SetMobility (farMobility);
+  Ptr<ConstantVelocityMobilityModel> movingMobility = CreateObject<ConstantVelocityMobilityModel> ();
+  movingMobility->SetPosition (Vector (1040, 0, 0));
+  movingMobility->SetVelocity (Vector (-200, 0, 0));
+  rx[2]->SetMobility (movingMobility);
+  Ptr<ConstantPositionMobilityModel> otherModelMobility = CreateObject<ConstantPositionMobilityModel> ();
+  otherModelMobility->SetPosition (Vector (0, 0, 80));
+  rx[4]->SetMobility (otherModelMobility);
+
+  channel->AddRx (tx);
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      channel->AddRx (rx[i]);
+    }
+
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->txPhy = tx;
+  params->duration = MilliSeconds (1);
+  params->psd = Create<SpectrumValue> (model1);
+  *params->psd = 1e-3;
+
+  Simulator::Schedule (Seconds (1), &MultiModelSpectrumChannelTestCase::StartTx, this, channel, params);
+  Simulator::Schedule (Seconds (2), &MultiModelSpectrumChannelTestCase::StartTx, this, channel, params);
+  Simulator::Schedule (Seconds (3), &ConstantPositionMobilityModel::SetPosition, farMobility, Vector (0, 60, 0));
+  Simulator::Schedule (Seconds (5), &MultiModelSpectrumChannelTestCase::StartTx, this, channel, params);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (tx->m_received, 0, "Signal received by the transmitter");
+  NS_TEST_EXPECT_MSG_EQ (rx[0]->m_received, 3, "Signals not received by the near receiver");
+  NS_TEST_EXPECT_MSG_EQ (rx[3]->m_received, 3, "Signals not received by the receiver without mobility model");
+  NS_TEST_EXPECT_MSG_EQ (rx[4]->m_received, 3, "Signals not received by the receiver with another model");
+  if (m_maxRange > 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rx[1]->m_received, 1, "Signals not received by the moved receiver once in range only");
+      NS_TEST_EXPECT_MSG_EQ (rx[2]->m_received, 1, "Signals not received by the moving receiver once in range only");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (rx[1]->m_received, 3, "Signals not received by the far receiver");
+      NS_TEST_EXPECT_MSG_EQ (rx[2]->m_received, 3, "Signals not received by the moving receiver");
+    }
+
+  // the received power does not depend on the attributes
+  double nearPower = 3 * Sum (*params->psd) * std::pow (10.0, loss->CalcRxPower (0, txMobility, nearMobility) / 10.0);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rx[0]->m_power, nearPower, nearPower * 1e-9, "Wrong power received by the near receiver");
+
+  // the losses computed at 1 s, 2 s and 5 s for the receivers with a
+  // mobility model, plus the one computed above
+  uint32_t calls;
+  if (m_maxRange > 0)
+    {
+      // near and other model, then the same, then all four; with the
+      // cache, only the moving one at 5 s and the moved one, not in
+      // range before
+      calls = m_cachePathLoss ? 2 + 0 + 2 : 2 + 2 + 4;
+    }
+  else
+    {
+      // all four each time; with the cache, only the moving one at 2 s,
+      // and the moving and moved ones at 5 s
+      calls = m_cachePathLoss ? 4 + 1 + 2 : 4 + 4 + 4;
+    }
+  calls += 1;
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, calls, "Wrong number of path loss computations");
+}
+
+
+/**
+ * Check that the path loss cache is not used after a SpectrumPhy is given
+ * another mobility model.
+ */
+class MultiModelSpectrumChannelMobilityChangeTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelMobilityChangeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MultiModelSpectrumChannelMobilityChangeTestCase::MultiModelSpectrumChannelMobilityChangeTestCase ()
+  : TestCase ("Check the MultiModelSpectrumChannel path loss cache after a mobility model change")
+{
+}
+
+void
+MultiModelSpectrumChannelMobilityChangeTestCase::DoRun (void)
+{
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("CachePathLoss", BooleanValue (true));
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  channel->AddPropagationLossModel (loss);
+
+  std::vector<double> freqs;
+  freqs.push_back (2.4e9);
+  freqs.push_back (2.5e9);
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+  Ptr<CountingSpectrumPhy> tx = CreateObject<CountingSpectrumPhy> (model);
+  tx->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  Ptr<CountingSpectrumPhy> rx = CreateObject<CountingSpectrumPhy> (model);
+  channel->AddRx (rx);
+
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->txPhy = tx;
+  params->duration = MilliSeconds (1);
+  params->psd = Create<SpectrumValue> (model);
+  *params->psd = 1;
+
+  for (double distance = 10; distance < 40; distance += 10)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (distance, 0, 0));
+      rx->SetMobility (mobility);
+      Ptr<SpectrumValue> rxPsd = channel->GetRxPowerSpectralDensity (params, rx);
+      double expected = std::pow (10.0, (-40 - 30 * std::log10 (distance)) / 10.0);
+      NS_TEST_EXPECT_MSG_EQ_TOL ((*rxPsd)[0], expected, expected * 1e-9, "Wrong power at " << distance << " m");
+    }
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, 3, "Wrong number of path loss computations");
+  channel->Dispose ();
+  Simulator::Destroy ();
+}
+
+
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelTestSuite ();
+};
+
+MultiModelSpectrumChannelTestSuite::MultiModelSpectrumChannelTestSuite ()
+  : TestSuite ("multi-model-spectrum-channel", UNIT)
+{
+  AddTestCase (new MultiModelSpectrumChannelTestCase (0, false), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelTestCase (100, false), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelTestCase (0, true), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelTestCase (100, true), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelMobilityChangeTestCase (), TestCase::QUICK);
+}
+
+static MultiModelSpectrumChannelTestSuite g_multiModelSpectrumChannelTestSuite;
@@ -203,6 +203,13 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv5, v5, "tv5 *= v2"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv6, v6, "tv6 div= v2"), TestCase::QUICK);
 
+  tv3 = v1;
+  tv4 = v1;
+  tv3.AddScaled (v2, 1.0);
+  tv4.AddScaled (v2, -1.0);
+  AddTestCase (new SpectrumValueTestCase (tv3, v3, "tv3 AddScaled v2 1"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv4, v4, "tv4 AddScaled v2 -1"), TestCase::QUICK);
+
   SpectrumValue tv7a (f), tv8a (f), tv9a (f), tv10a (f);
   tv7a = v1 + doubleValue;
   tv8a = v1 - doubleValue;
@@ -328,6 +335,13 @@ SpectrumConverterTestSuite::SpectrumConverterTestSuite ()
 //   NS_LOG_LOGIC(*res);
   AddTestCase (new SpectrumValueTestCase (t21b, *res, ""), TestCase::QUICK);
 
+  // converting into an existing value, defined over another model
+  SpectrumValue inPlace (sof2);
+  inPlace = 7;
+  c21.Convert (*v2b, inPlace);
+  AddTestCase (new SpectrumValueTestCase (t21b, inPlace, ""), TestCase::QUICK);
+  c12.Convert (*v1, inPlace);
+  AddTestCase (new SpectrumValueTestCase (t12, inPlace, ""), TestCase::QUICK);
 
 }
 
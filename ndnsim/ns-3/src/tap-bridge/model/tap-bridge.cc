@@ -143,6 +143,7 @@ TapBridge::TapBridge ()
     m_startEvent (),
     m_stopEvent (),
     m_fdReader (0),
+    m_forwardScheduled (false),
     m_ns3AddressRewritten (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -231,7 +232,8 @@ TapBridge::StartTapDevice (void)
   NS_LOG_LOGIC ("Spinning up read thread");
 
   m_fdReader = Create<TapBridgeFdReader> ();
-  m_fdReader->Start (m_sock, MakeCallback (&TapBridge::ReadCallback, this));
+  m_fdReader->Start (m_sock, MakeCallback (&TapBridge::ReadCallback, this),
+                     MakeCallback (&TapBridge::ReadBatchEndCallback, this));
 }
 
 void
@@ -245,6 +247,15 @@ TapBridge::StopTapDevice (void)
       m_fdReader = 0;
     }
 
+  {
+    CriticalSection cs (m_pendingMutex);
+    while (!m_pendingFrames.empty ())
+      {
+        std::free (m_pendingFrames.front ().first);
+        m_pendingFrames.pop ();
+      }
+  }
+
   if (m_sock != -1)
     {
       close (m_sock);
@@ -679,12 +690,55 @@ TapBridge::ReadCallback (uint8_t *buf, ssize_t len)
   // are talking about two threads here, so it is very, very dangerous to do
   // any kind of reference counting on a shared object.  Just don't do it.
   // So what we're going to do is pass the buffer allocated on the heap
-  // into the ns-3 context thread where it will create the packet.
+  // into the ns-3 context thread where it will create the packet.  The
+  // buffers read together are passed with a single event, scheduled by
+  // ReadBatchEndCallback.
   //
 
   NS_LOG_INFO ("TapBridge::ReadCallback(): Received packet on node " << m_nodeId);
-  NS_LOG_INFO ("TapBridge::ReadCallback(): Scheduling handler");
-  Simulator::ScheduleWithContext (m_nodeId, Seconds (0.0), MakeEvent (&TapBridge::ForwardToBridgedDevice, this, buf, len));
+  CriticalSection cs (m_pendingMutex);
+  m_pendingFrames.push (std::make_pair (buf, len));
+}
+
+void
+TapBridge::ReadBatchEndCallback (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  bool schedule = false;
+
+  {
+    CriticalSection cs (m_pendingMutex);
+    if (!m_pendingFrames.empty () && !m_forwardScheduled)
+      {
+        m_forwardScheduled = true;
+        schedule = true;
+      }
+  }
+
+  if (schedule)
+    {
+      NS_LOG_INFO ("TapBridge::ReadBatchEndCallback(): Scheduling handler");
+      Simulator::ScheduleWithContext (m_nodeId, Seconds (0.0), MakeEvent (&TapBridge::ForwardPending, this));
+    }
+}
+
+void
+TapBridge::ForwardPending (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  std::queue<std::pair<uint8_t *, ssize_t> > frames;
+  {
+    CriticalSection cs (m_pendingMutex);
+    frames.swap (m_pendingFrames);
+    m_forwardScheduled = false;
+  }
+
+  while (!frames.empty ())
+    {
+      ForwardToBridgedDevice (frames.front ().first, frames.front ().second);
+      frames.pop ();
+    }
 }
 
 void
@@ -32,6 +32,9 @@
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
 #include "ns3/unix-fd-reader.h"
+#include "ns3/system-mutex.h"
+#include <queue>
+#include <utility>
 
 namespace ns3 {
 
@@ -274,6 +277,18 @@ private:
    */
   void ReadCallback (uint8_t *buf, ssize_t len);
 
+  /**
+   * Callback invoked after each batch of reads, to schedule the
+   * forwarding of the packets read
+   */
+  void ReadBatchEndCallback (void);
+
+  /**
+   * Forward the packets read and not forwarded yet to the bridged ns-3
+   * device
+   */
+  void ForwardPending (void);
+
   /**
    * Forward a packet received from the tap device to the bridged ns-3 
    * device
@@ -368,6 +383,22 @@ private:
    */
   Ptr<TapBridgeFdReader> m_fdReader;
 
+  /**
+   * Packets read and not forwarded yet (protected by m_pendingMutex).
+   */
+  std::queue<std::pair<uint8_t *, ssize_t> > m_pendingFrames;
+
+  /**
+   * Whether an event forwarding m_pendingFrames is scheduled (protected
+   * by m_pendingMutex).
+   */
+  bool m_forwardScheduled;
+
+  /**
+   * Protects the packets passed from the read thread.
+   */
+  SystemMutex m_pendingMutex;
+
   /**
    * The operating mode of the bridge.  Tells basically who creates and
    * configures the underlying network tap.
@@ -24,12 +24,72 @@
 #include "ns3/inet-topology-reader.h"
 #include "ns3/orbis-topology-reader.h"
 #include "ns3/rocketfuel-topology-reader.h"
+#include "ns3/binary-topology-reader.h"
+#include "ns3/core-config.h"
 #include "ns3/log.h"
 
+#ifdef HAVE_SYS_STAT_H
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TopologyReaderHelper");
 
+/**
+ * \brief Identifies a topology file
+ * \param fileName the topology file
+ * \param fileType the type of the topology file
+ * \param [out] source the topology file, as recorded in the snapshots
+ * \returns true if the topology file exists
+ */
+static bool
+GetSource (const std::string &fileName, const std::string &fileType,
+           BinaryTopologyReader::Source &source)
+{
+#ifdef HAVE_SYS_STAT_H
+  struct stat input;
+  if (stat (fileName.c_str (), &input) != 0)
+    {
+      return false;
+    }
+  source.fileName = fileName;
+  source.fileType = fileType;
+  source.size = input.st_size;
+#ifdef __APPLE__
+  source.mtime = input.st_mtimespec.tv_sec * UINT64_C (1000000000) + input.st_mtimespec.tv_nsec;
+#else
+  source.mtime = input.st_mtim.tv_sec * UINT64_C (1000000000) + input.st_mtim.tv_nsec;
+#endif
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * \brief Checks whether a cache file can be used in place of a topology file
+ * \param cacheFileName the cache file
+ * \param fileName the topology file
+ * \param fileType the type of the topology file
+ * \returns true if the cache file was built from the topology file as it is now
+ */
+static bool
+IsCacheUpToDate (const std::string &cacheFileName, const std::string &fileName,
+                 const std::string &fileType)
+{
+  BinaryTopologyReader::Source input;
+  BinaryTopologyReader::Source cached;
+  if (!GetSource (fileName, fileType, input)
+      || !BinaryTopologyReader::ReadSource (cacheFileName, cached))
+    {
+      return false;
+    }
+  return cached.fileName == input.fileName && cached.fileType == input.fileType
+         && cached.size == input.size && cached.mtime == input.mtime;
+}
+
 TopologyReaderHelper::TopologyReaderHelper ()
 {
   m_inputModel = 0;
@@ -55,6 +115,14 @@ TopologyReaderHelper::GetTopologyReader ()
       NS_ASSERT_MSG (!m_fileType.empty (), "Missing File Type");
       NS_ASSERT_MSG (!m_fileName.empty (), "Missing File Name");
 
+      if (IsCached ())
+        {
+          NS_LOG_INFO ("Creating binary data input from cache " << m_cacheFileName);
+          m_inputModel = Create<BinaryTopologyReader> ();
+          m_inputModel->SetFileName (m_cacheFileName);
+          return m_inputModel;
+        }
+
       if (m_fileType == "Orbis")
         {
           NS_LOG_INFO ("Creating Orbis formatted data input.");
@@ -70,6 +138,11 @@ TopologyReaderHelper::GetTopologyReader ()
           NS_LOG_INFO ("Creating Rocketfuel formatted data input.");
           m_inputModel = Create<RocketfuelTopologyReader> ();
         }
+      else if (m_fileType == "Binary")
+        {
+          NS_LOG_INFO ("Creating binary data input.");
+          m_inputModel = Create<BinaryTopologyReader> ();
+        }
       else
         {
           NS_ASSERT_MSG (false, "Wrong (unknown) File Type");
@@ -80,6 +153,42 @@ TopologyReaderHelper::GetTopologyReader ()
   return m_inputModel;
 }
 
+void
+TopologyReaderHelper::SetCacheFileName (const std::string cacheFileName)
+{
+  m_cacheFileName = cacheFileName;
+}
+
+bool
+TopologyReaderHelper::IsCached (void)
+{
+  if (m_cacheFileName.empty ())
+    {
+      return false;
+    }
+  if (m_inputModel)
+    {
+      return m_inputModel->GetFileName () == m_cacheFileName;
+    }
+  return IsCacheUpToDate (m_cacheFileName, m_fileName, m_fileType);
+}
+
+bool
+TopologyReaderHelper::WriteCache (const NodeContainer &nodes)
+{
+  NS_ASSERT_MSG (!m_cacheFileName.empty (), "Missing Cache File Name");
+  if (IsCached ())
+    {
+      return false;
+    }
+  BinaryTopologyReader::Source source;
+  if (!GetSource (m_fileName, m_fileType, source))
+    {
+      NS_LOG_WARN ("Couldn't stat the file " << m_fileName << ", the cache would never be used");
+      return false;
+    }
+  return BinaryTopologyReader::Write (m_cacheFileName, GetTopologyReader (), nodes, source);
+}
 
 
 } // namespace ns3
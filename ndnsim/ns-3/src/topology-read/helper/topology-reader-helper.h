@@ -44,7 +44,8 @@ public:
   void SetFileName (const std::string fileName);
 
   /**
-   * \brief Sets the input file type. Supported file types are "Orbis", "Inet", "Rocketfuel".
+   * \brief Sets the input file type. Supported file types are "Orbis", "Inet", "Rocketfuel",
+   * and "Binary" for snapshots written by BinaryTopologyReader::Write.
    * \param [in] fileType The input file type.
    */
   void SetFileType (const std::string fileType);
@@ -55,10 +56,41 @@ public:
    */
   Ptr<TopologyReader> GetTopologyReader ();
 
+  /**
+   * \brief Sets the name of a binary snapshot caching the input file.
+   *
+   * If the snapshot exists and was built from the input file as it is
+   * now (same name, type, size and modification time), GetTopologyReader
+   * returns a BinaryTopologyReader reading it instead of a reader parsing
+   * the input file. Otherwise, the snapshot can be written with WriteCache
+   * once the topology has been read.
+   *
+   * \param [in] cacheFileName The snapshot file name.
+   */
+  void SetCacheFileName (const std::string cacheFileName);
+
+  /**
+   * \brief Checks whether the topology is read from the cache.
+   * \return True if GetTopologyReader returns (or will return) a reader of the cache file.
+   */
+  bool IsCached (void);
+
+  /**
+   * \brief Writes the cache file, unless the topology was read from it.
+   *
+   * Call this after reading the topology and, possibly, storing in
+   * the links further attributes to cache (e.g. their addresses).
+   *
+   * \param [in] nodes The container of nodes returned by the reader.
+   * \return True if the cache file was written.
+   */
+  bool WriteCache (const NodeContainer &nodes);
+
 private:
   Ptr<TopologyReader> m_inputModel;  //!< Smart pointer to the actual topology model.
   std::string m_fileName;  //!< Name of the input file.
   std::string m_fileType;  //!< Type of the input file (e.g., "Inet", "Orbis", etc.).
+  std::string m_cacheFileName;  //!< Name of the binary snapshot caching the input file.
 };
 
 } // namespace ns3
@@ -0,0 +1,380 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "binary-topology-reader.h"
+#include "topology-tokenizer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTopologyReader");
+
+/*
+ * Snapshot layout, all integers are uint32_t in host byte order, except
+ * the size and the modification time of the source file in the header:
+ *
+ *   header
+ *   node table        header.nodes entries: name
+ *   link table        header.links entries: from, to, first attribute, number of attributes
+ *   attribute table   header.attributes entries: name, value
+ *   string table      header.stringBytes bytes of NUL-terminated strings
+ *
+ * Names and values, and the name and type of the source file, are offsets
+ * in the string table; from and to are indexes in the node table.
+ */
+
+/// Magic number of the snapshots ("N3TO" read as a big-endian integer)
+static const uint32_t BINARY_TOPOLOGY_MAGIC = 0x4e33544f;
+/// Version of the snapshot layout
+static const uint32_t BINARY_TOPOLOGY_VERSION = 2;
+
+/**
+ * \brief Header of a topology snapshot
+ */
+struct BinaryTopologyHeader
+{
+  uint32_t magic;       //!< BINARY_TOPOLOGY_MAGIC
+  uint32_t version;     //!< BINARY_TOPOLOGY_VERSION
+  uint32_t nodes;       //!< number of nodes
+  uint32_t links;       //!< number of links
+  uint32_t attributes;  //!< number of link attributes
+  uint32_t stringBytes; //!< size of the string table
+  uint32_t sourceName;  //!< offset of the name of the source topology file
+  uint32_t sourceType;  //!< offset of the type of the source topology file
+  uint64_t sourceSize;  //!< size of the source topology file
+  uint64_t sourceMtime; //!< modification time of the source topology file, in nanoseconds
+};
+
+/**
+ * \brief Link table entry of a topology snapshot
+ */
+struct BinaryTopologyLink
+{
+  uint32_t from;           //!< index of the "from" node
+  uint32_t to;             //!< index of the "to" node
+  uint32_t firstAttribute; //!< index of the first attribute of the link
+  uint32_t nAttributes;    //!< number of attributes of the link
+};
+
+/**
+ * \brief Attribute table entry of a topology snapshot
+ */
+struct BinaryTopologyAttribute
+{
+  uint32_t name;  //!< offset of the attribute name
+  uint32_t value; //!< offset of the attribute value
+};
+
+/**
+ * \brief String table of a snapshot being written
+ */
+class BinaryTopologyStrings
+{
+public:
+  /**
+   * \param s a string
+   * \returns the offset of s in the table, adding it if needed
+   */
+  uint32_t Intern (const std::string &s)
+  {
+    std::unordered_map<std::string, uint32_t>::const_iterator i = m_offsets.find (s);
+    if (i != m_offsets.end ())
+      {
+        return i->second;
+      }
+    uint32_t offset = m_data.size ();
+    m_data.insert (m_data.end (), s.begin (), s.end ());
+    m_data.push_back ('\0');
+    m_offsets[s] = offset;
+    return offset;
+  }
+  /// \returns the contents of the table
+  const std::vector<char> &GetData (void) const
+  {
+    return m_data;
+  }
+private:
+  std::unordered_map<std::string, uint32_t> m_offsets; //!< offset of each string
+  std::vector<char> m_data;                            //!< table contents
+};
+
+/**
+ * \brief Check the header and the size of a mapped snapshot
+ * \param data the snapshot
+ * \param size the size of the snapshot
+ * \param fileName the snapshot file name
+ * \param [out] header the header of the snapshot
+ * \returns the string table of the snapshot, or 0 if it is not a valid snapshot
+ */
+static const char *
+CheckSnapshot (const char *data, std::size_t size, const std::string &fileName,
+               BinaryTopologyHeader &header)
+{
+  if (size < sizeof (header))
+    {
+      NS_LOG_WARN ("Truncated binary topology file " << fileName);
+      return 0;
+    }
+  std::memcpy (&header, data, sizeof (header));
+  if (header.magic != BINARY_TOPOLOGY_MAGIC || header.version != BINARY_TOPOLOGY_VERSION)
+    {
+      NS_LOG_WARN ("Not a binary topology file, or written with another version or byte order: " << fileName);
+      return 0;
+    }
+
+  uint64_t expected = sizeof (header)
+    + static_cast<uint64_t> (header.nodes) * sizeof (uint32_t)
+    + static_cast<uint64_t> (header.links) * sizeof (BinaryTopologyLink)
+    + static_cast<uint64_t> (header.attributes) * sizeof (BinaryTopologyAttribute)
+    + header.stringBytes;
+  if (size != expected || header.stringBytes == 0)
+    {
+      NS_LOG_WARN ("Binary topology file " << fileName << " has " << size
+                                           << " bytes instead of " << expected);
+      return 0;
+    }
+
+  const char *stringTable = data + (expected - header.stringBytes);
+  if (stringTable[header.stringBytes - 1] != '\0'
+      || header.sourceName >= header.stringBytes || header.sourceType >= header.stringBytes)
+    {
+      NS_LOG_WARN ("Corrupted string table in " << fileName);
+      return 0;
+    }
+  return stringTable;
+}
+
+BinaryTopologyReader::Source::Source ()
+  : size (0),
+    mtime (0)
+{
+}
+
+BinaryTopologyReader::BinaryTopologyReader ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTopologyReader::~BinaryTopologyReader ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+BinaryTopologyReader::Write (const std::string &fileName, Ptr<const TopologyReader> reader,
+                             const NodeContainer &nodes, const Source &source)
+{
+  NS_LOG_FUNCTION (fileName << reader << source.fileName);
+
+  std::unordered_map<uint32_t, uint32_t> nodeIndex;
+  nodeIndex.reserve (nodes.GetN ());
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nodeIndex[nodes.Get (i)->GetId ()] = i;
+    }
+
+  BinaryTopologyStrings strings;
+  std::vector<uint32_t> nodeNames (nodes.GetN (), strings.Intern (""));
+  std::vector<bool> named (nodes.GetN (), false);
+  std::vector<BinaryTopologyLink> links;
+  std::vector<BinaryTopologyAttribute> attributes;
+  links.reserve (reader->LinksSize ());
+
+  for (TopologyReader::ConstLinksIterator i = reader->LinksBegin (); i != reader->LinksEnd (); ++i)
+    {
+      std::unordered_map<uint32_t, uint32_t>::const_iterator from = nodeIndex.find (i->GetFromNode ()->GetId ());
+      std::unordered_map<uint32_t, uint32_t>::const_iterator to = nodeIndex.find (i->GetToNode ()->GetId ());
+      if (from == nodeIndex.end () || to == nodeIndex.end ())
+        {
+          NS_LOG_WARN ("Link " << i->GetFromNodeName () << " - " << i->GetToNodeName ()
+                               << " uses a node missing from the node container");
+          return false;
+        }
+      if (!named[from->second])
+        {
+          nodeNames[from->second] = strings.Intern (i->GetFromNodeName ());
+          named[from->second] = true;
+        }
+      if (!named[to->second])
+        {
+          nodeNames[to->second] = strings.Intern (i->GetToNodeName ());
+          named[to->second] = true;
+        }
+
+      BinaryTopologyLink link;
+      link.from = from->second;
+      link.to = to->second;
+      link.firstAttribute = attributes.size ();
+      for (TopologyReader::Link::ConstAttributesIterator j = i->AttributesBegin (); j != i->AttributesEnd (); ++j)
+        {
+          BinaryTopologyAttribute attribute;
+          attribute.name = strings.Intern (j->first);
+          attribute.value = strings.Intern (j->second);
+          attributes.push_back (attribute);
+        }
+      link.nAttributes = attributes.size () - link.firstAttribute;
+      links.push_back (link);
+    }
+
+  BinaryTopologyHeader header;
+  header.magic = BINARY_TOPOLOGY_MAGIC;
+  header.version = BINARY_TOPOLOGY_VERSION;
+  header.nodes = nodeNames.size ();
+  header.links = links.size ();
+  header.attributes = attributes.size ();
+  header.sourceName = strings.Intern (source.fileName);
+  header.sourceType = strings.Intern (source.fileType);
+  header.sourceSize = source.size;
+  header.sourceMtime = source.mtime;
+  header.stringBytes = strings.GetData ().size ();
+
+  std::ofstream out (fileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.is_open ())
+    {
+      NS_LOG_WARN ("Couldn't open the file " << fileName);
+      return false;
+    }
+  out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  if (!nodeNames.empty ())
+    {
+      out.write (reinterpret_cast<const char *> (&nodeNames[0]), nodeNames.size () * sizeof (uint32_t));
+    }
+  if (!links.empty ())
+    {
+      out.write (reinterpret_cast<const char *> (&links[0]), links.size () * sizeof (BinaryTopologyLink));
+    }
+  if (!attributes.empty ())
+    {
+      out.write (reinterpret_cast<const char *> (&attributes[0]),
+                 attributes.size () * sizeof (BinaryTopologyAttribute));
+    }
+  out.write (&strings.GetData ()[0], strings.GetData ().size ());
+  out.close ();
+  if (out.fail ())
+    {
+      NS_LOG_WARN ("Couldn't write the file " << fileName);
+      return false;
+    }
+
+  NS_LOG_INFO ("Binary topology written with " << header.nodes << " nodes and " << header.links << " links");
+  return true;
+}
+
+NodeContainer
+BinaryTopologyReader::Read (void)
+{
+  TopologyTokenizer input;
+  NodeContainer nodes;
+
+  if (!input.Open (GetFileName ()))
+    {
+      NS_LOG_WARN ("Couldn't open the file " << GetFileName ());
+      return nodes;
+    }
+
+  const char *data = input.GetData ();
+  BinaryTopologyHeader header;
+  const char *stringTable = CheckSnapshot (data, input.GetSize (), GetFileName (), header);
+  if (stringTable == 0)
+    {
+      return nodes;
+    }
+
+  const char *nodeTable = data + sizeof (header);
+  const char *linkTable = nodeTable + header.nodes * sizeof (uint32_t);
+  const char *attributeTable = linkTable + header.links * sizeof (BinaryTopologyLink);
+
+  std::vector<uint32_t> names (header.nodes);
+  if (header.nodes > 0)
+    {
+      std::memcpy (&names[0], nodeTable, header.nodes * sizeof (uint32_t));
+    }
+  for (uint32_t i = 0; i < header.nodes; i++)
+    {
+      if (names[i] >= header.stringBytes)
+        {
+          NS_LOG_WARN ("Corrupted node table in " << GetFileName ());
+          return nodes;
+        }
+    }
+
+  NodeList::Reserve (NodeList::GetNNodes () + header.nodes);
+  nodes.Create (header.nodes);
+
+  for (uint32_t i = 0; i < header.links; i++)
+    {
+      BinaryTopologyLink entry;
+      std::memcpy (&entry, linkTable + i * sizeof (entry), sizeof (entry));
+      if (entry.from >= header.nodes || entry.to >= header.nodes
+          || entry.firstAttribute > header.attributes
+          || entry.nAttributes > header.attributes - entry.firstAttribute)
+        {
+          NS_LOG_WARN ("Corrupted link table in " << GetFileName ());
+          break;
+        }
+      Link link (nodes.Get (entry.from), stringTable + names[entry.from],
+                 nodes.Get (entry.to), stringTable + names[entry.to]);
+      for (uint32_t j = 0; j < entry.nAttributes; j++)
+        {
+          BinaryTopologyAttribute attribute;
+          std::memcpy (&attribute,
+                       attributeTable + (entry.firstAttribute + j) * sizeof (attribute),
+                       sizeof (attribute));
+          if (attribute.name >= header.stringBytes || attribute.value >= header.stringBytes)
+            {
+              NS_LOG_WARN ("Corrupted attribute table in " << GetFileName ());
+              break;
+            }
+          link.SetAttribute (stringTable + attribute.name, stringTable + attribute.value);
+        }
+      AddLink (link);
+    }
+
+  NS_LOG_INFO ("Binary topology created with " << nodes.GetN () << " nodes and " << LinksSize () << " links");
+
+  return nodes;
+}
+
+bool
+BinaryTopologyReader::ReadSource (const std::string &fileName, Source &source)
+{
+  NS_LOG_FUNCTION (fileName);
+
+  TopologyTokenizer input;
+  if (!input.Open (fileName))
+    {
+      return false;
+    }
+  BinaryTopologyHeader header;
+  const char *stringTable = CheckSnapshot (input.GetData (), input.GetSize (), fileName, header);
+  if (stringTable == 0)
+    {
+      return false;
+    }
+  source.fileName = stringTable + header.sourceName;
+  source.fileType = stringTable + header.sourceType;
+  source.size = header.sourceSize;
+  source.mtime = header.sourceMtime;
+  return true;
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TOPOLOGY_READER_H
+#define BINARY_TOPOLOGY_READER_H
+
+#include "topology-reader.h"
+
+namespace ns3 {
+
+
+// ------------------------------------------------------------
+// --------------------------------------------
+/**
+ * \ingroup topology
+ *
+ * \brief Topology file reader for binary topology snapshots.
+ *
+ * A snapshot holds the nodes of a topology, in creation order, with their
+ * names, and the links between them with all their attributes. It is
+ * written by BinaryTopologyReader::Write after another reader parsed a
+ * text topology, and read back by memory-mapping the file, so that runs
+ * of the same topology do not parse the text file again. The nodes are
+ * created in the order they were written, so they get the same ids as
+ * in the run that wrote the snapshot.
+ *
+ * Anything the scenario derives from the topology, such as the addresses
+ * assigned to each link, can be cached along with it by storing it as
+ * link attributes before writing the snapshot.
+ *
+ * The snapshot is stored in the byte order of the host that wrote it,
+ * and is rejected on hosts with a different byte order.
+ */
+class BinaryTopologyReader : public TopologyReader
+{
+public:
+  /**
+   * \brief The text topology file a snapshot was built from.
+   *
+   * It is stored in the snapshot header, so that a snapshot is only used
+   * in place of the very file it was built from.
+   */
+  struct Source
+  {
+    Source ();
+
+    std::string fileName; //!< name of the topology file, empty if unknown
+    std::string fileType; //!< type of the topology file (see TopologyReaderHelper::SetFileType)
+    uint64_t size;        //!< size of the topology file, in bytes
+    uint64_t mtime;       //!< last modification time of the topology file, in nanoseconds
+  };
+
+  BinaryTopologyReader ();
+  virtual ~BinaryTopologyReader ();
+
+  /**
+   * \brief Main topology reading function.
+   *
+   * This method maps the snapshot file, checks its header and creates
+   * the nodes and links it holds.
+   *
+   * \return The container of the nodes created (or empty container if there was an error)
+   */
+  virtual NodeContainer Read (void);
+
+  /**
+   * \brief Write a topology snapshot.
+   *
+   * \param [in] fileName The snapshot file name.
+   * \param [in] reader The reader holding the links of the topology.
+   * \param [in] nodes The nodes of the topology, in creation order
+   *             (usually the container returned by the reader).
+   * \param [in] source The topology file the snapshot is built from.
+   * \return True if the snapshot was written.
+   */
+  static bool Write (const std::string &fileName, Ptr<const TopologyReader> reader,
+                     const NodeContainer &nodes, const Source &source = Source ());
+
+  /**
+   * \brief Read the topology file a snapshot was built from.
+   *
+   * \param [in] fileName The snapshot file name.
+   * \param [out] source The topology file recorded in the snapshot.
+   * \return True if the file is a valid snapshot.
+   */
+  static bool ReadSource (const std::string &fileName, Source &source);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse.
+   */
+  BinaryTopologyReader (const BinaryTopologyReader&);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse.
+   * \returns
+   */
+  BinaryTopologyReader& operator= (const BinaryTopologyReader&);
+
+  // end class BinaryTopologyReader
+};
+
+// end namespace ns3
+};
+
+
+#endif /* BINARY_TOPOLOGY_READER_H */
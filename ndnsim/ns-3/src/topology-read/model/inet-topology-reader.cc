@@ -19,13 +19,14 @@
  * Author: Valerio Sartini (Valesar@gmail.com)
  */
 
-#include <fstream>
 #include <cstdlib>
-#include <sstream>
+#include <unordered_map>
 
 #include "ns3/log.h"
+#include "ns3/node-list.h"
 
 #include "inet-topology-reader.h"
+#include "topology-tokenizer.h"
 
 
 namespace ns3 {
@@ -45,12 +46,11 @@ InetTopologyReader::~InetTopologyReader ()
 NodeContainer
 InetTopologyReader::Read (void)
 {
-  std::ifstream topgen;
-  topgen.open (GetFileName ().c_str ());
-  std::map<std::string, Ptr<Node> > nodeMap;
+  TopologyTokenizer topgen;
+  std::unordered_map<std::string, Ptr<Node> > nodeMap;
   NodeContainer nodes;
 
-  if ( !topgen.is_open () )
+  if ( !topgen.Open (GetFileName ()) )
     {
       NS_LOG_WARN ("Inet topology file object is not open, check file name and permissions");
       return nodes;
@@ -66,54 +66,57 @@ InetTopologyReader::Read (void)
   int totnode = 0;
   int totlink = 0;
 
-  std::istringstream lineBuffer;
-  std::string line;
-
-  getline (topgen,line);
-  lineBuffer.str (line);
-
-  lineBuffer >> totnode;
-  lineBuffer >> totlink;
+  if (topgen.NextLine () && topgen.NextToken (from) && topgen.NextToken (to))
+    {
+      totnode = std::atoi (from.c_str ());
+      totlink = std::atoi (to.c_str ());
+    }
   NS_LOG_INFO ("Inet topology should have " << totnode << " nodes and " << totlink << " links");
 
-  for (int i = 0; i < totnode && !topgen.eof (); i++)
+  if (totnode > 0)
     {
-      getline (topgen,line);
+      nodeMap.reserve (totnode);
+      NodeList::Reserve (NodeList::GetNNodes () + totnode);
     }
 
-  for (int i = 0; i < totlink && !topgen.eof (); i++)
+  // node lines only carry coordinates, nodes are created from the links
+  for (int i = 0; i < totnode; i++)
     {
-      getline (topgen,line);
-      lineBuffer.clear ();
-      lineBuffer.str (line);
+      if (!topgen.NextLine ())
+        {
+          break;
+        }
+    }
 
-      lineBuffer >> from;
-      lineBuffer >> to;
-      lineBuffer >> linkAttr;
+  for (int i = 0; i < totlink && topgen.NextLine (); i++)
+    {
+      topgen.NextToken (from);
+      topgen.NextToken (to);
+      topgen.NextToken (linkAttr);
 
       if ( (!from.empty ()) && (!to.empty ()) )
         {
           NS_LOG_INFO ( "Link " << linksNumber << " from: " << from << " to: " << to);
 
-          if ( nodeMap[from] == 0 )
+          Ptr<Node> &fromNode = nodeMap[from];
+          if ( fromNode == 0 )
             {
               NS_LOG_INFO ( "Node " << nodesNumber << " name: " << from);
-              Ptr<Node> tmpNode = CreateObject<Node> ();
-              nodeMap[from] = tmpNode;
-              nodes.Add (tmpNode);
+              fromNode = CreateObject<Node> ();
+              nodes.Add (fromNode);
               nodesNumber++;
             }
 
-          if (nodeMap[to] == 0)
+          Ptr<Node> &toNode = nodeMap[to];
+          if (toNode == 0)
             {
               NS_LOG_INFO ( "Node " << nodesNumber << " name: " << to);
-              Ptr<Node> tmpNode = CreateObject<Node> ();
-              nodeMap[to] = tmpNode;
-              nodes.Add (tmpNode);
+              toNode = CreateObject<Node> ();
+              nodes.Add (toNode);
               nodesNumber++;
             }
 
-          Link link ( nodeMap[from], from, nodeMap[to], to );
+          Link link ( fromNode, from, toNode, to );
           if ( !linkAttr.empty () )
             {
               NS_LOG_INFO ( "Link " << linksNumber << " weight: " << linkAttr);
@@ -126,7 +129,6 @@ InetTopologyReader::Read (void)
     }
 
   NS_LOG_INFO ("Inet topology created with " << nodesNumber << " nodes and " << linksNumber << " links");
-  topgen.close ();
 
   return nodes;
 }
@@ -19,13 +19,11 @@
  * Author: Valerio Sartini (valesar@gmail.com)
  */
 
-#include <fstream>
-#include <cstdlib>
-#include <iostream>
-#include <sstream>
+#include <unordered_map>
 
 #include "ns3/log.h"
 #include "orbis-topology-reader.h"
+#include "topology-tokenizer.h"
 
 
 namespace ns3 {
@@ -45,63 +43,49 @@ OrbisTopologyReader::~OrbisTopologyReader ()
 NodeContainer
 OrbisTopologyReader::Read (void)
 {
-  std::ifstream topgen;
-  topgen.open (GetFileName ().c_str ());
-  std::map<std::string, Ptr<Node> > nodeMap;
+  TopologyTokenizer topgen;
+  std::unordered_map<std::string, Ptr<Node> > nodeMap;
   NodeContainer nodes;
 
-  if ( !topgen.is_open () )
+  if ( !topgen.Open (GetFileName ()) )
     {
       return nodes;
     }
 
   std::string from;
   std::string to;
-  std::istringstream lineBuffer;
-  std::string line;
 
   int linksNumber = 0;
   int nodesNumber = 0;
 
-  while (!topgen.eof ())
+  while (topgen.NextLine ())
     {
-      line.clear ();
-      lineBuffer.clear ();
-      from.clear ();
-      to.clear ();
-
-      getline (topgen,line);
-      lineBuffer.str (line);
-      lineBuffer >> from;
-      lineBuffer >> to;
-
-      if ( (!from.empty ()) && (!to.empty ()) )
+      if ( topgen.NextToken (from) && topgen.NextToken (to) )
         {
           NS_LOG_INFO ( linksNumber << " From: " << from << " to: " << to );
-          if ( nodeMap[from] == 0 )
+          Ptr<Node> &fromNode = nodeMap[from];
+          if ( fromNode == 0 )
             {
-              Ptr<Node> tmpNode = CreateObject<Node> ();
-              nodeMap[from] = tmpNode;
-              nodes.Add (tmpNode);
+              fromNode = CreateObject<Node> ();
+              nodes.Add (fromNode);
               nodesNumber++;
             }
 
-          if (nodeMap[to] == 0)
+          Ptr<Node> &toNode = nodeMap[to];
+          if (toNode == 0)
             {
-              Ptr<Node> tmpNode = CreateObject<Node> ();
-              nodeMap[to] = tmpNode;
-              nodes.Add (tmpNode);
+              toNode = CreateObject<Node> ();
+              nodes.Add (toNode);
               nodesNumber++;
             }
 
-          Link link ( nodeMap[from], from, nodeMap[to], to );
+          Link link ( fromNode, from, toNode, to );
           AddLink (link);
 
           linksNumber++;
         }
     }
   NS_LOG_INFO ("Orbis topology created with " << nodesNumber << " nodes and " << linksNumber << " links");
-  topgen.close ();
 
   return nodes;
 }
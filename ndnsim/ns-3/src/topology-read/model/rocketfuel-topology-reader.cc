@@ -18,15 +18,12 @@
  * Author: Hajime Tazaki (tazaki@sfc.wide.ad.jp)
  */
 
-#include <fstream>
 #include <cstdlib>
-#include <iostream>
-#include <sstream>
-#include <regex.h>
 
 #include "ns3/log.h"
 #include "ns3/unused.h"
 #include "rocketfuel-topology-reader.h"
+#include "topology-tokenizer.h"
 
 namespace ns3 {
 
@@ -46,25 +43,195 @@ RocketfuelTopologyReader::~RocketfuelTopologyReader ()
 
 /* uid @loc [+] [bb] (num_neigh) [&ext] -> <nuid-1> <nuid-2> ... {-euid} ... =name[!] rn */
 
+/**
+ * \brief Fields of a line of a Rocketfuel maps file.
+ */
+struct RocketfuelMapsLine
+{
+  std::string uid;                 //!< node ID
+  std::string loc;                 //!< node location
+  bool dns;                        //!< is a DNS node ?
+  bool bb;                         //!< is a BB node ?
+  int numNeigh;                    //!< announced number of neighbors
+  std::vector<std::string> neighs; //!< neighbor IDs
+  std::string name;                //!< node name
+  int radius;                      //!< node radius
+};
 
-#define REGMATCH_MAX 16
+/**
+ * \brief Check that a string only holds characters from a given set
+ * \param s the string
+ * \param from first character to check
+ * \param chars the allowed characters
+ * \returns true if every character of s starting at from is in chars
+ */
+static inline bool
+OnlyChars (const std::string &s, std::string::size_type from, const char *chars)
+{
+  return s.find_first_not_of (chars, from) == std::string::npos;
+}
 
-#define START "^"
-#define END "$"
-#define SPACE "[ \t]+"
-#define MAYSPACE "[ \t]*"
+/**
+ * \brief Split a maps file line into its fields
+ *
+ * This is a hand-written equivalent of the regular expression
+ * START "(-*[0-9]+)" SPACE "(@[?A-Za-z0-9,+]+)" SPACE
+ * "(\\+)*" MAYSPACE "(bb)*" MAYSPACE
+ * "\\(([0-9]+)\\)" SPACE "(&[0-9]+)*" MAYSPACE
+ * "->" MAYSPACE "(<[0-9 \t<>]+>)*" MAYSPACE
+ * "(\\{-[0-9\\{\\} \t-]+\\})*" SPACE
+ * "=([A-Za-z0-9.!-]+)" SPACE "r([0-9])" MAYSPACE END
+ * working on whitespace-separated tokens.
+ *
+ * \param tokens the tokens of the line
+ * \param line where to store the fields, or 0 to only validate the line
+ * \returns true if the line is a valid maps file line
+ */
+static bool
+ParseMapsLine (const std::vector<std::string> &tokens, RocketfuelMapsLine *line)
+{
+  std::vector<std::string>::size_type i = 0;
+  std::vector<std::string>::size_type n = tokens.size ();
 
-#define ROCKETFUEL_MAPS_LINE \
-  START "(-*[0-9]+)" SPACE "(@[?A-Za-z0-9,+]+)" SPACE \
-  "(\\+)*" MAYSPACE "(bb)*" MAYSPACE \
-  "\\(([0-9]+)\\)" SPACE "(&[0-9]+)*" MAYSPACE \
-  "->" MAYSPACE "(<[0-9 \t<>]+>)*" MAYSPACE \
-  "(\\{-[0-9\\{\\} \t-]+\\})*" SPACE \
-  "=([A-Za-z0-9.!-]+)" SPACE "r([0-9])" \
-  MAYSPACE END
+  // uid
+  if (i == n || tokens[i].empty ()
+      || tokens[i].find_first_not_of ('-') == std::string::npos
+      || !OnlyChars (tokens[i], tokens[i].find_first_not_of ('-'), "0123456789"))
+    {
+      return false;
+    }
+  const std::string &uid = tokens[i++];
 
-#define ROCKETFUEL_WEIGHTS_LINE \
-  START "([^ \t]+)" SPACE "([^ \t]+)" SPACE "([0-9.]+)" MAYSPACE END
+  // @loc
+  if (i == n || tokens[i].size () < 2 || tokens[i][0] != '@'
+      || !OnlyChars (tokens[i], 1, "?ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789,+"))
+    {
+      return false;
+    }
+  const std::string &loc = tokens[i++];
+
+  // [+] [bb], possibly written together
+  bool dns = false;
+  bool bb = false;
+  while (i < n && (tokens[i][0] == '+' || tokens[i][0] == 'b'))
+    {
+      const std::string &t = tokens[i];
+      std::string::size_type j = 0;
+      while (j < t.size () && t[j] == '+')
+        {
+          dns = true;
+          j++;
+        }
+      while (j + 1 < t.size () && t[j] == 'b' && t[j + 1] == 'b')
+        {
+          bb = true;
+          j += 2;
+        }
+      if (j != t.size ())
+        {
+          return false;
+        }
+      i++;
+    }
+
+  // (num_neigh)
+  if (i == n || tokens[i].size () < 3 || tokens[i][0] != '('
+      || tokens[i][tokens[i].size () - 1] != ')'
+      || tokens[i].find_first_not_of ("0123456789", 1) != tokens[i].size () - 1)
+    {
+      return false;
+    }
+  int numNeigh = std::atoi (tokens[i].c_str () + 1);
+  i++;
+
+  // [&ext]
+  while (i < n && tokens[i][0] == '&')
+    {
+      if (tokens[i].size () < 2 || !OnlyChars (tokens[i], 1, "&0123456789"))
+        {
+          return false;
+        }
+      i++;
+    }
+
+  if (i == n || tokens[i] != "->")
+    {
+      return false;
+    }
+  i++;
+
+  // <nuid-1> <nuid-2> ...
+  std::vector<std::string>::size_type firstNeigh = i;
+  while (i < n && tokens[i][0] == '<')
+    {
+      if (tokens[i].size () < 3 || tokens[i][tokens[i].size () - 1] != '>'
+          || !OnlyChars (tokens[i], 1, "0123456789<>"))
+        {
+          return false;
+        }
+      i++;
+    }
+  std::vector<std::string>::size_type lastNeigh = i;
+
+  // {-euid} ...
+  while (i < n && tokens[i][0] != '=')
+    {
+      if (!OnlyChars (tokens[i], 0, "{}-0123456789"))
+        {
+          return false;
+        }
+      i++;
+    }
+
+  // =name[!]
+  if (i == n || tokens[i].size () < 2
+      || !OnlyChars (tokens[i], 1, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789.!-"))
+    {
+      return false;
+    }
+  const std::string &name = tokens[i++];
+
+  // rn
+  if (i + 1 != n || tokens[i].size () != 2 || tokens[i][0] != 'r'
+      || tokens[i][1] < '0' || tokens[i][1] > '9')
+    {
+      return false;
+    }
+  int radius = tokens[i][1] - '0';
+
+  if (line != 0)
+    {
+      line->uid = uid;
+      line->loc = loc;
+      line->dns = dns;
+      line->bb = bb;
+      line->numNeigh = numNeigh;
+      line->neighs.clear ();
+      for (i = firstNeigh; i < lastNeigh; i++)
+        {
+          line->neighs.push_back (tokens[i].substr (1, tokens[i].size () - 2));
+        }
+      line->name = name.substr (1);
+      line->radius = radius;
+    }
+  return true;
+}
+
+/**
+ * \brief Check whether a line is a valid weights file line
+ *
+ * This is a hand-written equivalent of the regular expression
+ * START "([^ \t]+)" SPACE "([^ \t]+)" SPACE "([0-9.]+)" MAYSPACE END
+ *
+ * \param tokens the tokens of the line
+ * \returns true if the line is a valid weights file line
+ */
+static bool
+IsWeightsLine (const std::vector<std::string> &tokens)
+{
+  return tokens.size () == 3 && !tokens[2].empty ()
+         && OnlyChars (tokens[2], 0, "0123456789.");
+}
 
 /**
  * \brief Print node info
@@ -77,9 +244,9 @@ RocketfuelTopologyReader::~RocketfuelTopologyReader ()
  * \param radius node radius
  */
 static inline void
-PrintNodeInfo (std::string & uid, std::string & loc, bool dns, bool bb,
+PrintNodeInfo (const std::string & uid, const std::string & loc, bool dns, bool bb,
                std::vector <std::string>::size_type neighListSize,
-               std::string & name, int radius)
+               const std::string & name, int radius)
 {
   /* uid @loc [+] [bb] (num_neigh) [&ext] -> <nuid-1> <nuid-2> ... {-euid} ... =name[!] rn */
   NS_LOG_INFO ("Load Node[" << uid << "]: location: " << loc << " dns: " << dns
@@ -88,111 +255,70 @@ PrintNodeInfo (std::string & uid, std::string & loc, bool dns, bool bb,
                             << "name: " << name << " radius: " << radius);
 }
 
+Ptr<Node>
+RocketfuelTopologyReader::GetOrCreateNode (const std::string &name, NodeContainer &nodes)
+{
+  Ptr<Node> &node = m_nodeMap[name];
+  if (node == 0)
+    {
+      node = CreateObject<Node> ();
+      nodes.Add (node);
+      m_nodesNumber++;
+    }
+  return node;
+}
+
 NodeContainer
-RocketfuelTopologyReader::GenerateFromMapsFile (int argc, char *argv[])
+RocketfuelTopologyReader::GenerateFromMapsFile (const std::vector<std::string> &tokens)
 {
-  std::string uid;
-  std::string loc;
-  std::string ptr;
-  std::string name;
-  std::string nuid;
-  bool dns = false;
-  bool bb = false;
-  int num_neigh_s = 0;
+  RocketfuelMapsLine line;
   unsigned int num_neigh = 0;
-  int radius = 0;
-  std::vector <std::string> neigh_list;
   NodeContainer nodes;
 
-  uid = argv[0];
-  loc = argv[1];
-
-  if (argv[2])
-    {
-      dns = true;
-    }
-
-  if (argv[3])
+  if (!ParseMapsLine (tokens, &line))
     {
-      bb = true;
+      return nodes;
     }
 
-  num_neigh_s = ::atoi (argv[4]);
-  if (num_neigh_s < 0)
+  if (line.numNeigh < 0)
     {
       num_neigh = 0;
       NS_LOG_WARN ("Negative number of neighbors given");
     }
   else
     {
-      num_neigh = num_neigh_s;
-    }
-
-  /* neighbors */
-  if (argv[6])
-    {
-      char *nbr;
-      char *stringp = argv[6];
-      while ((nbr = strsep (&stringp, " \t")) != NULL)
-        {
-          nbr[strlen (nbr) - 1] = '\0';
-          neigh_list.push_back (nbr + 1);
-        }
-    }
-  if (num_neigh != neigh_list.size ())
-    {
-      NS_LOG_WARN ("Given number of neighbors = " << num_neigh << " != size of neighbors list = " << neigh_list.size ());
+      num_neigh = line.numNeigh;
     }
 
-  /* externs */
-  if (argv[7])
+  if (num_neigh != line.neighs.size ())
     {
-      // euid = argv[7];
+      NS_LOG_WARN ("Given number of neighbors = " << num_neigh << " != size of neighbors list = " << line.neighs.size ());
     }
 
-  /* name */
-  if (argv[8])
-    {
-      name = argv[8];
-    }
-
-  radius = ::atoi (&argv[9][1]);
-  if (radius > 0)
+  if (line.radius > 0)
     {
       return nodes;
     }
 
-  PrintNodeInfo (uid, loc, dns, bb, neigh_list.size (), name, radius);
+  PrintNodeInfo (line.uid, line.loc, line.dns, line.bb, line.neighs.size (), line.name, line.radius);
 
   // Create node and link
-  if (!uid.empty ())
+  if (!line.uid.empty ())
     {
-      if (m_nodeMap[uid] == 0)
-        {
-          Ptr<Node> tmpNode = CreateObject<Node> ();
-          m_nodeMap[uid] = tmpNode;
-          nodes.Add (tmpNode);
-          m_nodesNumber++;
-        }
+      Ptr<Node> node = GetOrCreateNode (line.uid, nodes);
 
-      for (uint32_t i = 0; i < neigh_list.size (); ++i)
+      for (uint32_t i = 0; i < line.neighs.size (); ++i)
         {
-          nuid = neigh_list[i];
+          const std::string &nuid = line.neighs[i];
 
           if (nuid.empty ())
             {
               return nodes;
             }
 
-          if (m_nodeMap[nuid] == 0)
-            {
-              Ptr<Node> tmpNode = CreateObject<Node> ();
-              m_nodeMap[nuid] = tmpNode;
-              nodes.Add (tmpNode);
-              m_nodesNumber++;
-            }
-          NS_LOG_INFO (m_linksNumber << ":" << m_nodesNumber << " From: " << uid << " to: " << nuid);
-          Link link (m_nodeMap[uid], uid, m_nodeMap[nuid], nuid);
+          Ptr<Node> neigh = GetOrCreateNode (nuid, nodes);
+          NS_LOG_INFO (m_linksNumber << ":" << m_nodesNumber << " From: " << line.uid << " to: " << nuid);
+          Link link (node, line.uid, neigh, nuid);
           AddLink (link);
           m_linksNumber++;
         }
@@ -204,58 +330,35 @@ RocketfuelTopologyReader::GenerateFromMapsFile (int argc, char *argv[])
 }
 
 NodeContainer
-RocketfuelTopologyReader::GenerateFromWeightsFile (int argc, char *argv[])
+RocketfuelTopologyReader::GenerateFromWeightsFile (const std::vector<std::string> &tokens)
 {
   /* uid @loc [+] [bb] (num_neigh) [&ext] -> <nuid-1> <nuid-2> ... {-euid} ... =name[!] rn */
-  std::string sname;
-  std::string tname;
   char *endptr;
   NodeContainer nodes;
 
-  sname = argv[0];
-  tname = argv[1];
-  double v = strtod (argv[2], &endptr); // weight
+  const std::string &sname = tokens[0];
+  const std::string &tname = tokens[1];
+  double v = strtod (tokens[2].c_str (), &endptr); // weight
   NS_UNUSED (v); // suppress "set but not used" compiler warning in optimized builds
   if (*endptr != '\0')
     {
-      NS_LOG_WARN ("invalid weight: " << argv[2]);
+      NS_LOG_WARN ("invalid weight: " << tokens[2]);
       return nodes;
     }
 
   // Create node and link
   if (!sname.empty () && !tname.empty ())
     {
-      if (m_nodeMap[sname] == 0)
-        {
-          Ptr<Node> tmpNode = CreateObject<Node> ();
-          m_nodeMap[sname] = tmpNode;
-          nodes.Add (tmpNode);
-          m_nodesNumber++;
-        }
-
-      if (m_nodeMap[tname] == 0)
-        {
-          Ptr<Node> tmpNode = CreateObject<Node> ();
-          m_nodeMap[tname] = tmpNode;
-          nodes.Add (tmpNode);
-          m_nodesNumber++;
-        }
+      Ptr<Node> snode = GetOrCreateNode (sname, nodes);
+      Ptr<Node> tnode = GetOrCreateNode (tname, nodes);
       NS_LOG_INFO (m_linksNumber << ":" << m_nodesNumber << " From: " << sname << " to: " << tname);
-      TopologyReader::ConstLinksIterator iter;
-      bool found = false;
-      for (iter = LinksBegin (); iter != LinksEnd (); iter++)
-        {
-          if ((iter->GetFromNode () == m_nodeMap[tname])
-              && (iter->GetToNode () == m_nodeMap[sname]))
-            {
-              found = true;
-              break;
-            }
-        }
 
-      if (!found)
+      // weights files list both directions of each link, keep only the first one
+      uint64_t reverse = (static_cast<uint64_t> (tnode->GetId ()) << 32) | snode->GetId ();
+      if (m_weightsLinks.find (reverse) == m_weightsLinks.end ())
         {
-          Link link (m_nodeMap[sname], sname, m_nodeMap[tname], tname);
+          m_weightsLinks.insert ((static_cast<uint64_t> (snode->GetId ()) << 32) | tnode->GetId ());
+          Link link (snode, sname, tnode, tname);
           AddLink (link);
           m_linksNumber++;
         }
@@ -267,42 +370,19 @@ RocketfuelTopologyReader::GenerateFromWeightsFile (int argc, char *argv[])
 }
 
 enum RocketfuelTopologyReader::RF_FileType
-RocketfuelTopologyReader::GetFileType (const char *line)
+RocketfuelTopologyReader::GetFileType (const std::vector<std::string> &tokens)
 {
-  int ret;
-  regmatch_t regmatch[REGMATCH_MAX];
-  regex_t regex;
-  char errbuf[512];
-
   // Check whether MAPS file or not
-  ret = regcomp (&regex, ROCKETFUEL_MAPS_LINE, REG_EXTENDED | REG_NEWLINE);
-  if (ret != 0)
+  if (ParseMapsLine (tokens, 0))
     {
-      regerror (ret, &regex, errbuf, sizeof (errbuf));
-      return RF_UNKNOWN;
-    }
-  ret = regexec (&regex, line, REGMATCH_MAX, regmatch, 0);
-  if (ret != REG_NOMATCH)
-    {
-      regfree (&regex);
       return RF_MAPS;
     }
-  regfree (&regex);
 
   // Check whether Weights file or not
-  ret = regcomp (&regex, ROCKETFUEL_WEIGHTS_LINE, REG_EXTENDED | REG_NEWLINE);
-  if (ret != 0)
-    {
-      regerror (ret, &regex, errbuf, sizeof (errbuf));
-      return RF_UNKNOWN;
-    }
-  ret = regexec (&regex, line, REGMATCH_MAX, regmatch, 0);
-  if (ret != REG_NOMATCH)
+  if (IsWeightsLine (tokens))
     {
-      regfree (&regex);
       return RF_WEIGHTS;
     }
-  regfree (&regex);
 
   return RF_UNKNOWN;
 }
@@ -311,39 +391,34 @@ RocketfuelTopologyReader::GetFileType (const char *line)
 NodeContainer
 RocketfuelTopologyReader::Read (void)
 {
-  std::ifstream topgen;
-  topgen.open (GetFileName ().c_str ());
+  TopologyTokenizer topgen;
   NodeContainer nodes;
 
-  std::istringstream lineBuffer;
-  std::string line;
-  int lineNumber = 0;
+  std::vector<std::string> tokens;
+  std::string token;
   enum RF_FileType ftype = RF_UNKNOWN;
-  char errbuf[512];
 
-  if (!topgen.is_open ())
+  if (!topgen.Open (GetFileName ()))
     {
       NS_LOG_WARN ("Couldn't open the file " << GetFileName ());
       return nodes;
     }
 
-  while (!topgen.eof ())
+  while (topgen.NextLine ())
     {
-      int ret;
-      int argc;
-      char *argv[REGMATCH_MAX];
-      char *buf;
-
-      lineNumber++;
-      line.clear ();
-      lineBuffer.clear ();
-
-      getline (topgen, line);
-      buf = (char *)line.c_str ();
+      tokens.clear ();
+      while (topgen.NextToken (token))
+        {
+          tokens.push_back (token);
+        }
+      if (tokens.empty ())
+        {
+          continue;
+        }
 
-      if (lineNumber == 1)
+      if (ftype == RF_UNKNOWN)
         {
-          ftype = GetFileType (buf);
+          ftype = GetFileType (tokens);
           if (ftype == RF_UNKNOWN)
             {
               NS_LOG_INFO ("Unknown File Format (" << GetFileName () << ")");
@@ -351,86 +426,27 @@ RocketfuelTopologyReader::Read (void)
             }
         }
 
-      regmatch_t regmatch[REGMATCH_MAX];
-      regex_t regex;
-
       if (ftype == RF_MAPS)
         {
-          ret = regcomp (&regex, ROCKETFUEL_MAPS_LINE, REG_EXTENDED | REG_NEWLINE);
-          if (ret != 0)
-            {
-              regerror (ret, &regex, errbuf, sizeof (errbuf));
-              regfree (&regex);
-              break;
-            }
-
-          ret = regexec (&regex, buf, REGMATCH_MAX, regmatch, 0);
-          if (ret == REG_NOMATCH)
+          if (!ParseMapsLine (tokens, 0))
             {
-              NS_LOG_WARN ("match failed (maps file): %s" << buf);
-              regfree (&regex);
+              NS_LOG_WARN ("match failed (maps file): " << topgen.GetLine ());
               break;
             }
+          nodes.Add (GenerateFromMapsFile (tokens));
         }
       else if (ftype == RF_WEIGHTS)
         {
-          ret = regcomp (&regex, ROCKETFUEL_WEIGHTS_LINE, REG_EXTENDED | REG_NEWLINE);
-          if (ret != 0)
-            {
-              regerror (ret, &regex, errbuf, sizeof (errbuf));
-              regfree (&regex);
-              break;
-            }
-
-          ret = regexec (&regex, buf, REGMATCH_MAX, regmatch, 0);
-          if (ret == REG_NOMATCH)
+          if (!IsWeightsLine (tokens))
             {
-              NS_LOG_WARN ("match failed (weights file): %s" << buf);
-              regfree (&regex);
+              NS_LOG_WARN ("match failed (weights file): " << topgen.GetLine ());
               break;
             }
+          nodes.Add (GenerateFromWeightsFile (tokens));
         }
-
-      line = buf;
-      argc = 0;
-
-      /* regmatch[0] is the entire strings that matched */
-      for (int i = 1; i < REGMATCH_MAX; i++)
-        {
-          if (regmatch[i].rm_so == -1)
-            {
-              argv[i - 1] = NULL;
-            }
-          else
-            {
-              line[regmatch[i].rm_eo] = '\0';
-              argv[i - 1] = &line[regmatch[i].rm_so];
-              argc = i;
-            }
-        }
-
-      if (ftype == RF_MAPS)
-        {
-          nodes.Add (GenerateFromMapsFile (argc, argv));
-        }
-      else if (ftype == RF_WEIGHTS)
-        {
-          nodes.Add (GenerateFromWeightsFile (argc, argv));
-        }
-      else
-        {
-          NS_LOG_WARN ("Unsupported file format (only Maps/Weights are supported)");
-        }
-
-      regfree (&regex);
     }
 
-
-  topgen.close ();
-
   return nodes;
 }
 
 } /* namespace ns3 */
-
-
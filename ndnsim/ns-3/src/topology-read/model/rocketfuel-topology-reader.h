@@ -21,6 +21,10 @@
 #ifndef ROCKETFUEL_TOPOLOGY_READER_H
 #define ROCKETFUEL_TOPOLOGY_READER_H
 
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "ns3/nstime.h"
 #include "topology-reader.h"
 
@@ -65,11 +69,10 @@ private:
    * Parser for the *.cch file available at:
    * http://www.cs.washington.edu/research/networking/rocketfuel/maps/rocketfuel_maps_cch.tar.gz
    *
-   * \param [in] argc Argument counter.
-   * \param [in] argv Argument vector.
+   * \param [in] tokens The whitespace-separated fields of one line.
    * \return The container of the nodes created (or empty container if there was an error).
    */
-  NodeContainer GenerateFromMapsFile (int argc, char *argv[]);
+  NodeContainer GenerateFromMapsFile (const std::vector<std::string> &tokens);
 
   /**
    * \brief Topology read function from a file containing the nodes weights.
@@ -77,11 +80,10 @@ private:
    * Parser for the weights.* file available at:
    * http://www.cs.washington.edu/research/networking/rocketfuel/maps/weights-dist.tar.gz
    *
-   * \param [in] argc Argument counter.
-   * \param [in] argv Argument vector.
+   * \param [in] tokens The whitespace-separated fields of one line.
    * \return The container of the nodes created (or empty container if there was an error).
    */
-  NodeContainer GenerateFromWeightsFile (int argc, char *argv[]);
+  NodeContainer GenerateFromWeightsFile (const std::vector<std::string> &tokens);
 
   /**
    * \brief Enum of the possible file types.
@@ -97,13 +99,28 @@ private:
   /**
    * \brief Classifies the file type according to its content.
    *
+   * \param [in] tokens The whitespace-separated fields of the first line.
    * \return The file type (RF_MAPS, RF_WEIGHTS, or RF_UNKNOWN)
    */
-  enum RF_FileType GetFileType (const char *);
+  enum RF_FileType GetFileType (const std::vector<std::string> &tokens);
+
+  /**
+   * \brief Get the node with the given name, creating it if needed.
+   *
+   * \param [in] name The node name.
+   * \param [in,out] nodes Container the node is added to if it is created.
+   * \return The node.
+   */
+  Ptr<Node> GetOrCreateNode (const std::string &name, NodeContainer &nodes);
 
   int m_linksNumber; //!< Number of links.
   int m_nodesNumber; //!< Number of nodes.
-  std::map<std::string, Ptr<Node> > m_nodeMap; //!< Map of the nodes (name, node).
+  std::unordered_map<std::string, Ptr<Node> > m_nodeMap; //!< Map of the nodes (name, node).
+  /**
+   * Links already added from a weights file, as (from node id, to node id)
+   * packed in 64 bits, used to skip the reverse direction of each link.
+   */
+  std::unordered_set<uint64_t> m_weightsLinks;
 
 private:
   /**
@@ -64,6 +64,18 @@ TopologyReader::LinksEnd (void) const
   return m_linksList.end ();
 }
 
+TopologyReader::LinksIterator
+TopologyReader::LinksBegin (void)
+{
+  return m_linksList.begin ();
+}
+
+TopologyReader::LinksIterator
+TopologyReader::LinksEnd (void)
+{
+  return m_linksList.end ();
+}
+
 int
 TopologyReader::LinksSize (void) const
 {
@@ -155,6 +155,11 @@ private:
    */
   typedef std::list< Link >::const_iterator ConstLinksIterator;
 
+  /**
+   * \brief Iterator to the list of the links.
+   */
+  typedef std::list< Link >::iterator LinksIterator;
+
   TopologyReader ();
   virtual ~TopologyReader ();
 
@@ -195,6 +200,22 @@ private:
    */
   ConstLinksIterator LinksEnd (void) const;
 
+  /**
+   * \brief Returns an iterator to the the first link in this block.
+   *
+   * Unlike the const version, this allows to set attributes on the links
+   * after they have been read, e.g. to store them in a topology cache.
+   *
+   * \return An iterator to the first link in this block.
+   */
+  LinksIterator LinksBegin (void);
+
+  /**
+   * \brief Returns an iterator to the the last link in this block.
+   * \return An iterator to the last link in this block.
+   */
+  LinksIterator LinksEnd (void);
+
   /**
    * \brief Returns the number of links in this block.
    * \return The number of links in this block.
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <cstring>
+#include <iterator>
+
+#include "ns3/core-config.h"
+#include "ns3/log.h"
+#include "topology-tokenizer.h"
+
+#if defined (HAVE_SYS_STAT_H) && !defined (_WIN32)
+#define TOPOLOGY_TOKENIZER_USE_MMAP 1
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TopologyTokenizer");
+
+static inline bool
+IsBlank (char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+TopologyTokenizer::TopologyTokenizer ()
+  : m_data (0),
+    m_size (0),
+    m_mapped (false),
+    m_next (0),
+    m_lineBegin (0),
+    m_lineEnd (0),
+    m_cursor (0),
+    m_lineNumber (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TopologyTokenizer::~TopologyTokenizer ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+TopologyTokenizer::Open (const std::string &fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  Close ();
+
+#ifdef TOPOLOGY_TOKENIZER_USE_MMAP
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Couldn't open the file " << fileName);
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) == 0 && S_ISREG (st.st_mode) && st.st_size > 0)
+    {
+      void *addr = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED)
+        {
+#ifdef MADV_SEQUENTIAL
+          madvise (addr, st.st_size, MADV_SEQUENTIAL);
+#endif
+          m_data = static_cast<const char *> (addr);
+          m_size = st.st_size;
+          m_mapped = true;
+        }
+    }
+  close (fd);
+#endif
+
+  if (!m_mapped)
+    {
+      std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+      if (!file.is_open ())
+        {
+          NS_LOG_WARN ("Couldn't open the file " << fileName);
+          return false;
+        }
+      m_buffer.assign (std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ());
+      // keep m_data non-null for an empty file so that IsOpen () holds
+      m_buffer.push_back ('\0');
+      m_data = &m_buffer[0];
+      m_size = m_buffer.size () - 1;
+    }
+
+  m_next = m_data;
+  m_lineBegin = m_lineEnd = m_cursor = m_data;
+  m_lineNumber = 0;
+  return true;
+}
+
+void
+TopologyTokenizer::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef TOPOLOGY_TOKENIZER_USE_MMAP
+  if (m_mapped)
+    {
+      munmap (const_cast<char *> (m_data), m_size);
+    }
+#endif
+  m_buffer.clear ();
+  m_data = 0;
+  m_size = 0;
+  m_mapped = false;
+  m_next = m_lineBegin = m_lineEnd = m_cursor = 0;
+  m_lineNumber = 0;
+}
+
+bool
+TopologyTokenizer::IsOpen (void) const
+{
+  return m_data != 0;
+}
+
+bool
+TopologyTokenizer::NextLine (void)
+{
+  const char *end = m_data + m_size;
+  if (m_data == 0 || m_next >= end)
+    {
+      return false;
+    }
+  m_lineBegin = m_next;
+  const char *eol = static_cast<const char *> (std::memchr (m_lineBegin, '\n', end - m_lineBegin));
+  if (eol == 0)
+    {
+      m_lineEnd = end;
+      m_next = end;
+    }
+  else
+    {
+      m_lineEnd = eol;
+      m_next = eol + 1;
+    }
+  m_cursor = m_lineBegin;
+  m_lineNumber++;
+  return true;
+}
+
+bool
+TopologyTokenizer::NextToken (const char **begin, std::size_t *length)
+{
+  while (m_cursor < m_lineEnd && IsBlank (*m_cursor))
+    {
+      m_cursor++;
+    }
+  if (m_cursor == m_lineEnd)
+    {
+      *begin = m_cursor;
+      *length = 0;
+      return false;
+    }
+  *begin = m_cursor;
+  while (m_cursor < m_lineEnd && !IsBlank (*m_cursor))
+    {
+      m_cursor++;
+    }
+  *length = m_cursor - *begin;
+  return true;
+}
+
+bool
+TopologyTokenizer::NextToken (std::string &token)
+{
+  const char *begin;
+  std::size_t length;
+  bool found = NextToken (&begin, &length);
+  token.assign (begin, length);
+  return found;
+}
+
+std::string
+TopologyTokenizer::GetLine (void) const
+{
+  const char *end = m_lineEnd;
+  while (end > m_lineBegin && *(end - 1) == '\r')
+    {
+      end--;
+    }
+  return std::string (m_lineBegin, end);
+}
+
+uint32_t
+TopologyTokenizer::GetLineNumber (void) const
+{
+  return m_lineNumber;
+}
+
+const char *
+TopologyTokenizer::GetData (void) const
+{
+  return m_data;
+}
+
+std::size_t
+TopologyTokenizer::GetSize (void) const
+{
+  return m_size;
+}
+
+} // namespace ns3
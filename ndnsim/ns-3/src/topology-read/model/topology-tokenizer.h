@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TOPOLOGY_TOKENIZER_H
+#define TOPOLOGY_TOKENIZER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup topology
+ *
+ * \brief Line and whitespace tokenizer shared by the topology readers.
+ *
+ * The whole input file is memory-mapped when the platform supports it
+ * (and read into a single buffer otherwise), so that walking the lines
+ * and tokens of large topology files does not go through iostreams.
+ * Tokens are separated by spaces, tabs or carriage returns.
+ */
+class TopologyTokenizer
+{
+public:
+  TopologyTokenizer ();
+  ~TopologyTokenizer ();
+
+  /**
+   * \brief Open a file and position the tokenizer before its first line.
+   *
+   * \param fileName the file to read
+   * \return true if the file could be opened and read
+   */
+  bool Open (const std::string &fileName);
+
+  /**
+   * \brief Release the file contents.
+   */
+  void Close (void);
+
+  /**
+   * \return true if a file is currently open
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \brief Advance to the next line of the file.
+   *
+   * \return false if the end of the file was reached
+   */
+  bool NextLine (void);
+
+  /**
+   * \brief Extract the next token of the current line.
+   *
+   * \param [out] token the token found (cleared if there is none)
+   * \return false if the current line has no more tokens
+   */
+  bool NextToken (std::string &token);
+
+  /**
+   * \brief Extract the next token of the current line without copying it.
+   *
+   * \param [out] begin pointer to the first character of the token
+   * \param [out] length length of the token
+   * \return false if the current line has no more tokens
+   */
+  bool NextToken (const char **begin, std::size_t *length);
+
+  /**
+   * \return the current line, without its end-of-line characters
+   */
+  std::string GetLine (void) const;
+
+  /**
+   * \return the number (starting from 1) of the current line
+   */
+  uint32_t GetLineNumber (void) const;
+
+  /**
+   * \return the raw contents of the file, for readers of binary formats
+   */
+  const char *GetData (void) const;
+
+  /**
+   * \return the size in bytes of the file contents
+   */
+  std::size_t GetSize (void) const;
+
+private:
+  TopologyTokenizer (const TopologyTokenizer &);
+  TopologyTokenizer& operator= (const TopologyTokenizer &);
+
+  const char *m_data;      //!< Start of the file contents.
+  std::size_t m_size;      //!< Size of the file contents.
+  bool m_mapped;           //!< True if m_data is a memory mapping.
+  std::vector<char> m_buffer; //!< File contents when mmap is not available.
+  const char *m_next;      //!< Start of the next line.
+  const char *m_lineBegin; //!< Start of the current line.
+  const char *m_lineEnd;   //!< End of the current line.
+  const char *m_cursor;    //!< Tokenizer position inside the current line.
+  uint32_t m_lineNumber;   //!< Number of the current line.
+};
+
+} // namespace ns3
+
+#endif /* TOPOLOGY_TOKENIZER_H */
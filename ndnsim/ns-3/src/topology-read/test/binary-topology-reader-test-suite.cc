@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/topology-reader-helper.h"
+#include "ns3/binary-topology-reader.h"
+#include "ns3/simulator.h"
+#include "ns3/core-config.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#ifdef HAVE_SYS_STAT_H
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+using namespace ns3;
+
+class BinaryTopologyReaderTest : public TestCase
+{
+public:
+  BinaryTopologyReaderTest ();
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTopologyReaderTest::BinaryTopologyReaderTest ()
+  : TestCase ("BinaryTopologyReaderTest")
+{
+}
+
+void
+BinaryTopologyReaderTest::DoRun (void)
+{
+  std::string cache = CreateTempDirFilename ("inet-small.bin");
+  std::remove (cache.c_str ());
+  Simulator::Destroy ();
+
+  TopologyReaderHelper helper;
+  helper.SetFileName ("./src/topology-read/examples/Inet_small_toposample.txt");
+  helper.SetFileType ("Inet");
+  helper.SetCacheFileName (cache);
+  NS_TEST_ASSERT_MSG_EQ (helper.IsCached (), false, "no cache yet");
+
+  Ptr<TopologyReader> reader = helper.GetTopologyReader ();
+  NodeContainer nodes = reader->Read ();
+  std::vector<std::string> expected;
+  uint32_t n = 0;
+  for (TopologyReader::LinksIterator i = reader->LinksBegin (); i != reader->LinksEnd (); ++i, ++n)
+    {
+      std::ostringstream address;
+      address << "10.0." << n << ".0";
+      i->SetAttribute ("Network", address.str ());
+      std::ostringstream oss;
+      oss << i->GetFromNode ()->GetId () << " " << i->GetFromNodeName () << " "
+          << i->GetToNode ()->GetId () << " " << i->GetToNodeName () << " "
+          << i->GetAttribute ("Weight") << " " << i->GetAttribute ("Network");
+      expected.push_back (oss.str ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (helper.WriteCache (nodes), true, "cache not written");
+  uint32_t nNodes = nodes.GetN ();
+  Simulator::Destroy ();
+
+  TopologyReaderHelper cached;
+  cached.SetFileName ("./src/topology-read/examples/Inet_small_toposample.txt");
+  cached.SetFileType ("Inet");
+  cached.SetCacheFileName (cache);
+  NS_TEST_ASSERT_MSG_EQ (cached.IsCached (), true, "cache not used");
+  reader = cached.GetTopologyReader ();
+  nodes = reader->Read ();
+  NS_TEST_EXPECT_MSG_EQ (nodes.GetN (), nNodes, "nodes");
+  NS_TEST_ASSERT_MSG_EQ (reader->LinksSize (), static_cast<int> (expected.size ()), "links");
+  n = 0;
+  for (TopologyReader::ConstLinksIterator i = reader->LinksBegin (); i != reader->LinksEnd (); ++i, ++n)
+    {
+      std::ostringstream oss;
+      oss << i->GetFromNode ()->GetId () << " " << i->GetFromNodeName () << " "
+          << i->GetToNode ()->GetId () << " " << i->GetToNodeName () << " "
+          << i->GetAttribute ("Weight") << " " << i->GetAttribute ("Network");
+      NS_TEST_EXPECT_MSG_EQ (oss.str (), expected[n], "link " << n);
+    }
+  NS_TEST_EXPECT_MSG_EQ (cached.WriteCache (nodes), false, "cache rewritten");
+  Simulator::Destroy ();
+  std::remove (cache.c_str ());
+}
+
+#ifdef HAVE_SYS_STAT_H
+/**
+ * Check that a cache is only used in place of the very topology file it
+ * was built from.
+ */
+class BinaryTopologyCacheInvalidationTest : public TestCase
+{
+public:
+  BinaryTopologyCacheInvalidationTest ();
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param fileName a topology file
+   * \param nanoSeconds the nanoseconds of its new modification time
+   */
+  void SetModificationTime (const std::string &fileName, long nanoSeconds);
+  /**
+   * \param fileName a topology file
+   * \param fileType its type
+   * \returns true if its cache would be used
+   */
+  bool IsCached (const std::string &fileName, const std::string &fileType);
+
+  std::string m_cache; //!< the cache file
+};
+
+BinaryTopologyCacheInvalidationTest::BinaryTopologyCacheInvalidationTest ()
+  : TestCase ("BinaryTopologyCacheInvalidationTest")
+{
+}
+
+void
+BinaryTopologyCacheInvalidationTest::SetModificationTime (const std::string &fileName, long nanoSeconds)
+{
+  struct timespec times[2];
+  times[0].tv_sec = 1000000000;
+  times[0].tv_nsec = 0;
+  times[1].tv_sec = 1000000000;
+  times[1].tv_nsec = nanoSeconds;
+  NS_TEST_ASSERT_MSG_EQ (utimensat (AT_FDCWD, fileName.c_str (), times, 0), 0, "can't set the modification time of " << fileName);
+}
+
+bool
+BinaryTopologyCacheInvalidationTest::IsCached (const std::string &fileName, const std::string &fileType)
+{
+  TopologyReaderHelper helper;
+  helper.SetFileName (fileName);
+  helper.SetFileType (fileType);
+  helper.SetCacheFileName (m_cache);
+  return helper.IsCached ();
+}
+
+void
+BinaryTopologyCacheInvalidationTest::DoRun (void)
+{
+  m_cache = CreateTempDirFilename ("topology.bin");
+  std::string topology = CreateTempDirFilename ("topology.txt");
+  std::string copy = CreateTempDirFilename ("copy.txt");
+  {
+    std::ifstream in ("./src/topology-read/examples/Inet_small_toposample.txt");
+    std::ofstream out (topology.c_str ());
+    std::ofstream outCopy (copy.c_str ());
+    std::ostringstream contents;
+    contents << in.rdbuf ();
+    out << contents.str ();
+    outCopy << contents.str ();
+  }
+  SetModificationTime (topology, 0);
+  SetModificationTime (copy, 0);
+
+  TopologyReaderHelper helper;
+  helper.SetFileName (topology);
+  helper.SetFileType ("Inet");
+  helper.SetCacheFileName (m_cache);
+  NodeContainer nodes = helper.GetTopologyReader ()->Read ();
+  NS_TEST_ASSERT_MSG_EQ (helper.WriteCache (nodes), true, "cache not written");
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (IsCached (topology, "Inet"), true, "cache not used");
+  NS_TEST_EXPECT_MSG_EQ (IsCached (topology, "Orbis"), false, "cache used for another file type");
+  NS_TEST_EXPECT_MSG_EQ (IsCached (copy, "Inet"), false, "cache used for another file");
+
+  // modified within the same second, with the same size
+  SetModificationTime (topology, 1);
+  NS_TEST_EXPECT_MSG_EQ (IsCached (topology, "Inet"), false, "cache used after a modification");
+
+  // same modification time, another size
+  {
+    std::ofstream out (topology.c_str (), std::ios::app);
+    out << std::endl;
+  }
+  SetModificationTime (topology, 0);
+  NS_TEST_EXPECT_MSG_EQ (IsCached (topology, "Inet"), false, "cache used after a change of size");
+
+  std::remove (topology.c_str ());
+  NS_TEST_EXPECT_MSG_EQ (IsCached (topology, "Inet"), false, "cache used without the topology file");
+
+  std::remove (copy.c_str ());
+  std::remove (m_cache.c_str ());
+}
+#endif /* HAVE_SYS_STAT_H */
+
+class BinaryTopologyReaderTestSuite : public TestSuite
+{
+public:
+  BinaryTopologyReaderTestSuite ();
+};
+
+BinaryTopologyReaderTestSuite::BinaryTopologyReaderTestSuite ()
+  : TestSuite ("binary-topology-reader", UNIT)
+{
+  AddTestCase (new BinaryTopologyReaderTest (), TestCase::QUICK);
+#ifdef HAVE_SYS_STAT_H
+  AddTestCase (new BinaryTopologyCacheInvalidationTest (), TestCase::QUICK);
+#endif /* HAVE_SYS_STAT_H */
+}
+
+static BinaryTopologyReaderTestSuite binaryTopologyReaderTestSuite;
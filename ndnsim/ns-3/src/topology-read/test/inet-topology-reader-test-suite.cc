@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/inet-topology-reader.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+class InetTopologyReaderTest : public TestCase
+{
+public:
+  InetTopologyReaderTest ();
+private:
+  virtual void DoRun (void);
+};
+
+InetTopologyReaderTest::InetTopologyReaderTest ()
+  : TestCase ("InetTopologyReaderTest")
+{
+}
+
+void
+InetTopologyReaderTest::DoRun (void)
+{
+  Ptr<InetTopologyReader> inFile = Create<InetTopologyReader> ();
+  inFile->SetFileName ("./src/topology-read/examples/Inet_toposample.txt");
+  NodeContainer nodes = inFile->Read ();
+
+  NS_TEST_EXPECT_MSG_EQ (nodes.GetN (), 3037, "nodes");
+  NS_TEST_EXPECT_MSG_EQ (inFile->LinksSize (), 4788, "links");
+  Simulator::Destroy ();
+}
+
+class InetTopologyReaderTestSuite : public TestSuite
+{
+public:
+  InetTopologyReaderTestSuite ();
+};
+
+InetTopologyReaderTestSuite::InetTopologyReaderTestSuite ()
+  : TestSuite ("inet-topology-reader", UNIT)
+{
+  AddTestCase (new InetTopologyReaderTest (), TestCase::QUICK);
+}
+
+static InetTopologyReaderTestSuite inetTopologyReaderTestSuite;
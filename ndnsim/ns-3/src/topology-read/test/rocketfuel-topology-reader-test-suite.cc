@@ -30,6 +30,7 @@
 #include "ns3/object-factory.h"
 #include "ns3/object-factory.h"
 #include "ns3/simulator.h"
+#include <fstream>
 
 using namespace ns3;
 
@@ -72,6 +73,48 @@ RocketfuelTopologyReaderTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+class RocketfuelMapsTopologyReaderTest : public TestCase
+{
+public:
+  RocketfuelMapsTopologyReaderTest ();
+private:
+  virtual void DoRun (void);
+};
+
+RocketfuelMapsTopologyReaderTest::RocketfuelMapsTopologyReaderTest ()
+  : TestCase ("RocketfuelMapsTopologyReaderTest")
+{
+}
+
+
+void
+RocketfuelMapsTopologyReaderTest::DoRun (void)
+{
+  std::string input = CreateTempDirFilename ("rocketfuel-maps.cch");
+  std::ofstream out (input.c_str ());
+  out << "1 @Sydney,+Australia + bb (2) &1 -> <2> <3> =sydney1 r0\n"
+      << "2 @Perth,+Australia (1) -> <1> =perth1 r1\n"
+      << "3 @Melbourne,+Australia +bb (1)  ->  <1> {-5} {-6} =mel1! r0\r\n"
+      << "this line stops the reader\n"
+      << "4 @Hobart,+Australia (1) -> <3> =hob1 r0\n";
+  out.close ();
+
+  Ptr<RocketfuelTopologyReader> inFile = Create<RocketfuelTopologyReader> ();
+  inFile->SetFileName (input);
+  NodeContainer nodes = inFile->Read ();
+
+  NS_TEST_EXPECT_MSG_EQ (nodes.GetN (), 3, "nodes");
+  NS_TEST_EXPECT_MSG_EQ (inFile->LinksSize (), 3, "links");
+  TopologyReader::ConstLinksIterator link = inFile->LinksBegin ();
+  NS_TEST_EXPECT_MSG_EQ (link->GetFromNodeName (), "1", "");
+  NS_TEST_EXPECT_MSG_EQ (link->GetToNodeName (), "2", "");
+  link++;
+  link++;
+  NS_TEST_EXPECT_MSG_EQ (link->GetFromNodeName (), "3", "");
+  NS_TEST_EXPECT_MSG_EQ (link->GetToNodeName (), "1", "");
+  Simulator::Destroy ();
+}
+
 class RocketfuelTopologyReaderTestSuite : public TestSuite
 {
 public:
@@ -83,6 +126,7 @@ RocketfuelTopologyReaderTestSuite::RocketfuelTopologyReaderTestSuite ()
   : TestSuite ("rocketfuel-topology-reader", UNIT)
 {
   AddTestCase (new RocketfuelTopologyReaderTest (), TestCase::QUICK);
+  AddTestCase (new RocketfuelMapsTopologyReaderTest (), TestCase::QUICK);
 }
 
 static RocketfuelTopologyReaderTestSuite rocketfuelTopologyReaderTestSuite;
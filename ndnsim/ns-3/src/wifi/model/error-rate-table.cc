@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+#include "error-rate-table.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ErrorRateTable");
+
+const double ErrorRateTable::MIN_SNR_DB = -20.0;
+const double ErrorRateTable::MAX_SNR_DB = 60.0;
+const double ErrorRateTable::STEP_DB = 0.05;
+
+/**
+ * Largest -log (s) stored in the tables: it is a certain loss of any
+ * chunk of at least one bit.
+ */
+static const double MAX_BIT_LOG_ERROR = 1000.0;
+
+/**
+ * Largest -log (s) interpolated: the models clamp the bit error rate, and
+ * -log (s) grows too fast for a linear interpolation when it nears 1.
+ * Beyond, a chunk of 100 bits is lost at least 99.99% of the time, and
+ * the model itself is used.
+ */
+static const double MAX_INTERPOLATED_BIT_LOG_ERROR = 0.1;
+
+ErrorRateTable::ErrorRateTable (SuccessRateCallback successRate)
+  : m_successRate (successRate),
+    m_size ((uint32_t)((MAX_SNR_DB - MIN_SNR_DB) / STEP_DB + 0.5) + 1),
+    m_maxEntry (std::log (MAX_INTERPOLATED_BIT_LOG_ERROR))
+{
+}
+
+const std::vector<double> &
+ErrorRateTable::GetTable (WifiMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_tables.size ())
+    {
+      m_tables.resize (uid + 1);
+    }
+  std::vector<double> &table = m_tables[uid];
+  if (table.empty ())
+    {
+      NS_LOG_DEBUG ("Building the table of " << mode);
+      table.resize (m_size);
+      for (uint32_t i = 0; i < m_size; i++)
+        {
+          double snr = std::pow (10.0, (MIN_SNR_DB + i * STEP_DB) / 10.0);
+          double bitLogError = -std::log (m_successRate (mode, snr, 1));
+          // log (0) is -infinity: a bit is never lost
+          table[i] = std::log (std::min (bitLogError, MAX_BIT_LOG_ERROR));
+        }
+    }
+  return table;
+}
+
+double
+ErrorRateTable::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  double position = (10.0 * std::log10 (snr) - MIN_SNR_DB) / STEP_DB;
+  if (!(position >= 0.0 && position < m_size - 1))
+    {
+      return m_successRate (mode, snr, nbits);
+    }
+  const std::vector<double> &table = GetTable (mode);
+  uint32_t index = (uint32_t)position;
+  double fraction = position - index;
+  double low = table[index];
+  double high = table[index + 1];
+  if (std::max (low, high) > m_maxEntry)
+    {
+      return m_successRate (mode, snr, nbits);
+    }
+  double bitLogError;
+  if (low == -std::numeric_limits<double>::infinity ()
+      || high == -std::numeric_limits<double>::infinity ())
+    {
+      bitLogError = (1 - fraction) * std::exp (low) + fraction * std::exp (high);
+    }
+  else
+    {
+      bitLogError = std::exp (low + fraction * (high - low));
+    }
+  return std::exp (-bitLogError * nbits);
+}
+
+} //namespace ns3
@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ERROR_RATE_TABLE_H
+#define ERROR_RATE_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include "wifi-mode.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Lookup tables of the chunk success rate of an error rate model
+ *
+ * In all the error rate models, the success rate of a chunk of n bits is
+ * the success rate s of a single bit to the power n.  The table of a
+ * WifiMode holds log (-log (s)) for SNRs from MIN_SNR_DB to MAX_SNR_DB, by
+ * steps of STEP_DB; it is built the first time the mode is looked up, and
+ * the chunk success rate is then linearly interpolated from it.  Outside
+ * of the table, or when a single bit is lost more than 10% of the time,
+ * the error rate model itself is used.
+ */
+class ErrorRateTable
+{
+public:
+  /**
+   * Callback computing the success rate of a chunk from the mode, the
+   * SNR (linear) and the number of bits of the chunk
+   */
+  typedef Callback<double, WifiMode, double, uint32_t> SuccessRateCallback;
+
+  /**
+   * \param successRate the error rate model to tabulate
+   */
+  ErrorRateTable (SuccessRateCallback successRate);
+
+  /**
+   * \param mode the Wi-Fi mode the chunk is sent
+   * \param snr the SNR of the chunk
+   * \param nbits the number of bits in this chunk
+   *
+   * \return the probability of successfully receiving the chunk
+   */
+  double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+  static const double MIN_SNR_DB; ///< SNR (dB) of the first entry of the tables
+  static const double MAX_SNR_DB; ///< SNR (dB) of the last entry of the tables
+  static const double STEP_DB;    ///< SNR (dB) between two entries of the tables
+
+private:
+  /**
+   * \param mode the Wi-Fi mode
+   * \return the table of the mode, built if needed
+   */
+  const std::vector<double> & GetTable (WifiMode mode) const;
+
+  SuccessRateCallback m_successRate;                 //!< the tabulated model
+  uint32_t m_size;                                   //!< number of entries of a table
+  double m_maxEntry;                                 //!< largest table entry interpolated
+  mutable std::vector<std::vector<double> > m_tables; //!< the tables, indexed by mode UID
+};
+
+} //namespace ns3
+
+#endif /* ERROR_RATE_TABLE_H */
@@ -191,10 +191,16 @@ Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
+  if (!m_rxing)
+    {
+      // the changes at the current time are kept, the loop below stops at
+      // the first of them which takes the energy under the threshold
+      RetireNiChanges (now, false);
+    }
   double noiseInterferenceW = 0.0;
   Time end = now;
   noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  for (NiChangeRing::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
     {
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
@@ -216,13 +222,9 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
   Time now = Simulator::Now ();
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
-        {
-          m_firstPower += i->GetDelta ();
-        }
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      RetireNiChanges (now, true);
+      // the remaining changes are all in the future
+      m_niChanges.push_front (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
     }
   else
     {
@@ -253,7 +255,7 @@ InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event>
 {
   double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  for (NiChangeRing::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
     {
       if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
         {
@@ -583,12 +585,29 @@ InterferenceHelper::EraseEvents (void)
   m_firstPower = 0.0;
 }
 
-InterferenceHelper::NiChanges::iterator
+InterferenceHelper::NiChangeRing::iterator
 InterferenceHelper::GetPosition (Time moment)
 {
   return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
 }
 
+void
+InterferenceHelper::RetireNiChanges (Time moment, bool included)
+{
+  while (!m_niChanges.empty ()
+         && (m_niChanges.front ().GetTime () < moment
+             || (included && m_niChanges.front ().GetTime () == moment)))
+    {
+      m_firstPower += m_niChanges.front ().GetDelta ();
+      m_niChanges.pop_front ();
+    }
+  if (m_niChanges.empty ())
+    {
+      // no signal is ongoing: drop the rounding errors of the sum
+      m_firstPower = 0.0;
+    }
+}
+
 void
 InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <deque>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -259,6 +260,10 @@ private:
    * typedef for a vector of NiChanges
    */
   typedef std::vector <NiChange> NiChanges;
+  /**
+   * typedef for the ring of pending NiChanges, sorted by time
+   */
+  typedef std::deque <NiChange> NiChangeRing;
   /**
    * typedef for a list of Events
    */
@@ -324,18 +329,30 @@ private:
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
-  /// Experimental: needed for energy duration calculation
-  NiChanges m_niChanges;
-  double m_firstPower;
+  /**
+   * The NI changes not retired yet, sorted by time. When no packet is
+   * being received, the changes which are not in the future are retired
+   * and their power accumulated in m_firstPower, so that the ring only
+   * holds the changes of the ongoing signals.
+   */
+  NiChangeRing m_niChanges;
+  double m_firstPower; ///< noise and interference power (W) of the retired changes
   bool m_rxing;
   /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
+  NiChangeRing::iterator GetPosition (Time moment);
   /**
-   * Add NiChange to the list at the appropriate position.
+   * Add NiChange to the ring at the appropriate position.
    *
    * \param change
    */
   void AddNiChangeEvent (NiChange change);
+  /**
+   * Retire the NiChanges up to the given moment into m_firstPower.
+   *
+   * \param moment
+   * \param included whether the changes at the moment itself are retired
+   */
+  void RetireNiChanges (Time moment, bool included);
 };
 
 } //namespace ns3
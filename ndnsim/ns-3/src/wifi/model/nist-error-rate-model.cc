@@ -23,6 +23,7 @@
 #include "nist-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
 
 namespace ns3 {
 
@@ -37,14 +38,29 @@ NistErrorRateModel::GetTypeId (void)
     .SetParent<ErrorRateModel> ()
     .SetGroupName ("Wifi")
     .AddConstructor<NistErrorRateModel> ()
+    .AddAttribute ("UseLookupTable",
+                   "Interpolate the chunk success rates from lookup tables "
+                   "built from the model, instead of computing them.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NistErrorRateModel::m_useLookupTable),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 NistErrorRateModel::NistErrorRateModel ()
+  : m_useLookupTable (false)
 {
 }
 
+const ErrorRateTable &
+NistErrorRateModel::GetLookupTable (void)
+{
+  static Ptr<NistErrorRateModel> model = CreateObject<NistErrorRateModel> ();
+  static ErrorRateTable table (MakeCallback (&NistErrorRateModel::CalculateChunkSuccessRate, model));
+  return table;
+}
+
 double
 NistErrorRateModel::GetBpskBer (double snr) const
 {
@@ -214,6 +230,16 @@ NistErrorRateModel::GetFec64QamBer (double snr, uint32_t nbits,
 
 double
 NistErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (m_useLookupTable)
+    {
+      return GetLookupTable ().GetChunkSuccessRate (mode, snr, nbits);
+    }
+  return CalculateChunkSuccessRate (mode, snr, nbits);
+}
+
+double
+NistErrorRateModel::CalculateChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
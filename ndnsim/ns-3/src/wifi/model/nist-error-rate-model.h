@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include "wifi-mode.h"
 #include "error-rate-model.h"
+#include "error-rate-table.h"
 #include "dsss-error-rate-model.h"
 
 namespace ns3 {
@@ -45,6 +46,16 @@ public:
 
   virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
 
+  /**
+   * Compute the chunk success rate with the model, without the lookup tables.
+   *
+   * \param mode the Wi-Fi mode the chunk is sent
+   * \param snr the SNR of the chunk
+   * \param nbits the number of bits in this chunk
+   *
+   * \return probability of successfully receiving the chunk
+   */
+  double CalculateChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
 
 private:
   /**
@@ -132,6 +143,16 @@ private:
    */
   double GetFec64QamBer (double snr, uint32_t nbits,
                          uint32_t bValue) const;
+
+  /**
+   * The lookup tables only depend on the equations of the model, so
+   * they are built once and shared by all the instances.
+   *
+   * \return the lookup tables of the model
+   */
+  static const ErrorRateTable & GetLookupTable (void);
+
+  bool m_useLookupTable; //!< interpolate the chunk success rates from the lookup tables
 };
 
 } //namespace ns3
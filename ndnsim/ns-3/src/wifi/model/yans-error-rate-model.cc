@@ -23,6 +23,7 @@
 #include "yans-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
 
 namespace ns3 {
 
@@ -37,14 +38,29 @@ YansErrorRateModel::GetTypeId (void)
     .SetParent<ErrorRateModel> ()
     .SetGroupName ("Wifi")
     .AddConstructor<YansErrorRateModel> ()
+    .AddAttribute ("UseLookupTable",
+                   "Interpolate the chunk success rates from lookup tables "
+                   "built from the model, instead of computing them.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansErrorRateModel::m_useLookupTable),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansErrorRateModel::YansErrorRateModel ()
+  : m_useLookupTable (false)
 {
 }
 
+const ErrorRateTable &
+YansErrorRateModel::GetLookupTable (void)
+{
+  static Ptr<YansErrorRateModel> model = CreateObject<YansErrorRateModel> ();
+  static ErrorRateTable table (MakeCallback (&YansErrorRateModel::CalculateChunkSuccessRate, model));
+  return table;
+}
+
 double
 YansErrorRateModel::Log2 (double val) const
 {
@@ -181,6 +197,16 @@ YansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
 
 double
 YansErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (m_useLookupTable)
+    {
+      return GetLookupTable ().GetChunkSuccessRate (mode, snr, nbits);
+    }
+  return CalculateChunkSuccessRate (mode, snr, nbits);
+}
+
+double
+YansErrorRateModel::CalculateChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
@@ -25,6 +25,7 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "ns3/propagation-loss-model.h"
@@ -51,17 +52,26 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "The distance (m) beyond which transmissions are not delivered, "
+                   "or 0 to deliver them to every PHY.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0.0),
+    m_indexValid (false)
 {
 }
 
 YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  ClearIndex ();
   m_phyList.clear ();
 }
 
@@ -83,46 +93,115 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+
+  struct Parameters parameters;
+  parameters.aMpdu = aMpdu;
+  parameters.duration = duration;
+  parameters.txVector = txVector;
+  parameters.preamble = preamble;
+
+  // the receivers are collected first, to compute all the received powers
+  // in a single pass over the loss models
+  m_receivers.clear ();
+  m_rxMobility.clear ();
+  if (m_maxRange > 0)
     {
-      if (sender != (*i))
+      if (!m_indexValid || m_index.GetCellSize () != m_maxRange)
+        {
+          BuildIndex ();
+        }
+      // in the order of the PHY list, as without MaxRange
+      std::vector<uint32_t> nearby = m_index.GetNearby (senderMobility->GetPosition ());
+      for (std::vector<uint32_t>::const_iterator i = nearby.begin (); i != nearby.end (); i++)
         {
-          //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          Ptr<YansWifiPhy> phy = m_phyList[*i];
+          if (sender == phy || phy->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
-
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
+          Ptr<MobilityModel> receiverMobility = phy->GetMobility ()->GetObject<MobilityModel> ();
+          if (senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
             {
-              dstNode = 0xffffffff;
+              continue;
             }
-          else
+          m_receivers.push_back (*i);
+          m_rxMobility.push_back (receiverMobility);
+        }
+    }
+  else
+    {
+      uint32_t j = 0;
+      for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+        {
+          if (sender != (*i))
             {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+              //For now don't account for inter channel interference
+              if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+                {
+                  continue;
+                }
+              m_receivers.push_back (j);
+              m_rxMobility.push_back ((*i)->GetMobility ()->GetObject<MobilityModel> ());
             }
+        }
+    }
 
-          struct Parameters parameters;
-          parameters.rxPowerDbm = rxPowerDbm;
-          parameters.aMpdu = aMpdu;
-          parameters.duration = duration;
-          parameters.txVector = txVector;
-          parameters.preamble = preamble;
+  m_loss->CalcRxPowers (txPowerDbm, senderMobility, m_rxMobility, m_rxPowerDbm);
+  for (uint32_t k = 0; k < m_receivers.size (); k++)
+    {
+      Deliver (m_receivers[k], senderMobility, m_rxMobility[k], packet, txPowerDbm, m_rxPowerDbm[k], parameters);
+    }
+  // do not keep the mobility models alive until the next transmission
+  m_rxMobility.clear ();
+}
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, parameters);
-        }
+void
+YansWifiChannel::Deliver (uint32_t j, Ptr<MobilityModel> senderMobility, Ptr<MobilityModel> receiverMobility,
+                          Ptr<const Packet> packet, double txPowerDbm, double rxPowerDbm,
+                          struct Parameters parameters) const
+{
+  Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+  Ptr<Packet> copy = packet->Copy ();
+  Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
     }
+
+  parameters.rxPowerDbm = rxPowerDbm;
+
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive, this,
+                                  j, copy, parameters);
+}
+
+void
+YansWifiChannel::BuildIndex (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_index.Clear (m_maxRange);
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      m_index.Add (i, mobility);
+    }
+  m_indexValid = true;
+}
+
+void
+YansWifiChannel::ClearIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_index.Clear (0.0);
+  m_indexValid = false;
 }
 
 void
@@ -147,6 +226,11 @@ void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   m_phyList.push_back (phy);
+  // The PHY may not have a mobility model yet, the index is rebuilt on the next Send
+  if (m_indexValid)
+    {
+      ClearIndex ();
+    }
 }
 
 int64_t
@@ -30,10 +30,12 @@
 #include "wifi-tx-vector.h"
 #include "yans-wifi-phy.h"
 #include "ns3/nstime.h"
+#include "ns3/mobility-grid-index.h"
 
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 
@@ -57,6 +59,16 @@ struct Parameters
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * By default, every transmission is delivered to every other PHY on the
+ * same channel number, whatever its received power.  If the MaxRange
+ * attribute is set, the PHYs farther than MaxRange from the sender are
+ * skipped: the positions of the PHYs are kept in a uniform grid of cubic
+ * cells of MaxRange side, updated when their mobility models report a
+ * course change, and a transmission is only delivered to the PHYs in the
+ * cells next to the sender and to the PHYs that are moving.  MaxRange
+ * should be set to a distance at which the received power is well below
+ * the energy detection threshold of the PHYs.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -122,6 +134,30 @@ private:
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
 
+  /**
+   * Put all the PHYs in the spatial index.  It is built on the first Send,
+   * since the PHYs may not have a mobility model yet when they are added.
+   */
+  void BuildIndex (void) const;
+  /**
+   * Empty the spatial index.
+   */
+  void ClearIndex (void);
+  /**
+   * Schedule the reception of a transmission by a PHY.
+   *
+   * \param j index of the receiving PHY in the PHY list
+   * \param senderMobility the mobility model of the sender
+   * \param receiverMobility the mobility model of the receiver
+   * \param packet the packet being sent
+   * \param txPowerDbm the tx power associated to the packet
+   * \param rxPowerDbm the power received by the PHY
+   * \param parameters the parameters of the transmission; the received power is filled in
+   */
+  void Deliver (uint32_t j, Ptr<MobilityModel> senderMobility, Ptr<MobilityModel> receiverMobility,
+                Ptr<const Packet> packet, double txPowerDbm, double rxPowerDbm,
+                struct Parameters parameters) const;
+
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
    * The method then calls the corresponding YansWifiPhy that the first
@@ -138,6 +174,14 @@ private:
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< Distance beyond which PHYs are skipped, 0 to deliver to all
+
+  mutable bool m_indexValid;         //!< True if the spatial index holds every PHY
+  mutable MobilityGridIndex m_index; //!< Spatial index of the PHYs, by index in the PHY list
+
+  mutable std::vector<uint32_t> m_receivers;             //!< Indexes of the receivers of the current transmission
+  mutable std::vector<Ptr<MobilityModel> > m_rxMobility; //!< Mobility models of the receivers of the current transmission
+  mutable std::vector<double> m_rxPowerDbm;              //!< Received powers of the current transmission
 };
 
 } //namespace ns3
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/error-rate-model.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ErrorRateTableTest");
+
+/**
+ * Compare the chunk success rates interpolated from the lookup tables of
+ * an error rate model with the ones computed by the model, for
+ * DSSS, OFDM and HT modes, SNRs which fall between the table entries and
+ * chunks from one bit to a long frame.
+ */
+class ErrorRateTableAccuracyTest : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test case
+   * \param model the error rate model to test
+   */
+  ErrorRateTableAccuracyTest (std::string name, Ptr<ErrorRateModel> model);
+
+private:
+  virtual void DoRun (void);
+
+  Ptr<ErrorRateModel> m_model;
+};
+
+ErrorRateTableAccuracyTest::ErrorRateTableAccuracyTest (std::string name, Ptr<ErrorRateModel> model)
+  : TestCase ("Check the lookup tables of the " + name),
+    m_model (model)
+{
+}
+
+void
+ErrorRateTableAccuracyTest::DoRun (void)
+{
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetDsssRate1Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate2Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate5_5Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate11Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate9Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate12Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate18Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate24Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate36Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate48Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate6_5MbpsBW20MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate58_5MbpsBW20MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate65MbpsBW20MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate150MbpsBW40MHz ());
+
+  std::vector<uint32_t> sizes;
+  sizes.push_back (1);
+  sizes.push_back (100);
+  sizes.push_back (1500 * 8);
+  sizes.push_back (65535 * 8);
+
+  double maxError = 0;
+  for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); ++mode)
+    {
+      for (double snrDb = -25; snrDb < 65; snrDb += 0.137)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          for (std::vector<uint32_t>::const_iterator nbits = sizes.begin (); nbits != sizes.end (); ++nbits)
+            {
+              m_model->SetAttribute ("UseLookupTable", BooleanValue (false));
+              double expected = m_model->GetChunkSuccessRate (*mode, snr, *nbits);
+              m_model->SetAttribute ("UseLookupTable", BooleanValue (true));
+              double actual = m_model->GetChunkSuccessRate (*mode, snr, *nbits);
+              maxError = std::max (maxError, std::fabs (actual - expected));
+              NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, 5e-4, "Wrong success rate for " << *mode
+                                         << " at " << snrDb << " dB with " << *nbits << " bits");
+            }
+        }
+    }
+  NS_LOG_INFO ("largest error " << maxError);
+}
+
+/**
+ * \ingroup wifi-test
+ * The test suite of the lookup tables of the error rate models
+ */
+class ErrorRateTableTestSuite : public TestSuite
+{
+public:
+  ErrorRateTableTestSuite ();
+};
+
+ErrorRateTableTestSuite::ErrorRateTableTestSuite ()
+  : TestSuite ("wifi-error-rate-table", UNIT)
+{
+  AddTestCase (new ErrorRateTableAccuracyTest ("NistErrorRateModel", CreateObject<NistErrorRateModel> ()), TestCase::QUICK);
+  AddTestCase (new ErrorRateTableAccuracyTest ("YansErrorRateModel", CreateObject<YansErrorRateModel> ()), TestCase::QUICK);
+}
+
+static ErrorRateTableTestSuite g_errorRateTableTestSuite;
@@ -33,13 +33,21 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/interference-helper.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/test.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
 #include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/constant-rate-wifi-manager.h"
+
+#include <cstdlib>
+#include <sstream>
 
 using namespace ns3;
 
@@ -622,6 +630,297 @@ Bug730TestCase::DoRun (void)
 }
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the InterferenceHelper accounts for the signals which
+ * ended before a reception and for the ongoing ones, and that nothing is
+ * left of the signals once they all ended.
+ *
+ * Signal A (1 nW) is received from 0 to 100 us, while B (0.3 nW, 10 to
+ * 60 us) and C (0.07 nW, 20 to 220 us) interfere.  Signal D, received
+ * from 300 to 350 us, must see no interference at all.
+ */
+class InterferenceHelperRetirementTest : public TestCase
+{
+public:
+  InterferenceHelperRetirementTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  Ptr<InterferenceHelper::Event> StartRx (Time duration, double rxPowerW);
+  void AddInterference (Time duration, double rxPowerW);
+  void EndRxA (void);
+  void StartRxD (void);
+  void EndRxD (void);
+  double GetSnrWithoutInterference (double rxPowerW) const;
+
+  InterferenceHelper m_interference;
+  WifiTxVector m_txVector;
+  Ptr<InterferenceHelper::Event> m_a;
+  Ptr<InterferenceHelper::Event> m_d;
+};
+
+InterferenceHelperRetirementTest::InterferenceHelperRetirementTest ()
+  : TestCase ("InterferenceHelperRetirement")
+{
+}
+
+Ptr<InterferenceHelper::Event>
+InterferenceHelperRetirementTest::StartRx (Time duration, double rxPowerW)
+{
+  Ptr<InterferenceHelper::Event> event = m_interference.Add (1000, m_txVector, WIFI_PREAMBLE_LONG, duration, rxPowerW);
+  m_interference.NotifyRxStart ();
+  return event;
+}
+
+void
+InterferenceHelperRetirementTest::AddInterference (Time duration, double rxPowerW)
+{
+  m_interference.Add (1000, m_txVector, WIFI_PREAMBLE_LONG, duration, rxPowerW);
+}
+
+double
+InterferenceHelperRetirementTest::GetSnrWithoutInterference (double rxPowerW) const
+{
+  return rxPowerW / (1.3803e-23 * 290.0 * m_txVector.GetMode ().GetBandwidth ());
+}
+
+void
+InterferenceHelperRetirementTest::EndRxA (void)
+{
+  struct InterferenceHelper::SnrPer snrPer = m_interference.CalculatePlcpPayloadSnrPer (m_a);
+  m_interference.NotifyRxEnd ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (snrPer.snr, GetSnrWithoutInterference (1e-9), 1e-6, "A starts without interference");
+  NS_TEST_EXPECT_MSG_GT (snrPer.per, 0, "B and C interfere with A");
+
+  // only C is still ongoing
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (0.7e-10 / 2), MicroSeconds (120), "C ends at 220 us");
+}
+
+void
+InterferenceHelperRetirementTest::StartRxD (void)
+{
+  m_d = StartRx (MicroSeconds (50), 1e-9);
+}
+
+void
+InterferenceHelperRetirementTest::EndRxD (void)
+{
+  struct InterferenceHelper::SnrPer snrPer = m_interference.CalculatePlcpPayloadSnrPer (m_d);
+  m_interference.NotifyRxEnd ();
+  NS_TEST_EXPECT_MSG_EQ (snrPer.snr, GetSnrWithoutInterference (1e-9), "D is received without interference");
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (1e-20), MicroSeconds (0), "no signal is ongoing");
+}
+
+void
+InterferenceHelperRetirementTest::DoRun (void)
+{
+  m_interference.SetNoiseFigure (1);
+  m_interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  m_txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+
+  m_a = StartRx (MicroSeconds (100), 1e-9);
+  Simulator::Schedule (MicroSeconds (10), &InterferenceHelperRetirementTest::AddInterference, this, MicroSeconds (50), 0.3e-9);
+  Simulator::Schedule (MicroSeconds (20), &InterferenceHelperRetirementTest::AddInterference, this, MicroSeconds (200), 0.7e-10);
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperRetirementTest::EndRxA, this);
+  Simulator::Schedule (MicroSeconds (300), &InterferenceHelperRetirementTest::StartRxD, this);
+  Simulator::Schedule (MicroSeconds (350), &InterferenceHelperRetirementTest::EndRxD, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the InterferenceHelper takes into account the NI changes
+ * happening exactly at the current time when it computes the CCA duration.
+ *
+ * Signal A (1 nW, 0 to 100 us) and signal B (0.1 nW, 10 to 200 us) are
+ * not received.  At 100 us, when A ends, only B is left, hence the energy
+ * is already under a threshold of 0.5 nW.
+ */
+class InterferenceHelperCcaTest : public TestCase
+{
+public:
+  InterferenceHelperCcaTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void AddSignal (Time duration, double rxPowerW);
+  void CheckEnergyDuration (double energyW, Time expected);
+
+  InterferenceHelper m_interference;
+  WifiTxVector m_txVector;
+};
+
+InterferenceHelperCcaTest::InterferenceHelperCcaTest ()
+  : TestCase ("InterferenceHelperCca")
+{
+}
+
+void
+InterferenceHelperCcaTest::AddSignal (Time duration, double rxPowerW)
+{
+  m_interference.Add (1000, m_txVector, WIFI_PREAMBLE_LONG, duration, rxPowerW);
+}
+
+void
+InterferenceHelperCcaTest::CheckEnergyDuration (double energyW, Time expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (energyW), expected,
+                         "Wrong energy duration at " << Simulator::Now ().GetMicroSeconds () << " us for " << energyW << " W");
+}
+
+void
+InterferenceHelperCcaTest::DoRun (void)
+{
+  m_interference.SetNoiseFigure (1);
+  m_interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  m_txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+
+  AddSignal (MicroSeconds (100), 1e-9);
+  Simulator::Schedule (MicroSeconds (10), &InterferenceHelperCcaTest::AddSignal, this, MicroSeconds (190), 0.1e-9);
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperCcaTest::CheckEnergyDuration, this, 0.5e-9, MicroSeconds (50));
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperCcaTest::CheckEnergyDuration, this, 0.5e-9, MicroSeconds (0));
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperCcaTest::CheckEnergyDuration, this, 0.05e-9, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (200), &InterferenceHelperCcaTest::CheckEnergyDuration, this, 0.05e-9, MicroSeconds (0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the MaxRange attribute of the YansWifiChannel skips the
+ * receivers that are too far from the sender, and only them, as they move.
+ *
+ * A sender at the origin broadcasts a packet at 1 s and at 5 s, with a
+ * fixed received power.  One receiver stays 50 m away; one is 350 m away and
+ * is moved 60 m away at 3 s; one moves at 200 m/s toward the sender and is
+ * 840 m away at 1 s and 40 m away at 5 s.
+ */
+class YansWifiChannelMaxRangeTest : public TestCase
+{
+public:
+  YansWifiChannelMaxRangeTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void RunOne (double maxRange);
+  Ptr<WifiNetDevice> CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel, uint32_t index);
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  void NotifyPhyRxBegin (std::string context, Ptr<const Packet> p);
+
+  uint32_t m_received[4];
+};
+
+YansWifiChannelMaxRangeTest::YansWifiChannelMaxRangeTest ()
+  : TestCase ("Test the MaxRange attribute of the YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelMaxRangeTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelMaxRangeTest::NotifyPhyRxBegin (std::string context, Ptr<const Packet> p)
+{
+  m_received[std::atoi (context.c_str ())]++;
+}
+
+Ptr<WifiNetDevice>
+YansWifiChannelMaxRangeTest::CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel, uint32_t index)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  ObjectFactory mac;
+  mac.SetTypeId ("ns3::AdhocWifiMac");
+  Ptr<WifiMac> wifiMac = mac.Create<WifiMac> ();
+  wifiMac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  std::ostringstream context;
+  context << index;
+  phy->TraceConnect ("PhyRxBegin", context.str (), MakeCallback (&YansWifiChannelMaxRangeTest::NotifyPhyRxBegin, this));
+
+  node->AggregateObject (mobility);
+  wifiMac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (wifiMac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (CreateObject<ConstantRateWifiManager> ());
+  node->AddDevice (dev);
+  return dev;
+}
+
+void
+YansWifiChannelMaxRangeTest::RunOne (double maxRange)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<FixedRssLossModel> propLoss = CreateObject<FixedRssLossModel> ();
+  propLoss->SetRss (-50.0);
+  channel->SetPropagationLossModel (propLoss);
+
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_received[i] = 0;
+    }
+
+  Ptr<ConstantPositionMobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  txMobility->SetPosition (Vector (0.0, 0.0, 0.0));
+  Ptr<WifiNetDevice> txDev = CreateOne (txMobility, channel, 0);
+
+  Ptr<ConstantPositionMobilityModel> nearMobility = CreateObject<ConstantPositionMobilityModel> ();
+  nearMobility->SetPosition (Vector (50.0, 0.0, 0.0));
+  CreateOne (nearMobility, channel, 1);
+
+  Ptr<ConstantPositionMobilityModel> farMobility = CreateObject<ConstantPositionMobilityModel> ();
+  farMobility->SetPosition (Vector (0.0, 350.0, 0.0));
+  CreateOne (farMobility, channel, 2);
+  Simulator::Schedule (Seconds (3.0), &ConstantPositionMobilityModel::SetPosition, farMobility, Vector (0.0, 60.0, 0.0));
+
+  Ptr<ConstantVelocityMobilityModel> movingMobility = CreateObject<ConstantVelocityMobilityModel> ();
+  movingMobility->SetPosition (Vector (1040.0, 0.0, 0.0));
+  movingMobility->SetVelocity (Vector (-200.0, 0.0, 0.0));
+  CreateOne (movingMobility, channel, 3);
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelMaxRangeTest::SendOnePacket, this, txDev);
+  Simulator::Schedule (Seconds (5.0), &YansWifiChannelMaxRangeTest::SendOnePacket, this, txDev);
+
+  Simulator::Stop (Seconds (6.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+YansWifiChannelMaxRangeTest::DoRun (void)
+{
+  RunOne (0.0);
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], 2, "Packets not delivered to the near receiver");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 2, "Packets not delivered to the far receiver without MaxRange");
+  NS_TEST_EXPECT_MSG_EQ (m_received[3], 2, "Packets not delivered to the moving receiver without MaxRange");
+
+  RunOne (100.0);
+  NS_TEST_EXPECT_MSG_EQ (m_received[0], 0, "Packet delivered to the sender");
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], 2, "Packets not delivered to the near receiver");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 1, "Packets not delivered to the moved receiver once in range only");
+  NS_TEST_EXPECT_MSG_EQ (m_received[3], 1, "Packets not delivered to the moving receiver once in range only");
+}
+
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -637,6 +936,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); //Bug 555
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
+  AddTestCase (new YansWifiChannelMaxRangeTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperRetirementTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperCcaTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
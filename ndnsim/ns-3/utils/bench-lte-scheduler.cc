@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the time an LTE FF MAC scheduler takes to schedule a downlink
+ * TTI. The scheduler is driven directly through its SAPs, without the
+ * rest of the eNB: every UE has a single logical channel which is never
+ * empty, reports a wideband and subband CQI every few TTIs, and
+ * acknowledges every transmission one TTI later.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ff-mac-scheduler.h"
+#include "ns3/ff-mac-csched-sap.h"
+#include "ns3/ff-mac-sched-sap.h"
+#include "ns3/lte-fr-no-op-algorithm.h"
+#include "ns3/lte-common.h"
+
+using namespace ns3;
+
+
+/**
+ * The SAP user side of the scheduler: the configurations are ignored and
+ * the DL allocations are kept to acknowledge them.
+ */
+class BenchMac : public FfMacCschedSapUser, public FfMacSchedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params) {}
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params) {}
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params) {}
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params) {}
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params) {}
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params) {}
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params) {}
+
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    for (std::vector<BuildDataListElement_s>::const_iterator it = params.m_buildDataList.begin ();
+         it != params.m_buildDataList.end (); ++it)
+      {
+        DlInfoListElement_s info;
+        info.m_rnti = it->m_rnti;
+        info.m_harqProcessId = it->m_dci.m_harqProcess;
+        info.m_harqStatus.resize (it->m_dci.m_ndi.size (), DlInfoListElement_s::ACK);
+        m_acks.push_back (info);
+        m_bytes += it->m_dci.m_tbsSize.at (0);
+      }
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params) {}
+
+  /// acknowledgements of the last DL allocations
+  std::vector<DlInfoListElement_s> m_acks;
+  /// bytes allocated on the first layer
+  uint64_t m_bytes;
+};
+
+
+/**
+ * \param bandwidth the DL bandwidth in RBs
+ * \return the size of an RBG, as per table 7.1.6.1-1 of 36.213
+ */
+static uint32_t
+GetRbgSize (uint32_t bandwidth)
+{
+  if (bandwidth <= 10)
+    {
+      return 1;
+    }
+  if (bandwidth <= 26)
+    {
+      return 2;
+    }
+  if (bandwidth <= 63)
+    {
+      return 3;
+    }
+  return 4;
+}
+
+
+int main (int argc, char *argv[])
+{
+  std::string scheduler = "ns3::PfFfMacScheduler";
+  uint32_t nUes = 500;
+  uint32_t ttis = 1000;
+  uint32_t cqiPeriod = 5;
+  uint32_t bandwidth = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("scheduler", "the TypeId of the scheduler", scheduler);
+  cmd.AddValue ("ues", "number of UEs in the cell (default 500)", nUes);
+  cmd.AddValue ("ttis", "number of TTIs scheduled (default 1000)", ttis);
+  cmd.AddValue ("cqiPeriod", "TTIs between two CQI reports of a UE (default 5)", cqiPeriod);
+  cmd.AddValue ("bandwidth", "bandwidth of the cell in RBs (default 100)", bandwidth);
+  cmd.Parse (argc, argv);
+
+  ObjectFactory factory;
+  factory.SetTypeId (scheduler);
+  Ptr<FfMacScheduler> sched = factory.Create<FfMacScheduler> ();
+  Ptr<LteFfrAlgorithm> ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  ffr->SetDlBandwidth (bandwidth);
+  ffr->SetUlBandwidth (bandwidth);
+  sched->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  ffr->SetLteFfrSapUser (sched->GetLteFfrSapUser ());
+
+  BenchMac mac;
+  mac.m_bytes = 0;
+  sched->SetFfMacCschedSapUser (&mac);
+  sched->SetFfMacSchedSapUser (&mac);
+  FfMacCschedSapProvider *csched = sched->GetFfMacCschedSapProvider ();
+  FfMacSchedSapProvider *schedSap = sched->GetFfMacSchedSapProvider ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cellConfig;
+  cellConfig.m_dlBandwidth = bandwidth;
+  cellConfig.m_ulBandwidth = bandwidth;
+  csched->CschedCellConfigReq (cellConfig);
+
+  for (uint16_t rnti = 1; rnti <= nUes; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+      ueConfig.m_rnti = rnti;
+      ueConfig.m_transmissionMode = 0;
+      ueConfig.m_reconfigureFlag = false;
+      csched->CschedUeConfigReq (ueConfig);
+
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+      lcConfig.m_rnti = rnti;
+      lcConfig.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 3;
+      lc.m_logicalChannelGroup = 0;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      lc.m_eRabMaximulBitrateUl = 0;
+      lc.m_eRabMaximulBitrateDl = 0;
+      lc.m_eRabGuaranteedBitrateUl = 0;
+      lc.m_eRabGuaranteedBitrateDl = 0;
+      lcConfig.m_logicalChannelConfigList.push_back (lc);
+      csched->CschedLcConfigReq (lcConfig);
+
+      FfMacSchedSapProvider::SchedDlRlcBufferReqParameters buffer;
+      buffer.m_rnti = rnti;
+      buffer.m_logicalChannelIdentity = 3;
+      buffer.m_rlcTransmissionQueueSize = 2000000000;
+      buffer.m_rlcTransmissionQueueHolDelay = 0;
+      buffer.m_rlcRetransmissionQueueSize = 0;
+      buffer.m_rlcRetransmissionHolDelay = 0;
+      buffer.m_rlcStatusPduSize = 0;
+      schedSap->SchedDlRlcBufferReq (buffer);
+    }
+
+  Ptr<UniformRandomVariable> cqi = CreateObject<UniformRandomVariable> ();
+  cqi->SetAttribute ("Min", DoubleValue (1));
+  cqi->SetAttribute ("Max", DoubleValue (15));
+  uint32_t rbgNum = bandwidth / GetRbgSize (bandwidth);
+
+  SystemWallClockMs clock;
+  int64_t elapsed = 0;
+  for (uint32_t tti = 0; tti < ttis; tti++)
+    {
+      uint16_t sfnSf = (((tti / 10) % 1024) << 4) | (tti % 10);
+
+      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiInfo;
+      cqiInfo.m_sfnSf = sfnSf;
+      for (uint16_t rnti = 1 + tti % cqiPeriod; rnti <= nUes; rnti += cqiPeriod)
+        {
+          CqiListElement_s report;
+          report.m_rnti = rnti;
+          report.m_ri = 1;
+          report.m_cqiType = CqiListElement_s::A30;
+          report.m_wbCqi.push_back (cqi->GetInteger ());
+          report.m_wbPmi = 0;
+          for (uint32_t i = 0; i < rbgNum; i++)
+            {
+              HigherLayerSelected_s subband;
+              subband.m_sbPmi = 0;
+              subband.m_sbCqi.push_back (cqi->GetInteger ());
+              report.m_sbMeasResult.m_higherLayerSelected.push_back (subband);
+            }
+          cqiInfo.m_cqiList.push_back (report);
+        }
+
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters trigger;
+      trigger.m_sfnSf = sfnSf;
+      trigger.m_dlInfoList.swap (mac.m_acks);
+
+      clock.Start ();
+      schedSap->SchedDlCqiInfoReq (cqiInfo);
+      schedSap->SchedDlTriggerReq (trigger);
+      elapsed += clock.End ();
+    }
+
+  std::cout << scheduler << " " << nUes << " UEs " << bandwidth << " RBs: "
+            << (double) elapsed * 1000 / ttis << " us per TTI, "
+            << mac.m_bytes / ttis << " bytes per TTI" << std::endl;
+
+  sched->Dispose ();
+  ffr->Dispose ();
+  return 0;
+}
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Benchmark the topology readers and the bulk point-to-point link
+// installation on a synthetic Orbis graph.
+//
+// ./waf --run "bench-topology-read --edges=1000000 --install=1"
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/orbis-topology-reader.h"
+#include "ns3/point-to-point-helper.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+static void
+WriteOrbisGraph (std::string fileName, uint32_t nodes, uint32_t edges, uint32_t seed)
+{
+  std::ofstream out (fileName.c_str ());
+  // a ring keeps the graph connected, the remaining edges are random chords
+  // (drawn with a simple LCG so that the file does not depend on the
+  // ns-3 random number streams)
+  uint64_t state = seed;
+  for (uint32_t i = 0; i < edges; i++)
+    {
+      uint32_t from = i % nodes;
+      uint32_t to;
+      if (i < nodes)
+        {
+          to = (i + 1) % nodes;
+        }
+      else
+        {
+          state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+          to = (state >> 33) % nodes;
+        }
+      out << from << " " << to << "\n";
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t edges = 1000000;
+  uint32_t nodes = 0;
+  uint32_t seed = 1;
+  bool install = false;
+  bool bulk = true;
+  std::string fileName = "bench-topology-read.orb";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark topology reading and point-to-point link installation");
+  cmd.AddValue ("edges", "number of edges of the synthetic graph", edges);
+  cmd.AddValue ("nodes", "number of nodes of the synthetic graph (default edges/4)", nodes);
+  cmd.AddValue ("seed", "seed of the synthetic graph", seed);
+  cmd.AddValue ("install", "also install a point-to-point link per edge", install);
+  cmd.AddValue ("bulk", "use PointToPointHelper::InstallLinks instead of one Install per link", bulk);
+  cmd.AddValue ("file", "name of the temporary Orbis file", fileName);
+  cmd.Parse (argc, argv);
+
+  if (nodes == 0)
+    {
+      nodes = edges / 4 > 1 ? edges / 4 : 2;
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  WriteOrbisGraph (fileName, nodes, edges, seed);
+  std::cout << "write " << edges << " edges: " << clock.End () << " ms" << std::endl;
+
+  Ptr<OrbisTopologyReader> reader = Create<OrbisTopologyReader> ();
+  reader->SetFileName (fileName);
+  clock.Start ();
+  NodeContainer created = reader->Read ();
+  std::cout << "read " << created.GetN () << " nodes, " << reader->LinksSize ()
+            << " links: " << clock.End () << " ms" << std::endl;
+
+  if (install)
+    {
+      PointToPointHelper p2p;
+      clock.Start ();
+      if (bulk)
+        {
+          NodeContainer from;
+          NodeContainer to;
+          for (TopologyReader::ConstLinksIterator i = reader->LinksBegin (); i != reader->LinksEnd (); ++i)
+            {
+              from.Add (i->GetFromNode ());
+              to.Add (i->GetToNode ());
+            }
+          p2p.InstallLinks (from, to);
+        }
+      else
+        {
+          for (TopologyReader::ConstLinksIterator i = reader->LinksBegin (); i != reader->LinksEnd (); ++i)
+            {
+              p2p.Install (i->GetFromNode (), i->GetToNode ());
+            }
+        }
+      std::cout << (bulk ? "bulk " : "") << "install " << reader->LinksSize ()
+                << " links: " << clock.End () << " ms" << std::endl;
+    }
+
+  std::remove (fileName.c_str ());
+  Simulator::Destroy ();
+  return 0;
+}